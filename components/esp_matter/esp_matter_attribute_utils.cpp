@@ -12,14 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <esp_check.h>
 #include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_attribute_utils.h>
+#include <esp_matter_callback_stats.h>
 #include <esp_matter_console.h>
 #include <esp_matter_core.h>
 #include <esp_matter_mem.h>
+#include <esp_timer.h>
 #include <string.h>
 
+#include <app-common/zap-generated/callback.h>
 #include <app/util/attribute-storage.h>
 #include <app/util/attribute-table.h>
 #include <app/reporting/reporting.h>
@@ -520,6 +524,39 @@ namespace attribute {
 
 static esp_matter_val_type_t get_val_type_from_attribute_type(int attribute_type);
 static callback_t attribute_callback = NULL;
+
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_LEVEL_NONE
+static val_print_level_t val_print_level = VAL_PRINT_NONE;
+#elif CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_LEVEL_WRITE
+static val_print_level_t val_print_level = VAL_PRINT_WRITE;
+#else
+static val_print_level_t val_print_level = VAL_PRINT_ALL;
+#endif
+/* Clusters whose attribute accesses are printed, all the clusters when empty */
+static uint32_t val_print_clusters[CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_FILTER_COUNT];
+static size_t val_print_cluster_count = 0;
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+
+/* Checked on the attribute access paths before any formatting work */
+static inline bool should_val_print(uint32_t cluster_id, bool is_read)
+{
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    if (val_print_level == VAL_PRINT_NONE || (is_read && val_print_level != VAL_PRINT_ALL)) {
+        return false;
+    }
+    if (val_print_cluster_count == 0) {
+        return true;
+    }
+    for (size_t i = 0; i < val_print_cluster_count; ++i) {
+        if (val_print_clusters[i] == cluster_id) {
+            return true;
+        }
+    }
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    return false;
+}
+
 #if CONFIG_ENABLE_CHIP_SHELL
 static esp_matter::console::engine attribute_console;
 
@@ -959,6 +996,93 @@ static esp_err_t console_get_handler(int argc, char **argv)
     return ESP_OK;
 }
 
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+static esp_err_t console_print_handler(int argc, char **argv)
+{
+    if (argc >= 1) {
+        if (strcmp(argv[0], "none") == 0) {
+            set_val_print_level(VAL_PRINT_NONE);
+        } else if (strcmp(argv[0], "write") == 0) {
+            set_val_print_level(VAL_PRINT_WRITE);
+        } else if (strcmp(argv[0], "all") == 0) {
+            set_val_print_level(VAL_PRINT_ALL);
+        } else if (strcmp(argv[0], "add") == 0 && argc >= 2) {
+            ESP_RETURN_ON_ERROR(add_val_print_filter(strtoul(argv[1], NULL, 16)), TAG,
+                                "Failed to add the cluster filter");
+        } else if (strcmp(argv[0], "remove") == 0 && argc >= 2) {
+            ESP_RETURN_ON_ERROR(remove_val_print_filter(strtoul(argv[1], NULL, 16)), TAG,
+                                "Failed to remove the cluster filter");
+        } else if (strcmp(argv[0], "clear") == 0) {
+            clear_val_print_filters();
+        } else {
+            ESP_LOGE(TAG, "The arguments for this command is invalid");
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    static const char *level_names[] = {"none", "write", "all"};
+    printf("Attribute print level: %s, clusters:", level_names[val_print_level]);
+    if (val_print_cluster_count == 0) {
+        printf(" all");
+    }
+    for (size_t i = 0; i < val_print_cluster_count; ++i) {
+        printf(" 0x%08" PRIX32, val_print_clusters[i]);
+    }
+    printf("\n");
+    return ESP_OK;
+}
+
+/* Average duration in microseconds of the external attribute read path at a print level */
+static int64_t bench_read(uint16_t endpoint_id, uint32_t cluster_id, const EmberAfAttributeMetadata *matter_attribute,
+                          uint8_t *buffer, uint16_t buffer_size, val_print_level_t level, uint32_t count)
+{
+    val_print_level = level;
+    int64_t start_us = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (emberAfExternalAttributeReadCallback(endpoint_id, cluster_id, matter_attribute, buffer, buffer_size) !=
+            Status::Success) {
+            return -1;
+        }
+    }
+    return (esp_timer_get_time() - start_us) / count;
+}
+
+static esp_err_t console_bench_handler(int argc, char **argv)
+{
+    VerifyOrReturnError(argc >= 3, ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "The arguments for this command is invalid"));
+    uint16_t endpoint_id = strtoul(argv[0], NULL, 16);
+    uint32_t cluster_id = strtoul(argv[1], NULL, 16);
+    uint32_t attribute_id = strtoul(argv[2], NULL, 16);
+    uint32_t count = argc >= 4 ? strtoul(argv[3], NULL, 10) : 100;
+    VerifyOrReturnError(count > 0, ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "The count must be positive"));
+
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturnError(lock_status != lock::FAILED, ESP_FAIL, ESP_LOGE(TAG, "Could not get task context"));
+    const EmberAfAttributeMetadata *matter_attribute = emberAfLocateAttributeMetadata(endpoint_id, cluster_id,
+                                                                                      attribute_id);
+    // Room for the length prefix of the string attributes.
+    uint16_t buffer_size = matter_attribute ? matter_attribute->size + 2 : 0;
+    uint8_t *buffer = matter_attribute ? (uint8_t *)esp_matter_mem_calloc(1, buffer_size) : NULL;
+    int64_t none_us = -1;
+    int64_t all_us = -1;
+    if (buffer) {
+        val_print_level_t level = val_print_level;
+        none_us = bench_read(endpoint_id, cluster_id, matter_attribute, buffer, buffer_size, VAL_PRINT_NONE, count);
+        all_us = bench_read(endpoint_id, cluster_id, matter_attribute, buffer, buffer_size, VAL_PRINT_ALL, count);
+        val_print_level = level;
+        esp_matter_mem_free(buffer);
+    }
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+    VerifyOrReturnError(matter_attribute, ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Matter attribute not found"));
+    VerifyOrReturnError(buffer, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Failed to alloc memory for the read buffer"));
+    VerifyOrReturnError(none_us >= 0 && all_us >= 0, ESP_FAIL, ESP_LOGE(TAG, "Failed to read the attribute"));
+    printf("Attribute read path over %" PRIu32 " reads: %" PRId64 " us per read with print level none, %" PRId64
+           " us with print level all\n", count, none_us, all_us);
+    return ESP_OK;
+}
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+
 static esp_err_t console_dispatch(int argc, char **argv)
 {
     VerifyOrReturnError(argc > 0, ESP_OK, attribute_console.for_each_command(esp_matter::console::print_description, NULL));
@@ -990,6 +1114,23 @@ static void register_console_commands()
                            "Example: matter esp attribute get 0x0001 0x0006 0x0000.",
             .handler = console_get_handler,
         },
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+        {
+            .name = "print",
+            .description = "Get or set which attribute accesses are printed. "
+                           "Usage: matter esp attribute print "
+                           "[none|write|all|add <cluster_id>|remove <cluster_id>|clear]. "
+                           "Example: matter esp attribute print add 0x0006.",
+            .handler = console_print_handler,
+        },
+        {
+            .name = "bench",
+            .description = "Time the attribute read path with the print level none and all, the filters apply. "
+                           "Usage: matter esp attribute bench <endpoint_id> <cluster_id> <attribute_id> [count]. "
+                           "Example: matter esp attribute bench 0x0001 0x0006 0x0000 100.",
+            .handler = console_bench_handler,
+        },
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
     };
     attribute_console.register_commands(attribute_commands, sizeof(attribute_commands)/sizeof(esp_matter::console::command_t));
     esp_matter::console::add_commands(&command, 1);
@@ -1008,10 +1149,26 @@ esp_err_t set_callback(callback_t callback)
     return ESP_OK;
 }
 
+static callback_stats::callback_type_t get_stats_callback_type(callback_type_t type)
+{
+    switch (type) {
+    case PRE_UPDATE:
+        return callback_stats::ATTRIBUTE_PRE_UPDATE;
+    case POST_UPDATE:
+        return callback_stats::ATTRIBUTE_POST_UPDATE;
+    case READ:
+        return callback_stats::ATTRIBUTE_READ;
+    case WRITE:
+        return callback_stats::ATTRIBUTE_WRITE;
+    }
+    return callback_stats::CALLBACK_TYPE_MAX;
+}
+
 static esp_err_t execute_callback(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id,
                                   uint32_t attribute_id, esp_matter_attr_val_t *val)
 {
     if (attribute_callback) {
+        callback_stats::scoped_timer timer(get_stats_callback_type(type), endpoint_id, cluster_id, attribute_id);
         void *priv_data = endpoint::get_priv_data(endpoint_id);
         return attribute_callback(type, endpoint_id, cluster_id, attribute_id, val, priv_data);
     }
@@ -1024,12 +1181,15 @@ static esp_err_t execute_override_callback(attribute_t *attribute, callback_type
     callback_t override_callback = attribute::get_override_callback(attribute);
     void *priv_data = endpoint::get_priv_data(endpoint_id);
     if (override_callback) {
+        callback_stats::scoped_timer timer(get_stats_callback_type(type), endpoint_id, cluster_id, attribute_id);
         return override_callback(type, endpoint_id, cluster_id, attribute_id, val, priv_data);
     } else {
         ESP_LOGI(TAG, "Attribute override callback not set for Endpoint 0x%04" PRIX16 "'s Cluster 0x%08" PRIX32 "'s Attribute 0x%08" PRIX32 ", calling the common callback",
                  endpoint_id, cluster_id, attribute_id);
-        if (attribute_callback)
+        if (attribute_callback) {
+            callback_stats::scoped_timer timer(get_stats_callback_type(type), endpoint_id, cluster_id, attribute_id);
             return attribute_callback(type, endpoint_id, cluster_id, attribute_id, val, priv_data);
+        }
     }
     return ESP_OK;
 }
@@ -1974,6 +2134,77 @@ esp_err_t get_attr_val_from_data(esp_matter_attr_val_t *val, EmberAfAttributeTyp
     return ESP_OK;
 }
 
+esp_err_t set_val_print_level(val_print_level_t level)
+{
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    VerifyOrReturnError(level <= VAL_PRINT_ALL, ESP_ERR_INVALID_ARG);
+    val_print_level = level;
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+}
+
+esp_err_t add_val_print_filter(uint32_t cluster_id)
+{
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturnError(lock_status != lock::FAILED, ESP_FAIL, ESP_LOGE(TAG, "Could not get task context"));
+    esp_err_t err = ESP_OK;
+    bool found = false;
+    for (size_t i = 0; i < val_print_cluster_count; ++i) {
+        found = found || val_print_clusters[i] == cluster_id;
+    }
+    if (!found) {
+        if (val_print_cluster_count < CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_FILTER_COUNT) {
+            val_print_clusters[val_print_cluster_count++] = cluster_id;
+        } else {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+    return err;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+}
+
+esp_err_t remove_val_print_filter(uint32_t cluster_id)
+{
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturnError(lock_status != lock::FAILED, ESP_FAIL, ESP_LOGE(TAG, "Could not get task context"));
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    for (size_t i = 0; i < val_print_cluster_count; ++i) {
+        if (val_print_clusters[i] == cluster_id) {
+            val_print_clusters[i] = val_print_clusters[--val_print_cluster_count];
+            err = ESP_OK;
+            break;
+        }
+    }
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+    return err;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+}
+
+void clear_val_print_filters()
+{
+#if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturn(lock_status != lock::FAILED, ESP_LOGE(TAG, "Could not get task context"));
+    val_print_cluster_count = 0;
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+#endif // CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT
+}
+
 void val_print(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t *val, bool is_read)
 {
     char action = (is_read) ? 'R' :'W';
@@ -2073,7 +2304,7 @@ esp_err_t update(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_i
     }
 
     /* Get value */
-    uint8_t *value = (uint8_t *)esp_matter_mem_calloc(1, attribute_size);
+    uint8_t *value = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, attribute_size);
     if (!value) {
         ESP_LOGE(TAG, "Could not allocate value buffer, size: %u", attribute_size);
         if (lock_status == lock::SUCCESS) {
@@ -2090,14 +2321,14 @@ esp_err_t update(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_i
         if (status != Status::Success) {
             ESP_LOGE(TAG, "Error updating Endpoint 0x%04" PRIX16 "'s Cluster 0x%08" PRIX32 "'s Attribute 0x%08" PRIX32 " to matter: 0x%X", endpoint_id,
                      cluster_id, attribute_id, static_cast<uint16_t>(status));
-            esp_matter_mem_free(value);
+            esp_matter_mem_free_tagged(value);
             if (lock_status == lock::SUCCESS) {
                 lock::chip_stack_unlock();
             }
             return ESP_FAIL;
         }
     }
-    esp_matter_mem_free(value);
+    esp_matter_mem_free_tagged(value);
     if (lock_status == lock::SUCCESS) {
         lock::chip_stack_unlock();
     }
@@ -2158,7 +2389,9 @@ Status MatterPreAttributeChangeCallback(const chip::app::ConcreteAttributePath &
     attribute::get_attr_val_from_data(&val, type, size, value, attribute_metadata);
 
     /* Here, the val_print function gets called on attribute write.*/
-    attribute::val_print(endpoint_id, cluster_id, attribute_id, &val, false);
+    if (attribute::should_val_print(cluster_id, false)) {
+        attribute::val_print(endpoint_id, cluster_id, attribute_id, &val, false);
+    }
 
     /* Callback to application */
     esp_err_t err = execute_callback(attribute::PRE_UPDATE, endpoint_id, cluster_id, attribute_id, &val);
@@ -2201,7 +2434,9 @@ Status emberAfExternalAttributeReadCallback(EndpointId endpoint_id, ClusterId cl
     }
 
     /* Here, the val_print function gets called on attribute read. */
-    attribute::val_print(endpoint_id, cluster_id, attribute_id, &val, true);
+    if (attribute::should_val_print(cluster_id, true)) {
+        attribute::val_print(endpoint_id, cluster_id, attribute_id, &val, true);
+    }
 
     /* Get size */
     uint16_t attribute_size = 0;
@@ -450,5 +450,54 @@ esp_err_t report(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_i
  */
 void val_print(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t *val, bool is_read);
 
+/** Attribute accesses printed by the data model */
+typedef enum {
+    /** No attribute access is printed */
+    VAL_PRINT_NONE,
+    /** Only the attribute writes are printed */
+    VAL_PRINT_WRITE,
+    /** The attribute reads and writes are printed */
+    VAL_PRINT_ALL,
+} val_print_level_t;
+
+/** Set the attribute print level
+ *
+ * The data model prints the attribute values with `val_print()` on the attribute accesses of this level. The
+ * default is set by CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_LEVEL_NONE, CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_LEVEL_WRITE
+ * or CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_LEVEL_ALL.
+ *
+ * @param[in] level Attribute accesses to print.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT is disabled.
+ * @return error in case of failure.
+ */
+esp_err_t set_val_print_level(val_print_level_t level);
+
+/** Add a cluster to the attribute print filters
+ *
+ * When there are filters, only the attribute accesses of the filtered clusters are printed.
+ *
+ * @param[in] cluster_id Cluster ID.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NO_MEM if there are CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT_FILTER_COUNT filters already.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT is disabled.
+ */
+esp_err_t add_val_print_filter(uint32_t cluster_id);
+
+/** Remove a cluster from the attribute print filters
+ *
+ * @param[in] cluster_id Cluster ID.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_FOUND if the cluster is not filtered.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_ATTRIBUTE_VAL_PRINT is disabled.
+ */
+esp_err_t remove_val_print_filter(uint32_t cluster_id);
+
+/** Remove all the attribute print filters, the attribute accesses of all the clusters are printed */
+void clear_val_print_filters();
+
 } /* attribute */
 } /* esp_matter */
@@ -0,0 +1,152 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_matter_callback_stats.h>
+
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "esp_matter_callback";
+
+namespace esp_matter {
+namespace callback_stats {
+
+static const char *k_type_names[CALLBACK_TYPE_MAX] = {"pre-update", "post-update", "read", "write", "command"};
+
+static stats_t s_stats;
+// The callbacks run in tasks, a mutex keeps the interrupts enabled while the cluster table is searched or copied.
+static StaticSemaphore_t s_stats_mutex_buffer;
+static SemaphoreHandle_t s_stats_mutex = xSemaphoreCreateMutexStatic(&s_stats_mutex_buffer);
+static uint32_t s_slow_threshold_us = CONFIG_ESP_MATTER_CALLBACK_STATS_SLOW_THRESHOLD_MS * 1000;
+
+class stats_lock {
+public:
+    stats_lock() { xSemaphoreTake(s_stats_mutex, portMAX_DELAY); }
+    ~stats_lock() { xSemaphoreGive(s_stats_mutex); }
+};
+
+static size_t histogram_bucket(uint32_t duration_us)
+{
+    if (duration_us < 16) {
+        return 0;
+    }
+    size_t bucket = 31 - __builtin_clz(duration_us) - 3;
+    return bucket < k_histogram_bucket_count ? bucket : k_histogram_bucket_count - 1;
+}
+
+static cluster_stats_t *get_cluster_stats(uint32_t cluster_id)
+{
+    for (size_t i = 0; i < s_stats.cluster_count; ++i) {
+        if (s_stats.clusters[i].cluster_id == cluster_id) {
+            return &s_stats.clusters[i];
+        }
+    }
+    if (s_stats.cluster_count < CONFIG_ESP_MATTER_CALLBACK_STATS_CLUSTER_COUNT) {
+        cluster_stats_t *cluster = &s_stats.clusters[s_stats.cluster_count++];
+        memset(cluster, 0, sizeof(*cluster));
+        cluster->cluster_id = cluster_id;
+        return cluster;
+    }
+    return nullptr;
+}
+
+static void update_stats(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id,
+                         uint32_t duration_us, bool slow)
+{
+    stats_lock guard;
+    cluster_stats_t *cluster = get_cluster_stats(cluster_id);
+    if (cluster) {
+        type_stats_t &stats = cluster->types[type];
+        stats.count++;
+        stats.total_us += duration_us;
+        if (duration_us >= stats.max_us) {
+            stats.max_us = duration_us;
+            stats.max_endpoint_id = endpoint_id;
+            stats.max_id = id;
+        }
+        uint16_t &bucket = stats.histogram[histogram_bucket(duration_us)];
+        if (bucket < UINT16_MAX) {
+            bucket++;
+        }
+    } else {
+        s_stats.dropped_count++;
+    }
+    if (slow) {
+        s_stats.slow_count++;
+    }
+}
+
+void record(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id, uint32_t duration_us)
+{
+    if (type >= CALLBACK_TYPE_MAX) {
+        return;
+    }
+    bool slow = s_slow_threshold_us > 0 && duration_us >= s_slow_threshold_us;
+    update_stats(type, endpoint_id, cluster_id, id, duration_us, slow);
+
+    if (slow) {
+        ESP_LOGW(TAG, "Slow %s callback: %" PRIu32 " ms for Endpoint 0x%04" PRIX16 "'s Cluster 0x%08" PRIX32
+                 "'s 0x%08" PRIX32, k_type_names[type], duration_us / 1000, endpoint_id, cluster_id, id);
+    }
+}
+
+esp_err_t get_stats(stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    stats_lock guard;
+    *stats = s_stats;
+    return ESP_OK;
+}
+
+void reset_stats()
+{
+    stats_lock guard;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void set_slow_threshold(uint32_t threshold_ms)
+{
+    s_slow_threshold_us = threshold_ms * 1000;
+}
+
+uint32_t get_slow_threshold()
+{
+    return s_slow_threshold_us / 1000;
+}
+
+scoped_timer::scoped_timer(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id)
+    : m_start_us(esp_timer_get_time())
+    , m_type(type)
+    , m_endpoint_id(endpoint_id)
+    , m_cluster_id(cluster_id)
+    , m_id(id)
+{
+}
+
+scoped_timer::~scoped_timer()
+{
+    record(m_type, m_endpoint_id, m_cluster_id, m_id, static_cast<uint32_t>(esp_timer_get_time() - m_start_us));
+}
+
+} // namespace callback_stats
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_CALLBACK_STATS
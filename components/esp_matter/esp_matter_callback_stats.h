@@ -0,0 +1,136 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <sdkconfig.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace callback_stats {
+
+/** Type of the timed application callbacks */
+typedef enum {
+    /** Attribute callback with `attribute::PRE_UPDATE` */
+    ATTRIBUTE_PRE_UPDATE,
+    /** Attribute callback with `attribute::POST_UPDATE` */
+    ATTRIBUTE_POST_UPDATE,
+    /** Attribute override callback with `attribute::READ` */
+    ATTRIBUTE_READ,
+    /** Attribute override callback with `attribute::WRITE` */
+    ATTRIBUTE_WRITE,
+    /** User callback of a received command, set with `command::set_user_callback()`. The cluster server and the
+     * command callbacks are not included, the attribute callbacks they trigger are recorded as ATTRIBUTE_PRE_UPDATE
+     * and ATTRIBUTE_POST_UPDATE. */
+    COMMAND,
+    CALLBACK_TYPE_MAX,
+} callback_type_t;
+
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+/** Number of buckets of the callback histograms
+ *
+ * The first bucket counts the durations below 16 microseconds, the bucket N counts the durations from 2^(N+3) to
+ * 2^(N+4) - 1 microseconds and the last bucket the durations from 2^18 microseconds (262 ms).
+ */
+constexpr size_t k_histogram_bucket_count = 16;
+
+/** Statistics of the callbacks of one type for a cluster */
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    /** Endpoint, and attribute or command, of the longest callback */
+    uint16_t max_endpoint_id;
+    uint32_t max_id;
+    /** Histogram of the durations, the counts saturate at UINT16_MAX */
+    uint16_t histogram[k_histogram_bucket_count];
+} type_stats_t;
+
+/** Statistics of the callbacks for a cluster */
+typedef struct {
+    uint32_t cluster_id;
+    type_stats_t types[CALLBACK_TYPE_MAX];
+} cluster_stats_t;
+
+/** Statistics of the application callbacks */
+typedef struct {
+    cluster_stats_t clusters[CONFIG_ESP_MATTER_CALLBACK_STATS_CLUSTER_COUNT];
+    size_t cluster_count;
+    /** Callbacks not recorded because the cluster table was full */
+    uint32_t dropped_count;
+    /** Callbacks longer than the slow callback threshold */
+    uint32_t slow_count;
+} stats_t;
+
+/** Record a callback
+ *
+ * @param[in] type Callback type.
+ * @param[in] endpoint_id Endpoint ID of the callback.
+ * @param[in] cluster_id Cluster ID of the callback.
+ * @param[in] id Attribute ID or command ID of the callback.
+ * @param[in] duration_us Duration of the callback in microseconds.
+ */
+void record(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id, uint32_t duration_us);
+
+/** Get the statistics of the application callbacks
+ *
+ * @param[out] stats Statistics of the callbacks.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t get_stats(stats_t *stats);
+
+/** Reset the statistics of the application callbacks */
+void reset_stats();
+
+/** Set the slow callback threshold
+ *
+ * A warning is logged for the callbacks which take longer than the threshold. The default is
+ * CONFIG_ESP_MATTER_CALLBACK_STATS_SLOW_THRESHOLD_MS.
+ *
+ * @param[in] threshold_ms Threshold in milliseconds, 0 disables the warnings.
+ */
+void set_slow_threshold(uint32_t threshold_ms);
+
+/** Get the slow callback threshold in milliseconds */
+uint32_t get_slow_threshold();
+
+/** Time the callbacks of the enclosing scope
+ *
+ * The duration between the construction and the destruction is recorded with `record()`.
+ */
+class scoped_timer {
+public:
+    scoped_timer(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id);
+    ~scoped_timer();
+
+private:
+    int64_t m_start_us;
+    callback_type_t m_type;
+    uint16_t m_endpoint_id;
+    uint32_t m_cluster_id;
+    uint32_t m_id;
+};
+#else
+class scoped_timer {
+public:
+    scoped_timer(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t id) {}
+};
+#endif // CONFIG_ESP_MATTER_CALLBACK_STATS
+
+} // namespace callback_stats
+} // namespace esp_matter
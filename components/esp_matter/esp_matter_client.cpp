@@ -12,13 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <esp_check.h>
 #include <esp_err.h>
 #include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_client.h>
 #include <esp_matter_core.h>
+#include <esp_matter_mem.h>
 #include <json_to_tlv.h>
+#include <new>
+#include <type_traits>
+#include <utility>
 
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app-common/zap-generated/ids/Commands.h>
 #include <app/ConcreteAttributePath.h>
 #include <app/EventHeader.h>
 #include <app/MessageDef/DataVersionFilterIBs.h>
@@ -26,7 +34,11 @@
 #include <app/ReadClient.h>
 #include <app/ReadPrepareParams.h>
 #include <app/clusters/bindings/BindingManager.h>
+#include <app/util/binding-table.h>
+#include <credentials/GroupDataProvider.h>
+#include <transport/SessionHolder.h>
 #include <core/Optional.h>
+#include <core/TLVBackingStore.h>
 #include <core/TLVReader.h>
 #include <core/TLVWriter.h>
 
@@ -53,6 +65,324 @@ static group_request_callback_t client_group_request_callback = NULL;
 static void *request_callback_priv_data;
 static bool initialize_binding_manager = false;
 
+/** Pool of objects constructed in preallocated storage
+ *
+ * The objects are allocated from the heap when all the preallocated ones are in use, so that a burst of requests
+ * does not fail. The pools are only used in the Matter thread.
+ */
+template <typename T, size_t N>
+class object_pool {
+public:
+    template <typename... Args>
+    T *create(Args &&... args)
+    {
+        for (size_t i = 0; i < N; ++i) {
+            if (!m_in_use[i]) {
+                m_in_use[i] = true;
+                m_in_use_count++;
+                m_peak_in_use = std::max(m_peak_in_use, m_in_use_count);
+                return new (&m_storage[i]) T(std::forward<Args>(args)...);
+            }
+        }
+        m_exhausted_count++;
+        void *object = esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_CLIENT, 1, sizeof(T));
+        return object ? new (object) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void release(T *object)
+    {
+        if (!object) {
+            return;
+        }
+        uintptr_t addr = reinterpret_cast<uintptr_t>(object);
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_storage);
+        object->~T();
+        if (addr < base || addr >= base + sizeof(m_storage)) {
+            esp_matter_mem_free_tagged(object);
+            return;
+        }
+        m_in_use[(addr - base) / sizeof(m_storage[0])] = false;
+        m_in_use_count--;
+    }
+
+    void get_usage(pool_usage_t &usage) const
+    {
+        usage.size = N;
+        usage.in_use = m_in_use_count;
+        usage.peak_in_use = m_peak_in_use;
+        usage.exhausted_count = m_exhausted_count;
+    }
+
+    void reset_stats()
+    {
+        m_peak_in_use = m_in_use_count;
+        m_exhausted_count = 0;
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage[N];
+    bool m_in_use[N] = {};
+    uint16_t m_in_use_count = 0;
+    uint16_t m_peak_in_use = 0;
+    uint32_t m_exhausted_count = 0;
+};
+
+static object_pool<request_handle_t, CONFIG_ESP_MATTER_CLIENT_REQUEST_POOL_SIZE> request_handle_pool;
+static object_pool<chip::app::CommandSender, CONFIG_ESP_MATTER_CLIENT_COMMAND_SENDER_POOL_SIZE> command_sender_pool;
+static object_pool<interaction::invoke::custom_command_callback, CONFIG_ESP_MATTER_CLIENT_COMMAND_SENDER_POOL_SIZE>
+    command_callback_pool;
+
+esp_err_t get_pool_stats(pool_stats_t *stats)
+{
+    VerifyOrReturnError(stats, ESP_ERR_INVALID_ARG);
+    request_handle_pool.get_usage(stats->request_handles);
+    command_sender_pool.get_usage(stats->command_senders);
+    command_callback_pool.get_usage(stats->command_callbacks);
+    return ESP_OK;
+}
+
+void reset_pool_stats()
+{
+    request_handle_pool.reset_stats();
+    command_sender_pool.reset_stats();
+    command_callback_pool.reset_stats();
+}
+
+#if CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM
+/** Sessions kept established to the bound peer nodes
+ *
+ * The requests to these peer nodes do not wait for the CASE establishment. At most
+ * CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM_BUDGET peer nodes are kept, and the least recently used one is evicted
+ * for a bound peer node which is sent a request. It is only used in the Matter thread.
+ */
+class session_cache {
+public:
+    void start() { refresh(); }
+
+    /** Record a request to a peer node and keep its session established if it is bound */
+    void lookup(const ScopedNodeId &peer_id);
+
+    void get_stats(session_cache_stats_t &stats) const;
+
+    void reset_stats()
+    {
+        m_stats.hits = 0;
+        m_stats.misses = 0;
+        m_stats.established = 0;
+        m_stats.evictions = 0;
+    }
+
+private:
+    struct entry_t {
+        entry_t()
+            : on_connected(connected_callback, this)
+            , on_failure(failure_callback, this)
+        {
+        }
+
+        ScopedNodeId peer_id;
+        chip::SessionHolder session;
+        uint32_t last_used = 0;
+        bool connecting = false;
+        Callback<chip::OnDeviceConnected> on_connected;
+        Callback<chip::OnDeviceConnectionFailure> on_failure;
+    };
+
+    static void connected_callback(void *context, ExchangeManager &exchange_mgr, const SessionHandle &session);
+    static void failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error);
+    static void refresh_timer_callback(chip::System::Layer *layer, void *context);
+    static bool is_bound(const ScopedNodeId &peer_id);
+
+    entry_t *find(const ScopedNodeId &peer_id);
+    entry_t *find_free();
+    void release(entry_t &entry);
+    void warm(entry_t &entry);
+    void refresh();
+
+    entry_t m_entries[CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM_BUDGET];
+    uint32_t m_use_count = 0;
+    session_cache_stats_t m_stats = {};
+};
+
+static session_cache s_session_cache;
+
+bool session_cache::is_bound(const ScopedNodeId &peer_id)
+{
+    for (const EmberBindingTableEntry &entry : chip::BindingTable::GetInstance()) {
+        if (entry.type == MATTER_UNICAST_BINDING && ScopedNodeId(entry.nodeId, entry.fabricIndex) == peer_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+session_cache::entry_t *session_cache::find(const ScopedNodeId &peer_id)
+{
+    for (entry_t &entry : m_entries) {
+        if (entry.peer_id.IsOperational() && entry.peer_id == peer_id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+session_cache::entry_t *session_cache::find_free()
+{
+    for (entry_t &entry : m_entries) {
+        if (!entry.peer_id.IsOperational()) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void session_cache::release(entry_t &entry)
+{
+    if (entry.connecting) {
+        entry.on_connected.Cancel();
+        entry.on_failure.Cancel();
+        entry.connecting = false;
+    }
+    entry.session.Release();
+    entry.peer_id = ScopedNodeId();
+    entry.last_used = 0;
+}
+
+void session_cache::warm(entry_t &entry)
+{
+    if (entry.connecting || entry.session) {
+        return;
+    }
+    entry.connecting = true;
+    // The callbacks may be called before FindOrEstablishSession() returns if the session exists.
+    chip::Server::GetInstance().GetCASESessionManager()->FindOrEstablishSession(entry.peer_id, &entry.on_connected,
+                                                                                &entry.on_failure);
+}
+
+void session_cache::lookup(const ScopedNodeId &peer_id)
+{
+    auto session = chip::Server::GetInstance().GetSecureSessionManager().FindSecureSessionForNode(
+        peer_id, chip::MakeOptional(chip::Transport::SecureSession::Type::kCASE));
+    if (session.HasValue()) {
+        m_stats.hits++;
+    } else {
+        m_stats.misses++;
+    }
+    entry_t *entry = find(peer_id);
+    if (!entry) {
+        if (!is_bound(peer_id)) {
+            return;
+        }
+        entry = find_free();
+        if (!entry) {
+            entry = &m_entries[0];
+            for (entry_t &candidate : m_entries) {
+                if (candidate.last_used < entry->last_used) {
+                    entry = &candidate;
+                }
+            }
+            ESP_LOGI(TAG, "Evict the session to node 0x%" PRIx64 " for node 0x%" PRIx64, entry->peer_id.GetNodeId(),
+                     peer_id.GetNodeId());
+            release(*entry);
+            m_stats.evictions++;
+        }
+        entry->peer_id = peer_id;
+    }
+    entry->last_used = ++m_use_count;
+    warm(*entry);
+}
+
+void session_cache::refresh()
+{
+    for (entry_t &entry : m_entries) {
+        if (entry.peer_id.IsOperational() && !is_bound(entry.peer_id)) {
+            release(entry);
+        }
+    }
+    // Fill the free entries with the bound peer nodes, they are evicted first.
+    for (const EmberBindingTableEntry &binding : chip::BindingTable::GetInstance()) {
+        ScopedNodeId peer_id(binding.nodeId, binding.fabricIndex);
+        if (binding.type != MATTER_UNICAST_BINDING || find(peer_id)) {
+            continue;
+        }
+        entry_t *entry = find_free();
+        if (!entry) {
+            break;
+        }
+        entry->peer_id = peer_id;
+    }
+    // The sessions expired or released by the peer nodes are established again.
+    for (entry_t &entry : m_entries) {
+        if (entry.peer_id.IsOperational()) {
+            warm(entry);
+        }
+    }
+    chip::DeviceLayer::SystemLayer().StartTimer(
+        chip::System::Clock::Seconds32(CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM_INTERVAL_S), refresh_timer_callback,
+        this);
+}
+
+void session_cache::refresh_timer_callback(chip::System::Layer *layer, void *context)
+{
+    static_cast<session_cache *>(context)->refresh();
+}
+
+void session_cache::connected_callback(void *context, ExchangeManager &exchange_mgr, const SessionHandle &session)
+{
+    entry_t *entry = static_cast<entry_t *>(context);
+    entry->connecting = false;
+    if (!entry->session.Contains(session) && entry->session.Grab(session)) {
+        s_session_cache.m_stats.established++;
+    }
+}
+
+void session_cache::failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error)
+{
+    entry_t *entry = static_cast<entry_t *>(context);
+    entry->connecting = false;
+    ESP_LOGW(TAG, "Failed to establish the session to node 0x%" PRIx64 ": %" CHIP_ERROR_FORMAT, peer_id.GetNodeId(),
+             error.Format());
+}
+
+void session_cache::get_stats(session_cache_stats_t &stats) const
+{
+    stats = m_stats;
+    stats.budget = CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM_BUDGET;
+    stats.warm_sessions = 0;
+    for (const entry_t &entry : m_entries) {
+        if (entry.session) {
+            stats.warm_sessions++;
+        }
+    }
+}
+
+static void session_cache_lookup(const ScopedNodeId &peer_id)
+{
+    s_session_cache.lookup(peer_id);
+}
+
+esp_err_t get_session_cache_stats(session_cache_stats_t *stats)
+{
+    VerifyOrReturnError(stats, ESP_ERR_INVALID_ARG);
+    s_session_cache.get_stats(*stats);
+    return ESP_OK;
+}
+
+void reset_session_cache_stats()
+{
+    s_session_cache.reset_stats();
+}
+#else
+static void session_cache_lookup(const ScopedNodeId &peer_id) {}
+
+esp_err_t get_session_cache_stats(session_cache_stats_t *stats)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void reset_session_cache_stats() {}
+#endif // CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM
+
 esp_err_t set_request_callback(request_callback_t callback, group_request_callback_t g_callback, void *priv_data)
 {
     client_request_callback = callback;
@@ -72,16 +402,14 @@ void esp_matter_connection_success_callback(void *context, ExchangeManager &exch
         OperationalDeviceProxy device(&exchangeMgr, sessionHandle);
         client_request_callback(&device, req_handle, request_callback_priv_data);
     }
-    chip::Platform::Delete(req_handle);
+    request_handle_pool.release(req_handle);
 }
 
 void esp_matter_connection_failure_callback(void *context, const ScopedNodeId &peerId, CHIP_ERROR error)
 {
     request_handle_t *req_handle = static_cast<request_handle_t *>(context);
     ESP_LOGI(TAG, "New connection failure");
-    if (req_handle) {
-        chip::Platform::Delete(req_handle);
-    }
+    request_handle_pool.release(req_handle);
 }
 
 esp_err_t connect(case_session_mgr_t *case_session_mgr, uint8_t fabric_index, uint64_t node_id,
@@ -91,10 +419,11 @@ esp_err_t connect(case_session_mgr_t *case_session_mgr, uint8_t fabric_index, ui
     static Callback<chip::OnDeviceConnected> success_callback(esp_matter_connection_success_callback, NULL);
     static Callback<chip::OnDeviceConnectionFailure> failure_callback(esp_matter_connection_failure_callback, NULL);
 
-    request_handle_t *context = chip::Platform::New<request_handle_t>(req_handle);
+    request_handle_t *context = request_handle_pool.create(req_handle);
     VerifyOrReturnError(context, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "failed to alloc memory for the command handle"));
     success_callback.mContext = static_cast<void *>(context);
     failure_callback.mContext = static_cast<void *>(context);
+    session_cache_lookup(ScopedNodeId(node_id, fabric_index));
     case_session_mgr->FindOrEstablishSession(ScopedNodeId(node_id, fabric_index), &success_callback, &failure_callback);
     return ESP_OK;
 }
@@ -144,14 +473,12 @@ static void esp_matter_command_client_binding_callback(const EmberBindingTableEn
 
 static void esp_matter_binding_context_release(void *context)
 {
-    if (context) {
-        chip::Platform::Delete(static_cast<request_handle_t *>(context));
-    }
+    request_handle_pool.release(static_cast<request_handle_t *>(context));
 }
 
 esp_err_t cluster_update(uint16_t local_endpoint_id, request_handle_t *req_handle)
 {
-    request_handle_t *context = chip::Platform::New<request_handle_t>(req_handle);
+    request_handle_t *context = request_handle_pool.create(req_handle);
     VerifyOrReturnError(context, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "failed to alloc memory for the request handle"));
     chip::ClusterId notified_cluster_id = chip::kInvalidClusterId;
     if (req_handle->type == INVOKE_CMD) {
@@ -161,11 +488,33 @@ esp_err_t cluster_update(uint16_t local_endpoint_id, request_handle_t *req_handl
     } else if (req_handle->type == READ_EVENT || req_handle->type == SUBSCRIBE_EVENT) {
         notified_cluster_id = req_handle->event_path.mClusterId;
     }
-    VerifyOrReturnError(notified_cluster_id != chip::kInvalidClusterId, ESP_ERR_INVALID_ARG);
+    VerifyOrReturnError(notified_cluster_id != chip::kInvalidClusterId, ESP_ERR_INVALID_ARG,
+                        request_handle_pool.release(context));
+#if CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM
+    auto is_notified = [&](const EmberBindingTableEntry &entry) {
+        return entry.type == MATTER_UNICAST_BINDING && entry.local == local_endpoint_id &&
+            (!entry.clusterId.HasValue() || entry.clusterId.Value() == notified_cluster_id);
+    };
+    // The session to a peer node bound on several endpoints is established once, so it is looked up once.
+    chip::BindingTable &binding_table = chip::BindingTable::GetInstance();
+    for (auto iter = binding_table.begin(); iter != binding_table.end(); ++iter) {
+        if (!is_notified(*iter)) {
+            continue;
+        }
+        ScopedNodeId peer_id(iter->nodeId, iter->fabricIndex);
+        bool looked_up = false;
+        for (auto prev = binding_table.begin(); prev != iter && !looked_up; ++prev) {
+            looked_up = is_notified(*prev) && ScopedNodeId(prev->nodeId, prev->fabricIndex) == peer_id;
+        }
+        if (!looked_up) {
+            session_cache_lookup(peer_id);
+        }
+    }
+#endif
     if (CHIP_NO_ERROR !=
         chip::BindingManager::GetInstance().NotifyBoundClusterChanged(local_endpoint_id, notified_cluster_id,
                                                                       static_cast<void *>(context))) {
-        chip::Platform::Delete(context);
+        request_handle_pool.release(context);
         ESP_LOGE(TAG, "failed to notify the bound cluster changed");
         return ESP_FAIL;
     }
@@ -185,6 +534,9 @@ static void __binding_manager_init(intptr_t arg)
     chip::BindingManager::GetInstance().Init(binding_init_params);
     chip::BindingManager::GetInstance().RegisterBoundDeviceChangedHandler(esp_matter_command_client_binding_callback);
     chip::BindingManager::GetInstance().RegisterBoundDeviceContextReleaseHandler(esp_matter_binding_context_release);
+#if CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM
+    s_session_cache.start();
+#endif
 }
 
 void binding_manager_init()
@@ -202,6 +554,181 @@ void binding_init()
 
 namespace interaction {
 using chip::app::DataModel::EncodableToTLV;
+using chip::TLV::TLVReader;
+using chip::TLV::TLVWriter;
+
+static constexpr size_t k_max_encoded_buf_size = chip::kMaxAppMessageLen;
+
+esp_err_t tlv_encodable_type::set(const uint8_t *tlv_buf, size_t tlv_len)
+{
+    VerifyOrReturnError(tlv_buf && tlv_len > 0, ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid TLV buffer"));
+    m_tlv_buf.Alloc(tlv_len);
+    VerifyOrReturnError(m_tlv_buf.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Failed to alloc memory for TLV buffer"));
+    memcpy(m_tlv_buf.Get(), tlv_buf, tlv_len);
+    return ESP_OK;
+}
+
+/* Backing store of a TLVWriter which only counts the encoded length. The data is written to a small scratch buffer
+ * which is reused for each chunk, so that the TLV buffer could be allocated with the exact size before encoding. */
+class tlv_length_counter : public chip::TLV::TLVBackingStore {
+public:
+    CHIP_ERROR OnInit(TLVReader &reader, const uint8_t *&buf_start, uint32_t &buf_len) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    CHIP_ERROR GetNextBuffer(TLVReader &reader, const uint8_t *&buf_start, uint32_t &buf_len) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    CHIP_ERROR OnInit(TLVWriter &writer, uint8_t *&buf_start, uint32_t &buf_len) override
+    {
+        return GetNewBuffer(writer, buf_start, buf_len);
+    }
+
+    CHIP_ERROR GetNewBuffer(TLVWriter &writer, uint8_t *&buf_start, uint32_t &buf_len) override
+    {
+        buf_start = m_scratch;
+        buf_len = sizeof(m_scratch);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR FinalizeBuffer(TLVWriter &writer, uint8_t *buf_start, uint32_t buf_len) override
+    {
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    uint8_t m_scratch[32];
+};
+
+esp_err_t tlv_encodable_type::set(const EncodableToTLV &encodable)
+{
+    // Get the encoded length first, then encode into a buffer of that size. The data is encoded twice, but there is
+    // neither a kMaxAppMessageLen scratch buffer nor a copy.
+    tlv_length_counter counter;
+    TLVWriter counting_writer;
+    counting_writer.Init(counter, k_max_encoded_buf_size);
+    VerifyOrReturnError(encodable.EncodeTo(counting_writer, chip::TLV::AnonymousTag()) == CHIP_NO_ERROR, ESP_FAIL,
+                        ESP_LOGE(TAG, "Failed to encode data"));
+    VerifyOrReturnError(counting_writer.Finalize() == CHIP_NO_ERROR, ESP_FAIL,
+                        ESP_LOGE(TAG, "Failed to finalize TLV writer"));
+    size_t encoded_len = counting_writer.GetLengthWritten();
+
+    m_tlv_buf.Alloc(encoded_len);
+    VerifyOrReturnError(m_tlv_buf.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Failed to alloc memory for TLV buffer"));
+    TLVWriter writer;
+    writer.Init(m_tlv_buf.Get(), encoded_len);
+    if (encodable.EncodeTo(writer, chip::TLV::AnonymousTag()) != CHIP_NO_ERROR || writer.Finalize() != CHIP_NO_ERROR ||
+        writer.GetLengthWritten() != encoded_len) {
+        ESP_LOGE(TAG, "Failed to encode data");
+        m_tlv_buf.Free();
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+template <typename T>
+static CHIP_ERROR put_nullable(TLVWriter &writer, chip::TLV::Tag tag, T val, bool nullable)
+{
+    if (nullable && chip::app::NumericAttributeTraits<T>::IsNullValue(val)) {
+        return writer.PutNull(tag);
+    }
+    return writer.Put(tag, val);
+}
+
+static esp_err_t encode_attr_val(TLVWriter &writer, chip::TLV::Tag tag, const esp_matter_attr_val_t &val)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    bool nullable = (val.type & ESP_MATTER_VAL_NULLABLE_BASE) != 0;
+    switch (val.type & ~ESP_MATTER_VAL_NULLABLE_BASE) {
+    case ESP_MATTER_VAL_TYPE_BOOLEAN:
+        if (nullable && chip::app::NumericAttributeTraits<bool>::IsNullValue(val.val.u8)) {
+            err = writer.PutNull(tag);
+        } else {
+            err = writer.Put(tag, val.val.b);
+        }
+        break;
+    case ESP_MATTER_VAL_TYPE_INTEGER:
+        err = put_nullable<int32_t>(writer, tag, val.val.i, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_FLOAT:
+        err = put_nullable<float>(writer, tag, val.val.f, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_INT8:
+        err = put_nullable<int8_t>(writer, tag, val.val.i8, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_UINT8:
+    case ESP_MATTER_VAL_TYPE_ENUM8:
+    case ESP_MATTER_VAL_TYPE_BITMAP8:
+        err = put_nullable<uint8_t>(writer, tag, val.val.u8, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_INT16:
+        err = put_nullable<int16_t>(writer, tag, val.val.i16, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_UINT16:
+    case ESP_MATTER_VAL_TYPE_ENUM16:
+    case ESP_MATTER_VAL_TYPE_BITMAP16:
+        err = put_nullable<uint16_t>(writer, tag, val.val.u16, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_INT32:
+        err = put_nullable<int32_t>(writer, tag, val.val.i32, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_UINT32:
+    case ESP_MATTER_VAL_TYPE_BITMAP32:
+        err = put_nullable<uint32_t>(writer, tag, val.val.u32, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_INT64:
+        err = put_nullable<int64_t>(writer, tag, val.val.i64, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_UINT64:
+        err = put_nullable<uint64_t>(writer, tag, val.val.u64, nullable);
+        break;
+    case ESP_MATTER_VAL_TYPE_CHAR_STRING:
+    case ESP_MATTER_VAL_TYPE_LONG_CHAR_STRING:
+        err = writer.PutString(tag, reinterpret_cast<const char *>(val.val.a.b), val.val.a.s);
+        break;
+    case ESP_MATTER_VAL_TYPE_OCTET_STRING:
+    case ESP_MATTER_VAL_TYPE_LONG_OCTET_STRING:
+        err = writer.PutBytes(tag, val.val.a.b, val.val.a.s);
+        break;
+    default:
+        ESP_LOGE(TAG, "Attribute value type %d is not supported", val.type);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    VerifyOrReturnError(err == CHIP_NO_ERROR, ESP_FAIL, ESP_LOGE(TAG, "Failed to encode attribute value"));
+    return ESP_OK;
+}
+
+esp_err_t tlv_encodable_type::set(const esp_matter_attr_val_t &val)
+{
+    // Reserve some room for the control byte, the tag and the length of the TLV element.
+    size_t encoded_buf_size = 16;
+    int base_type = val.type & ~ESP_MATTER_VAL_NULLABLE_BASE;
+    if (base_type == ESP_MATTER_VAL_TYPE_CHAR_STRING || base_type == ESP_MATTER_VAL_TYPE_LONG_CHAR_STRING ||
+        base_type == ESP_MATTER_VAL_TYPE_OCTET_STRING || base_type == ESP_MATTER_VAL_TYPE_LONG_OCTET_STRING) {
+        encoded_buf_size += val.val.a.s;
+    }
+    chip::Platform::ScopedMemoryBuffer<uint8_t> encoded_buf;
+    encoded_buf.Alloc(encoded_buf_size);
+    VerifyOrReturnError(encoded_buf.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Failed to alloc memory for encoded_buf"));
+    TLVWriter writer;
+    writer.Init(encoded_buf.Get(), encoded_buf_size);
+    esp_err_t err = encode_attr_val(writer, chip::TLV::AnonymousTag(), val);
+    VerifyOrReturnError(err == ESP_OK, err);
+    VerifyOrReturnError(writer.Finalize() == CHIP_NO_ERROR, ESP_FAIL, ESP_LOGE(TAG, "Failed to finalize TLV writer"));
+    return set(encoded_buf.Get(), writer.GetLengthWritten());
+}
+
+CHIP_ERROR tlv_encodable_type::EncodeTo(TLVWriter &writer, chip::TLV::Tag tag) const
+{
+    VerifyOrReturnError(!empty(), CHIP_ERROR_INCORRECT_STATE);
+    TLVReader reader;
+    reader.Init(m_tlv_buf.Get(), m_tlv_buf.AllocatedSize());
+    ReturnErrorOnFailure(reader.Next());
+    return writer.CopyElement(tag, reader);
+}
 
 namespace invoke {
 
@@ -234,23 +761,31 @@ esp_err_t send_request(void *ctx, peer_device_t *remote_device, const CommandPat
                         ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid Session Type"));
     VerifyOrReturnError(!command_path.mFlags.Has(chip::app::CommandPathFlags::kGroupIdValid),
                         ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid CommandPathFlags"));
-    auto decoder = chip::Platform::MakeUnique<custom_command_callback>(ctx, on_success, on_error);
+    custom_command_callback *decoder = command_callback_pool.create(ctx, on_success, on_error);
     VerifyOrReturnError(decoder != nullptr, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for command callback"));
 
-    auto on_done = [raw_decoder_ptr = decoder.get()](void *context, CommandSender *command_sender) {
-        chip::Platform::Delete(command_sender);
-        chip::Platform::Delete(raw_decoder_ptr);
+    auto on_done = [decoder](void *context, CommandSender *command_sender) {
+        command_sender_pool.release(command_sender);
+        command_callback_pool.release(decoder);
     };
     decoder->set_on_done_callback(on_done);
 
-    auto command_sender = chip::Platform::MakeUnique<CommandSender>(decoder.get(), remote_device->GetExchangeManager(),
-                                                                    timed_invoke_timeout_ms.HasValue());
-    VerifyOrReturnError(command_sender != nullptr, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for command sender"));
+    CommandSender *command_sender = command_sender_pool.create(decoder, remote_device->GetExchangeManager(),
+                                                               timed_invoke_timeout_ms.HasValue());
+    if (command_sender == nullptr) {
+        command_callback_pool.release(decoder);
+        ESP_LOGE(TAG, "No memory for command sender");
+        return ESP_ERR_NO_MEM;
+    }
     chip::app::CommandSender::AddRequestDataParameters add_request_data_params(timed_invoke_timeout_ms);
     command_sender->AddRequestData(command_path, encodable, add_request_data_params);
-    VerifyOrReturnError(command_sender->SendCommandRequest(remote_device->GetSecureSession().Value(), response_timeout) == CHIP_NO_ERROR, ESP_FAIL, ESP_LOGE(TAG, "Failed to send command request"));
-    (void)decoder.release();
-    (void)command_sender.release();
+    if (command_sender->SendCommandRequest(remote_device->GetSecureSession().Value(), response_timeout) !=
+        CHIP_NO_ERROR) {
+        command_sender_pool.release(command_sender);
+        command_callback_pool.release(decoder);
+        ESP_LOGE(TAG, "Failed to send command request");
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
@@ -261,14 +796,939 @@ esp_err_t send_group_request(const uint8_t fabric_index, const CommandPathParams
     chip::Transport::OutgoingGroupSession session(command_path.mGroupId, fabric_index);
     chip::Messaging::ExchangeManager *exchange_mgr =
         chip::app::InteractionModelEngine::GetInstance()->GetExchangeManager();
-    auto command_sender = chip::Platform::MakeUnique<chip::app::CommandSender>(nullptr, exchange_mgr);
+    CommandSender *command_sender = command_sender_pool.create(nullptr, exchange_mgr);
     VerifyOrReturnError(command_sender != nullptr, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for command sender"));
     chip::app::CommandSender::AddRequestDataParameters add_request_data_params;
     command_sender->AddRequestData(command_path, encodeable, add_request_data_params);
-    VerifyOrReturnError(command_sender->SendGroupCommandRequest(SessionHandle(session)) == CHIP_NO_ERROR, ESP_FAIL, ESP_LOGE(TAG, "Failed to send command request"));
+    CHIP_ERROR err = command_sender->SendGroupCommandRequest(SessionHandle(session));
+    // Group commands have no response, the CommandSender is done once the request is sent.
+    command_sender_pool.release(command_sender);
+    VerifyOrReturnError(err == CHIP_NO_ERROR, ESP_FAIL, ESP_LOGE(TAG, "Failed to send command request"));
+    return ESP_OK;
+}
+
+esp_err_t batch_command_callback::init(size_t command_count, size_t request_count)
+{
+    called_callback.Calloc(command_count);
+    VerifyOrReturnError(called_callback.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for batch command states"));
+    requests.Calloc(request_count);
+    VerifyOrReturnError(requests.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for batch command requests"));
+    this->request_count = 0;
+    pending_requests = 0;
+    return ESP_OK;
+}
+
+esp_err_t batch_command_callback::add_request(CommandSender *command_sender, size_t first_index, size_t count)
+{
+    VerifyOrReturnError(request_count < requests.AllocatedSize(), ESP_ERR_INVALID_STATE);
+    VerifyOrReturnError(first_index + count <= called_callback.AllocatedSize(), ESP_ERR_INVALID_ARG);
+    requests[request_count].command_sender = command_sender;
+    requests[request_count].first_index = first_index;
+    requests[request_count].count = count;
+    request_count++;
+    pending_requests++;
+    return ESP_OK;
+}
+
+void batch_command_callback::fail_commands(size_t first_index, size_t count, CHIP_ERROR error)
+{
+    for (size_t index = first_index; index < first_index + count && index < called_callback.AllocatedSize(); ++index) {
+        report_error(index, error);
+    }
+}
+
+batch_command_callback::request_t *batch_command_callback::find_request(const CommandSender *command_sender)
+{
+    for (size_t i = 0; i < request_count; ++i) {
+        if (requests[i].command_sender == command_sender) {
+            return &requests[i];
+        }
+    }
+    return nullptr;
+}
+
+void batch_command_callback::report_error(size_t command_index, CHIP_ERROR error)
+{
+    if (called_callback[command_index]) {
+        return;
+    }
+    called_callback[command_index] = true;
+    if (on_error_cb) {
+        on_error_cb(context, command_index, error);
+    }
+}
+
+void batch_command_callback::OnResponse(CommandSender *command_sender, const ResponseData &response_data)
+{
+    size_t command_index;
+    if (response_data.commandRef.HasValue()) {
+        command_index = response_data.commandRef.Value();
+    } else {
+        // Requests with a single command do not carry a CommandRef.
+        request_t *request = find_request(command_sender);
+        VerifyOrReturn(request && request->count == 1, ESP_LOGE(TAG, "Failed to match the command response"));
+        command_index = request->first_index;
+    }
+    VerifyOrReturn(command_index < called_callback.AllocatedSize(), ESP_LOGE(TAG, "Invalid CommandRef in response"));
+    if (called_callback[command_index]) {
+        return;
+    }
+    called_callback[command_index] = true;
+    if (on_success_cb) {
+        on_success_cb(context, command_index, response_data.path, response_data.statusIB, response_data.data);
+    }
+}
+
+void batch_command_callback::OnNoResponse(CommandSender *command_sender, const NoResponseData &no_response_data)
+{
+    VerifyOrReturn(no_response_data.commandRef < called_callback.AllocatedSize());
+    report_error(no_response_data.commandRef, CHIP_END_OF_TLV);
+}
+
+void batch_command_callback::OnError(const CommandSender *command_sender, const ErrorData &error_data)
+{
+    request_t *request = find_request(command_sender);
+    VerifyOrReturn(request);
+    fail_commands(request->first_index, request->count, error_data.error);
+}
+
+void batch_command_callback::OnDone(CommandSender *command_sender)
+{
+    request_t *request = find_request(command_sender);
+    if (request) {
+        fail_commands(request->first_index, request->count, CHIP_END_OF_TLV);
+        request->command_sender = nullptr;
+    }
+    command_sender_pool.release(command_sender);
+    if (pending_requests > 0 && --pending_requests == 0) {
+        if (on_done_cb) {
+            on_done_cb(context);
+        }
+        chip::Platform::Delete(this);
+    }
+}
+
+esp_err_t send_batch_request(void *ctx, peer_device_t *remote_device,
+                             const ScopedMemoryBufferWithSize<CommandPathParams> &command_paths,
+                             const ScopedMemoryBufferWithSize<const EncodableToTLV *> &command_data,
+                             batch_command_callback::on_success_callback_t on_success,
+                             batch_command_callback::on_error_callback_t on_error,
+                             batch_command_callback::on_done_callback_t on_done,
+                             const Optional<uint16_t> &timed_invoke_timeout_ms, const Optional<Timeout> &response_timeout)
+{
+    VerifyOrReturnError(remote_device->GetSecureSession().HasValue() && !remote_device->GetSecureSession().Value()->IsGroupSession(),
+                        ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid Session Type"));
+    size_t command_count = command_paths.AllocatedSize();
+    VerifyOrReturnError(command_count > 0 && command_count == command_data.AllocatedSize() &&
+                        command_count <= UINT16_MAX, ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid batch command count"));
+    for (size_t i = 0; i < command_count; ++i) {
+        VerifyOrReturnError(!command_paths[i].mFlags.Has(chip::app::CommandPathFlags::kGroupIdValid) && command_data[i],
+                            ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid command %u in batch", static_cast<unsigned>(i)));
+    }
+
+    SessionHandle session = remote_device->GetSecureSession().Value();
+    size_t max_paths_per_invoke = session->GetRemoteSessionParameters().GetMaxPathsPerInvoke();
+    if (max_paths_per_invoke == 0) {
+        max_paths_per_invoke = 1;
+    }
+    size_t request_count = (command_count + max_paths_per_invoke - 1) / max_paths_per_invoke;
+
+    auto decoder = chip::Platform::MakeUnique<batch_command_callback>(ctx, on_success, on_error, on_done);
+    VerifyOrReturnError(decoder != nullptr, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for batch command callback"));
+    ESP_RETURN_ON_ERROR(decoder->init(command_count, request_count), TAG, "Failed to init batch command callback");
+
+    esp_err_t err = ESP_OK;
+    for (size_t first_index = 0; first_index < command_count; first_index += max_paths_per_invoke) {
+        size_t count = std::min(max_paths_per_invoke, command_count - first_index);
+        CommandSender *command_sender = command_sender_pool.create(decoder.get(), remote_device->GetExchangeManager(),
+                                                                   timed_invoke_timeout_ms.HasValue());
+        if (command_sender == nullptr) {
+            ESP_LOGE(TAG, "No memory for command sender");
+            err = ESP_ERR_NO_MEM;
+            if (decoder->has_pending_requests()) {
+                decoder->fail_commands(first_index, command_count - first_index, CHIP_ERROR_NO_MEMORY);
+            }
+            break;
+        }
+        CHIP_ERROR chip_err = CHIP_NO_ERROR;
+        if (count > 1) {
+            CommandSender::ConfigParameters config;
+            config.SetRemoteMaxPathsPerInvoke(static_cast<uint16_t>(max_paths_per_invoke));
+            chip_err = command_sender->SetCommandSenderConfig(config);
+        }
+        for (size_t index = first_index; index < first_index + count && chip_err == CHIP_NO_ERROR; ++index) {
+            CommandSender::AddRequestDataParameters add_request_data_params(timed_invoke_timeout_ms);
+            add_request_data_params.SetCommandRef(static_cast<uint16_t>(index));
+            chip_err = command_sender->AddRequestData(command_paths[index], *command_data[index], add_request_data_params);
+        }
+        if (chip_err == CHIP_NO_ERROR) {
+            chip_err = command_sender->SendCommandRequest(session, response_timeout);
+        }
+        if (chip_err != CHIP_NO_ERROR) {
+            ESP_LOGE(TAG, "Failed to send batch command request: %" CHIP_ERROR_FORMAT, chip_err.Format());
+            command_sender_pool.release(command_sender);
+            err = ESP_FAIL;
+            if (decoder->has_pending_requests()) {
+                decoder->fail_commands(first_index, command_count - first_index, chip_err);
+            }
+            break;
+        }
+        decoder->add_request(command_sender, first_index, count);
+    }
+
+    if (!decoder->has_pending_requests()) {
+        // Nothing was sent, so none of the callbacks has been or will be called.
+        return err;
+    }
+    // Part of the batch is in flight, the errors of the remaining commands have been reported by on_error and
+    // on_done will be called once the sent requests are done.
+    (void)decoder.release();
     return ESP_OK;
 }
 
+static group_promotion_policy_t s_group_promotion_policy = nullptr;
+static void *s_group_promotion_priv_data = nullptr;
+
+void set_group_promotion_policy(group_promotion_policy_t policy, void *priv_data)
+{
+    s_group_promotion_policy = policy;
+    s_group_promotion_priv_data = priv_data;
+}
+
+/** Fan-out of a command to the peer nodes bound to a local endpoint
+ *
+ * The instance deletes itself once all the peer nodes are done.
+ */
+class bound_request_fanout {
+public:
+    bound_request_fanout(void *ctx, on_peer_done_callback_t on_peer_done, on_bound_done_callback_t on_done,
+                         const Optional<uint16_t> &timed_invoke_timeout_ms, const Optional<Timeout> &response_timeout)
+        : m_on_peer_done(on_peer_done)
+        , m_on_done(on_done)
+        , m_timed_invoke_timeout_ms(timed_invoke_timeout_ms)
+        , m_response_timeout(response_timeout)
+        , m_context(ctx)
+    {
+    }
+
+    ~bound_request_fanout()
+    {
+        for (size_t i = 0; i < m_peer_count; ++i) {
+            m_peers[i].~peer_t();
+        }
+    }
+
+    esp_err_t init(uint16_t local_endpoint_id, chip::ClusterId cluster_id, chip::CommandId command_id,
+                   const EncodableToTLV &command_data);
+
+    /** Send the command to the groups and start the peer nodes, this instance may be deleted when it returns */
+    void start();
+
+private:
+    struct group_t {
+        chip::FabricIndex fabric_index;
+        chip::GroupId group_id;
+    };
+
+    struct peer_t {
+        peer_t(bound_request_fanout *fanout, const ScopedNodeId &peer_id, size_t first_endpoint)
+            : fanout(fanout)
+            , first_endpoint(first_endpoint)
+            , on_connected(connected_callback, this)
+            , on_failure(failure_callback, this)
+        {
+            status.peer_id = peer_id;
+            status.endpoint_count = 0;
+            status.group_count = 0;
+            status.success_count = 0;
+            status.error = CHIP_NO_ERROR;
+        }
+
+        bound_request_fanout *fanout;
+        size_t first_endpoint;
+        bound_peer_status_t status;
+        Callback<chip::OnDeviceConnected> on_connected;
+        Callback<chip::OnDeviceConnectionFailure> on_failure;
+    };
+
+    static void connected_callback(void *context, ExchangeManager &exchange_mgr, const SessionHandle &session);
+    static void failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error);
+
+    void promote_to_group(chip::FabricIndex fabric_index, bound_target_t *targets, size_t target_count);
+    void send_groups();
+    void start_peers();
+    esp_err_t send_peer(peer_t *peer, ExchangeManager &exchange_mgr, const SessionHandle &session);
+    void finish_peer(peer_t *peer, CHIP_ERROR error);
+
+    on_peer_done_callback_t m_on_peer_done;
+    on_bound_done_callback_t m_on_done;
+    Optional<uint16_t> m_timed_invoke_timeout_ms;
+    Optional<Timeout> m_response_timeout;
+    void *m_context;
+    chip::ClusterId m_cluster_id = chip::kInvalidClusterId;
+    chip::CommandId m_command_id = 0;
+    tlv_encodable_type m_command_data;
+    uint16_t m_local_endpoint_id = chip::kInvalidEndpointId;
+    ScopedMemoryBufferWithSize<group_t> m_groups;
+    size_t m_group_count = 0;
+    ScopedMemoryBufferWithSize<chip::EndpointId> m_endpoints;
+    ScopedMemoryBufferWithSize<peer_t> m_peers;
+    size_t m_peer_count = 0;
+    size_t m_next_peer = 0;
+    size_t m_peers_in_flight = 0;
+    bool m_starting_peers = false;
+};
+
+esp_err_t bound_request_fanout::init(uint16_t local_endpoint_id, chip::ClusterId cluster_id,
+                                     chip::CommandId command_id, const EncodableToTLV &command_data)
+{
+    m_local_endpoint_id = local_endpoint_id;
+    m_cluster_id = cluster_id;
+    m_command_id = command_id;
+    ESP_RETURN_ON_ERROR(m_command_data.set(command_data), TAG, "Failed to encode the command data");
+
+    auto matches = [&](const EmberBindingTableEntry &entry) {
+        return entry.local == local_endpoint_id &&
+            (!entry.clusterId.HasValue() || entry.clusterId.Value() == cluster_id);
+    };
+    size_t target_count = 0;
+    size_t group_count = 0;
+    for (const EmberBindingTableEntry &entry : chip::BindingTable::GetInstance()) {
+        if (matches(entry) && entry.type == MATTER_UNICAST_BINDING) {
+            target_count++;
+        } else if (matches(entry) && entry.type == MATTER_MULTICAST_BINDING) {
+            group_count++;
+        }
+    }
+    VerifyOrReturnError(target_count + group_count > 0, ESP_ERR_NOT_FOUND,
+                        ESP_LOGE(TAG, "No binding for cluster 0x%" PRIx32 " on endpoint %u", cluster_id,
+                                 local_endpoint_id));
+
+    ScopedMemoryBufferWithSize<bound_target_t> targets;
+    if (target_count > 0) {
+        targets.Calloc(target_count);
+        m_endpoints.Calloc(target_count);
+        m_peers.Calloc(target_count);
+        VerifyOrReturnError(targets.Get() && m_endpoints.Get() && m_peers.Get(), ESP_ERR_NO_MEM,
+                            ESP_LOGE(TAG, "No memory for the bound peers"));
+    }
+    // Room for a promoted group per fabric
+    m_groups.Calloc(group_count + target_count);
+    VerifyOrReturnError(m_groups.Get(), ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for the bound groups"));
+    size_t target_index = 0;
+    for (const EmberBindingTableEntry &entry : chip::BindingTable::GetInstance()) {
+        if (matches(entry) && entry.type == MATTER_UNICAST_BINDING && target_index < target_count) {
+            targets[target_index++] = {ScopedNodeId(entry.nodeId, entry.fabricIndex), entry.remote, false};
+        } else if (matches(entry) && entry.type == MATTER_MULTICAST_BINDING && m_group_count < group_count) {
+            m_groups[m_group_count++] = {entry.fabricIndex, entry.groupId};
+        }
+    }
+
+    // Group the endpoints by peer node and remove the duplicated endpoints.
+    std::sort(targets.Get(), targets.Get() + target_index, [](const bound_target_t &a, const bound_target_t &b) {
+        if (a.peer_id.GetFabricIndex() != b.peer_id.GetFabricIndex()) {
+            return a.peer_id.GetFabricIndex() < b.peer_id.GetFabricIndex();
+        }
+        if (a.peer_id.GetNodeId() != b.peer_id.GetNodeId()) {
+            return a.peer_id.GetNodeId() < b.peer_id.GetNodeId();
+        }
+        return a.endpoint_id < b.endpoint_id;
+    });
+    target_count = 0;
+    for (size_t i = 0; i < target_index; ++i) {
+        if (target_count == 0 || targets[target_count - 1].peer_id != targets[i].peer_id ||
+            targets[target_count - 1].endpoint_id != targets[i].endpoint_id) {
+            targets[target_count++] = targets[i];
+        }
+    }
+
+    if (s_group_promotion_policy && !m_timed_invoke_timeout_ms.HasValue()) {
+        for (size_t first = 0, last = 0; first < target_count; first = last) {
+            chip::FabricIndex fabric_index = targets[first].peer_id.GetFabricIndex();
+            while (last < target_count && targets[last].peer_id.GetFabricIndex() == fabric_index) {
+                last++;
+            }
+            promote_to_group(fabric_index, &targets[first], last - first);
+        }
+    }
+
+    size_t endpoint_count = 0;
+    peer_t *peer = nullptr;
+    for (size_t i = 0; i < target_count; ++i) {
+        const bound_target_t &target = targets[i];
+        if (!peer || peer->status.peer_id != target.peer_id) {
+            peer = new (&m_peers[m_peer_count++]) peer_t(this, target.peer_id, endpoint_count);
+        }
+        peer->status.endpoint_count++;
+        if (target.group_member) {
+            peer->status.group_count++;
+        } else {
+            m_endpoints[endpoint_count++] = target.endpoint_id;
+        }
+    }
+    return ESP_OK;
+}
+
+void bound_request_fanout::promote_to_group(chip::FabricIndex fabric_index, bound_target_t *targets,
+                                            size_t target_count)
+{
+    if (target_count < CONFIG_ESP_MATTER_CLIENT_GROUP_PROMOTION_MIN_TARGETS) {
+        return;
+    }
+    chip::GroupId group_id = chip::kUndefinedGroupId;
+    bool promoted = s_group_promotion_policy(fabric_index, m_local_endpoint_id, m_cluster_id, m_command_id, targets,
+                                             target_count, &group_id, s_group_promotion_priv_data);
+    size_t member_count = 0;
+    for (size_t i = 0; i < target_count; ++i) {
+        member_count += targets[i].group_member ? 1 : 0;
+    }
+    chip::Credentials::GroupDataProvider::GroupInfo group_info;
+    chip::Credentials::GroupDataProvider *provider = chip::Credentials::GetGroupDataProvider();
+    if (!promoted || member_count < CONFIG_ESP_MATTER_CLIENT_GROUP_PROMOTION_MIN_TARGETS ||
+        group_id == chip::kUndefinedGroupId || !provider ||
+        provider->GetGroupInfo(fabric_index, group_id, group_info) != CHIP_NO_ERROR) {
+        // Send unicast commands to all the targets.
+        for (size_t i = 0; i < target_count; ++i) {
+            targets[i].group_member = false;
+        }
+        return;
+    }
+    ESP_LOGI(TAG, "Sending the command to group 0x%04x in place of %u unicast targets", group_id,
+             static_cast<unsigned>(member_count));
+    for (size_t i = 0; i < m_group_count; ++i) {
+        if (m_groups[i].fabric_index == fabric_index && m_groups[i].group_id == group_id) {
+            return;
+        }
+    }
+    m_groups[m_group_count++] = {fabric_index, group_id};
+}
+
+void bound_request_fanout::start()
+{
+    send_groups();
+    start_peers();
+}
+
+void bound_request_fanout::send_groups()
+{
+    for (size_t i = 0; i < m_group_count; ++i) {
+        CommandPathParams command_path(0, m_groups[i].group_id, m_cluster_id, m_command_id,
+                                       chip::app::CommandPathFlags::kGroupIdValid);
+        if (send_group_request(m_groups[i].fabric_index, command_path, m_command_data) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to send the command to group 0x%04x", m_groups[i].group_id);
+        }
+    }
+}
+
+void bound_request_fanout::start_peers()
+{
+    m_starting_peers = true;
+    chip::CASESessionManager *case_session_mgr = chip::Server::GetInstance().GetCASESessionManager();
+    while (m_next_peer < m_peer_count && m_peers_in_flight < CONFIG_ESP_MATTER_CLIENT_BINDING_FANOUT_MAX_IN_FLIGHT) {
+        peer_t *peer = &m_peers[m_next_peer++];
+        m_peers_in_flight++;
+        if (peer->status.group_count == peer->status.endpoint_count) {
+            // All the endpoints of the peer node got the group command.
+            finish_peer(peer, CHIP_NO_ERROR);
+            continue;
+        }
+        session_cache_lookup(peer->status.peer_id);
+        // The callbacks may be called before FindOrEstablishSession() returns if the session exists.
+        case_session_mgr->FindOrEstablishSession(peer->status.peer_id, &peer->on_connected, &peer->on_failure);
+    }
+    m_starting_peers = false;
+    if (m_peers_in_flight == 0 && m_next_peer == m_peer_count) {
+        if (m_on_done) {
+            m_on_done(m_context);
+        }
+        chip::Platform::Delete(this);
+    }
+}
+
+esp_err_t bound_request_fanout::send_peer(peer_t *peer, ExchangeManager &exchange_mgr, const SessionHandle &session)
+{
+    size_t count = peer->status.endpoint_count - peer->status.group_count;
+    ScopedMemoryBufferWithSize<CommandPathParams> command_paths;
+    ScopedMemoryBufferWithSize<const EncodableToTLV *> command_data;
+    command_paths.Calloc(count);
+    command_data.Calloc(count);
+    VerifyOrReturnError(command_paths.Get() && command_data.Get(), ESP_ERR_NO_MEM,
+                        ESP_LOGE(TAG, "No memory for the bound commands"));
+    for (size_t i = 0; i < count; ++i) {
+        command_paths[i] = CommandPathParams(m_endpoints[peer->first_endpoint + i], 0, m_cluster_id, m_command_id,
+                                             chip::app::CommandPathFlags::kEndpointIdValid);
+        command_data[i] = &m_command_data;
+    }
+
+    auto on_success = [](void *context, size_t command_index, const ConcreteCommandPath &command_path,
+                         const StatusIB &status, TLVReader *response_data) {
+        peer_t *peer = static_cast<peer_t *>(context);
+        if (status.IsSuccess()) {
+            peer->status.success_count++;
+        } else if (peer->status.error == CHIP_NO_ERROR) {
+            peer->status.error = status.ToChipError();
+        }
+    };
+    auto on_error = [](void *context, size_t command_index, CHIP_ERROR error) {
+        peer_t *peer = static_cast<peer_t *>(context);
+        if (peer->status.error == CHIP_NO_ERROR) {
+            peer->status.error = error;
+        }
+    };
+    auto on_done = [](void *context) {
+        peer_t *peer = static_cast<peer_t *>(context);
+        peer->fanout->finish_peer(peer, CHIP_NO_ERROR);
+    };
+    OperationalDeviceProxy device(&exchange_mgr, session);
+    return send_batch_request(peer, &device, command_paths, command_data, on_success, on_error, on_done,
+                              m_timed_invoke_timeout_ms, m_response_timeout);
+}
+
+void bound_request_fanout::finish_peer(peer_t *peer, CHIP_ERROR error)
+{
+    if (peer->status.error == CHIP_NO_ERROR) {
+        peer->status.error = error;
+    }
+    if (peer->status.error != CHIP_NO_ERROR) {
+        size_t unicast_count = peer->status.endpoint_count - peer->status.group_count;
+        ESP_LOGW(TAG, "Bound command to node 0x%" PRIx64 " failed on %u of %u endpoints: %" CHIP_ERROR_FORMAT,
+                 peer->status.peer_id.GetNodeId(), static_cast<unsigned>(unicast_count - peer->status.success_count),
+                 static_cast<unsigned>(unicast_count), peer->status.error.Format());
+    }
+    if (m_on_peer_done) {
+        m_on_peer_done(m_context, peer->status);
+    }
+    m_peers_in_flight--;
+    if (!m_starting_peers) {
+        start_peers();
+    }
+}
+
+void bound_request_fanout::connected_callback(void *context, ExchangeManager &exchange_mgr,
+                                              const SessionHandle &session)
+{
+    peer_t *peer = static_cast<peer_t *>(context);
+    if (peer->fanout->send_peer(peer, exchange_mgr, session) != ESP_OK) {
+        peer->fanout->finish_peer(peer, CHIP_ERROR_INTERNAL);
+    }
+}
+
+void bound_request_fanout::failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error)
+{
+    peer_t *peer = static_cast<peer_t *>(context);
+    peer->fanout->finish_peer(peer, error);
+}
+
+esp_err_t send_bound_request(void *ctx, uint16_t local_endpoint_id, chip::ClusterId cluster_id,
+                             chip::CommandId command_id, const EncodableToTLV &command_data,
+                             on_peer_done_callback_t on_peer_done, on_bound_done_callback_t on_done,
+                             const Optional<uint16_t> &timed_invoke_timeout_ms, const Optional<Timeout> &response_timeout)
+{
+    auto fanout = chip::Platform::MakeUnique<bound_request_fanout>(ctx, on_peer_done, on_done, timed_invoke_timeout_ms,
+                                                                   response_timeout);
+    VerifyOrReturnError(fanout != nullptr, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "No memory for the bound request"));
+    esp_err_t err = fanout->init(local_endpoint_id, cluster_id, command_id, command_data);
+    VerifyOrReturnError(err == ESP_OK, err);
+    // The instance deletes itself once all the peer nodes are done.
+    fanout.release()->start();
+    return ESP_OK;
+}
+
+/** Relative command whose pending request is merged into the newer request of the same key
+ *
+ * The field 0 is the step mode and the field 1 the step size, or without step mode the fields 0 and 1 are signed
+ * steps (ColorControl StepColor). The other fields, such as the transition time, are taken from the newer request.
+ */
+typedef struct {
+    chip::ClusterId cluster_id;
+    chip::CommandId command_id;
+    bool has_step_mode;
+    uint8_t up_mode;
+    uint8_t down_mode;
+    int32_t max_step;
+} relative_command_t;
+
+// LevelControl StepModeEnum is kUp(0)/kDown(1), the ColorControl step modes are increase/up(1) and decrease/down(3).
+static const relative_command_t k_relative_commands[] = {
+    {LevelControl::Id, LevelControl::Commands::Step::Id, true, 0, 1, UINT8_MAX},
+    {LevelControl::Id, LevelControl::Commands::StepWithOnOff::Id, true, 0, 1, UINT8_MAX},
+    {ColorControl::Id, ColorControl::Commands::StepHue::Id, true, 1, 3, UINT8_MAX},
+    {ColorControl::Id, ColorControl::Commands::StepSaturation::Id, true, 1, 3, UINT8_MAX},
+    {ColorControl::Id, ColorControl::Commands::EnhancedStepHue::Id, true, 1, 3, UINT16_MAX},
+    {ColorControl::Id, ColorControl::Commands::StepColorTemperature::Id, true, 1, 3, UINT16_MAX},
+    {ColorControl::Id, ColorControl::Commands::StepColor::Id, false, 0, 0, INT16_MAX},
+};
+
+static const relative_command_t *find_relative_command(chip::ClusterId cluster_id, chip::CommandId command_id)
+{
+    for (const relative_command_t &command : k_relative_commands) {
+        if (command.cluster_id == cluster_id && command.command_id == command_id) {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+/** Read the signed steps of the relative command data, false if the data is not the expected structure */
+static bool read_relative_steps(const relative_command_t &command, const uint8_t *buf, size_t len, int32_t steps[2])
+{
+    TLVReader reader;
+    chip::TLV::TLVType outer_type;
+    reader.Init(buf, len);
+    if (reader.Next(chip::TLV::kTLVType_Structure, chip::TLV::AnonymousTag()) != CHIP_NO_ERROR ||
+        reader.EnterContainer(outer_type) != CHIP_NO_ERROR) {
+        return false;
+    }
+    bool found[2] = {false, false};
+    uint8_t step_mode = 0;
+    uint32_t step_size = 0;
+    while (reader.Next() == CHIP_NO_ERROR) {
+        chip::TLV::Tag tag = reader.GetTag();
+        if (!chip::TLV::IsContextTag(tag) || chip::TLV::TagNumFromTag(tag) > 1) {
+            continue;
+        }
+        uint32_t field = chip::TLV::TagNumFromTag(tag);
+        CHIP_ERROR err = CHIP_NO_ERROR;
+        if (!command.has_step_mode) {
+            err = reader.Get(steps[field]);
+        } else if (field == 0) {
+            err = reader.Get(step_mode);
+        } else {
+            err = reader.Get(step_size);
+        }
+        if (err != CHIP_NO_ERROR) {
+            return false;
+        }
+        found[field] = true;
+    }
+    if (!found[0] || !found[1]) {
+        return false;
+    }
+    if (command.has_step_mode) {
+        if ((step_mode != command.up_mode && step_mode != command.down_mode) ||
+            step_size > static_cast<uint32_t>(command.max_step)) {
+            return false;
+        }
+        steps[0] = step_mode == command.up_mode ? static_cast<int32_t>(step_size) : -static_cast<int32_t>(step_size);
+    }
+    return true;
+}
+
+/** Encode the relative command data with the steps, the other fields are copied from buf */
+static bool write_relative_steps(const relative_command_t &command, const uint8_t *buf, size_t len,
+                                 const int32_t steps[2], uint8_t *out_buf, size_t out_size, size_t &out_len)
+{
+    TLVReader reader;
+    TLVWriter writer;
+    chip::TLV::TLVType reader_outer_type;
+    chip::TLV::TLVType writer_outer_type;
+    reader.Init(buf, len);
+    writer.Init(out_buf, out_size);
+    if (reader.Next(chip::TLV::kTLVType_Structure, chip::TLV::AnonymousTag()) != CHIP_NO_ERROR ||
+        reader.EnterContainer(reader_outer_type) != CHIP_NO_ERROR ||
+        writer.StartContainer(chip::TLV::AnonymousTag(), chip::TLV::kTLVType_Structure, writer_outer_type) !=
+            CHIP_NO_ERROR) {
+        return false;
+    }
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    while ((err = reader.Next()) == CHIP_NO_ERROR) {
+        chip::TLV::Tag tag = reader.GetTag();
+        if (!chip::TLV::IsContextTag(tag) || chip::TLV::TagNumFromTag(tag) > 1) {
+            err = writer.CopyElement(reader);
+        } else if (!command.has_step_mode) {
+            err = writer.Put(tag, steps[chip::TLV::TagNumFromTag(tag)]);
+        } else if (chip::TLV::TagNumFromTag(tag) == 0) {
+            err = writer.Put(tag, steps[0] > 0 ? command.up_mode : command.down_mode);
+        } else {
+            err = writer.Put(tag, static_cast<uint32_t>(steps[0] > 0 ? steps[0] : -steps[0]));
+        }
+        if (err != CHIP_NO_ERROR) {
+            return false;
+        }
+    }
+    if (err != CHIP_END_OF_TLV || reader.ExitContainer(reader_outer_type) != CHIP_NO_ERROR ||
+        writer.EndContainer(writer_outer_type) != CHIP_NO_ERROR || writer.Finalize() != CHIP_NO_ERROR) {
+        return false;
+    }
+    out_len = writer.GetLengthWritten();
+    return true;
+}
+
+/** Pre-encoded TLV data of a buffer owned by the caller */
+class tlv_buffer_encodable : public EncodableToTLV {
+public:
+    tlv_buffer_encodable(const uint8_t *buf, size_t len)
+        : m_buf(buf)
+        , m_len(len)
+    {
+    }
+
+    CHIP_ERROR EncodeTo(TLVWriter &writer, chip::TLV::Tag tag) const override
+    {
+        TLVReader reader;
+        reader.Init(m_buf, m_len);
+        ReturnErrorOnFailure(reader.Next());
+        return writer.CopyElement(tag, reader);
+    }
+
+private:
+    const uint8_t *m_buf;
+    size_t m_len;
+};
+
+/** Requests coalesced by key, only the latest command data of a key is sent
+ *
+ * The pending request of a relative command (see k_relative_commands) is merged into the newer one instead. The
+ * command data is kept in the inline buffer of the slot, so that a submit does not allocate memory.
+ */
+class coalesced_request_slot {
+public:
+    coalesced_request_slot()
+        : m_on_connected(connected_callback, this)
+        , m_on_failure(failure_callback, this)
+    {
+    }
+
+    bool matches(bool bound, const ScopedNodeId &peer_id, chip::EndpointId endpoint_id, chip::ClusterId cluster_id,
+                 chip::CommandId command_id) const
+    {
+        return m_in_use && m_bound == bound && m_peer_id == peer_id && m_endpoint_id == endpoint_id &&
+            m_cluster_id == cluster_id && m_command_id == command_id;
+    }
+
+    /** The slot could be used for another key */
+    bool is_idle() const
+    {
+        return !m_in_use ||
+            (!m_pending && !m_connecting && !in_interval(chip::System::SystemClock().GetMonotonicTimestamp()));
+    }
+
+    void assign(bool bound, const ScopedNodeId &peer_id, chip::EndpointId endpoint_id, chip::ClusterId cluster_id,
+                chip::CommandId command_id)
+    {
+        chip::DeviceLayer::SystemLayer().CancelTimer(timer_callback, this);
+        m_in_use = true;
+        m_bound = bound;
+        m_peer_id = peer_id;
+        m_endpoint_id = endpoint_id;
+        m_cluster_id = cluster_id;
+        m_command_id = command_id;
+        m_pending = false;
+        m_has_sent = false;
+    }
+
+    esp_err_t submit(const EncodableToTLV &command_data, uint32_t min_interval_ms);
+
+private:
+    static void connected_callback(void *context, ExchangeManager &exchange_mgr, const SessionHandle &session);
+    static void failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error);
+    static void timer_callback(chip::System::Layer *layer, void *context);
+
+    bool in_interval(chip::System::Clock::Timestamp now) const
+    {
+        return m_has_sent && now < m_last_sent + chip::System::Clock::Milliseconds32(m_min_interval_ms);
+    }
+
+    esp_err_t merge(const relative_command_t &command, const uint8_t *buf, size_t len);
+    void flush();
+    void sent();
+
+    bool m_in_use = false;
+    bool m_bound = false;
+    ScopedNodeId m_peer_id;
+    chip::EndpointId m_endpoint_id = chip::kInvalidEndpointId;
+    chip::ClusterId m_cluster_id = chip::kInvalidClusterId;
+    chip::CommandId m_command_id = 0;
+    uint8_t m_command_buf[CONFIG_ESP_MATTER_CLIENT_COALESCED_REQUEST_DATA_SIZE];
+    size_t m_command_len = 0;
+    uint32_t m_min_interval_ms = 0;
+    bool m_pending = false;
+    bool m_connecting = false;
+    bool m_has_sent = false;
+    chip::System::Clock::Timestamp m_last_sent;
+    Callback<chip::OnDeviceConnected> m_on_connected;
+    Callback<chip::OnDeviceConnectionFailure> m_on_failure;
+};
+
+static coalesced_request_slot s_coalesced_request_slots[CONFIG_ESP_MATTER_CLIENT_COALESCED_REQUEST_SLOTS];
+static coalesce_stats_t s_coalesce_stats;
+
+esp_err_t coalesced_request_slot::submit(const EncodableToTLV &command_data, uint32_t min_interval_ms)
+{
+    uint8_t buf[CONFIG_ESP_MATTER_CLIENT_COALESCED_REQUEST_DATA_SIZE];
+    TLVWriter writer;
+    writer.Init(buf, sizeof(buf));
+    if (command_data.EncodeTo(writer, chip::TLV::AnonymousTag()) != CHIP_NO_ERROR ||
+        writer.Finalize() != CHIP_NO_ERROR) {
+        ESP_LOGE(TAG, "Failed to encode the command data in %u bytes", static_cast<unsigned>(sizeof(buf)));
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t len = writer.GetLengthWritten();
+    m_min_interval_ms = min_interval_ms;
+    if (m_pending) {
+        const relative_command_t *relative = find_relative_command(m_cluster_id, m_command_id);
+        if (relative && merge(*relative, buf, len) == ESP_OK) {
+            flush();
+            return ESP_OK;
+        }
+        s_coalesce_stats.superseded++;
+    }
+    memcpy(m_command_buf, buf, len);
+    m_command_len = len;
+    m_pending = true;
+    flush();
+    return ESP_OK;
+}
+
+esp_err_t coalesced_request_slot::merge(const relative_command_t &command, const uint8_t *buf, size_t len)
+{
+    int32_t pending_steps[2] = {0, 0};
+    int32_t steps[2] = {0, 0};
+    if (!read_relative_steps(command, m_command_buf, m_command_len, pending_steps) ||
+        !read_relative_steps(command, buf, len, steps)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        steps[i] = std::min(std::max(pending_steps[i] + steps[i], -command.max_step), command.max_step);
+    }
+    if (steps[0] == 0 && steps[1] == 0) {
+        // The steps cancel each other, neither of the requests is sent.
+        m_pending = false;
+        s_coalesce_stats.merged += 2;
+        return ESP_OK;
+    }
+    size_t merged_len = 0;
+    if (!write_relative_steps(command, buf, len, steps, m_command_buf, sizeof(m_command_buf), merged_len)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    m_command_len = merged_len;
+    s_coalesce_stats.merged++;
+    return ESP_OK;
+}
+
+void coalesced_request_slot::flush()
+{
+    if (!m_pending || m_connecting) {
+        return;
+    }
+    chip::System::Clock::Timestamp now = chip::System::SystemClock().GetMonotonicTimestamp();
+    if (in_interval(now)) {
+        auto delay = m_last_sent + chip::System::Clock::Milliseconds32(m_min_interval_ms) - now;
+        chip::DeviceLayer::SystemLayer().StartTimer(std::chrono::duration_cast<Timeout>(delay), timer_callback, this);
+        return;
+    }
+    if (m_bound) {
+        sent();
+        tlv_buffer_encodable command_data(m_command_buf, m_command_len);
+        if (send_bound_request(nullptr, m_endpoint_id, m_cluster_id, m_command_id, command_data, {}, {},
+                               chip::NullOptional) != ESP_OK) {
+            s_coalesce_stats.failed++;
+        }
+        return;
+    }
+    m_connecting = true;
+    // The callbacks may be called before FindOrEstablishSession() returns if the session exists.
+    chip::Server::GetInstance().GetCASESessionManager()->FindOrEstablishSession(m_peer_id, &m_on_connected,
+                                                                                &m_on_failure);
+}
+
+void coalesced_request_slot::sent()
+{
+    m_pending = false;
+    m_has_sent = true;
+    m_last_sent = chip::System::SystemClock().GetMonotonicTimestamp();
+    s_coalesce_stats.sent++;
+}
+
+void coalesced_request_slot::connected_callback(void *context, ExchangeManager &exchange_mgr,
+                                                const SessionHandle &session)
+{
+    coalesced_request_slot *slot = static_cast<coalesced_request_slot *>(context);
+    slot->m_connecting = false;
+    VerifyOrReturn(slot->m_pending);
+    // The command data is the latest one submitted while the session was established.
+    slot->sent();
+    OperationalDeviceProxy device(&exchange_mgr, session);
+    CommandPathParams command_path(slot->m_endpoint_id, 0, slot->m_cluster_id, slot->m_command_id,
+                                   chip::app::CommandPathFlags::kEndpointIdValid);
+    tlv_buffer_encodable command_data(slot->m_command_buf, slot->m_command_len);
+    if (send_request(nullptr, &device, command_path, command_data, {}, {}, chip::NullOptional) != ESP_OK) {
+        s_coalesce_stats.failed++;
+    }
+}
+
+void coalesced_request_slot::failure_callback(void *context, const ScopedNodeId &peer_id, CHIP_ERROR error)
+{
+    coalesced_request_slot *slot = static_cast<coalesced_request_slot *>(context);
+    slot->m_connecting = false;
+    slot->m_pending = false;
+    s_coalesce_stats.failed++;
+    ESP_LOGE(TAG, "Failed to establish the session to node 0x%" PRIx64 ": %" CHIP_ERROR_FORMAT, peer_id.GetNodeId(),
+             error.Format());
+}
+
+void coalesced_request_slot::timer_callback(chip::System::Layer *layer, void *context)
+{
+    static_cast<coalesced_request_slot *>(context)->flush();
+}
+
+static esp_err_t submit_coalesced_request(bool bound, const ScopedNodeId &peer_id, chip::EndpointId endpoint_id,
+                                          chip::ClusterId cluster_id, chip::CommandId command_id,
+                                          const EncodableToTLV &command_data, uint32_t min_interval_ms)
+{
+    s_coalesce_stats.submitted++;
+    coalesced_request_slot *slot = nullptr;
+    for (coalesced_request_slot &candidate : s_coalesced_request_slots) {
+        if (candidate.matches(bound, peer_id, endpoint_id, cluster_id, command_id)) {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (!slot) {
+        for (coalesced_request_slot &candidate : s_coalesced_request_slots) {
+            if (candidate.is_idle()) {
+                slot = &candidate;
+                slot->assign(bound, peer_id, endpoint_id, cluster_id, command_id);
+                break;
+            }
+        }
+    }
+    if (!slot) {
+        s_coalesce_stats.no_slot++;
+        ESP_LOGE(TAG, "No slot for the coalesced request to cluster 0x%" PRIx32 " command 0x%" PRIx32, cluster_id,
+                 command_id);
+        return ESP_ERR_NO_MEM;
+    }
+    return slot->submit(command_data, min_interval_ms);
+}
+
+esp_err_t send_coalesced_request(const ScopedNodeId &peer_id, chip::EndpointId endpoint_id, chip::ClusterId cluster_id,
+                                 chip::CommandId command_id, const EncodableToTLV &command_data,
+                                 uint32_t min_interval_ms)
+{
+    VerifyOrReturnError(peer_id.IsOperational(), ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid peer node"));
+    return submit_coalesced_request(false, peer_id, endpoint_id, cluster_id, command_id, command_data,
+                                    min_interval_ms);
+}
+
+esp_err_t send_coalesced_bound_request(uint16_t local_endpoint_id, chip::ClusterId cluster_id,
+                                       chip::CommandId command_id, const EncodableToTLV &command_data,
+                                       uint32_t min_interval_ms)
+{
+    return submit_coalesced_request(true, ScopedNodeId(), local_endpoint_id, cluster_id, command_id, command_data,
+                                    min_interval_ms);
+}
+
+void get_coalesce_stats(coalesce_stats_t &stats)
+{
+    stats = s_coalesce_stats;
+}
+
+void reset_coalesce_stats()
+{
+    s_coalesce_stats = {};
+}
+
 } // namespace invoke
 
 using chip::SubscriptionId;
@@ -582,6 +2042,43 @@ esp_err_t send_request(client::peer_device_t *remote_device,
     return ESP_OK;
 }
 
+esp_err_t send_request(client::peer_device_t *remote_device,
+                       ScopedMemoryBufferWithSize<AttributePathParams> &attr_paths, const tlv_encodable_type &attr_vals,
+                       WriteClient::Callback &callback, const chip::Optional<uint16_t> &timeout_ms)
+{
+    VerifyOrReturnError(!attr_vals.empty(), ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Empty attribute values"));
+    VerifyOrReturnError(remote_device->GetSecureSession().HasValue() &&
+                            !remote_device->GetSecureSession().Value()->IsGroupSession(),
+                        ESP_ERR_INVALID_ARG, ESP_LOGE(TAG, "Invalid Session Type"));
+    auto client_deleter_callback = chip::Platform::MakeUnique<client_deleter_write_callback>(callback);
+    VerifyOrReturnError(client_deleter_callback, ESP_ERR_NO_MEM,
+                        ESP_LOGE(TAG, "Failed to allocate memory for client deleter callback"));
+    auto write_client = chip::Platform::MakeUnique<WriteClient>(remote_device->GetExchangeManager(),
+                                                                client_deleter_callback.get(), timeout_ms, false);
+    VerifyOrReturnError(write_client, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Failed to allocate memory for WriteClient"));
+
+    // The attribute values are already encoded, so they are put to the WriteClient without any intermediate buffer.
+    TLVReader reader;
+    reader.Init(attr_vals.data(), attr_vals.size());
+    for (size_t i = 0; i < attr_paths.AllocatedSize(); ++i) {
+        VerifyOrReturnError(!attr_paths[i].HasWildcardEndpointId(), ESP_ERR_INVALID_ARG,
+                            ESP_LOGE(TAG, "Endpoint Id Invalid"));
+        ConcreteDataAttributePath path(attr_paths[i].mEndpointId, attr_paths[i].mClusterId, attr_paths[i].mAttributeId);
+        VerifyOrReturnError(reader.Next() == CHIP_NO_ERROR, ESP_ERR_INVALID_ARG,
+                            ESP_LOGE(TAG, "The attribute values count should be the same as the attr_paths count"));
+        VerifyOrReturnError(write_client->PutPreencodedAttribute(path, reader) == CHIP_NO_ERROR, ESP_FAIL,
+                            ESP_LOGE(TAG, "Failed to put pre-encoded attribute value to WriteClient"));
+    }
+
+    VerifyOrReturnError(write_client->SendWriteRequest(remote_device->GetSecureSession().Value()) == CHIP_NO_ERROR,
+                        ESP_FAIL, ESP_LOGE(TAG, "Failed to Send Write Request"));
+
+    // Release the write_client and client deleter callback as it will be managed by the client deleter callback
+    write_client.release();
+    client_deleter_callback.release();
+    return ESP_OK;
+}
+
 } // namespace write
 } // namespace interaction
 } // namespace client
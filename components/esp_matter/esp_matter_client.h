@@ -84,32 +84,68 @@ class multiple_write_encodable_type
 public:
     multiple_write_encodable_type(const char *json_str)
     {
-        json = cJSON_Parse(json_str);
+        if (json_str) {
+            m_json_str = strdup(json_str);
+        }
     }
 
-    ~multiple_write_encodable_type() { cJSON_Delete(json); }
+    ~multiple_write_encodable_type() { free(m_json_str); }
 
     CHIP_ERROR EncodeTo(chip::TLV::TLVWriter &writer, chip::TLV::Tag tag, size_t index)
     {
-        cJSON *json_at_index = NULL;
-        if (!json) {
+        if (!m_json_str) {
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
-        if (json->type != cJSON_Array) {
-            json_at_index = json;
-        } else {
-            json_at_index = cJSON_GetArrayItem(json, index);
-        }
-        if (json_to_tlv(json_at_index, writer, tag) != ESP_OK) {
+        if (json_array_item_to_tlv(m_json_str, index, writer, tag, &m_cursor) != ESP_OK) {
             return CHIP_ERROR_INTERNAL;
         }
         return CHIP_NO_ERROR;
     }
 
-    size_t GetJsonArraySize() { return static_cast<size_t>(cJSON_GetArraySize(json)); }
+    size_t GetJsonArraySize()
+    {
+        size_t size = 0;
+        if (!m_json_str || json_array_get_size(m_json_str, size) != ESP_OK) {
+            return 0;
+        }
+        return size;
+    }
+
+private:
+    char *m_json_str = NULL;
+    json_array_cursor_t m_cursor = {};
+};
+
+/** Pre-encoded TLV data
+ *
+ * It holds a copy of the TLV encoding of typed data so that it could be sent later without converting any JSON
+ * string. It encodes the first TLV element of the buffer with the given tag. The buffer could also hold several
+ * consecutive anonymous TLV elements, e.g. the values of a write request to multiple attribute paths.
+ */
+class tlv_encodable_type : public EncodableToTLV
+{
+public:
+    tlv_encodable_type() {}
+
+    /** Copy the pre-encoded TLV buffer **/
+    esp_err_t set(const uint8_t *tlv_buf, size_t tlv_len);
+
+    /** Encode the EncodableToTLV object with an anonymous tag **/
+    esp_err_t set(const EncodableToTLV &encodable);
+
+    /** Encode the attribute value with an anonymous tag. ESP_MATTER_VAL_TYPE_ARRAY is not supported. **/
+    esp_err_t set(const esp_matter_attr_val_t &val);
+
+    bool empty() const { return m_tlv_buf.AllocatedSize() == 0; }
+
+    const uint8_t *data() const { return m_tlv_buf.Get(); }
+
+    size_t size() const { return m_tlv_buf.AllocatedSize(); }
+
+    CHIP_ERROR EncodeTo(chip::TLV::TLVWriter &writer, chip::TLV::Tag tag) const override;
 
 private:
-    cJSON *json = NULL;
+    ScopedMemoryBufferWithSize<uint8_t> m_tlv_buf;
 };
 
 /** Command invoke APIs
@@ -176,6 +212,59 @@ private:
     void *context;
 };
 
+/** Callback of a batched invoke
+ *
+ * One instance is shared by all the CommandSenders of a batch. Responses are demultiplexed to the index of the
+ * command in the batch, either by the CommandRef of the response or, for single-command requests, by the sender.
+ * The instance deletes itself and the CommandSenders once all of them are done.
+ */
+class batch_command_callback final : public chip::app::CommandSender::ExtendableCallback {
+public:
+    using on_success_callback_t =
+        std::function<void(void *, size_t command_index, const ConcreteCommandPath &, const StatusIB &, TLVReader *)>;
+    using on_error_callback_t = std::function<void(void *, size_t command_index, CHIP_ERROR error)>;
+    using on_done_callback_t = std::function<void(void *)>;
+
+    batch_command_callback(void *ctx, on_success_callback_t on_success, on_error_callback_t on_error,
+                           on_done_callback_t on_done)
+        : on_success_cb(on_success)
+        , on_error_cb(on_error)
+        , on_done_cb(on_done)
+        , context(ctx)
+    {
+    }
+
+    esp_err_t init(size_t command_count, size_t request_count);
+    esp_err_t add_request(CommandSender *command_sender, size_t first_index, size_t count);
+    /** Report an error for the commands which could not be sent */
+    void fail_commands(size_t first_index, size_t count, CHIP_ERROR error);
+    bool has_pending_requests() const { return pending_requests > 0; }
+
+private:
+    struct request_t {
+        CommandSender *command_sender;
+        size_t first_index;
+        size_t count;
+    };
+
+    void OnResponse(CommandSender *command_sender, const ResponseData &response_data) override;
+    void OnNoResponse(CommandSender *command_sender, const NoResponseData &no_response_data) override;
+    void OnError(const CommandSender *command_sender, const ErrorData &error_data) override;
+    void OnDone(CommandSender *command_sender) override;
+
+    request_t *find_request(const CommandSender *command_sender);
+    void report_error(size_t command_index, CHIP_ERROR error);
+
+    on_success_callback_t on_success_cb;
+    on_error_callback_t on_error_cb;
+    on_done_callback_t on_done_cb;
+    ScopedMemoryBufferWithSize<bool> called_callback;
+    ScopedMemoryBufferWithSize<request_t> requests;
+    size_t request_count = 0;
+    size_t pending_requests = 0;
+    void *context;
+};
+
 esp_err_t send_request(void *ctx, peer_device_t *remote_device, const CommandPathParams &command_path,
                        const char *command_data_json_str, custom_command_callback::on_success_callback_t on_success,
                        custom_command_callback::on_error_callback_t on_error,
@@ -196,6 +285,184 @@ esp_err_t send_request(void *ctx, peer_device_t *remote_device, const CommandPat
 esp_err_t send_group_request(const uint8_t fabric_index, const CommandPathParams &command_path,
                              const chip::app::DataModel::EncodableToTLV &encodable);
 
+/** Send a batch of commands to a remote device
+ *
+ * The commands are packed into the minimum number of InvokeRequests allowed by the MaxPathsPerInvoke of the peer
+ * session. The command data is encoded before this function returns, so it does not need to outlive the call.
+ *
+ * @param[in] ctx Context passed to the callbacks.
+ * @param[in] remote_device Remote device with a CASE session.
+ * @param[in] command_paths Paths of the commands. The index of a path is the command index in the callbacks.
+ * @param[in] command_data Command data, one entry per command path.
+ * @param[in] on_success Called once for every command with a response.
+ * @param[in] on_error Called once for every command without a response.
+ * @param[in] on_done Called once after all the InvokeRequests of the batch are done.
+ * @param[in] timed_invoke_timeout_ms Timeout of the timed invoke, NullOptional for untimed invoke.
+ * @param[in] response_timeout Response timeout of each InvokeRequest.
+ *
+ * @return ESP_OK on success, in which case on_done will be called.
+ * @return error in case of failure, in which case no callback will be called.
+ */
+esp_err_t send_batch_request(void *ctx, peer_device_t *remote_device,
+                             const ScopedMemoryBufferWithSize<CommandPathParams> &command_paths,
+                             const ScopedMemoryBufferWithSize<const chip::app::DataModel::EncodableToTLV *> &command_data,
+                             batch_command_callback::on_success_callback_t on_success,
+                             batch_command_callback::on_error_callback_t on_error,
+                             batch_command_callback::on_done_callback_t on_done,
+                             const Optional<uint16_t> &timed_invoke_timeout_ms,
+                             const Optional<Timeout> &response_timeout = chip::NullOptional);
+
+/** Status of a bound command on a peer node */
+typedef struct {
+    chip::ScopedNodeId peer_id;
+    /** Number of endpoints of the peer node bound to the local endpoint */
+    size_t endpoint_count;
+    /** Number of endpoints which were sent a group command in place of a unicast command, they do not respond */
+    size_t group_count;
+    /** Number of endpoints which responded to the unicast command with a success status */
+    size_t success_count;
+    /** CHIP_NO_ERROR if all the endpoints responded with a success status, else the first error */
+    CHIP_ERROR error;
+} bound_peer_status_t;
+
+using on_peer_done_callback_t = std::function<void(void *, const bound_peer_status_t &)>;
+using on_bound_done_callback_t = std::function<void(void *)>;
+
+/** Endpoint of a peer node bound to a local endpoint */
+typedef struct {
+    chip::ScopedNodeId peer_id;
+    chip::EndpointId endpoint_id;
+    /** Set by the group promotion policy if the endpoint is a member of the group */
+    bool group_member;
+} bound_target_t;
+
+/** Group promotion policy
+ *
+ * Called by `send_bound_request()` for the unicast targets of each fabric, when there are at least
+ * CONFIG_ESP_MATTER_CLIENT_GROUP_PROMOTION_MIN_TARGETS targets and the invoke is not timed. The policy selects a
+ * group which the local node can send commands to and sets group_member for the targets which are members of this
+ * group, e.g. after having added them to the group with the Groups cluster. A single group command is then sent in
+ * place of the unicast commands to the member targets, and the other targets are still sent unicast commands.
+ *
+ * @param[in] fabric_index Fabric of the targets.
+ * @param[in] local_endpoint_id Local endpoint with the Binding cluster.
+ * @param[in] cluster_id Cluster of the command.
+ * @param[in] command_id Command ID.
+ * @param[in,out] targets Unicast targets of the fabric.
+ * @param[in] target_count Number of targets.
+ * @param[out] group_id Group to send the command to.
+ * @param[in] priv_data Private data passed to `set_group_promotion_policy()`.
+ *
+ * @return true to send the command to the group, false to send unicast commands to all the targets.
+ */
+typedef bool (*group_promotion_policy_t)(chip::FabricIndex fabric_index, uint16_t local_endpoint_id,
+                                         chip::ClusterId cluster_id, chip::CommandId command_id,
+                                         bound_target_t *targets, size_t target_count, chip::GroupId *group_id,
+                                         void *priv_data);
+
+/** Set the group promotion policy of `send_bound_request()`, NULL to always send unicast commands
+ *
+ * @note The group commands have no response, so the policy should only promote the commands whose response is not
+ * needed. The group must be known by the group data provider of the local node, or the promotion is ignored.
+ */
+void set_group_promotion_policy(group_promotion_policy_t policy, void *priv_data);
+
+/** Send a command to all the devices bound to a local endpoint
+ *
+ * The unicast bindings of the local endpoint and the cluster are grouped by peer node. The sessions to the peer
+ * nodes are found or established concurrently, with at most CONFIG_ESP_MATTER_CLIENT_BINDING_FANOUT_MAX_IN_FLIGHT
+ * peer nodes in flight, and the command is sent to all the bound endpoints of a peer node in a single batch (refer
+ * to `send_batch_request()`). The command is sent without response to the group of each multicast binding, and to
+ * the group selected by the group promotion policy, if any (refer to `set_group_promotion_policy()`).
+ *
+ * This should be called in the Matter thread or with the CHIP stack lock held.
+ *
+ * @param[in] ctx Context passed to the callbacks.
+ * @param[in] local_endpoint_id Local endpoint with the Binding cluster.
+ * @param[in] cluster_id Cluster of the command.
+ * @param[in] command_id Command ID.
+ * @param[in] command_data Command data, it is encoded before this function returns.
+ * @param[in] on_peer_done Called once for every bound peer node, with the status of the command on its endpoints.
+ * @param[in] on_done Called once after all the bound peer nodes are done.
+ * @param[in] timed_invoke_timeout_ms Timeout of the timed invoke, NullOptional for untimed invoke.
+ * @param[in] response_timeout Response timeout of each InvokeRequest.
+ *
+ * @return ESP_OK on success, in which case on_done will be called.
+ * @return ESP_ERR_NOT_FOUND if no binding matches the local endpoint and the cluster.
+ * @return error in case of failure, in which case no callback will be called.
+ */
+esp_err_t send_bound_request(void *ctx, uint16_t local_endpoint_id, chip::ClusterId cluster_id,
+                             chip::CommandId command_id, const chip::app::DataModel::EncodableToTLV &command_data,
+                             on_peer_done_callback_t on_peer_done, on_bound_done_callback_t on_done,
+                             const Optional<uint16_t> &timed_invoke_timeout_ms,
+                             const Optional<Timeout> &response_timeout = chip::NullOptional);
+
+/** Statistics of the coalesced requests */
+typedef struct {
+    /** Requests submitted */
+    uint32_t submitted;
+    /** Requests sent */
+    uint32_t sent;
+    /** Requests replaced by a newer request of the same key before being sent */
+    uint32_t superseded;
+    /** Requests of a relative command merged into a newer request of the same key, or cancelled by it */
+    uint32_t merged;
+    /** Requests which failed to be sent */
+    uint32_t failed;
+    /** Requests rejected because all the slots were busy with other keys */
+    uint32_t no_slot;
+} coalesce_stats_t;
+
+/** Send a command to a remote device, coalesced with the previous commands of the same key
+ *
+ * The key is the peer node, the endpoint, the cluster and the command. A command which is not sent yet, because the
+ * session is being established or because of the minimum interval, is replaced by the newer command of the same
+ * key, so that a burst of commands such as a held dimmer button only sends the latest intent. The commands of a key
+ * are sent at least min_interval_ms apart. The keys use one of CONFIG_ESP_MATTER_CLIENT_COALESCED_REQUEST_SLOTS
+ * slots, which is reused once the key is idle for min_interval_ms.
+ *
+ * The relative commands are merged instead of replaced: the step sizes of the LevelControl Step and StepWithOnOff
+ * commands, and of the ColorControl StepHue, EnhancedStepHue, StepSaturation, StepColorTemperature and StepColor
+ * commands, are summed (saturated at the maximum of the field, opposite step modes subtract), and the other fields
+ * are taken from the newer command. The Move commands set a rate rather than an offset, so the latest one is kept.
+ *
+ * The command data is encoded in the slot buffer of CONFIG_ESP_MATTER_CLIENT_COALESCED_REQUEST_DATA_SIZE bytes,
+ * without memory allocation.
+ *
+ * The commands are sent without callback, so this should only be used for the commands whose response is not needed.
+ * This should be called in the Matter thread or with the CHIP stack lock held.
+ *
+ * @param[in] peer_id Peer node.
+ * @param[in] endpoint_id Endpoint of the peer node.
+ * @param[in] cluster_id Cluster of the command.
+ * @param[in] command_id Command ID.
+ * @param[in] command_data Command data, it is encoded before this function returns.
+ * @param[in] min_interval_ms Minimum interval between two commands of the key.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NO_MEM if all the slots are busy with other keys.
+ * @return ESP_ERR_INVALID_SIZE if the command data does not fit in the slot buffer.
+ * @return error in case of failure.
+ */
+esp_err_t send_coalesced_request(const chip::ScopedNodeId &peer_id, chip::EndpointId endpoint_id,
+                                 chip::ClusterId cluster_id, chip::CommandId command_id,
+                                 const chip::app::DataModel::EncodableToTLV &command_data, uint32_t min_interval_ms);
+
+/** Send a command to the devices bound to a local endpoint, coalesced with the previous commands of the same key
+ *
+ * Same as `send_coalesced_request()`, the key is the local endpoint, the cluster and the command, and the command is
+ * sent with `send_bound_request()`.
+ */
+esp_err_t send_coalesced_bound_request(uint16_t local_endpoint_id, chip::ClusterId cluster_id,
+                                       chip::CommandId command_id,
+                                       const chip::app::DataModel::EncodableToTLV &command_data,
+                                       uint32_t min_interval_ms);
+
+/** Get the statistics of the coalesced requests, with the CHIP stack lock held */
+void get_coalesce_stats(coalesce_stats_t &stats);
+
+void reset_coalesce_stats();
+
 } // namespace invoke
 
 /** Attribute/event read API
@@ -223,6 +490,14 @@ esp_err_t send_request(client::peer_device_t *remote_device, AttributePathParams
 esp_err_t send_request(client::peer_device_t *remote_device, ScopedMemoryBufferWithSize<AttributePathParams> &attr_paths,
                        multiple_write_encodable_type &json_encodable, WriteClient::Callback &callback,
                        const chip::Optional<uint16_t> &timeout_ms);
+
+/** Send a write request with pre-encoded attribute values
+ *
+ * @note attr_vals should hold one anonymous TLV element per attribute path, in the same order as attr_paths.
+ */
+esp_err_t send_request(client::peer_device_t *remote_device, ScopedMemoryBufferWithSize<AttributePathParams> &attr_paths,
+                       const tlv_encodable_type &attr_vals, WriteClient::Callback &callback,
+                       const chip::Optional<uint16_t> &timeout_ms);
 } // namespace write
 
 namespace subscribe {
@@ -14,6 +14,7 @@
 
 #include <esp_log.h>
 #include <esp_matter.h>
+#include <esp_matter_callback_stats.h>
 #include <esp_matter_command.h>
 #include <esp_matter_core.h>
 
@@ -56,6 +57,9 @@ void DispatchSingleClusterCommandCommon(const ConcreteCommandPath &command_path,
     if (command) {
         callback_t callback = get_user_callback(command);
         if (callback) {
+            // Only the user callback is timed, the other callbacks update the attributes and the nested PRE_UPDATE
+            // and POST_UPDATE callbacks are recorded on their own.
+            callback_stats::scoped_timer timer(callback_stats::COMMAND, endpoint_id, cluster_id, command_id);
             err = callback(command_path, tlv_reader, opaque_ptr);
         }
         callback = get_callback(command);
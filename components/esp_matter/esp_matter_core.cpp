@@ -50,6 +50,15 @@
 #include <esp_matter_nvs.h>
 #include <singly_linked_list.h>
 
+#if CONFIG_ESP_MATTER_LOCK_STATS
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+#include <algorithm>
+#endif
+
 using chip::CommandId;
 using chip::DataVersion;
 using chip::EventId;
@@ -332,13 +341,13 @@ static esp_err_t free_default_value(attribute_t *attribute)
     /* Free value if data is more than 2 bytes or if it is min max attribute */
     if (current_attribute->flags & ATTRIBUTE_FLAG_MIN_MAX) {
         if (matter_attribute->size > 2) {
-            esp_matter_mem_free((void *)matter_attribute->defaultValue.ptrToMinMaxValue->defaultValue.ptrToDefaultValue);
-            esp_matter_mem_free((void *)matter_attribute->defaultValue.ptrToMinMaxValue->minValue.ptrToDefaultValue);
-            esp_matter_mem_free((void *)matter_attribute->defaultValue.ptrToMinMaxValue->maxValue.ptrToDefaultValue);
+            esp_matter_mem_free_tagged((void *)matter_attribute->defaultValue.ptrToMinMaxValue->defaultValue.ptrToDefaultValue);
+            esp_matter_mem_free_tagged((void *)matter_attribute->defaultValue.ptrToMinMaxValue->minValue.ptrToDefaultValue);
+            esp_matter_mem_free_tagged((void *)matter_attribute->defaultValue.ptrToMinMaxValue->maxValue.ptrToDefaultValue);
         }
-        esp_matter_mem_free((void *)matter_attribute->defaultValue.ptrToMinMaxValue);
+        esp_matter_mem_free_tagged((void *)matter_attribute->defaultValue.ptrToMinMaxValue);
     } else if (matter_attribute->size > 2) {
-        esp_matter_mem_free((void *)matter_attribute->defaultValue.ptrToDefaultValue);
+        esp_matter_mem_free_tagged((void *)matter_attribute->defaultValue.ptrToDefaultValue);
     }
     return ESP_OK;
 }
@@ -348,7 +357,7 @@ static EmberAfDefaultAttributeValue get_default_value_from_data(esp_matter_attr_
                                                                 uint16_t attribute_size)
 {
     EmberAfDefaultAttributeValue default_value = (uint16_t)0;
-    uint8_t *value = (uint8_t *)esp_matter_mem_calloc(1, attribute_size);
+    uint8_t *value = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, attribute_size);
     VerifyOrReturnValue(value, default_value, ESP_LOGE(TAG, "Could not allocate value buffer for default value"));
     get_data_from_attr_val(val, &attribute_type, &attribute_size, value);
 
@@ -365,7 +374,7 @@ static EmberAfDefaultAttributeValue get_default_value_from_data(esp_matter_attr_
             int_value = (uint16_t)*value;
         }
         default_value = int_value;
-        esp_matter_mem_free(value);
+        esp_matter_mem_free_tagged(value);
     }
     return default_value;
 }
@@ -390,7 +399,8 @@ static esp_err_t set_default_value_from_current_val(attribute_t *attribute, esp_
 
     /* Get and set value */
     if (current_attribute->flags & ATTRIBUTE_FLAG_MIN_MAX) {
-        EmberAfAttributeMinMaxValue *temp_value = (EmberAfAttributeMinMaxValue *)esp_matter_mem_calloc(1,
+        EmberAfAttributeMinMaxValue *temp_value =
+            (EmberAfAttributeMinMaxValue *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1,
                                                                                 sizeof(EmberAfAttributeMinMaxValue));
         VerifyOrReturnError(temp_value, ESP_FAIL, ESP_LOGE(TAG, "Could not allocate ptrToMinMaxValue for default value"));
         temp_value->defaultValue = get_default_value_from_data(val, attribute_type, attribute_size);
@@ -460,7 +470,7 @@ esp_err_t enable(endpoint_t *endpoint)
     _endpoint_t *current_endpoint = (_endpoint_t *)endpoint;
 
     /* Device types */
-    EmberAfDeviceType *device_types_ptr = (EmberAfDeviceType *)esp_matter_mem_calloc(current_endpoint->device_type_count, sizeof(EmberAfDeviceType));
+    EmberAfDeviceType *device_types_ptr = (EmberAfDeviceType *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, current_endpoint->device_type_count, sizeof(EmberAfDeviceType));
     if (!device_types_ptr) {
         ESP_LOGE(TAG, "Couldn't allocate device_types");
         /* goto cleanup is not used here to avoid 'crosses initialization' of device_types below */
@@ -478,10 +488,12 @@ esp_err_t enable(endpoint_t *endpoint)
     int cluster_count = SinglyLinkedList<_cluster_t>::count(cluster);
     int cluster_index = 0;
 
-    DataVersion *data_versions_ptr = (DataVersion *)esp_matter_mem_calloc(1, cluster_count * sizeof(DataVersion));
+    DataVersion *data_versions_ptr =
+        (DataVersion *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                    1, cluster_count * sizeof(DataVersion));
     if (!data_versions_ptr) {
         ESP_LOGE(TAG, "Couldn't allocate data_versions");
-        esp_matter_mem_free(device_types_ptr);
+        esp_matter_mem_free_tagged(device_types_ptr);
         current_endpoint->device_types_ptr = NULL;
         /* goto cleanup is not used here to avoid 'crosses initialization' of data_versions below */
         return ESP_ERR_NO_MEM;
@@ -545,7 +557,9 @@ esp_err_t enable(endpoint_t *endpoint)
         command_count += command::get_cluster_accepted_command_count(cluster_id);
         if (command_count > 0) {
             command_index = 0;
-            accepted_command_ids = (CommandId *)esp_matter_mem_calloc(1, (command_count + 1) * sizeof(CommandId));
+            accepted_command_ids =
+                (CommandId *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                          1, (command_count + 1) * sizeof(CommandId));
             if (!accepted_command_ids) {
                 ESP_LOGE(TAG, "Couldn't allocate accepted_command_ids");
                 err = ESP_ERR_NO_MEM;
@@ -573,7 +587,9 @@ esp_err_t enable(endpoint_t *endpoint)
         command_count += command::get_cluster_generated_command_count(cluster_id);
         if (command_count > 0) {
             command_index = 0;
-            generated_command_ids = (CommandId *)esp_matter_mem_calloc(1, (command_count + 1) * sizeof(CommandId));
+            generated_command_ids =
+                (CommandId *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                          1, (command_count + 1) * sizeof(CommandId));
             if (!generated_command_ids) {
                 ESP_LOGE(TAG, "Couldn't allocate generated_command_ids");
                 err = ESP_ERR_NO_MEM;
@@ -599,7 +615,9 @@ esp_err_t enable(endpoint_t *endpoint)
         event_count = SinglyLinkedList<_event_t>::count(event);
         if (event_count > 0) {
             event_index = 0;
-            event_ids = (EventId *)esp_matter_mem_calloc(1, (event_count + 1) * sizeof(EventId));
+            event_ids =
+                (EventId *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                        1, (event_count + 1) * sizeof(EventId));
             if (!event_ids) {
                 ESP_LOGE(TAG, "Couldn't allocate event_ids");
                 err = ESP_ERR_NO_MEM;
@@ -663,24 +681,24 @@ esp_err_t enable(endpoint_t *endpoint)
     return err;
 
 cleanup:
-    esp_matter_mem_free(generated_command_ids);
-    esp_matter_mem_free(accepted_command_ids);
-    esp_matter_mem_free(event_ids);
+    esp_matter_mem_free_tagged(generated_command_ids);
+    esp_matter_mem_free_tagged(accepted_command_ids);
+    esp_matter_mem_free_tagged(event_ids);
     if (current_endpoint->endpoint_type->cluster) {
         for (int cluster_index = 0; cluster_index < cluster_count; cluster_index++) {
             /* Free attributes */
-            esp_matter_mem_free((void *)current_endpoint->endpoint_type->cluster[cluster_index].attributes);
+            esp_matter_mem_free_tagged((void *)current_endpoint->endpoint_type->cluster[cluster_index].attributes);
             /* Free commands */
-            esp_matter_mem_free((void *)current_endpoint->endpoint_type->cluster[cluster_index].acceptedCommandList);
-            esp_matter_mem_free((void *)current_endpoint->endpoint_type->cluster[cluster_index].generatedCommandList);
+            esp_matter_mem_free_tagged((void *)current_endpoint->endpoint_type->cluster[cluster_index].acceptedCommandList);
+            esp_matter_mem_free_tagged((void *)current_endpoint->endpoint_type->cluster[cluster_index].generatedCommandList);
             /* Free events */
-            esp_matter_mem_free((void *)current_endpoint->endpoint_type->cluster[cluster_index].eventList);
+            esp_matter_mem_free_tagged((void *)current_endpoint->endpoint_type->cluster[cluster_index].eventList);
         }
 
     }
-    esp_matter_mem_free(data_versions_ptr);
+    esp_matter_mem_free_tagged(data_versions_ptr);
     current_endpoint->data_versions_ptr = NULL;
-    esp_matter_mem_free(device_types_ptr);
+    esp_matter_mem_free_tagged(device_types_ptr);
     current_endpoint->device_types_ptr = NULL;
     return err;
 }
@@ -702,11 +720,107 @@ static esp_err_t enable_all()
 
 namespace lock {
 #define DEFAULT_TICKS (500 / portTICK_PERIOD_MS) /* 500 ms in ticks */
-status_t chip_stack_lock(uint32_t ticks_to_wait)
+
+#if CONFIG_ESP_MATTER_LOCK_STATS
+static stats_t s_stats;
+// The stats are only touched from tasks, a mutex keeps the interrupts enabled while the tables are copied.
+static StaticSemaphore_t s_stats_mutex_buffer;
+static SemaphoreHandle_t s_stats_mutex = xSemaphoreCreateMutexStatic(&s_stats_mutex_buffer);
+// Current holder of the lock, the lock is exclusive so there is at most one.
+static void *s_holder_caller = nullptr;
+static int64_t s_holder_start_us = 0;
+static uint32_t s_holder_wait_us = 0;
+
+class stats_lock {
+public:
+    stats_lock() { xSemaphoreTake(s_stats_mutex, portMAX_DELAY); }
+    ~stats_lock() { xSemaphoreGive(s_stats_mutex); }
+};
+
+static size_t histogram_bucket(uint32_t duration_us)
+{
+    size_t bucket = duration_us == 0 ? 0 : 31 - __builtin_clz(duration_us);
+    return bucket < k_histogram_bucket_count ? bucket : k_histogram_bucket_count - 1;
+}
+
+static void record_lock(void *caller, int64_t start_us, status_t status)
+{
+    int64_t now_us = esp_timer_get_time();
+    uint32_t wait_us = static_cast<uint32_t>(now_us - start_us);
+    stats_lock guard;
+    if (status == SUCCESS) {
+        s_stats.lock_count++;
+        s_stats.wait_histogram[histogram_bucket(wait_us)]++;
+        s_holder_caller = caller;
+        s_holder_start_us = now_us;
+        s_holder_wait_us = wait_us;
+    } else if (status == FAILED) {
+        s_stats.failed_count++;
+        s_stats.wait_histogram[histogram_bucket(wait_us)]++;
+    }
+}
+
+static void record_unlock()
+{
+    int64_t now_us = esp_timer_get_time();
+    const char *task_name = pcTaskGetName(NULL);
+    stats_lock guard;
+    VerifyOrReturn(s_holder_caller);
+    uint32_t hold_us = static_cast<uint32_t>(now_us - s_holder_start_us);
+    s_stats.hold_histogram[histogram_bucket(hold_us)]++;
+    holder_stats_t *holder = nullptr;
+    for (size_t i = 0; i < s_stats.holder_count; ++i) {
+        if (s_stats.holders[i].caller == s_holder_caller) {
+            holder = &s_stats.holders[i];
+            break;
+        }
+    }
+    if (!holder && s_stats.holder_count < CONFIG_ESP_MATTER_LOCK_STATS_HOLDER_COUNT) {
+        holder = &s_stats.holders[s_stats.holder_count++];
+        memset(holder, 0, sizeof(*holder));
+    } else if (!holder) {
+        // Replace the call site with the shortest hold time if this one is longer.
+        holder_stats_t *shortest = &s_stats.holders[0];
+        for (size_t i = 1; i < s_stats.holder_count; ++i) {
+            if (s_stats.holders[i].max_hold_us < shortest->max_hold_us) {
+                shortest = &s_stats.holders[i];
+            }
+        }
+        if (shortest->max_hold_us < hold_us) {
+            holder = shortest;
+            memset(holder, 0, sizeof(*holder));
+        }
+    }
+    if (holder) {
+        holder->caller = s_holder_caller;
+        holder->count++;
+        holder->total_hold_us += hold_us;
+        holder->max_wait_us = std::max(holder->max_wait_us, s_holder_wait_us);
+        if (hold_us >= holder->max_hold_us) {
+            holder->max_hold_us = hold_us;
+            strlcpy(holder->task_name, task_name ? task_name : "", sizeof(holder->task_name));
+        }
+    }
+    s_holder_caller = nullptr;
+}
+
+esp_err_t get_stats(stats_t *stats)
+{
+    VerifyOrReturnError(stats, ESP_ERR_INVALID_ARG);
+    stats_lock guard;
+    *stats = s_stats;
+    return ESP_OK;
+}
+
+void reset_stats()
+{
+    stats_lock guard;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+#endif // CONFIG_ESP_MATTER_LOCK_STATS
+
+static status_t take_chip_stack_lock(uint32_t ticks_to_wait)
 {
-#if CHIP_STACK_LOCK_TRACKING_ENABLED
-    VerifyOrReturnValue(!PlatformMgr().IsChipStackLockedByCurrentThread(), ALREADY_TAKEN);
-#endif
     VerifyOrReturnValue(ticks_to_wait != portMAX_DELAY, SUCCESS, PlatformMgr().LockChipStack());
     uint32_t ticks_remaining = ticks_to_wait;
     uint32_t ticks = DEFAULT_TICKS;
@@ -721,8 +835,28 @@ status_t chip_stack_lock(uint32_t ticks_to_wait)
     return FAILED;
 }
 
+status_t chip_stack_lock(uint32_t ticks_to_wait)
+{
+#if CHIP_STACK_LOCK_TRACKING_ENABLED
+    VerifyOrReturnValue(!PlatformMgr().IsChipStackLockedByCurrentThread(), ALREADY_TAKEN);
+#endif
+#if CONFIG_ESP_MATTER_LOCK_STATS
+    void *caller = reinterpret_cast<void *>(esp_cpu_get_call_addr(
+        reinterpret_cast<intptr_t>(__builtin_return_address(0))));
+    int64_t start_us = esp_timer_get_time();
+    status_t status = take_chip_stack_lock(ticks_to_wait);
+    record_lock(caller, start_us, status);
+    return status;
+#else
+    return take_chip_stack_lock(ticks_to_wait);
+#endif // CONFIG_ESP_MATTER_LOCK_STATS
+}
+
 esp_err_t chip_stack_unlock()
 {
+#if CONFIG_ESP_MATTER_LOCK_STATS
+    record_unlock();
+#endif
     PlatformMgr().UnlockChipStack();
     return ESP_OK;
 }
@@ -966,9 +1100,9 @@ attribute_t *create(cluster_t *cluster, uint32_t attribute_id, uint16_t flags, e
     int attribute_count = matter_clusters->attributeCount;
 
     if (current_cluster->matter_attributes) {
-        current_cluster->matter_attributes = (EmberAfAttributeMetadata *)esp_matter_mem_realloc(current_cluster->matter_attributes, attribute_count * sizeof(EmberAfAttributeMetadata));
+        current_cluster->matter_attributes = (EmberAfAttributeMetadata *)esp_matter_mem_realloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, current_cluster->matter_attributes, attribute_count * sizeof(EmberAfAttributeMetadata));
     } else {
-        current_cluster->matter_attributes = (EmberAfAttributeMetadata *)esp_matter_mem_calloc(1, attribute_count * sizeof(EmberAfAttributeMetadata));
+        current_cluster->matter_attributes = (EmberAfAttributeMetadata *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, attribute_count * sizeof(EmberAfAttributeMetadata));
     }
     if (!current_cluster->matter_attributes) {
         ESP_LOGE(TAG, "Couldn't allocate matter_attributes");
@@ -990,7 +1124,8 @@ attribute_t *create(cluster_t *cluster, uint32_t attribute_id, uint16_t flags, e
     _attribute_t *attribute = NULL;
     if (!(flags & ATTRIBUTE_FLAG_MANAGED_INTERNALLY)) {
         /* Allocate */
-        attribute = (_attribute_t *)esp_matter_mem_calloc(1, sizeof(_attribute_t));
+        attribute =
+            (_attribute_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_attribute_t));
         if (!attribute) {
             ESP_LOGE(TAG, "Couldn't allocate _attribute_t");
             return NULL;
@@ -1038,7 +1173,8 @@ attribute_t *create(cluster_t *cluster, uint32_t attribute_id, uint16_t flags, e
         }
         matter_clusters->clusterSize += matter_attribute->size;
     } else {
-        attribute = (_attribute_t *)esp_matter_mem_calloc(1, sizeof(_attribute_base_t));
+        attribute =
+            (_attribute_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_attribute_base_t));
         attribute->attribute_id = attribute_id;
         attribute->index = attribute_count - 1;
         attribute->flags = flags;
@@ -1056,7 +1192,7 @@ static esp_err_t destroy(attribute_t *attribute)
 
     if (current_attribute->flags & ATTRIBUTE_FLAG_MANAGED_INTERNALLY) {
         // For attribute managed internally, free as the _attribute_base_t pointer.
-        esp_matter_mem_free((_attribute_base_t *)attribute);
+        esp_matter_mem_free_tagged((_attribute_base_t *)attribute);
         return ESP_OK;
     }
 
@@ -1070,7 +1206,7 @@ static esp_err_t destroy(attribute_t *attribute)
         current_attribute->val.type == ESP_MATTER_VAL_TYPE_LONG_OCTET_STRING ||
         current_attribute->val.type == ESP_MATTER_VAL_TYPE_ARRAY) {
         /* Free buf */
-        esp_matter_mem_free(current_attribute->val.val.a.b);
+        esp_matter_mem_free_tagged(current_attribute->val.val.a.b);
     }
 
     /* Erase the persistent data */
@@ -1079,7 +1215,7 @@ static esp_err_t destroy(attribute_t *attribute)
     }
 
     /* Free */
-    esp_matter_mem_free(current_attribute);
+    esp_matter_mem_free_tagged(current_attribute);
     return ESP_OK;
 }
 
@@ -1148,11 +1284,11 @@ esp_err_t set_val(attribute_t *attribute, esp_matter_attr_val_t *val)
         val->type == ESP_MATTER_VAL_TYPE_LONG_CHAR_STRING || val->type == ESP_MATTER_VAL_TYPE_LONG_OCTET_STRING ||
         val->type == ESP_MATTER_VAL_TYPE_ARRAY) {
         /* Free old buf */
-        esp_matter_mem_free(current_attribute->val.val.a.b);
+        esp_matter_mem_free_tagged(current_attribute->val.val.a.b);
         current_attribute->val.val.a.b = NULL;
         if (val->val.a.s > 0) {
             /* Alloc new buf */
-            uint8_t *new_buf = (uint8_t *)esp_matter_mem_calloc(1, val->val.a.s);
+            uint8_t *new_buf = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, val->val.a.s);
             VerifyOrReturnError(new_buf, ESP_ERR_NO_MEM, ESP_LOGE(TAG, "Could not allocate new buffer"));
             /* Copy to new buf and assign */
             memcpy(new_buf, val->val.a.b, val->val.a.s);
@@ -1336,7 +1472,8 @@ command_t *create(cluster_t *cluster, uint32_t command_id, uint8_t flags, callba
     }
 
     /* Allocate */
-    _command_t *command = (_command_t *)esp_matter_mem_calloc(1, sizeof(_command_t));
+    _command_t *command =
+        (_command_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_command_t));
     VerifyOrReturnValue(command, NULL, ESP_LOGE(TAG, "Couldn't allocate _command_t"));
 
     /* Set */
@@ -1432,7 +1569,7 @@ event_t *create(cluster_t *cluster, uint32_t event_id)
     }
 
     /* Allocate */
-    _event_t *event = (_event_t *)esp_matter_mem_calloc(1, sizeof(_event_t));
+    _event_t *event = (_event_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_event_t));
     VerifyOrReturnValue(event, NULL, ESP_LOGE(TAG, "Couldn't allocate _event_t"));
 
     /* Set */
@@ -1516,7 +1653,8 @@ cluster_t *create(endpoint_t *endpoint, uint32_t cluster_id, uint8_t flags)
     }
 
     /* Allocate */
-    _cluster_t *cluster = (_cluster_t *)esp_matter_mem_calloc(1, sizeof(_cluster_t));
+    _cluster_t *cluster =
+        (_cluster_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_cluster_t));
     if (!cluster) {
         ESP_LOGE(TAG, "Couldn't allocate _cluster_t");
         return NULL;
@@ -1527,9 +1665,9 @@ cluster_t *create(endpoint_t *endpoint, uint32_t cluster_id, uint8_t flags)
     current_endpoint->cluster_count++;
     cluster->index = current_endpoint->cluster_count - 1;
     if (matter_clusters) {
-        matter_clusters = (EmberAfCluster *)esp_matter_mem_realloc(matter_clusters, current_endpoint->cluster_count * sizeof(EmberAfCluster));
+        matter_clusters = (EmberAfCluster *)esp_matter_mem_realloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, matter_clusters, current_endpoint->cluster_count * sizeof(EmberAfCluster));
     } else {
-        matter_clusters = (EmberAfCluster *)esp_matter_mem_calloc(1, current_endpoint->cluster_count * sizeof(EmberAfCluster));
+        matter_clusters = (EmberAfCluster *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, current_endpoint->cluster_count * sizeof(EmberAfCluster));
     }
     if (!matter_clusters) {
         ESP_LOGE(TAG, "Couldn't allocate EmberAfCluster");
@@ -1573,12 +1711,12 @@ static esp_err_t destroy(cluster_t *cluster)
 
     /* Free matter_attributes if allocated */
     if (current_cluster->matter_attributes) {
-        esp_matter_mem_free(current_cluster->matter_attributes);
+        esp_matter_mem_free_tagged(current_cluster->matter_attributes);
         current_cluster->matter_attributes = NULL;
     }
 
     /* Free */
-    esp_matter_mem_free(current_cluster);
+    esp_matter_mem_free_tagged(current_cluster);
     return ESP_OK;
 }
 
@@ -1717,13 +1855,16 @@ endpoint_t *create(node_t *node, uint8_t flags, void *priv_data)
                 CONFIG_ESP_MATTER_MAX_DYNAMIC_ENDPOINT_COUNT));
 
     /* Allocate */
-    _endpoint_t *endpoint = (_endpoint_t *)esp_matter_mem_calloc(1, sizeof(_endpoint_t));
+    _endpoint_t *endpoint =
+        (_endpoint_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_endpoint_t));
     VerifyOrReturnValue(endpoint, NULL, ESP_LOGE(TAG, "Couldn't allocate _endpoint_t"));
 
-    endpoint->endpoint_type = (EmberAfEndpointType *)esp_matter_mem_calloc(1, sizeof(EmberAfEndpointType));
+    endpoint->endpoint_type =
+        (EmberAfEndpointType *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                            1, sizeof(EmberAfEndpointType));
     if (!endpoint->endpoint_type) {
         ESP_LOGE(TAG, "Couldn't allocate EmberAfEndpointType");
-        esp_matter_mem_free(endpoint);
+        esp_matter_mem_free_tagged(endpoint);
         return NULL;
     }
 
@@ -1762,13 +1903,16 @@ endpoint_t *resume(node_t *node, uint8_t flags, uint16_t endpoint_id, void *priv
     VerifyOrReturnError(endpoint_id < current_node->min_unused_endpoint_id, NULL, ESP_LOGE(TAG, "The endpoint_id of the resumed endpoint should have been used"));
 
      /* Allocate */
-     _endpoint_t *endpoint = (_endpoint_t *)esp_matter_mem_calloc(1, sizeof(_endpoint_t));
+     _endpoint_t *endpoint =
+         (_endpoint_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_endpoint_t));
      VerifyOrReturnValue(endpoint, NULL, ESP_LOGE(TAG, "Couldn't allocate _endpoint_t"));
 
-     endpoint->endpoint_type = (EmberAfEndpointType *)esp_matter_mem_calloc(1, sizeof(EmberAfEndpointType));
+     endpoint->endpoint_type =
+         (EmberAfEndpointType *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL,
+                                                             1, sizeof(EmberAfEndpointType));
     if (!endpoint->endpoint_type) {
         ESP_LOGE(TAG, "Couldn't allocate EmberAfEndpointType");
-        esp_matter_mem_free(endpoint);
+        esp_matter_mem_free_tagged(endpoint);
         return NULL;
     }
 
@@ -1830,32 +1974,32 @@ esp_err_t destroy(node_t *node, endpoint_t *endpoint)
         for (int cluster_index = 0; cluster_index < cluster_count; cluster_index++) {
             /* Free commands */
             if (endpoint_type->cluster[cluster_index].acceptedCommandList) {
-                esp_matter_mem_free((void *)endpoint_type->cluster[cluster_index].acceptedCommandList);
+                esp_matter_mem_free_tagged((void *)endpoint_type->cluster[cluster_index].acceptedCommandList);
             }
             if (endpoint_type->cluster[cluster_index].generatedCommandList) {
-                esp_matter_mem_free((void *)endpoint_type->cluster[cluster_index].generatedCommandList);
+                esp_matter_mem_free_tagged((void *)endpoint_type->cluster[cluster_index].generatedCommandList);
             }
             /* Free events */
             if (endpoint_type->cluster[cluster_index].eventList) {
-                esp_matter_mem_free((void *)endpoint_type->cluster[cluster_index].eventList);
+                esp_matter_mem_free_tagged((void *)endpoint_type->cluster[cluster_index].eventList);
             }
         }
-        esp_matter_mem_free((void *)endpoint_type->cluster);
+        esp_matter_mem_free_tagged((void *)endpoint_type->cluster);
 
         /* Free data versions */
         if (current_endpoint->data_versions_ptr) {
-            esp_matter_mem_free(current_endpoint->data_versions_ptr);
+            esp_matter_mem_free_tagged(current_endpoint->data_versions_ptr);
             current_endpoint->data_versions_ptr = NULL;
         }
 
         /* Free device types */
         if (current_endpoint->device_types_ptr) {
-            esp_matter_mem_free(current_endpoint->device_types_ptr);
+            esp_matter_mem_free_tagged(current_endpoint->device_types_ptr);
             current_endpoint->device_types_ptr = NULL;
         }
 
         /* Free endpoint type */
-        esp_matter_mem_free(endpoint_type);
+        esp_matter_mem_free_tagged(endpoint_type);
         current_endpoint->endpoint_type = NULL;
     }
 
@@ -1871,7 +2015,7 @@ esp_err_t destroy(node_t *node, endpoint_t *endpoint)
         chip::Platform::Delete(current_endpoint->identify);
         current_endpoint->identify = NULL;
     }
-    esp_matter_mem_free(current_endpoint);
+    esp_matter_mem_free_tagged(current_endpoint);
     return ESP_OK;
 }
 
@@ -2000,7 +2144,7 @@ namespace node {
 node_t *create_raw()
 {
     VerifyOrReturnValue(!node, (node_t*) node, ESP_LOGE(TAG, "Node already exists"));
-    node = (_node_t *)esp_matter_mem_calloc(1, sizeof(_node_t));
+    node = (_node_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, sizeof(_node_t));
     VerifyOrReturnValue(node, NULL, ESP_LOGE(TAG, "Couldn't allocate _node_t"));
     return (node_t *)node;
 }
@@ -2009,7 +2153,7 @@ esp_err_t destroy_raw()
 {
     VerifyOrReturnError(node, ESP_ERR_INVALID_STATE, ESP_LOGE(TAG, "NULL node cannot be destroyed"));
     _node_t *current_node = (_node_t *)node;
-    esp_matter_mem_free(current_node);
+    esp_matter_mem_free_tagged(current_node);
     node = NULL;
     return ESP_OK;
 }
@@ -116,6 +116,54 @@ status_t chip_stack_lock(uint32_t ticks_to_wait);
  */
 esp_err_t chip_stack_unlock();
 
+#if CONFIG_ESP_MATTER_LOCK_STATS
+/** Number of buckets of the lock histograms
+ *
+ * The bucket N counts the durations from 2^N to 2^(N+1) - 1 microseconds, the first bucket also counts the durations
+ * below 1 microsecond and the last bucket the longer durations.
+ */
+constexpr size_t k_histogram_bucket_count = 20;
+
+/** Statistics of the locks taken from a call site */
+typedef struct {
+    /** Address of the call to `chip_stack_lock()`, which can be decoded with addr2line */
+    void *caller;
+    /** Task which held the lock for the longest time */
+    char task_name[16];
+    uint32_t count;
+    uint32_t max_hold_us;
+    uint32_t max_wait_us;
+    uint64_t total_hold_us;
+} holder_stats_t;
+
+/** Statistics of the CHIP stack locks taken with `chip_stack_lock()` */
+typedef struct {
+    /** Locks taken */
+    uint32_t lock_count;
+    /** Locks not taken within the ticks to wait */
+    uint32_t failed_count;
+    /** Histogram of the time waited for the lock */
+    uint32_t wait_histogram[k_histogram_bucket_count];
+    /** Histogram of the time the lock was held */
+    uint32_t hold_histogram[k_histogram_bucket_count];
+    /** Call sites which held the lock for the longest time, the shortest ones are replaced when the table is full */
+    holder_stats_t holders[CONFIG_ESP_MATTER_LOCK_STATS_HOLDER_COUNT];
+    size_t holder_count;
+} stats_t;
+
+/** Get the statistics of the CHIP stack locks
+ *
+ * @param[out] stats Statistics of the locks.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t get_stats(stats_t *stats);
+
+/** Reset the statistics of the CHIP stack locks */
+void reset_stats();
+#endif // CONFIG_ESP_MATTER_LOCK_STATS
+
 } /* lock */
 
 namespace node {
@@ -1110,5 +1158,77 @@ esp_err_t set_request_callback(request_callback_t callback, group_request_callba
  */
 esp_err_t cluster_update(uint16_t local_endpoint_id, request_handle_t *req_handle);
 
+/** Usage of a preallocated pool of the client */
+typedef struct {
+    /** Number of preallocated objects */
+    uint16_t size;
+    /** Number of preallocated objects in use */
+    uint16_t in_use;
+    /** Highest number of preallocated objects in use at the same time */
+    uint16_t peak_in_use;
+    /** Number of objects allocated from the heap because the pool was exhausted */
+    uint32_t exhausted_count;
+} pool_usage_t;
+
+/** Statistics of the preallocated pools of the client */
+typedef struct {
+    /** Request handles of `connect()` and `cluster_update()`, refer to CONFIG_ESP_MATTER_CLIENT_REQUEST_POOL_SIZE */
+    pool_usage_t request_handles;
+    /** CommandSenders of the invoke requests, refer to CONFIG_ESP_MATTER_CLIENT_COMMAND_SENDER_POOL_SIZE */
+    pool_usage_t command_senders;
+    /** Response callbacks of the unicast invoke requests */
+    pool_usage_t command_callbacks;
+} pool_stats_t;
+
+/** Get the statistics of the preallocated pools
+ *
+ * The pools are only used in the Matter thread, so this should be called with the CHIP stack lock held.
+ *
+ * @param[out] stats Statistics of the pools.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t get_pool_stats(pool_stats_t *stats);
+
+/** Reset the peak usage and the exhaustion count of the preallocated pools
+ *
+ * This should be called with the CHIP stack lock held.
+ */
+void reset_pool_stats();
+
+/** Statistics of the sessions kept established to the bound peer nodes */
+typedef struct {
+    /** Requests which found an established session to the peer node, counted once per peer node of a request */
+    uint32_t hits;
+    /** Requests which had to wait for the CASE session establishment, counted once per peer node of a request */
+    uint32_t misses;
+    /** Sessions established in background */
+    uint32_t established;
+    /** Peer nodes evicted for a more recently used one */
+    uint32_t evictions;
+    /** Peer nodes with an established session */
+    uint16_t warm_sessions;
+    /** Maximum number of peer nodes, refer to CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM_BUDGET */
+    uint16_t budget;
+} session_cache_stats_t;
+
+/** Get the statistics of the sessions kept established to the bound peer nodes
+ *
+ * This should be called with the CHIP stack lock held.
+ *
+ * @param[out] stats Statistics of the sessions.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_CLIENT_SESSION_PREWARM is disabled.
+ */
+esp_err_t get_session_cache_stats(session_cache_stats_t *stats);
+
+/** Reset the counters of the sessions kept established to the bound peer nodes
+ *
+ * This should be called with the CHIP stack lock held.
+ */
+void reset_session_cache_stats();
+
 } /* client */
 } /* esp_matter */
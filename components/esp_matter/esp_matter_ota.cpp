@@ -30,6 +30,15 @@
 
 #include <esp_matter.h>
 #include <esp_matter_ota.h>
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#include <esp_matter_ota_image_processor.h>
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+#include <esp_matter_ota_compressed.h>
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+#include <esp_matter_ota_delta.h>
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
 #include <zap-generated/endpoint_config.h>
 
 using chip::BDXDownloader;
@@ -44,11 +53,22 @@ using namespace esp_matter::endpoint;
 using namespace esp_matter::cluster;
 
 #if CONFIG_ENABLE_OTA_REQUESTOR
+static const char *TAG = "esp_matter_ota";
+
 DefaultOTARequestor gRequestorCore;
 DefaultOTARequestorStorage gRequestorStorage;
 ExtendedOTARequestorDriver gRequestorUser;
 BDXDownloader gDownloader;
 OTAImageProcessorImpl gImageProcessor;
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+esp_matter::ota::StreamOTAImageProcessor gResumableImageProcessor;
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+esp_matter::ota::CompressedOTAImageProcessor gCompressedImageProcessor;
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+esp_matter::ota::DeltaOTAImageProcessor gDeltaImageProcessor;
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
 
 static esp_matter_ota_requestor_impl_t s_ota_requestor_impl = {
     .driver = &gRequestorUser,
@@ -104,6 +124,15 @@ void esp_matter_ota_requestor_start(void)
     gRequestorCore.Init(Server::GetInstance(), gRequestorStorage, *s_ota_requestor_impl.driver, gDownloader);
 
     gImageProcessor.SetOTADownloader(&gDownloader);
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    gResumableImageProcessor.SetOTADownloader(&gDownloader);
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+    gCompressedImageProcessor.SetOTADownloader(&gDownloader);
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+    gDeltaImageProcessor.SetOTADownloader(&gDownloader);
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
 
     gDownloader.SetImageProcessorDelegate(s_ota_requestor_impl.image_processor);
 
@@ -121,6 +150,12 @@ esp_err_t esp_matter_ota_requestor_encrypted_init(const char *key, uint16_t size
 }
 #endif // CONFIG_ENABLE_ENCRYPTED_OTA
 
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+chip::OTAImageProcessorInterface *esp_matter_ota_requestor_get_delta_image_processor(void)
+{
+    return &gDeltaImageProcessor;
+}
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
 
 esp_err_t esp_matter_ota_requestor_set_config(const esp_matter_ota_config_t & config)
 {
@@ -131,6 +166,24 @@ esp_err_t esp_matter_ota_requestor_set_config(const esp_matter_ota_config_t & co
     if (config.watchdog_timeout) {
         gRequestorUser.SetWatchdogTimeout(config.watchdog_timeout);
     }
+    if (config.resumable_download) {
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+        ESP_LOGI(TAG, "Use the resumable OTA image processor");
+        s_ota_requestor_impl.image_processor = &gResumableImageProcessor;
+#else
+        ESP_LOGE(TAG, "Enable CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD to resume the OTA downloads");
+        return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    }
+    if (config.compressed_image) {
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+        ESP_LOGI(TAG, "Use the compressed OTA image processor");
+        s_ota_requestor_impl.image_processor = &gCompressedImageProcessor;
+#else
+        ESP_LOGE(TAG, "Enable CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE to support the compressed OTA images");
+        return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+    }
     if (config.impl != nullptr) {
         esp_matter_ota_override_impl(config.impl);
     }
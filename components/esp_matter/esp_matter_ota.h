@@ -48,6 +48,18 @@ typedef struct {
      * If not set, default implementation is used.
      */
     const esp_matter_ota_requestor_impl_t *impl = nullptr;
+    /**
+     * Use the image processor which decompresses the compressed OTA images while they are downloaded.
+     * The uncompressed images are still accepted. This option requires CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+     * and is ignored if impl overrides the image processor.
+     */
+    bool compressed_image = false;
+    /**
+     * Use the image processor which resumes the interrupted downloads from the last checkpoint. This option
+     * requires CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD and is ignored if impl overrides the image processor.
+     * The compressed image processor also resumes the downloads of the uncompressed images.
+     */
+    bool resumable_download = false;
 } esp_matter_ota_config_t;
 
 /**
@@ -76,6 +88,18 @@ void esp_matter_ota_requestor_start(void);
 esp_err_t esp_matter_ota_requestor_encrypted_init(const char *key, uint16_t size);
 #endif // CONFIG_ENABLE_ENCRYPTED_OTA
 
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+/**
+ * @brief Get the image processor of the delta OTA images
+ *
+ * Set it as the image_processor of esp_matter_ota_requestor_impl_t to apply the delta images generated by
+ * tools/ota_delta/ota_delta.py. The full images are still accepted by this processor.
+ *
+ * @return the delta image processor
+ */
+chip::OTAImageProcessorInterface *esp_matter_ota_requestor_get_delta_image_processor(void);
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+
 /**
  * @brief Set the OTA Requestor configuration parameters
  *
@@ -0,0 +1,74 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <string.h>
+
+#include <esp_matter_ota_compressed.h>
+
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+static const char *TAG = "esp_matter_ota";
+
+namespace esp_matter {
+namespace ota {
+
+CompressedOTAImageProcessor::CompressedOTAImageProcessor()
+    : StreamOTAImageProcessor(k_compressed_image_magic, sizeof(compressed_image_header_t))
+{
+}
+
+esp_err_t CompressedOTAImageProcessor::BeginPayload(const uint8_t *header)
+{
+    compressed_image_header_t compressed_header;
+    memcpy(&compressed_header, header, sizeof(compressed_header));
+    ESP_RETURN_ON_FALSE(compressed_header.version == k_compressed_image_version, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Unsupported compressed image version %u", compressed_header.version);
+    ESP_RETURN_ON_FALSE(compressed_header.image_size <= m_update_partition->size, ESP_ERR_INVALID_SIZE, TAG,
+                        "The image of %" PRIu32 " bytes does not fit the OTA partition", compressed_header.image_size);
+    ESP_RETURN_ON_ERROR(m_decoder.init(compressed_header.window_bits, compressed_header.lookahead_bits,
+                                       compressed_header.image_size, write_decoded, this),
+                        TAG, "Failed to initialize the decoder");
+    ESP_LOGI(TAG, "Compressed image of %" PRIu32 " bytes, window %u bits, lookahead %u bits",
+             compressed_header.image_size, compressed_header.window_bits, compressed_header.lookahead_bits);
+    return ESP_OK;
+}
+
+esp_err_t CompressedOTAImageProcessor::ProcessPayload(const uint8_t *data, size_t size)
+{
+    return m_decoder.decode(data, size);
+}
+
+esp_err_t CompressedOTAImageProcessor::EndPayload()
+{
+    esp_err_t err = m_decoder.finish();
+    ESP_LOGI(TAG, "Decompressed %u bytes of application image", static_cast<unsigned>(m_decoder.get_output_size()));
+    m_decoder.deinit();
+    return err;
+}
+
+void CompressedOTAImageProcessor::AbortPayload()
+{
+    m_decoder.deinit();
+}
+
+esp_err_t CompressedOTAImageProcessor::write_decoded(const uint8_t *data, size_t size, void *ctx)
+{
+    return reinterpret_cast<CompressedOTAImageProcessor *>(ctx)->WriteImage(data, size);
+}
+
+} // namespace ota
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
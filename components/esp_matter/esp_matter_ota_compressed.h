@@ -0,0 +1,46 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <esp_matter_ota_image_processor.h>
+#include <esp_matter_ota_lzss_decoder.h>
+#include <sdkconfig.h>
+
+namespace esp_matter {
+namespace ota {
+
+/** OTA image processor which decompresses the application image while it is downloaded
+ *
+ * The payloads which do not start with a compressed_image_header_t are written as is.
+ */
+class CompressedOTAImageProcessor : public StreamOTAImageProcessor {
+public:
+    CompressedOTAImageProcessor();
+
+protected:
+    esp_err_t BeginPayload(const uint8_t *header) override;
+    esp_err_t ProcessPayload(const uint8_t *data, size_t size) override;
+    esp_err_t EndPayload() override;
+    void AbortPayload() override;
+
+private:
+    static esp_err_t write_decoded(const uint8_t *data, size_t size, void *ctx);
+
+    lzss_decoder m_decoder;
+};
+
+} // namespace ota
+} // namespace esp_matter
@@ -0,0 +1,91 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <string.h>
+
+#include <esp_matter_ota_delta.h>
+
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+static const char *TAG = "esp_matter_ota";
+
+namespace esp_matter {
+namespace ota {
+
+DeltaOTAImageProcessor::DeltaOTAImageProcessor()
+    : StreamOTAImageProcessor(k_delta_image_magic, sizeof(delta_image_header_t))
+{
+}
+
+esp_err_t DeltaOTAImageProcessor::VerifyBaseImage(size_t base_size, const uint8_t *digest)
+{
+    ESP_RETURN_ON_FALSE(base_size <= m_base_partition->size, ESP_ERR_INVALID_SIZE, TAG,
+                        "The base image is larger than the running partition");
+    // The patch is applied once the digest of the running image is verified, in slices on the Matter task
+    return VerifyPartition(m_base_partition, base_size, digest);
+}
+
+esp_err_t DeltaOTAImageProcessor::BeginPayload(const uint8_t *header)
+{
+    delta_image_header_t delta_header;
+    memcpy(&delta_header, header, sizeof(delta_header));
+    ESP_RETURN_ON_FALSE(delta_header.version == k_delta_image_version, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Unsupported delta image version %u", delta_header.version);
+    ESP_RETURN_ON_FALSE(delta_header.image_size <= m_update_partition->size, ESP_ERR_INVALID_SIZE, TAG,
+                        "The image of %" PRIu32 " bytes does not fit the OTA partition", delta_header.image_size);
+    m_base_partition = esp_ota_get_running_partition();
+    ESP_RETURN_ON_FALSE(m_base_partition, ESP_ERR_NOT_FOUND, TAG, "No running partition");
+    ESP_RETURN_ON_ERROR(VerifyBaseImage(delta_header.base_size, delta_header.base_digest), TAG,
+                        "Failed to verify the base image");
+    ESP_RETURN_ON_ERROR(m_applier.init(delta_header.base_size, delta_header.image_size, read_base, write_patched, this),
+                        TAG, "Failed to initialize the patch applier");
+    ESP_LOGI(TAG, "Delta image of %" PRIu32 " bytes from a base image of %" PRIu32 " bytes", delta_header.image_size,
+             delta_header.base_size);
+    return ESP_OK;
+}
+
+esp_err_t DeltaOTAImageProcessor::ProcessPayload(const uint8_t *data, size_t size)
+{
+    return m_applier.apply(data, size);
+}
+
+esp_err_t DeltaOTAImageProcessor::EndPayload()
+{
+    esp_err_t err = m_applier.finish();
+    ESP_LOGI(TAG, "Patched %u bytes of application image, %u bytes copied from the running image",
+             m_applier.get_output_size(), m_applier.get_copied_size());
+    m_applier.deinit();
+    return err;
+}
+
+void DeltaOTAImageProcessor::AbortPayload()
+{
+    m_applier.deinit();
+}
+
+esp_err_t DeltaOTAImageProcessor::read_base(size_t offset, uint8_t *buf, size_t size, void *ctx)
+{
+    return esp_partition_read(reinterpret_cast<DeltaOTAImageProcessor *>(ctx)->m_base_partition, offset, buf, size);
+}
+
+esp_err_t DeltaOTAImageProcessor::write_patched(const uint8_t *data, size_t size, void *ctx)
+{
+    return reinterpret_cast<DeltaOTAImageProcessor *>(ctx)->WriteImage(data, size);
+}
+
+} // namespace ota
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
@@ -0,0 +1,52 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <esp_matter_ota_delta_patch.h>
+#include <esp_matter_ota_image_processor.h>
+#include <sdkconfig.h>
+
+namespace esp_matter {
+namespace ota {
+
+/** OTA image processor which rebuilds the new application image from the running one and a delta patch
+ *
+ * The patch only applies to the running application image it was generated from, which is checked with the digest
+ * of the header before anything is written. The payloads which do not start with a delta_image_header_t are written
+ * as is, so the full images are still accepted.
+ */
+class DeltaOTAImageProcessor : public StreamOTAImageProcessor {
+public:
+    DeltaOTAImageProcessor();
+
+protected:
+    esp_err_t BeginPayload(const uint8_t *header) override;
+    esp_err_t ProcessPayload(const uint8_t *data, size_t size) override;
+    esp_err_t EndPayload() override;
+    void AbortPayload() override;
+
+private:
+    static esp_err_t read_base(size_t offset, uint8_t *buf, size_t size, void *ctx);
+    static esp_err_t write_patched(const uint8_t *data, size_t size, void *ctx);
+
+    esp_err_t VerifyBaseImage(size_t base_size, const uint8_t *digest);
+
+    const esp_partition_t *m_base_partition = nullptr;
+    delta_patch_applier m_applier;
+};
+
+} // namespace ota
+} // namespace esp_matter
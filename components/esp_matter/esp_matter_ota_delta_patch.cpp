@@ -0,0 +1,148 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <inttypes.h>
+#include <sdkconfig.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <esp_matter_mem.h>
+#include <esp_matter_ota_delta_patch.h>
+
+#if CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
+static const char *TAG = "esp_matter_ota";
+
+static constexpr uint8_t k_delta_op_copy = 0x01;
+static constexpr uint8_t k_delta_op_insert = 0x02;
+
+namespace esp_matter {
+namespace ota {
+
+static uint32_t get_le32(const uint8_t *buf)
+{
+    return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+esp_err_t delta_patch_applier::init(size_t base_size, size_t output_size, read_base_callback_t read_base,
+                                    output_callback_t output, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(read_base && output, ESP_ERR_INVALID_ARG, TAG, "callbacks cannot be NULL");
+    deinit();
+    m_copy_buffer = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_REQUESTOR, 1, k_copy_buffer_size);
+    ESP_RETURN_ON_FALSE(m_copy_buffer, ESP_ERR_NO_MEM, TAG, "Failed to allocate the copy buffer");
+    m_state = STATE_OPCODE;
+    m_args_len = 0;
+    m_args_needed = 0;
+    m_remaining = 0;
+    m_base_size = base_size;
+    m_output_size = output_size;
+    m_produced = 0;
+    m_copied = 0;
+    m_read_base = read_base;
+    m_output = output;
+    m_ctx = ctx;
+    return ESP_OK;
+}
+
+void delta_patch_applier::deinit()
+{
+    if (m_copy_buffer) {
+        esp_matter_mem_free_tagged(m_copy_buffer);
+        m_copy_buffer = nullptr;
+    }
+}
+
+esp_err_t delta_patch_applier::copy_base(uint32_t offset, uint32_t length)
+{
+    ESP_RETURN_ON_FALSE(offset <= m_base_size && length <= m_base_size - offset, ESP_ERR_INVALID_SIZE, TAG,
+                        "Copy out of the base image: offset %" PRIu32 " length %" PRIu32, offset, length);
+    while (length > 0) {
+        size_t chunk = std::min((size_t)length, k_copy_buffer_size);
+        ESP_RETURN_ON_ERROR(m_read_base(offset, m_copy_buffer, chunk, m_ctx), TAG, "Failed to read the base image");
+        ESP_RETURN_ON_ERROR(m_output(m_copy_buffer, chunk, m_ctx), TAG, "Failed to write the patched data");
+        offset += chunk;
+        length -= chunk;
+        m_produced += chunk;
+        m_copied += chunk;
+    }
+    return ESP_OK;
+}
+
+esp_err_t delta_patch_applier::apply(const uint8_t *data, size_t size)
+{
+    ESP_RETURN_ON_FALSE(m_copy_buffer, ESP_ERR_INVALID_STATE, TAG, "Applier is not initialized");
+    while (size > 0) {
+        switch (m_state) {
+        case STATE_OPCODE:
+            m_opcode = *data++;
+            size--;
+            ESP_RETURN_ON_FALSE(m_opcode == k_delta_op_copy || m_opcode == k_delta_op_insert, ESP_ERR_INVALID_RESPONSE,
+                                TAG, "Invalid patch opcode 0x%02x", m_opcode);
+            m_args_needed = m_opcode == k_delta_op_copy ? 8 : 4;
+            m_args_len = 0;
+            m_state = STATE_ARGS;
+            break;
+        case STATE_ARGS: {
+            size_t len = std::min(m_args_needed - m_args_len, size);
+            memcpy(m_args + m_args_len, data, len);
+            m_args_len += len;
+            data += len;
+            size -= len;
+            if (m_args_len < m_args_needed) {
+                break;
+            }
+            uint32_t length = get_le32(m_args + m_args_needed - 4);
+            ESP_RETURN_ON_FALSE(length <= m_output_size - m_produced, ESP_ERR_INVALID_SIZE, TAG,
+                                "The patch produces more than %u bytes", static_cast<unsigned>(m_output_size));
+            if (m_opcode == k_delta_op_copy) {
+                ESP_RETURN_ON_ERROR(copy_base(get_le32(m_args), length), TAG, "Failed to copy the base image");
+                m_state = STATE_OPCODE;
+            } else {
+                m_remaining = length;
+                m_state = length > 0 ? STATE_INSERT : STATE_OPCODE;
+            }
+            break;
+        }
+        case STATE_INSERT: {
+            size_t len = std::min((size_t)m_remaining, size);
+            ESP_RETURN_ON_ERROR(m_output(data, len, m_ctx), TAG, "Failed to write the patched data");
+            m_produced += len;
+            m_remaining -= len;
+            data += len;
+            size -= len;
+            if (m_remaining == 0) {
+                m_state = STATE_OPCODE;
+            }
+            break;
+        }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t delta_patch_applier::finish()
+{
+    ESP_RETURN_ON_FALSE(m_state == STATE_OPCODE && m_produced == m_output_size, ESP_ERR_INVALID_SIZE, TAG,
+                        "Truncated patch: %u of %u bytes patched", static_cast<unsigned>(m_produced),
+                        static_cast<unsigned>(m_output_size));
+    return ESP_OK;
+}
+
+} // namespace ota
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_OTA_DELTA_IMAGE
@@ -0,0 +1,111 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace ota {
+
+static constexpr uint8_t k_delta_image_magic[4] = {'E', 'S', 'P', 'D'};
+static constexpr uint8_t k_delta_image_version = 1;
+
+/** Header of a delta image, at the beginning of the payload of the Matter OTA image
+ *
+ * The patch follows the header. It is a sequence of operations, each one is an opcode byte followed by little-endian
+ * uint32 arguments: COPY (0x01) {base offset, length} copies data of the running application image, INSERT (0x02)
+ * {length} is followed by the data to write. The images are generated by tools/ota_delta/ota_delta.py.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t magic[4];
+    uint8_t version;
+    uint8_t reserved[3];
+    // Size of the new application image
+    uint32_t image_size;
+    // Size and SHA-256 digest of the application image the patch applies to
+    uint32_t base_size;
+    uint8_t base_digest[32];
+} delta_image_header_t;
+
+/** Streaming applier of a delta patch
+ *
+ * The applier does not access the flash directly, so it could be used with any storage of the base image.
+ */
+class delta_patch_applier {
+public:
+    using read_base_callback_t = esp_err_t (*)(size_t offset, uint8_t *buf, size_t size, void *ctx);
+    using output_callback_t = esp_err_t (*)(const uint8_t *data, size_t size, void *ctx);
+
+    ~delta_patch_applier() { deinit(); }
+
+    /**
+     * Initialize the applier
+     *
+     * @param[in] base_size Size of the base image.
+     * @param[in] output_size Size of the new image.
+     * @param[in] read_base Callback to read the base image.
+     * @param[in] output Callback called with chunks of the new image.
+     * @param[in] ctx Context of the callbacks.
+     *
+     * @return ESP_OK on success.
+     * @return error in case of failure.
+     */
+    esp_err_t init(size_t base_size, size_t output_size, read_base_callback_t read_base, output_callback_t output,
+                   void *ctx);
+
+    void deinit();
+
+    /** Apply a chunk of the patch */
+    esp_err_t apply(const uint8_t *data, size_t size);
+
+    /** Return an error if the patch is truncated */
+    esp_err_t finish();
+
+    size_t get_output_size() { return m_produced; }
+
+    /** Number of bytes of the new image copied from the base image */
+    size_t get_copied_size() { return m_copied; }
+
+private:
+    enum state_t : uint8_t {
+        STATE_OPCODE = 0,
+        STATE_ARGS,
+        STATE_INSERT,
+    };
+
+    static constexpr size_t k_copy_buffer_size = 1024;
+
+    esp_err_t copy_base(uint32_t offset, uint32_t length);
+
+    uint8_t *m_copy_buffer = nullptr;
+    state_t m_state = STATE_OPCODE;
+    uint8_t m_opcode = 0;
+    uint8_t m_args[8];
+    size_t m_args_len = 0;
+    size_t m_args_needed = 0;
+    uint32_t m_remaining = 0;
+    size_t m_base_size = 0;
+    size_t m_output_size = 0;
+    size_t m_produced = 0;
+    size_t m_copied = 0;
+    read_base_callback_t m_read_base = nullptr;
+    output_callback_t m_output = nullptr;
+    void *m_ctx = nullptr;
+};
+
+} // namespace ota
+} // namespace esp_matter
@@ -0,0 +1,631 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <esp_system.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <esp_matter_mem.h>
+#include <esp_matter_ota_image_processor.h>
+
+#if CONFIG_ESP_MATTER_OTA_STREAM_IMAGE_PROCESSOR
+#include <app/clusters/ota-requestor/OTARequestorInterface.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#include <nvs.h>
+#include <spi_flash_mmap.h>
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+
+using chip::ByteSpan;
+using chip::MutableByteSpan;
+using chip::OTARequestorInterface;
+using chip::DeviceLayer::PlatformMgr;
+
+static const char *TAG = "esp_matter_ota";
+static constexpr size_t k_read_buffer_size = 1024;
+
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+#define ESP_MATTER_NVS_PART_NAME CONFIG_ESP_MATTER_NVS_PART_NAME
+static constexpr char k_resume_nvs_namespace[] = "esp_matter_ota";
+static constexpr char k_resume_nvs_key[] = "resume";
+// The checkpoints are on flash sector boundaries, esp_ota_resume() erases the sectors after the resume offset
+static constexpr size_t k_checkpoint_size = (CONFIG_ESP_MATTER_OTA_RESUME_CHECKPOINT_KB * 1024 / SPI_FLASH_SEC_SIZE)
+    * SPI_FLASH_SEC_SIZE;
+// Start over if the download keeps failing right after resuming, the provider may not support BlockQueryWithSkip
+static constexpr uint8_t k_max_resume_count = 3;
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+
+namespace esp_matter {
+namespace ota {
+
+static void post_ota_state_change_event(chip::DeviceLayer::OtaState new_state)
+{
+    chip::DeviceLayer::ChipDeviceEvent ota_change;
+    ota_change.Type = chip::DeviceLayer::DeviceEventType::kOtaStateChanged;
+    ota_change.OtaStateChanged.newState = new_state;
+    CHIP_ERROR error = PlatformMgr().PostEvent(&ota_change);
+    if (error != CHIP_NO_ERROR) {
+        ESP_LOGE(TAG, "Failed to post OTA state change event, err:%" CHIP_ERROR_FORMAT, error.Format());
+    }
+}
+
+StreamOTAImageProcessor::StreamOTAImageProcessor(const uint8_t (&magic)[k_payload_magic_len], size_t header_len)
+    : m_magic(magic)
+    , m_payload_header_len(std::min(std::max(header_len, k_payload_magic_len), k_max_payload_header_len))
+{
+}
+
+CHIP_ERROR StreamOTAImageProcessor::PrepareDownload()
+{
+    PlatformMgr().ScheduleWork(HandlePrepareDownload, reinterpret_cast<intptr_t>(this));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::Finalize()
+{
+    PlatformMgr().ScheduleWork(HandleFinalize, reinterpret_cast<intptr_t>(this));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::Apply()
+{
+    PlatformMgr().ScheduleWork(HandleApply, reinterpret_cast<intptr_t>(this));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::Abort()
+{
+    PlatformMgr().ScheduleWork(HandleAbort, reinterpret_cast<intptr_t>(this));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::ProcessBlock(ByteSpan &block)
+{
+    CHIP_ERROR err = SetBlock(block);
+    if (err != CHIP_NO_ERROR) {
+        ESP_LOGE(TAG, "Cannot set block data: %" CHIP_ERROR_FORMAT, err.Format());
+        return err;
+    }
+    PlatformMgr().ScheduleWork(HandleProcessBlock, reinterpret_cast<intptr_t>(this));
+    return CHIP_NO_ERROR;
+}
+
+bool StreamOTAImageProcessor::IsFirstImageRun()
+{
+    OTARequestorInterface *requestor = chip::GetRequestorInstance();
+    if (requestor == nullptr) {
+        return false;
+    }
+    return requestor->GetCurrentUpdateState() == OTARequestorInterface::OTAUpdateStateEnum::kApplying;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::ConfirmCurrentImage()
+{
+    OTARequestorInterface *requestor = chip::GetRequestorInstance();
+    if (requestor == nullptr) {
+        return CHIP_ERROR_INTERNAL;
+    }
+    uint32_t current_version;
+    ReturnErrorOnFailure(chip::DeviceLayer::ConfigurationMgr().GetSoftwareVersion(current_version));
+    if (current_version != requestor->GetTargetVersion()) {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+    return CHIP_NO_ERROR;
+}
+
+void StreamOTAImageProcessor::HandlePrepareDownload(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr || processor->m_downloader == nullptr) {
+        ESP_LOGE(TAG, "ImageProcessor context or downloader is null");
+        return;
+    }
+    processor->m_update_partition = esp_ota_get_next_update_partition(NULL);
+    if (processor->m_update_partition == NULL) {
+        ESP_LOGE(TAG, "No OTA partition found");
+        processor->m_downloader->OnPreparedForDownload(CHIP_ERROR_INTERNAL);
+        return;
+    }
+    esp_err_t err = esp_ota_begin(processor->m_update_partition, OTA_WITH_SEQUENTIAL_WRITES, &processor->m_ota_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to begin OTA: %s", esp_err_to_name(err));
+        processor->m_downloader->OnPreparedForDownload(CHIP_ERROR_INTERNAL);
+        return;
+    }
+    processor->StopVerification();
+    processor->m_header_parser.Init();
+    processor->m_payload_header_received = 0;
+    processor->m_payload_checked = processor->m_magic == nullptr;
+    processor->m_payload_transformed = false;
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    mbedtls_sha256_free(&processor->m_sha_ctx);
+    mbedtls_sha256_init(&processor->m_sha_ctx);
+    mbedtls_sha256_starts(&processor->m_sha_ctx, 0);
+    processor->m_raw_written = 0;
+    processor->m_resume_skip = 0;
+    memset(&processor->m_resume_state, 0, sizeof(processor->m_resume_state));
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    processor->m_downloader->OnPreparedForDownload(CHIP_NO_ERROR);
+    post_ota_state_change_event(chip::DeviceLayer::kOtaDownloadInProgress);
+}
+
+void StreamOTAImageProcessor::HandleFinalize(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr) {
+        ESP_LOGE(TAG, "ImageProcessor context is null");
+        return;
+    }
+    esp_err_t err = ESP_OK;
+    processor->StopVerification();
+    if (processor->m_payload_transformed) {
+        err = processor->EndPayload();
+    }
+    if (err != ESP_OK) {
+        esp_ota_abort(processor->m_ota_handle);
+    } else {
+        err = esp_ota_end(processor->m_ota_handle);
+    }
+    processor->ReleaseBlock();
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    // The download is complete, or the written data is invalid: do not resume it
+    mbedtls_sha256_free(&processor->m_sha_ctx);
+    ClearResumeState();
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to finalize the OTA image: %s", esp_err_to_name(err));
+        post_ota_state_change_event(chip::DeviceLayer::kOtaDownloadFailed);
+        return;
+    }
+    ESP_LOGI(TAG, "OTA image downloaded to offset 0x%" PRIx32, processor->m_update_partition->address);
+    post_ota_state_change_event(chip::DeviceLayer::kOtaDownloadComplete);
+}
+
+void StreamOTAImageProcessor::HandleAbort(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr) {
+        ESP_LOGE(TAG, "ImageProcessor context is null");
+        return;
+    }
+    if (esp_ota_abort(processor->m_ota_handle) != ESP_OK) {
+        ESP_LOGE(TAG, "OTA abort failed");
+    }
+    // The pending slices of the verification stop when they find it stopped
+    processor->StopVerification();
+    if (processor->m_payload_transformed) {
+        processor->AbortPayload();
+    }
+    processor->ReleaseBlock();
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    // Keep the saved progress, the next download of the image resumes from the last checkpoint
+    mbedtls_sha256_free(&processor->m_sha_ctx);
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    post_ota_state_change_event(chip::DeviceLayer::kOtaDownloadAborted);
+}
+
+void StreamOTAImageProcessor::HandleProcessBlock(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr || processor->m_downloader == nullptr) {
+        ESP_LOGE(TAG, "ImageProcessor context or downloader is null");
+        return;
+    }
+    processor->m_block_offset = 0;
+    processor->ContinueBlock();
+}
+
+void StreamOTAImageProcessor::ContinueBlock()
+{
+    ByteSpan block = ByteSpan(m_block.data(), m_block.size()).SubSpan(m_block_offset);
+    CHIP_ERROR error = ProcessHeader(block);
+    if (error != CHIP_NO_ERROR) {
+        ESP_LOGE(TAG, "Failed to process OTA image header");
+        FailBlock(error);
+        return;
+    }
+    m_block_offset = m_block.size() - block.size();
+    if (m_verify.kind != VERIFY_NONE) {
+        // Continued by FinishVerification()
+        return;
+    }
+    uint32_t bytes_to_skip = 0;
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    if (m_resume_skip > 0) {
+        // The payload of the block was already written before the resumption
+        size_t skip_len = std::min(m_resume_skip, block.size());
+        block = block.SubSpan(skip_len);
+        bytes_to_skip = m_resume_skip - skip_len;
+        m_resume_skip = 0;
+    }
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    if (ProcessBlockPayload(block) != ESP_OK) {
+        FailBlock(CHIP_ERROR_WRITE_FAILED);
+        return;
+    }
+    if (m_verify.kind != VERIFY_NONE) {
+        // BeginPayload() requested a verification, ProcessBlockPayload() stopped after the payload header
+        m_block_offset = m_block.size() - block.size();
+        return;
+    }
+    mParams.downloadedBytes += m_block.size() + bytes_to_skip;
+    if (bytes_to_skip > 0) {
+        error = m_downloader->SkipData(bytes_to_skip);
+        if (error != CHIP_NO_ERROR) {
+            ESP_LOGE(TAG, "Failed to skip the downloaded data: %" CHIP_ERROR_FORMAT, error.Format());
+            FailBlock(error);
+        }
+        return;
+    }
+    m_downloader->FetchNextData();
+}
+
+void StreamOTAImageProcessor::FailBlock(CHIP_ERROR error)
+{
+    m_downloader->EndDownload(error);
+    post_ota_state_change_event(chip::DeviceLayer::kOtaDownloadFailed);
+}
+
+esp_err_t StreamOTAImageProcessor::VerifyPartition(const esp_partition_t *partition, size_t size,
+                                                   const uint8_t *digest)
+{
+    return StartVerification(VERIFY_PAYLOAD, partition, size, digest);
+}
+
+esp_err_t StreamOTAImageProcessor::StartVerification(verify_kind_t kind, const esp_partition_t *partition, size_t size,
+                                                     const uint8_t *digest)
+{
+    ESP_RETURN_ON_FALSE(partition && digest, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    ESP_RETURN_ON_FALSE(m_verify.kind == VERIFY_NONE, ESP_ERR_INVALID_STATE, TAG, "A verification is in progress");
+    ESP_RETURN_ON_FALSE(size <= partition->size, ESP_ERR_INVALID_SIZE, TAG, "The data is larger than the partition");
+    m_verify.buf = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_REQUESTOR, 1, k_read_buffer_size);
+    ESP_RETURN_ON_FALSE(m_verify.buf, ESP_ERR_NO_MEM, TAG, "Failed to allocate the read buffer");
+    m_verify.kind = kind;
+    m_verify.partition = partition;
+    m_verify.size = size;
+    m_verify.offset = 0;
+    memcpy(m_verify.digest, digest, sizeof(m_verify.digest));
+    mbedtls_sha256_init(&m_verify.sha_ctx);
+    mbedtls_sha256_starts(&m_verify.sha_ctx, 0);
+    PlatformMgr().ScheduleWork(HandleVerifySlice, reinterpret_cast<intptr_t>(this));
+    return ESP_OK;
+}
+
+void StreamOTAImageProcessor::HandleVerifySlice(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr || processor->m_verify.kind == VERIFY_NONE) {
+        // The download was aborted
+        return;
+    }
+    auto &verify = processor->m_verify;
+    size_t slice_end = std::min(verify.size, verify.offset + k_verify_slice_size);
+    esp_err_t err = ESP_OK;
+    while (verify.offset < slice_end) {
+        size_t len = std::min(slice_end - verify.offset, k_read_buffer_size);
+        err = esp_partition_read(verify.partition, verify.offset, verify.buf, len);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to read the partition %s: %s", verify.partition->label, esp_err_to_name(err));
+            break;
+        }
+        mbedtls_sha256_update(&verify.sha_ctx, verify.buf, len);
+        verify.offset += len;
+    }
+    if (err == ESP_OK && verify.offset < verify.size) {
+        // Let the other work of the Matter task run before the next slice
+        PlatformMgr().ScheduleWork(HandleVerifySlice, context);
+        return;
+    }
+    if (err == ESP_OK) {
+        // Keep the running digest, the resumed download continues it
+        uint8_t digest[32];
+        mbedtls_sha256_context sha_ctx;
+        mbedtls_sha256_init(&sha_ctx);
+        mbedtls_sha256_clone(&sha_ctx, &verify.sha_ctx);
+        mbedtls_sha256_finish(&sha_ctx, digest);
+        mbedtls_sha256_free(&sha_ctx);
+        if (memcmp(digest, verify.digest, sizeof(digest)) != 0) {
+            ESP_LOGE(TAG, "The data of the partition %s does not match the expected digest", verify.partition->label);
+            err = ESP_ERR_INVALID_CRC;
+        }
+    }
+    processor->FinishVerification(err);
+}
+
+void StreamOTAImageProcessor::FinishVerification(esp_err_t err)
+{
+    verify_kind_t kind = m_verify.kind;
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    if (kind == VERIFY_RESUME) {
+        FinishResume(err);
+    }
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    StopVerification();
+    if (kind == VERIFY_PAYLOAD && err != ESP_OK) {
+        FailBlock(CHIP_ERROR_WRITE_FAILED);
+        return;
+    }
+    ContinueBlock();
+}
+
+void StreamOTAImageProcessor::StopVerification()
+{
+    if (m_verify.kind == VERIFY_NONE) {
+        return;
+    }
+    mbedtls_sha256_free(&m_verify.sha_ctx);
+    esp_matter_mem_free_tagged(m_verify.buf);
+    m_verify.buf = nullptr;
+    m_verify.kind = VERIFY_NONE;
+}
+
+void StreamOTAImageProcessor::HandleApply(intptr_t context)
+{
+    auto *processor = reinterpret_cast<StreamOTAImageProcessor *>(context);
+    if (processor == nullptr) {
+        ESP_LOGE(TAG, "ImageProcessor context is null");
+        return;
+    }
+    esp_err_t err = esp_ota_set_boot_partition(processor->m_update_partition);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set the boot partition: %s", esp_err_to_name(err));
+        post_ota_state_change_event(chip::DeviceLayer::kOtaApplyFailed);
+        return;
+    }
+    post_ota_state_change_event(chip::DeviceLayer::kOtaApplyComplete);
+    ESP_LOGI(TAG, "Applying, Boot partition set offset:0x%" PRIx32, processor->m_update_partition->address);
+    esp_restart();
+}
+
+esp_err_t StreamOTAImageProcessor::WriteImage(const uint8_t *data, size_t size)
+{
+    esp_err_t err = esp_ota_write(m_ota_handle, data, size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write the OTA image: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+CHIP_ERROR StreamOTAImageProcessor::ProcessHeader(ByteSpan &block)
+{
+    if (m_header_parser.IsInitialized()) {
+        chip::OTAImageHeader header;
+        CHIP_ERROR error = m_header_parser.AccumulateAndDecode(block, header);
+        // Need more data to decode the header
+        ReturnErrorCodeIf(error == CHIP_ERROR_BUFFER_TOO_SMALL, CHIP_NO_ERROR);
+        ReturnErrorOnFailure(error);
+        mParams.totalFileBytes = header.mPayloadSize;
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+        Resume(header);
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+        m_header_parser.Clear();
+    }
+    return CHIP_NO_ERROR;
+}
+
+esp_err_t StreamOTAImageProcessor::ProcessBlockPayload(ByteSpan &block)
+{
+    const uint8_t *data = block.data();
+    size_t size = block.size();
+    if (!m_payload_checked) {
+        size_t copy_len = std::min(m_payload_header_len - m_payload_header_received, size);
+        memcpy(m_payload_header + m_payload_header_received, data, copy_len);
+        m_payload_header_received += copy_len;
+        data += copy_len;
+        size -= copy_len;
+        if (memcmp(m_payload_header, m_magic, std::min(m_payload_header_received, k_payload_magic_len)) != 0) {
+            // Not a transformed payload, write it as is
+            m_payload_checked = true;
+            ESP_RETURN_ON_ERROR(WriteRawPayload(m_payload_header, m_payload_header_received), TAG,
+                                "Failed to write the image");
+        } else if (m_payload_header_received < m_payload_header_len) {
+            return ESP_OK;
+        } else {
+            m_payload_checked = true;
+            ESP_RETURN_ON_ERROR(BeginPayload(m_payload_header), TAG, "Failed to process the payload header");
+            m_payload_transformed = true;
+            if (m_verify.kind != VERIFY_NONE) {
+                // The rest of the block is processed once the verification requested by BeginPayload() succeeds
+                block = block.SubSpan(data - block.data());
+                return ESP_OK;
+            }
+        }
+    }
+    if (size == 0) {
+        return ESP_OK;
+    }
+    if (m_payload_transformed) {
+        return ProcessPayload(data, size);
+    }
+    return WriteRawPayload(data, size);
+}
+
+esp_err_t StreamOTAImageProcessor::WriteRawPayload(const uint8_t *data, size_t size)
+{
+    ESP_RETURN_ON_ERROR(WriteImage(data, size), TAG, "Failed to write the image");
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    while (size > 0) {
+        // Split the digest update at the checkpoints
+        size_t next_checkpoint = (m_raw_written / k_checkpoint_size + 1) * k_checkpoint_size;
+        size_t len = std::min(size, next_checkpoint - m_raw_written);
+        mbedtls_sha256_update(&m_sha_ctx, data, len);
+        m_raw_written += len;
+        data += len;
+        size -= len;
+        if (m_raw_written == next_checkpoint) {
+            SaveCheckpoint();
+        }
+    }
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    return ESP_OK;
+}
+
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+void StreamOTAImageProcessor::Resume(const chip::OTAImageHeader &header)
+{
+    resume_state_t &state = m_resume_state;
+    state.software_version = header.mSoftwareVersion;
+    state.partition_address = m_update_partition->address;
+    state.payload_size = header.mPayloadSize;
+    memcpy(state.image_digest, header.mImageDigest.data(), std::min(header.mImageDigest.size(), sizeof(state.image_digest)));
+
+    resume_state_t &saved = m_saved_resume_state;
+    if (LoadResumeState(saved) != ESP_OK) {
+        return;
+    }
+    // Compare the identity of the images
+    if (memcmp(&saved, &state, offsetof(resume_state_t, written_size)) != 0 || saved.written_size == 0 ||
+        saved.written_size >= state.payload_size || saved.written_size % k_checkpoint_size != 0) {
+        ESP_LOGI(TAG, "The saved OTA progress is for another image, download the image from the beginning");
+        ClearResumeState();
+        return;
+    }
+    if (saved.resume_count >= k_max_resume_count) {
+        ESP_LOGW(TAG, "The download failed after %u resumptions, download the image from the beginning",
+                 saved.resume_count);
+        ClearResumeState();
+        return;
+    }
+    // The block waits for the verification of the written data, FinishResume() is called with the result
+    if (StartVerification(VERIFY_RESUME, m_update_partition, saved.written_size, saved.written_digest) != ESP_OK) {
+        ClearResumeState();
+    }
+}
+
+void StreamOTAImageProcessor::FinishResume(esp_err_t verify_err)
+{
+    const resume_state_t &saved = m_saved_resume_state;
+    if (verify_err != ESP_OK) {
+        ESP_LOGE(TAG, "The data written to the OTA partition does not match the saved progress");
+        ClearResumeState();
+        return;
+    }
+    esp_ota_handle_t resume_handle;
+    esp_err_t err = esp_ota_resume(m_update_partition, OTA_WITH_SEQUENTIAL_WRITES, saved.written_size, &resume_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to resume the OTA: %s", esp_err_to_name(err));
+        ClearResumeState();
+        return;
+    }
+    esp_ota_abort(m_ota_handle);
+    m_ota_handle = resume_handle;
+    // The digest of the written data continues with the resumed download
+    mbedtls_sha256_clone(&m_sha_ctx, &m_verify.sha_ctx);
+    m_raw_written = saved.written_size;
+    // The resumed payload is always written as is
+    m_payload_checked = true;
+    m_payload_transformed = false;
+    m_resume_state = saved;
+    m_resume_state.resume_count++;
+    SaveResumeState(m_resume_state);
+    ESP_LOGI(TAG, "Resume the download of the OTA image at %" PRIu32 " of %" PRIu64 " bytes", saved.written_size,
+             saved.payload_size);
+    m_resume_skip = saved.written_size;
+}
+
+void StreamOTAImageProcessor::SaveCheckpoint()
+{
+    mbedtls_sha256_context sha_ctx;
+    mbedtls_sha256_init(&sha_ctx);
+    mbedtls_sha256_clone(&sha_ctx, &m_sha_ctx);
+    mbedtls_sha256_finish(&sha_ctx, m_resume_state.written_digest);
+    mbedtls_sha256_free(&sha_ctx);
+    m_resume_state.written_size = m_raw_written;
+    m_resume_state.resume_count = 0;
+    if (SaveResumeState(m_resume_state) == ESP_OK) {
+        ESP_LOGD(TAG, "OTA checkpoint at %u bytes", m_raw_written);
+    }
+}
+
+esp_err_t StreamOTAImageProcessor::LoadResumeState(resume_state_t &state)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open_from_partition(ESP_MATTER_NVS_PART_NAME, k_resume_nvs_namespace, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t len = sizeof(state);
+    err = nvs_get_blob(handle, k_resume_nvs_key, &state, &len);
+    nvs_close(handle);
+    if (err == ESP_OK && len != sizeof(state)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    return err;
+}
+
+esp_err_t StreamOTAImageProcessor::SaveResumeState(const resume_state_t &state)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open_from_partition(ESP_MATTER_NVS_PART_NAME, k_resume_nvs_namespace, NVS_READWRITE, &handle);
+    ESP_RETURN_ON_ERROR(err, TAG, "Failed to open the NVS namespace of the OTA progress");
+    err = nvs_set_blob(handle, k_resume_nvs_key, &state, sizeof(state));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save the OTA progress: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+void StreamOTAImageProcessor::ClearResumeState()
+{
+    nvs_handle_t handle;
+    if (nvs_open_from_partition(ESP_MATTER_NVS_PART_NAME, k_resume_nvs_namespace, NVS_READWRITE, &handle) == ESP_OK) {
+        if (nvs_erase_key(handle, k_resume_nvs_key) == ESP_OK) {
+            nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+}
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+
+CHIP_ERROR StreamOTAImageProcessor::SetBlock(ByteSpan &block)
+{
+    if (!IsSpanUsable(block)) {
+        return CHIP_NO_ERROR;
+    }
+    if (m_block.size() < block.size()) {
+        if (!m_block.empty()) {
+            ReleaseBlock();
+        }
+        uint8_t *block_ptr = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(block.size()));
+        if (block_ptr == nullptr) {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        m_block = MutableByteSpan(block_ptr, block.size());
+    }
+    return CopySpanToMutableSpan(block, m_block);
+}
+
+void StreamOTAImageProcessor::ReleaseBlock()
+{
+    if (m_block.data() != nullptr) {
+        chip::Platform::MemoryFree(m_block.data());
+    }
+    m_block = MutableByteSpan();
+}
+
+} // namespace ota
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_OTA_STREAM_IMAGE_PROCESSOR
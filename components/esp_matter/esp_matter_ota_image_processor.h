@@ -0,0 +1,183 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include <sdkconfig.h>
+
+#include <app/clusters/ota-requestor/OTADownloader.h>
+#include <lib/core/OTAImageHeader.h>
+#include <platform/OTAImageProcessor.h>
+
+namespace esp_matter {
+namespace ota {
+
+/** OTA image processor which transforms the payload of the Matter OTA image while it is downloaded
+ *
+ * The processor writes the application image to the next OTA partition like the platform image processor. When
+ * the payload starts with the magic of the derived processor, the payload header is passed to BeginPayload() and the
+ * rest of the payload to ProcessPayload(), which writes the application image with WriteImage(). Otherwise the
+ * payload is written as is. The encrypted OTA images are not supported by these processors.
+ *
+ * With CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD, the progress of the payloads written as is is saved to NVS at every
+ * checkpoint with the SHA-256 digest of the written data. When the download of the same image restarts, after a reboot
+ * or a link loss, the written data is verified against the digest and the download resumes from the checkpoint: the
+ * processor asks the provider to skip the downloaded bytes with a BDX BlockQueryWithSkip.
+ *
+ * The digests of the data already in flash are computed in slices of k_verify_slice_size bytes, each slice is a work
+ * item of the Matter task, so that hashing an image of several megabytes does not stall the Matter stack. The block
+ * being processed waits for the result before its remaining data is processed.
+ */
+class StreamOTAImageProcessor : public chip::OTAImageProcessorInterface {
+public:
+    static constexpr size_t k_payload_magic_len = 4;
+    static constexpr size_t k_max_payload_header_len = 64;
+    static constexpr size_t k_verify_slice_size = 16 * 1024;
+
+    //////////// OTAImageProcessorInterface Implementation ///////////////
+    CHIP_ERROR PrepareDownload() override;
+    CHIP_ERROR Finalize() override;
+    CHIP_ERROR Apply() override;
+    CHIP_ERROR Abort() override;
+    CHIP_ERROR ProcessBlock(chip::ByteSpan &block) override;
+    bool IsFirstImageRun() override;
+    CHIP_ERROR ConfirmCurrentImage() override;
+
+    void SetOTADownloader(chip::OTADownloader *downloader) { m_downloader = downloader; }
+
+    // Processor which writes the payload as is
+    StreamOTAImageProcessor() = default;
+
+protected:
+    StreamOTAImageProcessor(const uint8_t (&magic)[k_payload_magic_len], size_t header_len);
+
+    // Called with the payload header, which starts with the magic
+    virtual esp_err_t BeginPayload(const uint8_t *header) { return ESP_ERR_NOT_SUPPORTED; }
+    virtual esp_err_t ProcessPayload(const uint8_t *data, size_t size) { return ESP_ERR_NOT_SUPPORTED; }
+    // Called when the download is complete, return an error if the application image is incomplete
+    virtual esp_err_t EndPayload() { return ESP_OK; }
+    virtual void AbortPayload() {}
+
+    esp_err_t WriteImage(const uint8_t *data, size_t size);
+
+    /**
+     * Verify the SHA-256 digest of the first bytes of a partition, to be called from BeginPayload()
+     *
+     * The digest is computed after BeginPayload() returns and before ProcessPayload() is called, the download fails
+     * if it does not match.
+     *
+     * @param[in] partition Partition to verify.
+     * @param[in] size Number of bytes to verify from the beginning of the partition.
+     * @param[in] digest Expected SHA-256 digest.
+     *
+     * @return ESP_OK on success.
+     * @return error in case of failure.
+     */
+    esp_err_t VerifyPartition(const esp_partition_t *partition, size_t size, const uint8_t *digest);
+
+    const esp_partition_t *m_update_partition = nullptr;
+
+private:
+    static void HandlePrepareDownload(intptr_t context);
+    static void HandleFinalize(intptr_t context);
+    static void HandleAbort(intptr_t context);
+    static void HandleProcessBlock(intptr_t context);
+    static void HandleApply(intptr_t context);
+    static void HandleVerifySlice(intptr_t context);
+
+    enum verify_kind_t : uint8_t {
+        VERIFY_NONE = 0,
+        // Data the payload depends on, requested by BeginPayload()
+        VERIFY_PAYLOAD,
+        // Data written before the download was interrupted
+        VERIFY_RESUME,
+    };
+
+    // Process the current block from m_block_offset, stop when a verification is pending
+    void ContinueBlock();
+    void FailBlock(CHIP_ERROR error);
+    esp_err_t StartVerification(verify_kind_t kind, const esp_partition_t *partition, size_t size,
+                                const uint8_t *digest);
+    void FinishVerification(esp_err_t err);
+    void StopVerification();
+
+    CHIP_ERROR ProcessHeader(chip::ByteSpan &block);
+    esp_err_t ProcessBlockPayload(chip::ByteSpan &block);
+    // Write the payload as is
+    esp_err_t WriteRawPayload(const uint8_t *data, size_t size);
+    CHIP_ERROR SetBlock(chip::ByteSpan &block);
+    void ReleaseBlock();
+
+#if CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+    // Progress of the download saved to NVS, the identity of the image comes first
+    typedef struct {
+        uint32_t software_version;
+        uint32_t partition_address;
+        uint64_t payload_size;
+        uint8_t image_digest[32];
+        // Number of payload bytes written to the partition and their SHA-256 digest
+        uint32_t written_size;
+        uint8_t written_digest[32];
+        // Number of resumptions since the last checkpoint
+        uint8_t resume_count;
+    } resume_state_t;
+
+    // Start the verification of the data written before the interruption if the saved progress is for this image
+    void Resume(const chip::OTAImageHeader &header);
+    // Resume the download once the written data is verified, the download starts over if the verification failed
+    void FinishResume(esp_err_t verify_err);
+    void SaveCheckpoint();
+    static esp_err_t LoadResumeState(resume_state_t &state);
+    static esp_err_t SaveResumeState(const resume_state_t &state);
+    static void ClearResumeState();
+
+    resume_state_t m_resume_state;
+    resume_state_t m_saved_resume_state;
+    mbedtls_sha256_context m_sha_ctx = {};
+    size_t m_raw_written = 0;
+    // Payload bytes to skip before writing, after a resumption
+    size_t m_resume_skip = 0;
+#endif // CONFIG_ESP_MATTER_OTA_RESUMABLE_DOWNLOAD
+
+    chip::OTADownloader *m_downloader = nullptr;
+    chip::OTAImageHeaderParser m_header_parser;
+    chip::MutableByteSpan m_block;
+    // Offset of the data of m_block which is not processed yet
+    size_t m_block_offset = 0;
+    esp_ota_handle_t m_ota_handle = 0;
+
+    // No magic for the processor which writes the payload as is
+    const uint8_t *m_magic = nullptr;
+    size_t m_payload_header_len = 0;
+    uint8_t m_payload_header[k_max_payload_header_len];
+    size_t m_payload_header_received = 0;
+    bool m_payload_checked = false;
+    bool m_payload_transformed = false;
+
+    struct {
+        verify_kind_t kind = VERIFY_NONE;
+        const esp_partition_t *partition = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+        uint8_t digest[32];
+        uint8_t *buf = nullptr;
+        mbedtls_sha256_context sha_ctx;
+    } m_verify;
+};
+
+} // namespace ota
+} // namespace esp_matter
@@ -0,0 +1,150 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <sdkconfig.h>
+#include <string.h>
+
+#include <esp_matter_mem.h>
+#include <esp_matter_ota_lzss_decoder.h>
+
+#if CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
+static const char *TAG = "esp_matter_ota";
+
+namespace esp_matter {
+namespace ota {
+
+esp_err_t lzss_decoder::init(uint8_t window_bits, uint8_t lookahead_bits, size_t output_size,
+                             output_callback_t callback, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(window_bits >= 4 && window_bits <= CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE_MAX_WINDOW_BITS,
+                        ESP_ERR_NOT_SUPPORTED, TAG, "Unsupported window size: %u bits", window_bits);
+    ESP_RETURN_ON_FALSE(lookahead_bits >= 3 && lookahead_bits < window_bits, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Unsupported lookahead size: %u bits", lookahead_bits);
+    ESP_RETURN_ON_FALSE(callback, ESP_ERR_INVALID_ARG, TAG, "callback cannot be NULL");
+    deinit();
+    // The back-references before the start of the output read zeros
+    m_window = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_REQUESTOR, 1, 1 << window_bits);
+    m_output = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_REQUESTOR, 1, k_output_buffer_size);
+    if (!m_window || !m_output) {
+        deinit();
+        ESP_LOGE(TAG, "Failed to allocate the decompression buffers");
+        return ESP_ERR_NO_MEM;
+    }
+    m_window_mask = (1 << window_bits) - 1;
+    m_window_bits = window_bits;
+    m_lookahead_bits = lookahead_bits;
+    m_state = STATE_TAG;
+    m_bits_needed = 1;
+    m_bits = 0;
+    m_index = 0;
+    m_produced = 0;
+    m_output_len = 0;
+    m_output_size = output_size;
+    m_callback = callback;
+    m_ctx = ctx;
+    return ESP_OK;
+}
+
+void lzss_decoder::deinit()
+{
+    if (m_window) {
+        esp_matter_mem_free_tagged(m_window);
+        m_window = nullptr;
+    }
+    if (m_output) {
+        esp_matter_mem_free_tagged(m_output);
+        m_output = nullptr;
+    }
+}
+
+esp_err_t lzss_decoder::flush()
+{
+    if (m_output_len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = m_callback(m_output, m_output_len, m_ctx);
+    m_output_len = 0;
+    return err;
+}
+
+esp_err_t lzss_decoder::emit(uint8_t byte)
+{
+    m_window[m_produced & m_window_mask] = byte;
+    m_output[m_output_len++] = byte;
+    m_produced++;
+    if (m_output_len == k_output_buffer_size || m_produced == m_output_size) {
+        return flush();
+    }
+    return ESP_OK;
+}
+
+esp_err_t lzss_decoder::decode(const uint8_t *data, size_t size)
+{
+    ESP_RETURN_ON_FALSE(m_window, ESP_ERR_INVALID_STATE, TAG, "Decoder is not initialized");
+    for (size_t i = 0; i < size && m_produced < m_output_size; ++i) {
+        for (int bit = 7; bit >= 0 && m_produced < m_output_size; --bit) {
+            m_bits = (m_bits << 1) | ((data[i] >> bit) & 1);
+            if (--m_bits_needed > 0) {
+                continue;
+            }
+            switch (m_state) {
+            case STATE_TAG:
+                if (m_bits) {
+                    m_state = STATE_LITERAL;
+                    m_bits_needed = 8;
+                } else {
+                    m_state = STATE_INDEX;
+                    m_bits_needed = m_window_bits;
+                }
+                break;
+            case STATE_LITERAL:
+                ESP_RETURN_ON_ERROR(emit(m_bits), TAG, "Failed to write the decompressed data");
+                m_state = STATE_TAG;
+                m_bits_needed = 1;
+                break;
+            case STATE_INDEX:
+                m_index = m_bits + 1;
+                m_state = STATE_COUNT;
+                m_bits_needed = m_lookahead_bits;
+                break;
+            case STATE_COUNT:
+                // The bytes are copied one by one, so the back-reference could overlap the bytes it produces
+                for (uint32_t count = m_bits + 1; count > 0 && m_produced < m_output_size; --count) {
+                    ESP_RETURN_ON_ERROR(emit(m_window[(m_produced - m_index) & m_window_mask]), TAG,
+                                        "Failed to write the decompressed data");
+                }
+                m_state = STATE_TAG;
+                m_bits_needed = 1;
+                break;
+            }
+            m_bits = 0;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t lzss_decoder::finish()
+{
+    ESP_RETURN_ON_FALSE(m_produced == m_output_size, ESP_ERR_INVALID_SIZE, TAG,
+                        "Truncated compressed image: %u of %u bytes decompressed", static_cast<unsigned>(m_produced),
+                        static_cast<unsigned>(m_output_size));
+    return flush();
+}
+
+} // namespace ota
+} // namespace esp_matter
+
+#endif // CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE
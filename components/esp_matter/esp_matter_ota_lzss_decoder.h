@@ -0,0 +1,104 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace ota {
+
+static constexpr uint8_t k_compressed_image_magic[4] = {'E', 'S', 'P', 'Z'};
+static constexpr uint8_t k_compressed_image_version = 1;
+
+/** Header of a compressed application image, at the beginning of the payload of the Matter OTA image
+ *
+ * The compressed data follows the header. It is a LZSS bit stream with the layout of heatshrink, most significant
+ * bit first: a 1 bit followed by a 8-bit literal, or a 0 bit followed by the distance minus 1 on window_bits bits and
+ * the length minus 1 on lookahead_bits bits. The images are generated by tools/ota_compress/ota_compress.py.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t magic[4];
+    uint8_t version;
+    uint8_t window_bits;
+    uint8_t lookahead_bits;
+    uint8_t reserved;
+    uint32_t image_size;
+} compressed_image_header_t;
+
+/** Streaming LZSS decoder with a window of 2^window_bits bytes */
+class lzss_decoder {
+public:
+    using output_callback_t = esp_err_t (*)(const uint8_t *data, size_t size, void *ctx);
+
+    ~lzss_decoder() { deinit(); }
+
+    /**
+     * Initialize the decoder
+     *
+     * @param[in] window_bits Window size of the stream in bits.
+     * @param[in] lookahead_bits Maximum match length of the stream in bits.
+     * @param[in] output_size Number of bytes to decode, the padding bits after them are ignored.
+     * @param[in] callback Callback called with chunks of the decoded data.
+     * @param[in] ctx Context of the callback.
+     *
+     * @return ESP_OK on success.
+     * @return error in case of failure.
+     */
+    esp_err_t init(uint8_t window_bits, uint8_t lookahead_bits, size_t output_size, output_callback_t callback,
+                   void *ctx);
+
+    void deinit();
+
+    /** Decode a chunk of the stream, the output is flushed to the callback when the output buffer is full */
+    esp_err_t decode(const uint8_t *data, size_t size);
+
+    /** Flush the remaining output, return an error if the stream is truncated */
+    esp_err_t finish();
+
+    size_t get_output_size() { return m_produced; }
+
+private:
+    enum state_t : uint8_t {
+        STATE_TAG = 0,
+        STATE_LITERAL,
+        STATE_INDEX,
+        STATE_COUNT,
+    };
+
+    static constexpr size_t k_output_buffer_size = 4096;
+
+    esp_err_t emit(uint8_t byte);
+    esp_err_t flush();
+
+    uint8_t *m_window = nullptr;
+    uint8_t *m_output = nullptr;
+    size_t m_output_len = 0;
+    uint32_t m_window_mask = 0;
+    uint8_t m_window_bits = 0;
+    uint8_t m_lookahead_bits = 0;
+    state_t m_state = STATE_TAG;
+    uint8_t m_bits_needed = 1;
+    uint32_t m_bits = 0;
+    uint32_t m_index = 0;
+    size_t m_produced = 0;
+    size_t m_output_size = 0;
+    output_callback_t m_callback = nullptr;
+    void *m_ctx = nullptr;
+};
+
+} // namespace ota
+} // namespace esp_matter
@@ -66,7 +66,7 @@ static esp_err_t nvs_get_val(const char *nvs_namespace, const char *attribute_ke
             // This function will only be called when recovering the non-volatile attributes during reboot
             // Add we should not decrease the size of the attribute value
             len = std::max(len, static_cast<size_t>(val.val.a.s));
-            uint8_t *buffer = (uint8_t *)esp_matter_mem_calloc(1, len);
+            uint8_t *buffer = (uint8_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_DATA_MODEL, 1, len);
             if (!buffer) {
                 err = ESP_ERR_NO_MEM;
             } else {
@@ -82,7 +82,7 @@ void SinglyLinkedList<T>::remove(T **head, T *target)
         p = &(*p)->next;
     }
     *p = target->next;
-    free(target);
+    esp_matter_mem_free_tagged(target);
 }
 
 template <typename T>
@@ -91,7 +91,7 @@ void SinglyLinkedList<T>::delete_list(T **head)
     T *current = *head;
     while (current) {
         T *next = current->next;
-        free(current);
+        esp_matter_mem_free_tagged(current);
         current = next;
     }
     *head = nullptr;
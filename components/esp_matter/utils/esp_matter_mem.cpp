@@ -16,7 +16,12 @@
 #include "esp_heap_caps.h"
 #include "esp_matter_mem.h"
 
-IRAM_ATTR void *esp_matter_mem_calloc(size_t n, size_t size)
+#if CONFIG_ESP_MATTER_MEM_ACCOUNTING
+#include "freertos/FreeRTOS.h"
+#include <assert.h>
+#endif
+
+static IRAM_ATTR void *mem_calloc(size_t n, size_t size)
 {
 #if CONFIG_ESP_MATTER_MEM_ALLOC_MODE_INTERNAL
     return heap_caps_calloc(n, size, MALLOC_CAP_INTERNAL|MALLOC_CAP_8BIT);
@@ -29,7 +34,7 @@ IRAM_ATTR void *esp_matter_mem_calloc(size_t n, size_t size)
 #endif
 }
 
-IRAM_ATTR void *esp_matter_mem_realloc(void *ptr, size_t size)
+static IRAM_ATTR void *mem_realloc(void *ptr, size_t size)
 {
 #if CONFIG_ESP_MATTER_MEM_ALLOC_MODE_INTERNAL
     return heap_caps_realloc(ptr, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
@@ -42,6 +47,161 @@ IRAM_ATTR void *esp_matter_mem_realloc(void *ptr, size_t size)
 #endif
 }
 
+#if CONFIG_ESP_MATTER_MEM_ACCOUNTING
+/* Each accounted allocation is prefixed with this 8-byte header. The heap blocks are 4-byte aligned on ESP32 (TLSF),
+ * the header is a multiple of 8 bytes so the returned pointer keeps the alignment of the heap block, whatever it is.
+ * Only the tagged functions look for the header, they must only be given the pointers of the tagged allocations. The
+ * magic catches the other pointers in debug builds. */
+typedef struct {
+    uint32_t magic_tag;
+    uint32_t size;
+} mem_header_t;
+
+#define MEM_HEADER_MAGIC 0x4D454D00 /* "MEM" */
+#define MEM_HEADER_MAGIC_MASK 0xFFFFFF00
+
+static esp_matter_mem_stats_t s_mem_stats[ESP_MATTER_MEM_TAG_MAX];
+static portMUX_TYPE s_mem_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *s_mem_tag_names[ESP_MATTER_MEM_TAG_MAX] = {
+    "other", "data-model", "bridge", "client", "ota-requestor", "ota-provider",
+};
+
+static IRAM_ATTR void account_alloc(esp_matter_mem_tag_t tag, size_t size)
+{
+    portENTER_CRITICAL_SAFE(&s_mem_stats_mux);
+    esp_matter_mem_stats_t &stats = s_mem_stats[tag];
+    stats.current += size;
+    stats.count++;
+    stats.total_count++;
+    if (stats.current > stats.peak) {
+        stats.peak = stats.current;
+    }
+    if (stats.current > stats.high_water) {
+        stats.high_water = stats.current;
+    }
+    portEXIT_CRITICAL_SAFE(&s_mem_stats_mux);
+}
+
+static IRAM_ATTR void account_free(esp_matter_mem_tag_t tag, size_t size)
+{
+    portENTER_CRITICAL_SAFE(&s_mem_stats_mux);
+    s_mem_stats[tag].current -= size;
+    s_mem_stats[tag].count--;
+    portEXIT_CRITICAL_SAFE(&s_mem_stats_mux);
+}
+
+static IRAM_ATTR mem_header_t *get_header(void *ptr)
+{
+    mem_header_t *header = (mem_header_t *)ptr - 1;
+    assert((header->magic_tag & MEM_HEADER_MAGIC_MASK) == MEM_HEADER_MAGIC &&
+           (header->magic_tag & ~MEM_HEADER_MAGIC_MASK) < ESP_MATTER_MEM_TAG_MAX);
+    return header;
+}
+
+static IRAM_ATTR void *set_header(mem_header_t *header, esp_matter_mem_tag_t tag, size_t size)
+{
+    header->magic_tag = MEM_HEADER_MAGIC | tag;
+    header->size = size;
+    account_alloc(tag, size);
+    return header + 1;
+}
+
+IRAM_ATTR void *esp_matter_mem_calloc_tagged(esp_matter_mem_tag_t tag, size_t n, size_t size)
+{
+    if (tag >= ESP_MATTER_MEM_TAG_MAX || (size != 0 && n > (UINT32_MAX - sizeof(mem_header_t)) / size)) {
+        return NULL;
+    }
+    mem_header_t *header = (mem_header_t *)mem_calloc(1, n * size + sizeof(mem_header_t));
+    return header ? set_header(header, tag, n * size) : NULL;
+}
+
+IRAM_ATTR void *esp_matter_mem_realloc_tagged(esp_matter_mem_tag_t tag, void *ptr, size_t size)
+{
+    if (tag >= ESP_MATTER_MEM_TAG_MAX || size > UINT32_MAX - sizeof(mem_header_t)) {
+        return NULL;
+    }
+    if (!ptr) {
+        mem_header_t *header = (mem_header_t *)mem_realloc(NULL, size + sizeof(mem_header_t));
+        return header ? set_header(header, tag, size) : NULL;
+    }
+    if (size == 0) {
+        esp_matter_mem_free_tagged(ptr);
+        return NULL;
+    }
+    mem_header_t *header = get_header(ptr);
+    esp_matter_mem_tag_t old_tag = (esp_matter_mem_tag_t)(header->magic_tag & ~MEM_HEADER_MAGIC_MASK);
+    size_t old_size = header->size;
+    header = (mem_header_t *)mem_realloc(header, size + sizeof(mem_header_t));
+    if (!header) {
+        return NULL;
+    }
+    account_free(old_tag, old_size);
+    return set_header(header, tag, size);
+}
+
+IRAM_ATTR void esp_matter_mem_free_tagged(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    mem_header_t *header = get_header(ptr);
+    account_free((esp_matter_mem_tag_t)(header->magic_tag & ~MEM_HEADER_MAGIC_MASK), header->size);
+    header->magic_tag = 0;
+    free(header);
+}
+
+esp_err_t esp_matter_mem_get_stats(esp_matter_mem_tag_t tag, esp_matter_mem_stats_t *stats)
+{
+    if (tag >= ESP_MATTER_MEM_TAG_MAX || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&s_mem_stats_mux);
+    *stats = s_mem_stats[tag];
+    portEXIT_CRITICAL(&s_mem_stats_mux);
+    return ESP_OK;
+}
+
+const char *esp_matter_mem_get_tag_name(esp_matter_mem_tag_t tag)
+{
+    return tag < ESP_MATTER_MEM_TAG_MAX ? s_mem_tag_names[tag] : "unknown";
+}
+
+void esp_matter_mem_reset_peak()
+{
+    portENTER_CRITICAL(&s_mem_stats_mux);
+    for (size_t i = 0; i < ESP_MATTER_MEM_TAG_MAX; ++i) {
+        s_mem_stats[i].peak = s_mem_stats[i].current;
+    }
+    portEXIT_CRITICAL(&s_mem_stats_mux);
+}
+#else
+IRAM_ATTR void *esp_matter_mem_calloc_tagged(esp_matter_mem_tag_t tag, size_t n, size_t size)
+{
+    return mem_calloc(n, size);
+}
+
+IRAM_ATTR void *esp_matter_mem_realloc_tagged(esp_matter_mem_tag_t tag, void *ptr, size_t size)
+{
+    return mem_realloc(ptr, size);
+}
+
+IRAM_ATTR void esp_matter_mem_free_tagged(void *ptr)
+{
+    free(ptr);
+}
+#endif // CONFIG_ESP_MATTER_MEM_ACCOUNTING
+
+IRAM_ATTR void *esp_matter_mem_calloc(size_t n, size_t size)
+{
+    return mem_calloc(n, size);
+}
+
+IRAM_ATTR void *esp_matter_mem_realloc(void *ptr, size_t size)
+{
+    return mem_realloc(ptr, size);
+}
+
 IRAM_ATTR void esp_matter_mem_free(void *ptr)
 {
     free(ptr);
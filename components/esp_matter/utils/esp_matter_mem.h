@@ -14,7 +14,32 @@
 
 #pragma once
 
+#include <esp_err.h>
+#include <sdkconfig.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Subsystems the ESP Matter memory allocations are accounted to */
+typedef enum {
+    /** Tagged allocations without a subsystem */
+    ESP_MATTER_MEM_TAG_OTHER = 0,
+    /** Data model: nodes, endpoints, clusters, attributes, commands and events */
+    ESP_MATTER_MEM_TAG_DATA_MODEL,
+    /** Bridged devices */
+    ESP_MATTER_MEM_TAG_BRIDGE,
+    /** Client requests */
+    ESP_MATTER_MEM_TAG_CLIENT,
+    /** OTA requestor image processors */
+    ESP_MATTER_MEM_TAG_OTA_REQUESTOR,
+    /** OTA provider candidates, downloads and image cache */
+    ESP_MATTER_MEM_TAG_OTA_PROVIDER,
+    ESP_MATTER_MEM_TAG_MAX,
+} esp_matter_mem_tag_t;
+
 /** ESP Matter Memory Allocations
+ *
+ * The allocation is not accounted, it is freed with `esp_matter_mem_free()`.
+ *
  * @param[in] n number of elements to be allocated
  * @param[in] size size of elements to be allocated
  */
@@ -30,3 +55,67 @@ void esp_matter_mem_free(void *ptr);
  * @param[in] size size to reallocate
  */
 void *esp_matter_mem_realloc(void *ptr, size_t size);
+
+/** ESP Matter Memory Allocations accounted to a subsystem
+ *
+ * The memory is freed with `esp_matter_mem_free_tagged()`. With CONFIG_ESP_MATTER_MEM_ACCOUNTING, the allocation is
+ * prefixed with an accounting header, so it must not be given to `esp_matter_mem_free()`, `esp_matter_mem_realloc()`
+ * or `free()`.
+ *
+ * @param[in] tag subsystem the allocation is accounted to
+ * @param[in] n number of elements to be allocated
+ * @param[in] size size of elements to be allocated
+ */
+void *esp_matter_mem_calloc_tagged(esp_matter_mem_tag_t tag, size_t n, size_t size);
+
+/** ESP Matter realloc accounted to a subsystem
+ *
+ * The allocation is accounted to the new tag after the reallocation.
+ *
+ * @param[in] tag subsystem the allocation is accounted to
+ * @param[in] ptr  NULL, or a pointer from `esp_matter_mem_calloc_tagged()` or `esp_matter_mem_realloc_tagged()`
+ * @param[in] size size to reallocate
+ */
+void *esp_matter_mem_realloc_tagged(esp_matter_mem_tag_t tag, void *ptr, size_t size);
+
+/** ESP Matter Free Memory accounted to a subsystem
+ * @param[in] ptr NULL, or a pointer from `esp_matter_mem_calloc_tagged()` or `esp_matter_mem_realloc_tagged()`
+ */
+void esp_matter_mem_free_tagged(void *ptr);
+
+#if CONFIG_ESP_MATTER_MEM_ACCOUNTING
+/** Memory accounting of a subsystem */
+typedef struct {
+    /** Bytes currently allocated */
+    size_t current;
+    /** Largest number of bytes allocated since the last `esp_matter_mem_reset_peak()` */
+    size_t peak;
+    /** Largest number of bytes allocated since boot */
+    size_t high_water;
+    /** Allocations currently alive */
+    uint32_t count;
+    /** Allocations since boot */
+    uint32_t total_count;
+} esp_matter_mem_stats_t;
+
+/** Get the memory accounting of a subsystem
+ *
+ * The sizes are the requested sizes, without the 8 bytes of accounting header of each allocation and the heap
+ * overhead.
+ *
+ * @param[in] tag subsystem
+ * @param[out] stats memory accounting of the subsystem
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t esp_matter_mem_get_stats(esp_matter_mem_tag_t tag, esp_matter_mem_stats_t *stats);
+
+/** Get the name of a subsystem
+ * @param[in] tag subsystem
+ */
+const char *esp_matter_mem_get_tag_name(esp_matter_mem_tag_t tag);
+
+/** Reset the peak of all the subsystems to their current usage */
+void esp_matter_mem_reset_peak();
+#endif // CONFIG_ESP_MATTER_MEM_ACCOUNTING
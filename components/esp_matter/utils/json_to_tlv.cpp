@@ -12,7 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <algorithm>
 #include <cJSON.h>
 #include <esp_check.h>
 #include <esp_matter_mem.h>
@@ -20,6 +19,7 @@
 #include <lib/support/Base64.h>
 #include <lib/support/SafeInt.h>
 
+#include <limits>
 #include <stdlib.h>
 
 using namespace chip;
@@ -31,38 +31,210 @@ constexpr uint32_t k_temporary_implicit_profile_id = 0xFF01;
 namespace esp_matter {
 
 constexpr size_t k_max_json_name_len = 64;
+// Maximum nesting depth of the JSON containers, this bounds the stack usage of the recursive encoder.
+constexpr uint8_t k_max_nesting_depth = 16;
+// Maximum member count of a JSON object whose members are not in tag order and need to be sorted.
+constexpr size_t k_max_sorted_members = 32;
+// The strings and byte strings shorter than this are decoded on the stack.
+constexpr size_t k_stack_decode_buf_size = 64;
+// max(strlen("-1.7976931348623157e+308")) with some margin for the leading zeros
+constexpr size_t k_max_number_len = 40;
 
-struct element_context {
-    element_context() {}
-    ~element_context() {}
-    char json_name[k_max_json_name_len];
-    TLV::Tag tag = chip::TLV::AnonymousTag();
-    TLV::TLVElementType type;
-    TLV::TLVElementType sub_type;
+typedef enum {
+    JSON_VALUE_STRING = 0,
+    JSON_VALUE_NUMBER,
+    JSON_VALUE_TRUE,
+    JSON_VALUE_FALSE,
+    JSON_VALUE_NULL,
+} json_value_type_t;
+
+/* A JSON scalar value. The strings are not copied and still point into the JSON input. */
+struct json_scalar {
+    json_value_type_t type;
+    const char *str = nullptr;
+    size_t str_len = 0;
+    bool str_escaped = false;
+    bool is_integer = false;
+    bool is_negative = false;
+    uint64_t magnitude = 0;
+    double double_val = 0;
 };
 
-static int compare_by_tag(const void *a, const void *b)
-{
-    const element_context *element_a = (const element_context *)a;
-    const element_context *element_b = (const element_context *)b;
-    if (TLV::IsContextTag(element_a->tag) == TLV::IsContextTag(element_b->tag)) {
-        return (int)TLV::TagNumFromTag(element_a->tag) - (int)TLV::TagNumFromTag(element_b->tag);
+/* Member of a JSON object which is collected only when the object members are not in tag order */
+struct member_entry {
+    TLV::Tag tag = TLV::AnonymousTag();
+    TLVElementType type = TLVElementType::NotSpecified;
+    TLVElementType sub_type = TLVElementType::NotSpecified;
+    const char *value_start = nullptr;
+};
+
+class json_tokenizer {
+public:
+    json_tokenizer(const char *json, size_t len) : m_pos(json), m_end(json + len) {}
+
+    char peek()
+    {
+        skip_whitespace();
+        return m_pos < m_end ? *m_pos : 0;
     }
-    return TLV::IsContextTag(element_a->tag);
-}
 
-static size_t get_char_count(const char *str, char ch)
-{
-    size_t ret = 0;
-    if (!str) {
-        return ret;
+    bool consume(char ch)
+    {
+        if (peek() == ch) {
+            m_pos++;
+            return true;
+        }
+        return false;
     }
-    for (size_t i = 0; i < strlen(str); ++i) {
-        if (ch == str[i]) {
-            ret++;
+
+    bool at_end() { return peek() == 0; }
+
+    const char *position() const { return m_pos; }
+
+    void set_position(const char *pos) { m_pos = pos; }
+
+    esp_err_t read_string(const char *&start, size_t &len, bool &escaped)
+    {
+        ESP_RETURN_ON_FALSE(consume('"'), ESP_ERR_INVALID_ARG, TAG, "Expected string");
+        start = m_pos;
+        escaped = false;
+        while (m_pos < m_end && *m_pos != '"') {
+            if (*m_pos == '\\') {
+                escaped = true;
+                m_pos++;
+            } else if ((unsigned char)*m_pos < 0x20) {
+                ESP_LOGE(TAG, "Control character in string");
+                return ESP_ERR_INVALID_ARG;
+            }
+            m_pos++;
         }
+        ESP_RETURN_ON_FALSE(m_pos < m_end, ESP_ERR_INVALID_ARG, TAG, "Unterminated string");
+        len = m_pos - start;
+        m_pos++;
+        return ESP_OK;
     }
-    return ret;
+
+    esp_err_t read_scalar(json_scalar &val)
+    {
+        char ch = peek();
+        if (ch == '"') {
+            val.type = JSON_VALUE_STRING;
+            return read_string(val.str, val.str_len, val.str_escaped);
+        } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            val.type = JSON_VALUE_NUMBER;
+            return read_number(val);
+        } else if (read_literal("true")) {
+            val.type = JSON_VALUE_TRUE;
+            return ESP_OK;
+        } else if (read_literal("false")) {
+            val.type = JSON_VALUE_FALSE;
+            return ESP_OK;
+        } else if (read_literal("null")) {
+            val.type = JSON_VALUE_NULL;
+            return ESP_OK;
+        }
+        ESP_LOGE(TAG, "Invalid JSON value");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t skip_value(uint8_t depth)
+    {
+        ESP_RETURN_ON_FALSE(depth < k_max_nesting_depth, ESP_ERR_INVALID_ARG, TAG, "Nesting too deep");
+        char ch = peek();
+        if (ch == '{' || ch == '[') {
+            char close = ch == '{' ? '}' : ']';
+            m_pos++;
+            if (consume(close)) {
+                return ESP_OK;
+            }
+            do {
+                if (ch == '{') {
+                    const char *key;
+                    size_t key_len;
+                    bool key_escaped;
+                    ESP_RETURN_ON_ERROR(read_string(key, key_len, key_escaped), TAG, "Invalid object key");
+                    ESP_RETURN_ON_FALSE(consume(':'), ESP_ERR_INVALID_ARG, TAG, "Expected ':'");
+                }
+                ESP_RETURN_ON_ERROR(skip_value(depth + 1), TAG, "Invalid JSON value");
+            } while (consume(','));
+            ESP_RETURN_ON_FALSE(consume(close), ESP_ERR_INVALID_ARG, TAG, "Unterminated container");
+            return ESP_OK;
+        }
+        json_scalar val;
+        return read_scalar(val);
+    }
+
+private:
+    void skip_whitespace()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) {
+            m_pos++;
+        }
+    }
+
+    bool read_literal(const char *literal)
+    {
+        size_t len = strlen(literal);
+        if ((size_t)(m_end - m_pos) >= len && strncmp(m_pos, literal, len) == 0) {
+            m_pos += len;
+            return true;
+        }
+        return false;
+    }
+
+    esp_err_t read_number(json_scalar &val)
+    {
+        const char *start = m_pos;
+        val.is_negative = (*m_pos == '-');
+        if (val.is_negative) {
+            m_pos++;
+        }
+        val.is_integer = true;
+        val.magnitude = 0;
+        bool overflow = false;
+        const char *digits_start = m_pos;
+        while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') {
+            uint64_t digit = *m_pos - '0';
+            if (val.magnitude > (UINT64_MAX - digit) / 10) {
+                overflow = true;
+            }
+            val.magnitude = val.magnitude * 10 + digit;
+            m_pos++;
+        }
+        ESP_RETURN_ON_FALSE(m_pos > digits_start, ESP_ERR_INVALID_ARG, TAG, "Invalid number");
+        while (m_pos < m_end && ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '.' || *m_pos == 'e' ||
+                                 *m_pos == 'E' || *m_pos == '+' || *m_pos == '-')) {
+            val.is_integer = false;
+            m_pos++;
+        }
+        size_t len = m_pos - start;
+        ESP_RETURN_ON_FALSE(len < k_max_number_len, ESP_ERR_INVALID_ARG, TAG, "Number too long");
+        char number[k_max_number_len];
+        memcpy(number, start, len);
+        number[len] = 0;
+        char *number_end = nullptr;
+        val.double_val = strtod(number, &number_end);
+        ESP_RETURN_ON_FALSE(number_end == number + len, ESP_ERR_INVALID_ARG, TAG, "Invalid number");
+        if (overflow) {
+            val.is_integer = false;
+        }
+        return ESP_OK;
+    }
+
+    const char *m_pos;
+    const char *m_end;
+};
+
+static int compare_tags(const TLV::Tag &a, const TLV::Tag &b)
+{
+    bool is_context_a = TLV::IsContextTag(a);
+    bool is_context_b = TLV::IsContextTag(b);
+    if (is_context_a != is_context_b) {
+        return is_context_a ? 1 : -1;
+    }
+    uint32_t tag_num_a = TLV::TagNumFromTag(a);
+    uint32_t tag_num_b = TLV::TagNumFromTag(b);
+    return tag_num_a < tag_num_b ? -1 : (tag_num_a > tag_num_b ? 1 : 0);
 }
 
 static bool is_unsigned_integer(const char *str, size_t len)
@@ -135,24 +307,39 @@ static esp_err_t type_str_to_tlv_element_type(const char *type_str, size_t len,
     return ESP_ERR_INVALID_ARG;
 }
 
-static esp_err_t split_json_name(const char *json_name, uint64_t &tag_number, TLVElementType &type,
+static size_t get_char_count(const char *str, size_t len, char ch)
+{
+    size_t ret = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (ch == str[i]) {
+            ret++;
+        }
+    }
+    return ret;
+}
+
+static esp_err_t split_json_name(const char *json_name, size_t len, uint64_t &tag_number, TLVElementType &type,
                                  TLVElementType &subtype)
 {
-    size_t split_char_count = get_char_count(json_name, ':');
+    const char *json_name_end = json_name + len;
+    size_t split_char_count = get_char_count(json_name, len, ':');
     ESP_RETURN_ON_FALSE(split_char_count == 1 || split_char_count == 2, ESP_ERR_INVALID_ARG, TAG,
                         "Invalid json name format");
-    ESP_RETURN_ON_FALSE(strchr(json_name, ':'), ESP_ERR_INVALID_ARG, TAG, "Invalid json name format");
-    const char *tag_start = split_char_count == 1 ? json_name : strchr(json_name, ':') + 1;
-    ESP_RETURN_ON_FALSE(strchr(tag_start, ':'), ESP_ERR_INVALID_ARG, TAG, "Invalid json name format");
-    const char *type_start = strchr(tag_start, ':') + 1;
+    const char *tag_start =
+        split_char_count == 1 ? json_name : (const char *)memchr(json_name, ':', len) + 1;
+    const char *type_start = (const char *)memchr(tag_start, ':', json_name_end - tag_start) + 1;
     size_t tag_len = type_start - tag_start - 1;
-    const char *subtype_prev = strchr(type_start, '-');
-    const char *subtype_start = subtype_prev ? subtype_prev + 1 : 0;
-    size_t type_len = subtype_start ? subtype_start - type_start - 1 : strlen(type_start);
-    size_t subtype_len = subtype_start ? strlen(subtype_start) : 0;
+    const char *subtype_prev = (const char *)memchr(type_start, '-', json_name_end - type_start);
+    const char *subtype_start = subtype_prev ? subtype_prev + 1 : nullptr;
+    size_t type_len = subtype_start ? subtype_prev - type_start : json_name_end - type_start;
+    size_t subtype_len = subtype_start ? json_name_end - subtype_start : 0;
 
     ESP_RETURN_ON_FALSE(is_unsigned_integer(tag_start, tag_len), ESP_ERR_INVALID_ARG, TAG, "Not an unsigned integer");
-    tag_number = strtoull(tag_start, NULL, 10);
+    ESP_RETURN_ON_FALSE(tag_len <= 10, ESP_ERR_INVALID_ARG, TAG, "Tag number too large");
+    tag_number = 0;
+    for (size_t i = 0; i < tag_len; ++i) {
+        tag_number = tag_number * 10 + (tag_start[i] - '0');
+    }
     ESP_RETURN_ON_ERROR(type_str_to_tlv_element_type(type_start, type_len, type), TAG,
                         "Failed to convert json_type_str to tlv element type");
     ESP_RETURN_ON_FALSE(type != TLVElementType::NotSpecified, ESP_ERR_INVALID_ARG, TAG,
@@ -180,31 +367,160 @@ static esp_err_t internal_convert_tlv_tag(const uint64_t tag_number, TLV::Tag &t
     return ESP_OK;
 }
 
-static esp_err_t parse_json_name(const char *name, element_context &element_ctx, uint32_t implicit_profile_id)
+static int hex_char_to_int(char ch)
 {
+    if ('A' <= ch && ch <= 'F') {
+        return 10 + ch - 'A';
+    } else if ('a' <= ch && ch <= 'f') {
+        return 10 + ch - 'a';
+    } else if ('0' <= ch && ch <= '9') {
+        return ch - '0';
+    }
+    return -1;
+}
+
+static esp_err_t parse_hex4(const char *str, const char *end, uint32_t &code_point)
+{
+    ESP_RETURN_ON_FALSE(end - str >= 4, ESP_ERR_INVALID_ARG, TAG, "Invalid unicode escape");
+    code_point = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        int digit = hex_char_to_int(str[i]);
+        ESP_RETURN_ON_FALSE(digit >= 0, ESP_ERR_INVALID_ARG, TAG, "Invalid unicode escape");
+        code_point = (code_point << 4) | digit;
+    }
+    return ESP_OK;
+}
+
+/* Decode the escape sequences of a JSON string. The output is never longer than the input. */
+static esp_err_t unescape_json_string(const char *str, size_t len, char *out, size_t &out_len)
+{
+    const char *end = str + len;
+    out_len = 0;
+    while (str < end) {
+        if (*str != '\\') {
+            out[out_len++] = *str++;
+            continue;
+        }
+        str++;
+        ESP_RETURN_ON_FALSE(str < end, ESP_ERR_INVALID_ARG, TAG, "Invalid escape");
+        char ch = *str++;
+        switch (ch) {
+        case '"':
+        case '\\':
+        case '/':
+            out[out_len++] = ch;
+            break;
+        case 'b':
+            out[out_len++] = '\b';
+            break;
+        case 'f':
+            out[out_len++] = '\f';
+            break;
+        case 'n':
+            out[out_len++] = '\n';
+            break;
+        case 'r':
+            out[out_len++] = '\r';
+            break;
+        case 't':
+            out[out_len++] = '\t';
+            break;
+        case 'u': {
+            uint32_t code_point = 0;
+            ESP_RETURN_ON_ERROR(parse_hex4(str, end, code_point), TAG, "Invalid escape");
+            str += 4;
+            if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                uint32_t low_surrogate = 0;
+                ESP_RETURN_ON_FALSE(end - str >= 6 && str[0] == '\\' && str[1] == 'u', ESP_ERR_INVALID_ARG, TAG,
+                                    "Invalid surrogate pair");
+                ESP_RETURN_ON_ERROR(parse_hex4(str + 2, end, low_surrogate), TAG, "Invalid escape");
+                ESP_RETURN_ON_FALSE(low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF, ESP_ERR_INVALID_ARG, TAG,
+                                    "Invalid surrogate pair");
+                str += 6;
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+            }
+            if (code_point < 0x80) {
+                out[out_len++] = code_point;
+            } else if (code_point < 0x800) {
+                out[out_len++] = 0xC0 | (code_point >> 6);
+                out[out_len++] = 0x80 | (code_point & 0x3F);
+            } else if (code_point < 0x10000) {
+                out[out_len++] = 0xE0 | (code_point >> 12);
+                out[out_len++] = 0x80 | ((code_point >> 6) & 0x3F);
+                out[out_len++] = 0x80 | (code_point & 0x3F);
+            } else {
+                out[out_len++] = 0xF0 | (code_point >> 18);
+                out[out_len++] = 0x80 | ((code_point >> 12) & 0x3F);
+                out[out_len++] = 0x80 | ((code_point >> 6) & 0x3F);
+                out[out_len++] = 0x80 | (code_point & 0x3F);
+            }
+            break;
+        }
+        default:
+            ESP_LOGE(TAG, "Invalid escape");
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+/* Scratch buffer that uses the stack for the short strings and the heap for the long ones */
+class decode_buffer {
+public:
+    char *alloc(size_t size)
+    {
+        if (size <= sizeof(m_stack_buf)) {
+            return m_stack_buf;
+        }
+        m_heap_buf.Alloc(size);
+        return m_heap_buf.Get();
+    }
+
+private:
+    char m_stack_buf[k_stack_decode_buf_size];
+    Platform::ScopedMemoryBuffer<char> m_heap_buf;
+};
+
+static esp_err_t get_string(const json_scalar &val, decode_buffer &buf, const char *&str, size_t &len)
+{
+    ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_STRING, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    if (!val.str_escaped) {
+        str = val.str;
+        len = val.str_len;
+        return ESP_OK;
+    }
+    char *out = buf.alloc(val.str_len);
+    ESP_RETURN_ON_FALSE(out, ESP_ERR_NO_MEM, TAG, "No memory");
+    ESP_RETURN_ON_ERROR(unescape_json_string(val.str, val.str_len, out, len), TAG, "Invalid string");
+    str = out;
+    return ESP_OK;
+}
+
+static esp_err_t parse_json_name(const char *name, size_t len, bool escaped, member_entry &member,
+                                 uint32_t implicit_profile_id)
+{
+    char unescaped_name[k_max_json_name_len];
+    if (escaped) {
+        ESP_RETURN_ON_FALSE(len <= sizeof(unescaped_name), ESP_ERR_INVALID_ARG, TAG, "json name too long");
+        ESP_RETURN_ON_ERROR(unescape_json_string(name, len, unescaped_name, len), TAG, "Invalid json name");
+        name = unescaped_name;
+    }
     uint64_t tag_number = 0;
-    ESP_RETURN_ON_FALSE(name, ESP_ERR_INVALID_ARG, TAG, "json name cannot be NULL");
-    ESP_RETURN_ON_ERROR(split_json_name(name, tag_number, element_ctx.type, element_ctx.sub_type), TAG,
+    ESP_RETURN_ON_ERROR(split_json_name(name, len, tag_number, member.type, member.sub_type), TAG,
                         "Failed to parse json name");
-    ESP_RETURN_ON_ERROR(internal_convert_tlv_tag(tag_number, element_ctx.tag, implicit_profile_id), TAG,
+    ESP_RETURN_ON_ERROR(internal_convert_tlv_tag(tag_number, member.tag, implicit_profile_id), TAG,
                         "Failed to convert TLV tag");
-    strncpy(element_ctx.json_name, name, strlen(name));
-    element_ctx.json_name[strlen(name)] = 0;
     return ESP_OK;
 }
 
-static bool is_valid_base64_str(const char *str)
+static bool is_valid_base64_str(const char *str, size_t len)
 {
     const char *base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    if (!str) {
-        return false;
-    }
-    size_t len = strlen(str);
     if (len % 4 != 0) {
         return false;
     }
     size_t padding_len = 0;
-    if (str[len - 1] == '=') {
+    if (len > 0 && str[len - 1] == '=') {
         padding_len++;
         if (str[len - 2] == '=') {
             padding_len++;
@@ -218,230 +534,463 @@ static bool is_valid_base64_str(const char *str)
     return true;
 }
 
-static size_t get_object_element_count(const cJSON *json)
+static esp_err_t get_int64(const json_scalar &val, int64_t min, int64_t max, int64_t &out)
 {
-    ESP_RETURN_ON_FALSE(json->type == cJSON_Object, 0, TAG, "Invalid type");
-    size_t ret = 0;
-    cJSON *current_element = json->child;
-    while (current_element) {
-        current_element = current_element->next;
-        ret++;
+    ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_NUMBER, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    if (val.is_integer) {
+        if (val.is_negative) {
+            ESP_RETURN_ON_FALSE(val.magnitude <= (uint64_t)INT64_MAX + 1, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+            out = (int64_t)(0 - val.magnitude);
+        } else {
+            ESP_RETURN_ON_FALSE(val.magnitude <= (uint64_t)INT64_MAX, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+            out = (int64_t)val.magnitude;
+        }
+    } else {
+        ESP_RETURN_ON_FALSE(val.double_val >= (double)INT64_MIN && val.double_val < (double)INT64_MAX,
+                            ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+        out = (int64_t)val.double_val;
     }
-    return ret;
+    ESP_RETURN_ON_FALSE(out >= min && out <= max, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+    return ESP_OK;
 }
 
-static esp_err_t encode_tlv_element(const cJSON *val, TLV::TLVWriter &writer, const element_context &element_ctx)
+static esp_err_t get_uint64(const json_scalar &val, uint64_t max, uint64_t &out)
 {
-    TLV::Tag tag = element_ctx.tag;
-
-    switch (element_ctx.type) {
-    case TLVElementType::Int8: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(val->valueint <= INT8_MAX && val->valueint >= INT8_MIN, ESP_ERR_INVALID_ARG, TAG,
+    ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_NUMBER, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    if (val.is_integer) {
+        ESP_RETURN_ON_FALSE(!val.is_negative || val.magnitude == 0, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+        out = val.magnitude;
+    } else {
+        ESP_RETURN_ON_FALSE(val.double_val >= 0 && val.double_val < (double)UINT64_MAX, ESP_ERR_INVALID_ARG, TAG,
                             "Invalid range");
-        int8_t int8_val = val->valueint;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, int8_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
+        out = (uint64_t)val.double_val;
     }
-    case TLVElementType::Int16: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(val->valueint <= INT16_MAX && val->valueint >= INT16_MIN, ESP_ERR_INVALID_ARG, TAG,
-                            "Invalid range");
-        int16_t int16_val = val->valueint;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, int16_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
+    ESP_RETURN_ON_FALSE(out <= max, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
+    return ESP_OK;
+}
+
+/* The 64-bit integers could also be represented as strings since they might not fit in a JSON number. */
+static esp_err_t string_to_number(const json_scalar &val, json_scalar &number)
+{
+    ESP_RETURN_ON_FALSE(!val.str_escaped && val.str_len > 0, ESP_ERR_INVALID_ARG, TAG, "Invalid number");
+    json_tokenizer tokenizer(val.str, val.str_len);
+    ESP_RETURN_ON_ERROR(tokenizer.read_scalar(number), TAG, "Invalid number");
+    ESP_RETURN_ON_FALSE(number.type == JSON_VALUE_NUMBER && tokenizer.at_end(), ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid number");
+    return ESP_OK;
+}
+
+template <typename T>
+static esp_err_t get_floating_point(const json_scalar &val, T &out)
+{
+    if (val.type == JSON_VALUE_NUMBER) {
+        out = static_cast<T>(val.double_val);
+        return ESP_OK;
     }
-    case TLVElementType::Int32: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        int32_t int32_val = val->valueint;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, int32_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
+    ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_STRING, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    if (val.str_len == strlen(element_type::k_floating_point_positive_infinity) &&
+        strncmp(val.str, element_type::k_floating_point_positive_infinity, val.str_len) == 0) {
+        out = std::numeric_limits<T>::infinity();
+    } else if (val.str_len == strlen(element_type::k_floating_point_negative_infinity) &&
+               strncmp(val.str, element_type::k_floating_point_negative_infinity, val.str_len) == 0) {
+        out = -std::numeric_limits<T>::infinity();
+    } else {
+        return ESP_ERR_INVALID_ARG;
     }
+    return ESP_OK;
+}
+
+static esp_err_t encode_tlv_scalar(const json_scalar &val, TLV::TLVWriter &writer, TLV::Tag tag,
+                                   TLVElementType type)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    switch (type) {
+    case TLVElementType::Int8:
+    case TLVElementType::Int16:
+    case TLVElementType::Int32:
     case TLVElementType::Int64: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number || val->type == cJSON_String, ESP_ERR_INVALID_ARG, TAG,
-                            "Invalid type");
-        int64_t int64_val = 0;
-        if (val->type == cJSON_Number) {
-            int64_val =
-                (val->valueint < INT32_MAX && val->valueint > INT32_MIN) ? val->valueint : (int64_t)val->valuedouble;
+        int64_t int_val = 0;
+        json_scalar number;
+        const json_scalar &num_val =
+            (type == TLVElementType::Int64 && val.type == JSON_VALUE_STRING && string_to_number(val, number) == ESP_OK)
+            ? number
+            : val;
+        if (type == TLVElementType::Int8) {
+            ESP_RETURN_ON_ERROR(get_int64(num_val, INT8_MIN, INT8_MAX, int_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<int8_t>(int_val));
+        } else if (type == TLVElementType::Int16) {
+            ESP_RETURN_ON_ERROR(get_int64(num_val, INT16_MIN, INT16_MAX, int_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<int16_t>(int_val));
+        } else if (type == TLVElementType::Int32) {
+            ESP_RETURN_ON_ERROR(get_int64(num_val, INT32_MIN, INT32_MAX, int_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<int32_t>(int_val));
         } else {
-            int64_val = strtoll(val->valuestring, nullptr, 10);
+            ESP_RETURN_ON_ERROR(get_int64(num_val, INT64_MIN, INT64_MAX, int_val), TAG, "Invalid value");
+            err = writer.Put(tag, int_val);
         }
-        ESP_RETURN_ON_FALSE(writer.Put(tag, int64_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
-    }
-    case TLVElementType::UInt8: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(val->valueint <= UINT8_MAX && val->valueint >= 0, ESP_ERR_INVALID_ARG, TAG,
-                            "Invalid range");
-        uint8_t uint8_val = val->valueint;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, uint8_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
-    }
-    case TLVElementType::UInt16: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(val->valueint <= UINT16_MAX && val->valueint >= 0, ESP_ERR_INVALID_ARG, TAG,
-                            "Invalid range");
-        uint16_t uint16_val = val->valueint;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, uint16_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        break;
-    }
-    case TLVElementType::UInt32: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(val->valueint >= 0, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
-        uint32_t uint32_val = val->valueint < INT32_MAX ? val->valueint : (uint32_t)val->valuedouble;
-        ESP_RETURN_ON_FALSE(writer.Put(tag, uint32_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
         break;
     }
+    case TLVElementType::UInt8:
+    case TLVElementType::UInt16:
+    case TLVElementType::UInt32:
     case TLVElementType::UInt64: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Number || val->type == cJSON_String, ESP_ERR_INVALID_ARG, TAG,
-                            "Invalid type");
-        uint64_t uint64_val = 0;
-        if (val->type == cJSON_Number) {
-            ESP_RETURN_ON_FALSE(val->valueint >= 0, ESP_ERR_INVALID_ARG, TAG, "Invalid range");
-            uint64_val = val->valueint < INT32_MAX ? val->valueint : (uint64_t)val->valuedouble;
+        uint64_t uint_val = 0;
+        json_scalar number;
+        const json_scalar &num_val =
+            (type == TLVElementType::UInt64 && val.type == JSON_VALUE_STRING && string_to_number(val, number) == ESP_OK)
+            ? number
+            : val;
+        if (type == TLVElementType::UInt8) {
+            ESP_RETURN_ON_ERROR(get_uint64(num_val, UINT8_MAX, uint_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<uint8_t>(uint_val));
+        } else if (type == TLVElementType::UInt16) {
+            ESP_RETURN_ON_ERROR(get_uint64(num_val, UINT16_MAX, uint_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<uint16_t>(uint_val));
+        } else if (type == TLVElementType::UInt32) {
+            ESP_RETURN_ON_ERROR(get_uint64(num_val, UINT32_MAX, uint_val), TAG, "Invalid value");
+            err = writer.Put(tag, static_cast<uint32_t>(uint_val));
         } else {
-            uint64_val = strtoull(val->valuestring, nullptr, 10);
+            ESP_RETURN_ON_ERROR(get_uint64(num_val, UINT64_MAX, uint_val), TAG, "Invalid value");
+            err = writer.Put(tag, uint_val);
         }
-        ESP_RETURN_ON_FALSE(writer.Put(tag, uint64_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
         break;
     }
     case TLVElementType::FloatingPointNumber32: {
-        if (val->type == cJSON_Number) {
-            float float_val = val->valuedouble;
-            ESP_RETURN_ON_FALSE(writer.Put(tag, float_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        } else if (val->type == cJSON_String) {
-            if (strcmp(val->valuestring, element_type::k_floating_point_positive_infinity) == 0) {
-                ESP_RETURN_ON_FALSE(writer.Put(tag, std::numeric_limits<float>::infinity()) == CHIP_NO_ERROR, ESP_FAIL,
-                                    TAG, "Failed to encode");
-            } else if (strcmp(val->valuestring, element_type::k_floating_point_negative_infinity) == 0) {
-                ESP_RETURN_ON_FALSE(writer.Put(tag, -std::numeric_limits<float>::infinity()) == CHIP_NO_ERROR, ESP_FAIL,
-                                    TAG, "Failed to encode");
-            } else {
-                return ESP_ERR_INVALID_ARG;
-            }
-        } else {
-            ESP_LOGE(TAG, "Invalid type");
-            return ESP_ERR_INVALID_ARG;
-        }
+        float float_val = 0;
+        ESP_RETURN_ON_ERROR(get_floating_point(val, float_val), TAG, "Invalid value");
+        err = writer.Put(tag, float_val);
         break;
     }
     case TLVElementType::FloatingPointNumber64: {
-        if (val->type == cJSON_Number) {
-            double double_val = val->valuedouble;
-            ESP_RETURN_ON_FALSE(writer.Put(tag, double_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
-        } else if (val->type == cJSON_String) {
-            if (strcmp(val->valuestring, element_type::k_floating_point_positive_infinity) == 0) {
-                ESP_RETURN_ON_FALSE(writer.Put(tag, std::numeric_limits<double>::infinity()) == CHIP_NO_ERROR, ESP_FAIL,
-                                    TAG, "Failed to encode");
-            } else if (strcmp(val->valuestring, element_type::k_floating_point_negative_infinity) == 0) {
-                ESP_RETURN_ON_FALSE(writer.Put(tag, -std::numeric_limits<double>::infinity()) == CHIP_NO_ERROR,
-                                    ESP_FAIL, TAG, "Failed to encode");
-            } else {
-                return ESP_ERR_INVALID_ARG;
-            }
-        } else {
-            ESP_LOGE(TAG, "Invalid type");
-            return ESP_ERR_INVALID_ARG;
-        }
+        double double_val = 0;
+        ESP_RETURN_ON_ERROR(get_floating_point(val, double_val), TAG, "Invalid value");
+        err = writer.Put(tag, double_val);
         break;
     }
     case TLVElementType::BooleanTrue:
     case TLVElementType::BooleanFalse: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_False || val->type == cJSON_True, ESP_ERR_INVALID_ARG, TAG,
+        ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_TRUE || val.type == JSON_VALUE_FALSE, ESP_ERR_INVALID_ARG, TAG,
                             "Invalid type");
-        bool bool_val = (val->type == cJSON_True);
-        ESP_RETURN_ON_FALSE(writer.Put(tag, bool_val) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
+        err = writer.Put(tag, val.type == JSON_VALUE_TRUE);
         break;
     }
     case TLVElementType::ByteString_1ByteLength: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_String && val->valuestring, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        size_t encoded_len = strlen(val->valuestring);
-        ESP_RETURN_ON_FALSE(chip::CanCastTo<uint16_t>(encoded_len), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(is_valid_base64_str(val->valuestring), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        Platform::ScopedMemoryBuffer<uint8_t> byte_str;
-        byte_str.Alloc(BASE64_MAX_DECODED_LEN(static_cast<uint16_t>(encoded_len)));
-        ESP_RETURN_ON_FALSE(byte_str.Get(), ESP_ERR_NO_MEM, TAG, "No memory");
-        auto decoded_len = Base64Decode(val->valuestring, static_cast<uint16_t>(encoded_len), byte_str.Get());
-        ESP_RETURN_ON_FALSE(writer.PutBytes(tag, byte_str.Get(), decoded_len) == CHIP_NO_ERROR, ESP_FAIL, TAG,
-                            "Failed to encode");
+        decode_buffer str_buf;
+        const char *str = nullptr;
+        size_t str_len = 0;
+        ESP_RETURN_ON_ERROR(get_string(val, str_buf, str, str_len), TAG, "Invalid type");
+        ESP_RETURN_ON_FALSE(chip::CanCastTo<uint16_t>(str_len), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+        ESP_RETURN_ON_FALSE(is_valid_base64_str(str, str_len), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+        decode_buffer byte_buf;
+        uint8_t *byte_str = (uint8_t *)byte_buf.alloc(BASE64_MAX_DECODED_LEN(static_cast<uint16_t>(str_len)));
+        ESP_RETURN_ON_FALSE(byte_str, ESP_ERR_NO_MEM, TAG, "No memory");
+        uint16_t decoded_len = Base64Decode(str, static_cast<uint16_t>(str_len), byte_str);
+        ESP_RETURN_ON_FALSE(decoded_len != UINT16_MAX, ESP_ERR_INVALID_ARG, TAG, "Invalid base64 string");
+        err = writer.PutBytes(tag, byte_str, decoded_len);
         break;
     }
     case TLVElementType::UTF8String_1ByteLength: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_String, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(writer.PutString(tag, val->valuestring) == CHIP_NO_ERROR, ESP_FAIL, TAG,
-                            "Failed to encode");
+        decode_buffer str_buf;
+        const char *str = nullptr;
+        size_t str_len = 0;
+        ESP_RETURN_ON_ERROR(get_string(val, str_buf, str, str_len), TAG, "Invalid type");
+        ESP_RETURN_ON_FALSE(chip::CanCastTo<uint32_t>(str_len), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+        err = writer.PutString(tag, str, static_cast<uint32_t>(str_len));
         break;
     }
     case TLVElementType::Null: {
-        ESP_RETURN_ON_FALSE(val->type == cJSON_NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        ESP_RETURN_ON_FALSE(writer.PutNull(tag) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
+        ESP_RETURN_ON_FALSE(val.type == JSON_VALUE_NULL, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+        err = writer.PutNull(tag);
         break;
     }
-    case TLVElementType::Array: {
-        TLV::TLVType container_type;
-        esp_err_t err = ESP_OK;
-        size_t array_size = cJSON_GetArraySize(val);
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Array, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        if (element_ctx.sub_type == TLV::TLVElementType::NotSpecified) {
-            ESP_RETURN_ON_FALSE(array_size == 0, ESP_ERR_INVALID_ARG, TAG, "Invalid array size");
+    default:
+        ESP_LOGE(TAG, "Invalid type");
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_RETURN_ON_FALSE(err == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to encode");
+    return ESP_OK;
+}
+
+static esp_err_t encode_tlv_structure(json_tokenizer &tokenizer, TLV::TLVWriter &writer, TLV::Tag tag,
+                                      uint8_t depth);
+
+static esp_err_t encode_tlv_element(json_tokenizer &tokenizer, TLV::TLVWriter &writer, TLV::Tag tag,
+                                    TLVElementType type, TLVElementType sub_type, uint8_t depth)
+{
+    ESP_RETURN_ON_FALSE(depth < k_max_nesting_depth, ESP_ERR_INVALID_ARG, TAG, "Nesting too deep");
+    if (type == TLVElementType::Structure) {
+        return encode_tlv_structure(tokenizer, writer, tag, depth);
+    } else if (type != TLVElementType::Array) {
+        json_scalar val;
+        ESP_RETURN_ON_ERROR(tokenizer.read_scalar(val), TAG, "Invalid JSON value");
+        return encode_tlv_scalar(val, writer, tag, type);
+    }
+
+    TLV::TLVType container_type;
+    esp_err_t err = ESP_OK;
+    ESP_RETURN_ON_FALSE(tokenizer.consume('['), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Array, container_type) == CHIP_NO_ERROR, ESP_FAIL,
+                        TAG, "Failed to start container");
+    if (!tokenizer.consume(']')) {
+        if (sub_type == TLVElementType::NotSpecified) {
+            ESP_LOGE(TAG, "Invalid array size");
+            return ESP_ERR_INVALID_ARG;
         }
-        ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Array, container_type) == CHIP_NO_ERROR, ESP_FAIL,
-                            TAG, "Failed to start container");
-        element_context nested_element_ctx;
-        nested_element_ctx.tag = TLV::AnonymousTag();
-        nested_element_ctx.type = element_ctx.sub_type;
-        for (size_t i = 0; i < array_size; ++i) {
-            if ((err = encode_tlv_element(cJSON_GetArrayItem(val, i), writer, nested_element_ctx)) != ESP_OK) {
+        do {
+            // The array elements are anonymous. The subtype of nested arrays is not specified so they must be empty.
+            err = encode_tlv_element(tokenizer, writer, TLV::AnonymousTag(), sub_type, TLVElementType::NotSpecified,
+                                     depth + 1);
+            if (err != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to encode");
-                writer.EndContainer(container_type);
                 return err;
             }
-        }
-        ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
-        break;
+        } while (tokenizer.consume(','));
+        ESP_RETURN_ON_FALSE(tokenizer.consume(']'), ESP_ERR_INVALID_ARG, TAG, "Unterminated array");
+    }
+    ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
+    return ESP_OK;
+}
+
+static esp_err_t read_member_name(json_tokenizer &tokenizer, member_entry &member, uint32_t implicit_profile_id)
+{
+    const char *name = nullptr;
+    size_t name_len = 0;
+    bool escaped = false;
+    ESP_RETURN_ON_ERROR(tokenizer.read_string(name, name_len, escaped), TAG, "Invalid json name");
+    ESP_RETURN_ON_ERROR(parse_json_name(name, name_len, escaped, member, implicit_profile_id), TAG,
+                        "Failed to parse json name");
+    ESP_RETURN_ON_FALSE(tokenizer.consume(':'), ESP_ERR_INVALID_ARG, TAG, "Expected ':'");
+    return ESP_OK;
+}
+
+/* Encode a JSON object whose members are not in tag order. The member names are collected in a first pass over
+ * the object and the values are encoded in tag order in a second pass. */
+static esp_err_t encode_tlv_sorted_structure(json_tokenizer &tokenizer, TLV::TLVWriter &writer, TLV::Tag tag,
+                                             uint8_t depth)
+{
+    // The member table is on the heap since this could be nested up to k_max_nesting_depth times.
+    Platform::ScopedMemoryBuffer<member_entry> members;
+    size_t member_count = 0;
+    esp_err_t err = ESP_OK;
+
+    ESP_RETURN_ON_FALSE(tokenizer.consume('{'), ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    if (!tokenizer.consume('}')) {
+        ESP_RETURN_ON_FALSE(members.Calloc(k_max_sorted_members), ESP_ERR_NO_MEM, TAG, "No memory");
+        do {
+            ESP_RETURN_ON_FALSE(member_count < k_max_sorted_members, ESP_ERR_NO_MEM, TAG,
+                                "Too many unsorted members in json object");
+            member_entry &member = members[member_count];
+            ESP_RETURN_ON_ERROR(read_member_name(tokenizer, member, writer.ImplicitProfileId), TAG,
+                                "Failed to read member name");
+            member.value_start = tokenizer.position();
+            ESP_RETURN_ON_ERROR(tokenizer.skip_value(depth + 1), TAG, "Invalid JSON value");
+            // Insertion sort, the member count is small and the members are usually almost sorted.
+            size_t idx = member_count++;
+            member_entry current = member;
+            while (idx > 0 && compare_tags(members[idx - 1].tag, current.tag) > 0) {
+                members[idx] = members[idx - 1];
+                idx--;
+            }
+            members[idx] = current;
+        } while (tokenizer.consume(','));
+        ESP_RETURN_ON_FALSE(tokenizer.consume('}'), ESP_ERR_INVALID_ARG, TAG, "Unterminated object");
     }
-    case TLVElementType::Structure: {
-        TLV::TLVType container_type;
-        esp_err_t err = ESP_OK;
-        ESP_RETURN_ON_FALSE(val->type == cJSON_Object, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
-        size_t element_count = get_object_element_count(val);
-        auto element_array = std::make_unique<element_context[]>(element_count);
-        ESP_RETURN_ON_FALSE(element_array.get(), ESP_ERR_NO_MEM, TAG, "No memory for element_array");
-        cJSON *element = val->child;
-        size_t element_idx = 0;
-        while (element && element_idx < element_count) {
-            ESP_RETURN_ON_ERROR(parse_json_name(element->string, element_array[element_idx], writer.ImplicitProfileId),
-                                TAG, "Failed to parse json name");
-            element = element->next;
-            element_idx++;
+    const char *object_end = tokenizer.position();
+
+    TLV::TLVType container_type;
+    ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Structure, container_type) == CHIP_NO_ERROR,
+                        ESP_FAIL, TAG, "Failed to start container");
+    for (size_t i = 0; i < member_count; ++i) {
+        tokenizer.set_position(members[i].value_start);
+        if ((err = encode_tlv_element(tokenizer, writer, members[i].tag, members[i].type, members[i].sub_type,
+                                      depth + 1)) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode");
+            return err;
         }
-        qsort(element_array.get(), element_count, sizeof(element_context), compare_by_tag);
-        ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Structure, container_type) == CHIP_NO_ERROR,
-                            ESP_FAIL, TAG, "Failed to start container");
-        for (element_idx = 0; element_idx < element_count; ++element_idx) {
-            if ((err = encode_tlv_element(cJSON_GetObjectItem(val, element_array[element_idx].json_name), writer,
-                                          element_array[element_idx])) != ESP_OK) {
+    }
+    ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
+    tokenizer.set_position(object_end);
+    return ESP_OK;
+}
+
+/* Encode a JSON object in a single pass. If the members turn out not to be in tag order, the writer is rolled back
+ * and the object is encoded again with encode_tlv_sorted_structure(). */
+static esp_err_t encode_tlv_structure(json_tokenizer &tokenizer, TLV::TLVWriter &writer, TLV::Tag tag,
+                                      uint8_t depth)
+{
+    ESP_RETURN_ON_FALSE(tokenizer.peek() == '{', ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    const char *object_start = tokenizer.position();
+    TLV::TLVWriter checkpoint = writer;
+    TLV::TLVType container_type;
+    esp_err_t err = ESP_OK;
+
+    tokenizer.consume('{');
+    ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Structure, container_type) == CHIP_NO_ERROR,
+                        ESP_FAIL, TAG, "Failed to start container");
+    if (!tokenizer.consume('}')) {
+        bool has_prev_member = false;
+        TLV::Tag prev_tag = TLV::AnonymousTag();
+        do {
+            member_entry member;
+            ESP_RETURN_ON_ERROR(read_member_name(tokenizer, member, writer.ImplicitProfileId), TAG,
+                                "Failed to read member name");
+            if (has_prev_member && compare_tags(prev_tag, member.tag) > 0) {
+                writer = checkpoint;
+                tokenizer.set_position(object_start);
+                return encode_tlv_sorted_structure(tokenizer, writer, tag, depth);
+            }
+            if ((err = encode_tlv_element(tokenizer, writer, member.tag, member.type, member.sub_type, depth + 1)) !=
+                ESP_OK) {
                 ESP_LOGE(TAG, "Failed to encode");
-                writer.EndContainer(container_type);
                 return err;
             }
-        }
-        ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
-        break;
+            prev_tag = member.tag;
+            has_prev_member = true;
+        } while (tokenizer.consume(','));
+        ESP_RETURN_ON_FALSE(tokenizer.consume('}'), ESP_ERR_INVALID_ARG, TAG, "Unterminated object");
     }
-    default:
+    ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
+    return ESP_OK;
+}
+
+/* Encode a JSON object. On failure the writer is rolled back so that it is not left inside an open container. */
+static esp_err_t encode_json_object(json_tokenizer &tokenizer, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag)
+{
+    TLV::TLVWriter checkpoint = writer;
+    esp_err_t err = encode_tlv_structure(tokenizer, writer, tag, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to encode tlv element");
+        writer = checkpoint;
+    }
+    return err;
+}
+
+esp_err_t json_to_tlv(const char *json_str, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag)
+{
+    ESP_RETURN_ON_FALSE(json_str, ESP_ERR_INVALID_ARG, TAG, "json_str cannot be NULL");
+    json_tokenizer tokenizer(json_str, strlen(json_str));
+    TLV::TLVWriter checkpoint = writer;
+    ESP_RETURN_ON_ERROR(encode_json_object(tokenizer, writer, tag), TAG, "Failed to convert json to tlv");
+    if (!tokenizer.at_end()) {
+        ESP_LOGE(TAG, "Unexpected characters after json object");
+        writer = checkpoint;
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/* Member of a cJSON object, collected to encode the members in tag order */
+struct cjson_member {
+    member_entry member;
+    const cJSON *item = nullptr;
+};
+
+/* The cJSON numbers are doubles, the integers are exact up to 2^53 as with cJSON_GetNumberValue(). */
+static esp_err_t cjson_to_scalar(const cJSON *json, json_scalar &val)
+{
+    switch (json->type & 0xFF) {
+    case cJSON_String:
+        ESP_RETURN_ON_FALSE(json->valuestring, ESP_ERR_INVALID_ARG, TAG, "Invalid string");
+        val.type = JSON_VALUE_STRING;
+        val.str = json->valuestring;
+        val.str_len = strlen(json->valuestring);
+        break;
+    case cJSON_Number:
+        val.type = JSON_VALUE_NUMBER;
+        val.double_val = json->valuedouble;
+        break;
+    case cJSON_True:
+        val.type = JSON_VALUE_TRUE;
+        break;
+    case cJSON_False:
+        val.type = JSON_VALUE_FALSE;
         break;
+    case cJSON_NULL:
+        val.type = JSON_VALUE_NULL;
+        break;
+    default:
+        ESP_LOGE(TAG, "Invalid JSON value");
+        return ESP_ERR_INVALID_ARG;
     }
     return ESP_OK;
 }
 
-esp_err_t json_to_tlv(const char *json_str, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag)
+static esp_err_t encode_cjson_element(const cJSON *json, TLV::TLVWriter &writer, TLV::Tag tag, TLVElementType type,
+                                      TLVElementType sub_type, uint8_t depth);
+
+static esp_err_t encode_cjson_structure(const cJSON *json, TLV::TLVWriter &writer, TLV::Tag tag, uint8_t depth)
 {
-    cJSON *json = cJSON_Parse(json_str);
-    esp_err_t err =  json_to_tlv(json, writer, tag);
-    cJSON_Delete(json);
-    return err;
+    ESP_RETURN_ON_FALSE((json->type & 0xFF) == cJSON_Object, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    size_t member_count = 0;
+    for (const cJSON *item = json->child; item; item = item->next) {
+        member_count++;
+    }
+    Platform::ScopedMemoryBuffer<cjson_member> members;
+    if (member_count > 0) {
+        ESP_RETURN_ON_FALSE(members.Calloc(member_count), ESP_ERR_NO_MEM, TAG, "No memory");
+    }
+    size_t idx = 0;
+    for (const cJSON *item = json->child; item; item = item->next, ++idx) {
+        ESP_RETURN_ON_FALSE(item->string, ESP_ERR_INVALID_ARG, TAG, "json name cannot be NULL");
+        cjson_member current;
+        ESP_RETURN_ON_ERROR(parse_json_name(item->string, strlen(item->string), false, current.member,
+                                            writer.ImplicitProfileId),
+                            TAG, "Failed to parse json name");
+        current.item = item;
+        // Insertion sort, the member count is small and the members are usually sorted.
+        size_t pos = idx;
+        while (pos > 0 && compare_tags(members[pos - 1].member.tag, current.member.tag) > 0) {
+            members[pos] = members[pos - 1];
+            pos--;
+        }
+        members[pos] = current;
+    }
+
+    TLV::TLVType container_type;
+    esp_err_t err = ESP_OK;
+    ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Structure, container_type) == CHIP_NO_ERROR,
+                        ESP_FAIL, TAG, "Failed to start container");
+    for (size_t i = 0; i < member_count; ++i) {
+        const member_entry &member = members[i].member;
+        if ((err = encode_cjson_element(members[i].item, writer, member.tag, member.type, member.sub_type,
+                                        depth + 1)) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode");
+            return err;
+        }
+    }
+    ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
+    return ESP_OK;
+}
+
+static esp_err_t encode_cjson_element(const cJSON *json, TLV::TLVWriter &writer, TLV::Tag tag, TLVElementType type,
+                                      TLVElementType sub_type, uint8_t depth)
+{
+    ESP_RETURN_ON_FALSE(depth < k_max_nesting_depth, ESP_ERR_INVALID_ARG, TAG, "Nesting too deep");
+    if (type == TLVElementType::Structure) {
+        return encode_cjson_structure(json, writer, tag, depth);
+    } else if (type != TLVElementType::Array) {
+        json_scalar val;
+        ESP_RETURN_ON_ERROR(cjson_to_scalar(json, val), TAG, "Invalid JSON value");
+        return encode_tlv_scalar(val, writer, tag, type);
+    }
+
+    ESP_RETURN_ON_FALSE((json->type & 0xFF) == cJSON_Array, ESP_ERR_INVALID_ARG, TAG, "Invalid type");
+    ESP_RETURN_ON_FALSE(!json->child || sub_type != TLVElementType::NotSpecified, ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid array size");
+    TLV::TLVType container_type;
+    esp_err_t err = ESP_OK;
+    ESP_RETURN_ON_FALSE(writer.StartContainer(tag, TLV::kTLVType_Array, container_type) == CHIP_NO_ERROR, ESP_FAIL,
+                        TAG, "Failed to start container");
+    for (const cJSON *item = json->child; item; item = item->next) {
+        // The array elements are anonymous. The subtype of nested arrays is not specified so they must be empty.
+        if ((err = encode_cjson_element(item, writer, TLV::AnonymousTag(), sub_type, TLVElementType::NotSpecified,
+                                        depth + 1)) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode");
+            return err;
+        }
+    }
+    ESP_RETURN_ON_FALSE(writer.EndContainer(container_type) == CHIP_NO_ERROR, ESP_FAIL, TAG, "Failed to end container");
+    return ESP_OK;
 }
 
 esp_err_t json_to_tlv(cJSON *json, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag)
@@ -449,18 +998,68 @@ esp_err_t json_to_tlv(cJSON *json, chip::TLV::TLVWriter &writer, chip::TLV::Tag
     if (!json) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (json->type != cJSON_Object) {
+    if ((json->type & 0xFF) != cJSON_Object) {
         return ESP_ERR_INVALID_ARG;
     }
-    element_context element_ctx;
-    element_ctx.type = TLVElementType::Structure;
-    element_ctx.sub_type = TLVElementType::NotSpecified;
-    element_ctx.tag = tag;
-    esp_err_t err = encode_tlv_element(json, writer, element_ctx);
+    // The tree is walked directly, the JSON string parser is only used for the string overloads.
+    TLV::TLVWriter checkpoint = writer;
+    esp_err_t err = encode_cjson_structure(json, writer, tag, 0);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to encode tlv element");
+        writer = checkpoint;
     }
     return err;
 }
 
+esp_err_t json_array_get_size(const char *json_str, size_t &size)
+{
+    ESP_RETURN_ON_FALSE(json_str, ESP_ERR_INVALID_ARG, TAG, "json_str cannot be NULL");
+    json_tokenizer tokenizer(json_str, strlen(json_str));
+    size = 0;
+    if (!tokenizer.consume('[')) {
+        ESP_RETURN_ON_ERROR(tokenizer.skip_value(0), TAG, "Invalid JSON value");
+        ESP_RETURN_ON_FALSE(tokenizer.at_end(), ESP_ERR_INVALID_ARG, TAG, "Unexpected characters after json value");
+        return ESP_OK;
+    }
+    if (!tokenizer.consume(']')) {
+        do {
+            ESP_RETURN_ON_ERROR(tokenizer.skip_value(1), TAG, "Invalid JSON value");
+            size++;
+        } while (tokenizer.consume(','));
+        ESP_RETURN_ON_FALSE(tokenizer.consume(']'), ESP_ERR_INVALID_ARG, TAG, "Unterminated array");
+    }
+    ESP_RETURN_ON_FALSE(tokenizer.at_end(), ESP_ERR_INVALID_ARG, TAG, "Unexpected characters after json array");
+    return ESP_OK;
+}
+
+esp_err_t json_array_item_to_tlv(const char *json_str, size_t index, chip::TLV::TLVWriter &writer,
+                                 chip::TLV::Tag tag, json_array_cursor_t *cursor)
+{
+    ESP_RETURN_ON_FALSE(json_str, ESP_ERR_INVALID_ARG, TAG, "json_str cannot be NULL");
+    bool resume = cursor && cursor->offset != 0 && cursor->index <= index;
+    size_t json_len = resume ? cursor->length : strlen(json_str);
+    json_tokenizer tokenizer(json_str, json_len);
+    size_t skip_count = index;
+    if (resume) {
+        tokenizer.set_position(json_str + cursor->offset);
+        skip_count = index - cursor->index;
+    } else if (!tokenizer.consume('[')) {
+        ESP_RETURN_ON_FALSE(index == 0, ESP_ERR_INVALID_ARG, TAG, "Index out of range");
+        return json_to_tlv(json_str, writer, tag);
+    }
+    for (size_t i = 0; i < skip_count; ++i) {
+        ESP_RETURN_ON_ERROR(tokenizer.skip_value(1), TAG, "Invalid JSON value");
+        ESP_RETURN_ON_FALSE(tokenizer.consume(','), ESP_ERR_INVALID_ARG, TAG, "Index out of range");
+    }
+    ESP_RETURN_ON_ERROR(encode_json_object(tokenizer, writer, tag), TAG, "Failed to convert json to tlv");
+    if (cursor) {
+        // Remember the position of the next item, or start over from the beginning after the last one.
+        bool has_next = tokenizer.consume(',');
+        cursor->index = has_next ? index + 1 : 0;
+        cursor->offset = has_next ? tokenizer.position() - json_str : 0;
+        cursor->length = json_len;
+    }
+    return ESP_OK;
+}
+
 } // namespace esp_matter
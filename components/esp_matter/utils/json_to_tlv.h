@@ -46,6 +46,12 @@ const char k_floating_point_negative_infinity[] = "-INF";
 } // namespace element_type
 
 /** Convert a JSON object to the given TLVWriter
+ *
+ * The JSON string is tokenized and written to the TLVWriter in a single pass without building a cJSON tree. The
+ * members of a JSON object are sorted by their tags only if they are not already in tag order.
+ *
+ * @note On failure the writer is rolled back to its state before the call, so it is never left inside an open
+ *       container and could still be used.
  *
  * @param[in]   json_str The JSON string that represents a TLV structure
  * @param[out]  writer   The TLV output from the JSON object
@@ -57,6 +63,8 @@ const char k_floating_point_negative_infinity[] = "-INF";
 esp_err_t json_to_tlv(const char *json_str, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag);
 
 /** Convert a JSON object to the given TLVWriter
+ *
+ * The cJSON tree is walked directly. The members of a JSON object are sorted by their tags before they are written.
  *
  * @param[in]   json     The JSON object
  * @param[out]  writer   The TLV output from the JSON object
@@ -67,4 +75,43 @@ esp_err_t json_to_tlv(const char *json_str, chip::TLV::TLVWriter &writer, chip::
  */
 esp_err_t json_to_tlv(cJSON *json, chip::TLV::TLVWriter &writer, chip::TLV::Tag tag);
 
+/** Get the item count of a JSON array
+ *
+ * @param[in]   json_str The JSON string
+ * @param[out]  size     The item count, 0 if the JSON value is not an array
+ *
+ * @return ESP_OK on success
+ * @return error in case of failure
+ */
+esp_err_t json_array_get_size(const char *json_str, size_t &size);
+
+/** Position of the next item of a JSON array
+ *
+ * It is updated by json_array_item_to_tlv() so that converting the items of an array one after the other does not
+ * scan the array from its beginning for each item. A zero-initialized cursor starts at the beginning of the array.
+ */
+typedef struct {
+    size_t index;
+    size_t offset;
+    size_t length;
+} json_array_cursor_t;
+
+/** Convert the JSON object at the given index of a JSON array to the given TLVWriter
+ *
+ * @note If the JSON string is not an array, it is treated as an array with a single item.
+ * @note On failure the writer is rolled back to its state before the call.
+ *
+ * @param[in]     json_str The JSON string of an array of JSON objects that represent TLV structures
+ * @param[in]     index    The index of the JSON object in the array
+ * @param[out]    writer   The TLV output from the JSON object
+ * @param[in]     tag      The TLV tag of the TLV structure
+ * @param[in,out] cursor   Optional cursor of the same JSON string, the conversion resumes from it when the index is
+ *                         not before the cursor
+ *
+ * @return ESP_OK on success
+ * @return error in case of failure
+ */
+esp_err_t json_array_item_to_tlv(const char *json_str, size_t index, chip::TLV::TLVWriter &writer,
+                                 chip::TLV::Tag tag, json_array_cursor_t *cursor = nullptr);
+
 } // namespace esp_matter
@@ -295,7 +295,7 @@ device_t *create_device(node_t *node, uint16_t parent_endpoint_id, uint32_t devi
     }
 
     // Create bridged device
-    device_t *dev = (device_t *)esp_matter_mem_calloc(1, sizeof(device_t));
+    device_t *dev = (device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE, 1, sizeof(device_t));
     dev->node = node;
     dev->persistent_info.parent_endpoint_id = parent_endpoint_id;
     bridged_node::config_t bridged_node_config;
@@ -303,7 +303,7 @@ device_t *create_device(node_t *node, uint16_t parent_endpoint_id, uint32_t devi
         bridged_node::create(node, &bridged_node_config, ENDPOINT_FLAG_DESTROYABLE | ENDPOINT_FLAG_BRIDGE, priv_data);
     if (!(dev->endpoint)) {
         ESP_LOGE(TAG, "Could not create esp_matter endpoint for bridged device");
-        esp_matter_mem_free(dev);
+        esp_matter_mem_free_tagged(dev);
         return NULL;
     }
     if (set_device_type(dev, device_type_id, priv_data) != ESP_OK) {
@@ -357,7 +357,7 @@ device_t *resume_device(node_t *node, uint16_t device_endpoint_id, void *priv_da
         ESP_LOGE(TAG, "Parent endpoint is invalid");
         return NULL;
     }
-    device_t *dev = (device_t *)esp_matter_mem_calloc(1, sizeof(device_t));
+    device_t *dev = (device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE, 1, sizeof(device_t));
     dev->node = node;
     dev->persistent_info = persistent_info;
     bridged_node::config_t bridged_node_config;
@@ -365,7 +365,7 @@ device_t *resume_device(node_t *node, uint16_t device_endpoint_id, void *priv_da
                                          device_endpoint_id, priv_data);
     if (!(dev->endpoint)) {
         ESP_LOGE(TAG, "Could not resume esp_matter endpoint for bridged device");
-        esp_matter_mem_free(dev);
+        esp_matter_mem_free_tagged(dev);
         erase_bridged_device_info(device_endpoint_id);
         return NULL;
     }
@@ -393,7 +393,7 @@ esp_err_t remove_device(device_t *bridged_device)
     if (error != ESP_OK) {
         ESP_LOGE(TAG, "Failed to delete bridged endpoint");
     }
-    esp_matter_mem_free(bridged_device);
+    esp_matter_mem_free_tagged(bridged_device);
     return error;
 }
 
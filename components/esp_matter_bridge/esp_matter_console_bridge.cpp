@@ -133,7 +133,7 @@ static esp_err_t remove_bridge_device_handler(int argc, char *argv[])
     } else {
         previous_device->next = current_device->next;
     }
-    esp_matter_mem_free(current_device);
+    esp_matter_mem_free_tagged(current_device);
     ESP_LOGI(TAG, "Removed bridged device (endpoint id 0x%04" PRIX16 ") successfully", endpoint_id);
     return ESP_OK;
 }
@@ -151,19 +151,21 @@ static esp_err_t add_bridge_device_handler(int argc, char *argv[])
         return ESP_ERR_INVALID_ARG;
     }
 
-    cli_bridged_device_t *new_cli_dev = (cli_bridged_device_t *)esp_matter_mem_calloc(1, sizeof(cli_bridged_device_t));
+    cli_bridged_device_t *new_cli_dev =
+        (cli_bridged_device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE,
+                                                             1, sizeof(cli_bridged_device_t));
     ESP_RETURN_ON_FALSE(new_cli_dev != NULL, ESP_ERR_NO_MEM, TAG, "Failed to allocate memory for bridged device");
 
     new_cli_dev->device = esp_matter_bridge::create_device(node, parent_endpoint_id, device_type_id, NULL);
     if (!new_cli_dev->device) {
         ESP_LOGE(TAG, "Failed to create bridged device");
-        esp_matter_mem_free(new_cli_dev);
+        esp_matter_mem_free_tagged(new_cli_dev);
         return ESP_ERR_NO_MEM;
     }
 
     if (esp_matter::endpoint::enable(new_cli_dev->device->endpoint) != ESP_OK) {
         esp_matter_bridge::remove_device(new_cli_dev->device);
-        esp_matter_mem_free(new_cli_dev);
+        esp_matter_mem_free_tagged(new_cli_dev);
         ESP_LOGE(TAG, "Failed to enable endpoint");
         return ESP_ERR_INVALID_STATE;
     }
@@ -201,7 +203,8 @@ static esp_err_t bridge_initialize()
     for (size_t idx = 0; idx < MAX_BRIDGED_DEVICE_COUNT; ++idx) {
         if (matter_endpoint_id_array[idx] != chip::kInvalidEndpointId) {
             cli_bridged_device_t *new_cli_dev =
-                (cli_bridged_device_t *)esp_matter_mem_calloc(1, sizeof(cli_bridged_device_t));
+                (cli_bridged_device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE,
+                                                                     1, sizeof(cli_bridged_device_t));
             if (!(new_cli_dev)) {
                 ESP_LOGE(TAG, "Failed to allocate memory for bridged device");
                 return ESP_ERR_NO_MEM;
@@ -210,14 +213,14 @@ static esp_err_t bridge_initialize()
             new_cli_dev->device = esp_matter_bridge::resume_device(node, matter_endpoint_id_array[idx], NULL);
             if (!(new_cli_dev->device)) {
                 ESP_LOGE(TAG, "Failed to resume the bridged device");
-                esp_matter_mem_free(new_cli_dev);
+                esp_matter_mem_free_tagged(new_cli_dev);
                 continue;
             }
 
             if (esp_matter::endpoint::enable(new_cli_dev->device->endpoint) != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to enable endpoint");
                 esp_matter_bridge::remove_device(new_cli_dev->device);
-                esp_matter_mem_free(new_cli_dev);
+                esp_matter_mem_free_tagged(new_cli_dev);
                 continue;
             }
             new_cli_dev->next = cli_device;
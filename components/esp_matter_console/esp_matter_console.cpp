@@ -46,22 +46,73 @@ void engine::for_each_command(command_iterator_t *on_command, void *arg)
     }
 }
 
-esp_err_t engine::exec_command(int argc, char *argv[])
+static uint32_t hash_name(const char *name)
 {
-    esp_err_t err = ESP_ERR_INVALID_ARG;
-    if (argc <= 0) {
-        return err;
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void engine::add_to_table(const command_t *command)
+{
+    if (!command->name || !command->handler) {
+        return;
+    }
+    uint32_t index = hash_name(command->name) % CONSOLE_COMMAND_TABLE_SIZE;
+    for (unsigned probe = 0; probe < CONSOLE_COMMAND_TABLE_SIZE; ++probe) {
+        const command_t *&slot = _command_table[(index + probe) % CONSOLE_COMMAND_TABLE_SIZE];
+        if (!slot) {
+            slot = command;
+            return;
+        }
+        if (strcmp(slot->name, command->name) == 0) {
+            // The command registered first is executed
+            return;
+        }
+    }
+    _command_table_full = true;
+}
+
+const command_t *engine::find_command(const char *name)
+{
+    uint32_t index = hash_name(name) % CONSOLE_COMMAND_TABLE_SIZE;
+    for (unsigned probe = 0; probe < CONSOLE_COMMAND_TABLE_SIZE; ++probe) {
+        const command_t *slot = _command_table[(index + probe) % CONSOLE_COMMAND_TABLE_SIZE];
+        if (!slot) {
+            break;
+        }
+        if (strcmp(slot->name, name) == 0) {
+            return slot;
+        }
+    }
+    if (!_command_table_full) {
+        return NULL;
     }
     // find the command from the command set
     for (unsigned i = 0; i < _command_set_count; ++i) {
         for (unsigned j = 0; j < _command_set_size[i]; ++j) {
-            if (strcmp(argv[0], _command_set[i][j].name) == 0 && _command_set[i][j].handler) {
-                err = _command_set[i][j].handler(argc - 1, &argv[1]);
-                break;
+            if (strcmp(name, _command_set[i][j].name) == 0 && _command_set[i][j].handler) {
+                return &_command_set[i][j];
             }
         }
     }
-    return err;
+    return NULL;
+}
+
+esp_err_t engine::exec_command(int argc, char *argv[])
+{
+    if (argc <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const command_t *command = find_command(argv[0]);
+    if (!command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return command->handler(argc - 1, &argv[1]);
 }
 
 esp_err_t engine::register_commands(const command_t *command_set, unsigned count)
@@ -74,6 +125,9 @@ esp_err_t engine::register_commands(const command_t *command_set, unsigned count
     _command_set[_command_set_count] = command_set;
     _command_set_size[_command_set_count] = count;
     ++_command_set_count;
+    for (unsigned i = 0; i < count; ++i) {
+        add_to_table(&command_set[i]);
+    }
     return ESP_OK;
 }
 
@@ -105,6 +159,31 @@ static esp_err_t register_default_commands()
     return add_commands(&command, 1);
 }
 
+/* Execute the commands of a batch separated by ';' tokens, such as "matter esp lock stats ; diagnostics mem-dump".
+ * The ';' must be a token on its own, so that the arguments which end with a ';' are passed as they are. All the
+ * commands are executed, the first error is returned. */
+static esp_err_t exec_batch(int argc, char **argv)
+{
+    esp_err_t batch_err = ESP_OK;
+    int start = 0;
+    unsigned index = 0;
+    for (int i = 0; i <= argc; ++i) {
+        if (i < argc && strcmp(argv[i], ";") != 0) {
+            continue;
+        }
+        if (i > start) {
+            esp_err_t err = base_engine.exec_command(i - start, &argv[start]);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Command %u (%s) of the batch failed: %s", index, argv[start], esp_err_to_name(err));
+                batch_err = batch_err == ESP_OK ? err : batch_err;
+            }
+            ++index;
+        }
+        start = i + 1;
+    }
+    return batch_err;
+}
+
 static CHIP_ERROR common_handler(int argc, char **argv)
 {
     /* This common handler is added to avoid adding `CHIP_ERROR` and its component requirements in other esp-matter
@@ -113,7 +192,7 @@ static CHIP_ERROR common_handler(int argc, char **argv)
         help_handler(argc, argv);
         return CHIP_NO_ERROR;
     }
-    return map_matter_error(base_engine.exec_command(argc, argv));
+    return map_matter_error(exec_batch(argc, argv));
 }
 
 static esp_err_t register_common_shell_handler()
@@ -122,7 +201,7 @@ static esp_err_t register_common_shell_handler()
         {
             .cmd_func = common_handler,
             .cmd_name = "esp",
-            .cmd_help = "Usage: matter esp <sub_command>",
+            .cmd_help = "Usage: matter esp <sub_command> [; <sub_command> ...]",
         },
     };
     int cmds_num = sizeof(cmds) / sizeof(chip::Shell::shell_command_t);
@@ -18,6 +18,7 @@
 #include <string.h>
 
 #define CONSOLE_MAX_COMMAND_SETS CONFIG_ESP_MATTER_CONSOLE_MAX_COMMANDS
+#define CONSOLE_COMMAND_TABLE_SIZE CONFIG_ESP_MATTER_CONSOLE_COMMAND_TABLE_SIZE
 
 namespace esp_matter {
 namespace console {
@@ -56,8 +57,15 @@ protected:
     const command_t *_command_set[CONSOLE_MAX_COMMAND_SETS];
     unsigned _command_set_size[CONSOLE_MAX_COMMAND_SETS];
     unsigned _command_set_count;
+    /* Open addressing hash table of the commands with a handler, indexed by the hash of their names. The commands
+     * which do not fit are found by walking the command sets. */
+    const command_t *_command_table[CONSOLE_COMMAND_TABLE_SIZE];
+    bool _command_table_full;
+
+    void add_to_table(const command_t *command);
+    const command_t *find_command(const char *name);
 public:
-    engine(): _command_set_count(0) {}
+    engine(): _command_set_count(0), _command_table(), _command_table_full(false) {}
 
     /** Execution callback for a console command.
      *
@@ -77,6 +85,8 @@ public:
     esp_err_t exec_command(int argc, char *argv[]);
 
     /** Registers a command set, or array of commands with the console.
+     *
+     * When several commands have the same name, only the one registered first is executed.
      *
      * @param command_set[in] An array of commands to add to the console.
      * @param count[in]       The number of commands in the command set array.
@@ -164,5 +174,25 @@ esp_err_t udc_register_commands();
  */
 esp_err_t factoryreset_register_commands();
 
+/** Add CHIP Stack Lock Commands
+ *
+ * Adds the commands which print and reset the statistics of the CHIP stack locks, refer to
+ * CONFIG_ESP_MATTER_LOCK_STATS.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_LOCK_STATS is disabled.
+ */
+esp_err_t lock_register_commands();
+
+/** Add Application Callback Commands
+ *
+ * Adds the commands which print and reset the durations of the attribute and command callbacks, refer to
+ * CONFIG_ESP_MATTER_CALLBACK_STATS.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_ESP_MATTER_CALLBACK_STATS is disabled.
+ */
+esp_err_t callback_register_commands();
+
 } // namespace console
 } // namespace esp_matter
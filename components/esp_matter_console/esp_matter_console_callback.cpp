@@ -0,0 +1,144 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_log.h>
+#include <esp_matter_callback_stats.h>
+#include <esp_matter_console.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace esp_matter {
+namespace console {
+
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+static engine callback_console;
+
+static const char *k_type_names[callback_stats::CALLBACK_TYPE_MAX] = {"pre-update", "post-update", "read", "write",
+                                                                       "command"};
+
+static void print_histogram(const uint16_t *histogram)
+{
+    for (size_t i = 0; i < callback_stats::k_histogram_bucket_count; ++i) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        if (i == 0) {
+            printf("\t\t< 16 us\t\t%" PRIu16 "\n", histogram[i]);
+        } else if (i == callback_stats::k_histogram_bucket_count - 1) {
+            printf("\t\t>= %" PRIu32 " us\t%" PRIu16 "\n", (uint32_t)1 << (i + 3), histogram[i]);
+        } else {
+            printf("\t\t< %" PRIu32 " us\t%" PRIu16 "\n", (uint32_t)1 << (i + 4), histogram[i]);
+        }
+    }
+}
+
+static esp_err_t callback_stats_handler(int argc, char **argv)
+{
+    bool has_cluster_id = argc >= 1;
+    uint32_t cluster_id = has_cluster_id ? strtoul(argv[0], NULL, 16) : 0;
+    callback_stats::stats_t *stats = (callback_stats::stats_t *)calloc(1, sizeof(callback_stats::stats_t));
+    if (!stats) {
+        return ESP_ERR_NO_MEM;
+    }
+    callback_stats::get_stats(stats);
+    printf("Slow callbacks (>= %" PRIu32 " ms): %" PRIu32 ", dropped: %" PRIu32 "\n",
+           callback_stats::get_slow_threshold(), stats->slow_count, stats->dropped_count);
+    for (size_t i = 0; i < stats->cluster_count; ++i) {
+        const callback_stats::cluster_stats_t &cluster = stats->clusters[i];
+        if (has_cluster_id && cluster.cluster_id != cluster_id) {
+            continue;
+        }
+        printf("Cluster 0x%08" PRIX32 ":\n", cluster.cluster_id);
+        for (size_t type = 0; type < callback_stats::CALLBACK_TYPE_MAX; ++type) {
+            const callback_stats::type_stats_t &type_stats = cluster.types[type];
+            if (type_stats.count == 0) {
+                continue;
+            }
+            printf("\t%s: count %" PRIu32 ", avg %" PRIu64 " us, max %" PRIu32 " us (endpoint 0x%04" PRIX16
+                   ", id 0x%08" PRIX32 ")\n", k_type_names[type], type_stats.count,
+                   type_stats.total_us / type_stats.count, type_stats.max_us, type_stats.max_endpoint_id,
+                   type_stats.max_id);
+            if (has_cluster_id) {
+                print_histogram(type_stats.histogram);
+            }
+        }
+    }
+    free(stats);
+    return ESP_OK;
+}
+
+static esp_err_t callback_threshold_handler(int argc, char **argv)
+{
+    if (argc >= 1) {
+        callback_stats::set_slow_threshold(strtoul(argv[0], NULL, 10));
+    }
+    printf("Slow callback threshold: %" PRIu32 " ms\n", callback_stats::get_slow_threshold());
+    return ESP_OK;
+}
+
+static esp_err_t callback_reset_handler(int argc, char **argv)
+{
+    callback_stats::reset_stats();
+    return ESP_OK;
+}
+
+static esp_err_t callback_dispatch(int argc, char **argv)
+{
+    if (argc <= 0) {
+        callback_console.for_each_command(print_description, NULL);
+        return ESP_OK;
+    }
+    return callback_console.exec_command(argc, argv);
+}
+#endif // CONFIG_ESP_MATTER_CALLBACK_STATS
+
+esp_err_t callback_register_commands()
+{
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+    static const command_t command = {
+        .name = "callback",
+        .description = "Application callback statistics. Usage: matter esp callback <callback_command>.",
+        .handler = callback_dispatch,
+    };
+
+    static const command_t callback_commands[] = {
+        {
+            .name = "stats",
+            .description = "Print the callback durations per cluster, with the histograms when a cluster is given. "
+                           "Usage: matter esp callback stats [cluster_id(hex)]",
+            .handler = callback_stats_handler,
+        },
+        {
+            .name = "threshold",
+            .description = "Get or set the slow callback threshold. Usage: matter esp callback threshold [ms]",
+            .handler = callback_threshold_handler,
+        },
+        {
+            .name = "reset",
+            .description = "Reset the callback statistics",
+            .handler = callback_reset_handler,
+        },
+    };
+    callback_console.register_commands(callback_commands, sizeof(callback_commands) / sizeof(command_t));
+
+    return add_commands(&command, 1);
+#else
+    ESP_LOGE("esp_matter_console_callback", "Enable CONFIG_ESP_MATTER_CALLBACK_STATS for the callback commands");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_CALLBACK_STATS
+}
+
+} // namespace console
+} // namespace esp_matter
@@ -15,7 +15,9 @@
 #include <esp_heap_caps.h>
 #include <esp_log.h>
 #include <esp_matter_console.h>
+#include <esp_matter_mem.h>
 #include <esp_timer.h>
+#include <inttypes.h>
 #include <string.h>
 
 namespace esp_matter {
@@ -37,6 +39,27 @@ static esp_err_t mem_dump_console_handler(int argc, char *argv[])
     return ESP_OK;
 }
 
+static esp_err_t mem_tags_console_handler(int argc, char *argv[])
+{
+#if CONFIG_ESP_MATTER_MEM_ACCOUNTING
+    if (argc >= 1 && strcmp(argv[0], "reset") == 0) {
+        esp_matter_mem_reset_peak();
+        return ESP_OK;
+    }
+    printf("Subsystem	Current		Peak		High-water	Count	Total count\n");
+    for (int tag = 0; tag < ESP_MATTER_MEM_TAG_MAX; ++tag) {
+        esp_matter_mem_stats_t stats;
+        esp_matter_mem_get_stats((esp_matter_mem_tag_t)tag, &stats);
+        printf("%-16s%-16u%-16u%-16u%-8" PRIu32 "%" PRIu32 "\n", esp_matter_mem_get_tag_name((esp_matter_mem_tag_t)tag),
+               stats.current, stats.peak, stats.high_water, stats.count, stats.total_count);
+    }
+    return ESP_OK;
+#else
+    ESP_LOGE(TAG, "Enable CONFIG_ESP_MATTER_MEM_ACCOUNTING for the memory accounting");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_MEM_ACCOUNTING
+}
+
 static esp_err_t up_time_console_handler(int argc, char *argv[])
 {
     printf("%s: Uptime of the device: %lld milliseconds\n", TAG, esp_timer_get_time() / 1000);
@@ -66,6 +89,12 @@ esp_err_t diagnostics_register_commands()
             .description = "help for memory analysis",
             .handler = mem_dump_console_handler,
         },
+        {
+            .name = "mem-tags",
+            .description = "print the memory allocated per subsystem, or reset the peaks. "
+                           "Usage: matter esp diagnostics mem-tags [reset]",
+            .handler = mem_tags_console_handler,
+        },
         {
             .name = "up-time",
             .description = "print the uptime of the device",
@@ -0,0 +1,111 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_log.h>
+#include <esp_matter_console.h>
+#include <esp_matter_core.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace esp_matter {
+namespace console {
+
+#if CONFIG_ESP_MATTER_LOCK_STATS
+static engine lock_console;
+
+static void print_histogram(const char *name, const uint32_t *histogram)
+{
+    printf("%s:\n", name);
+    for (size_t i = 0; i < lock::k_histogram_bucket_count; ++i) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        if (i == lock::k_histogram_bucket_count - 1) {
+            printf("\t>= %" PRIu32 " us\t%" PRIu32 "\n", (uint32_t)1 << i, histogram[i]);
+        } else {
+            printf("\t< %" PRIu32 " us\t%" PRIu32 "\n", (uint32_t)1 << (i + 1), histogram[i]);
+        }
+    }
+}
+
+static esp_err_t lock_stats_handler(int argc, char **argv)
+{
+    lock::stats_t *stats = (lock::stats_t *)calloc(1, sizeof(lock::stats_t));
+    if (!stats) {
+        return ESP_ERR_NO_MEM;
+    }
+    lock::get_stats(stats);
+    printf("Locks taken: %" PRIu32 ", failed: %" PRIu32 "\n", stats->lock_count, stats->failed_count);
+    print_histogram("Wait time", stats->wait_histogram);
+    print_histogram("Hold time", stats->hold_histogram);
+    printf("Longest holders:\n\tCaller\t\tTask\t\tCount\tMax hold (us)\tAvg hold (us)\tMax wait (us)\n");
+    for (size_t i = 0; i < stats->holder_count; ++i) {
+        const lock::holder_stats_t &holder = stats->holders[i];
+        printf("\t%p\t%-16s%" PRIu32 "\t%" PRIu32 "\t\t%" PRIu64 "\t\t%" PRIu32 "\n", holder.caller, holder.task_name,
+               holder.count, holder.max_hold_us, holder.count ? holder.total_hold_us / holder.count : 0,
+               holder.max_wait_us);
+    }
+    free(stats);
+    return ESP_OK;
+}
+
+static esp_err_t lock_reset_handler(int argc, char **argv)
+{
+    lock::reset_stats();
+    return ESP_OK;
+}
+
+static esp_err_t lock_dispatch(int argc, char **argv)
+{
+    if (argc <= 0) {
+        lock_console.for_each_command(print_description, NULL);
+        return ESP_OK;
+    }
+    return lock_console.exec_command(argc, argv);
+}
+#endif // CONFIG_ESP_MATTER_LOCK_STATS
+
+esp_err_t lock_register_commands()
+{
+#if CONFIG_ESP_MATTER_LOCK_STATS
+    static const command_t command = {
+        .name = "lock",
+        .description = "CHIP stack lock statistics. Usage: matter esp lock <lock_command>.",
+        .handler = lock_dispatch,
+    };
+
+    static const command_t lock_commands[] = {
+        {
+            .name = "stats",
+            .description = "Print the wait and hold time histograms and the longest lock holders",
+            .handler = lock_stats_handler,
+        },
+        {
+            .name = "reset",
+            .description = "Reset the lock statistics",
+            .handler = lock_reset_handler,
+        },
+    };
+    lock_console.register_commands(lock_commands, sizeof(lock_commands) / sizeof(command_t));
+
+    return add_commands(&command, 1);
+#else
+    ESP_LOGE("esp_matter_console_lock", "Enable CONFIG_ESP_MATTER_LOCK_STATS for the lock commands");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif // CONFIG_ESP_MATTER_LOCK_STATS
+}
+
+} // namespace console
+} // namespace esp_matter
@@ -149,7 +149,7 @@ void cluster_command::on_device_connected_fcn(void *context, ExchangeManager &ex
     chip::OperationalDeviceProxy device_proxy(&exchangeMgr, sessionHandle);
     chip::app::CommandPathParams command_path = {cmd->m_endpoint_id, 0, cmd->m_cluster_id, cmd->m_command_id,
                                                  chip::app::CommandPathFlags::kEndpointIdValid};
-    interaction::invoke::send_request(context, &device_proxy, command_path, cmd->m_command_data_field,
+    interaction::invoke::send_request(context, &device_proxy, command_path, cmd->get_command_data(),
                                       cmd->on_success_cb, cmd->on_error_cb, cmd->m_timed_invoke_timeout_ms);
     chip::Platform::Delete(cmd);
     return;
@@ -210,7 +210,7 @@ esp_err_t cluster_command::dispatch_group_command(void *context)
 #endif // CONFIG_ESP_MATTER_ENABLE_MATTER_SERVER
     chip::app::CommandPathParams command_path = {cmd->m_endpoint_id, group_id, cmd->m_cluster_id, cmd->m_command_id,
                                                  chip::app::CommandPathFlags::kGroupIdValid};
-    err = interaction::invoke::send_group_request(fabric_index, command_path, cmd->m_command_data_field);
+    err = interaction::invoke::send_group_request(fabric_index, command_path, cmd->get_command_data());
     chip::Platform::Delete(cmd);
     return err;
 }
@@ -259,5 +259,159 @@ esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint
     return cmd->send_command();
 }
 
+static esp_err_t send_invoke_tlv_cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                                 uint32_t command_id, tlv_encodable_type &&command_data,
+                                                 chip::Optional<uint16_t> timed_invoke_timeout_ms)
+{
+    cluster_command *cmd = chip::Platform::New<cluster_command>(destination_id, endpoint_id, cluster_id, command_id,
+                                                                std::move(command_data), timed_invoke_timeout_ms);
+    if (!cmd) {
+        ESP_LOGE(TAG, "Failed to alloc memory for cluster_command");
+        return ESP_ERR_NO_MEM;
+    }
+
+    return cmd->send_command();
+}
+
+esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                      uint32_t command_id, const EncodableToTLV &command_data,
+                                      chip::Optional<uint16_t> timed_invoke_timeout_ms)
+{
+    tlv_encodable_type command_data_tlv;
+    ESP_RETURN_ON_ERROR(command_data_tlv.set(command_data), TAG, "Failed to encode command data");
+    return send_invoke_tlv_cluster_command(destination_id, endpoint_id, cluster_id, command_id,
+                                           std::move(command_data_tlv), timed_invoke_timeout_ms);
+}
+
+esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                      uint32_t command_id, const uint8_t *command_data_tlv,
+                                      size_t command_data_tlv_len, chip::Optional<uint16_t> timed_invoke_timeout_ms)
+{
+    tlv_encodable_type command_data;
+    ESP_RETURN_ON_ERROR(command_data.set(command_data_tlv, command_data_tlv_len), TAG,
+                        "Failed to copy command data");
+    return send_invoke_tlv_cluster_command(destination_id, endpoint_id, cluster_id, command_id,
+                                           std::move(command_data), timed_invoke_timeout_ms);
+}
+
+void batch_cluster_command::fail_all_commands(CHIP_ERROR error)
+{
+    for (size_t i = 0; i < m_command_count; ++i) {
+        if (on_error_cb) {
+            on_error_cb(m_ctx, i, error);
+        }
+    }
+    if (on_done_cb) {
+        on_done_cb(m_ctx);
+    }
+}
+
+esp_err_t batch_cluster_command::add_command(uint16_t endpoint_id, uint32_t cluster_id, uint32_t command_id,
+                                             const char *command_data_field)
+{
+    custom_encodable_type command_data(command_data_field, custom_encodable_type::interaction_type::k_invoke_cmd);
+    return add_command(endpoint_id, cluster_id, command_id, command_data);
+}
+
+esp_err_t batch_cluster_command::add_command(uint16_t endpoint_id, uint32_t cluster_id, uint32_t command_id,
+                                             const EncodableToTLV &command_data)
+{
+    ESP_RETURN_ON_FALSE(m_command_count < CONFIG_ESP_MATTER_CONTROLLER_MAX_BATCH_INVOKE_COMMANDS, ESP_ERR_NO_MEM, TAG,
+                        "Too many commands in the batch");
+    command_entry &entry = m_commands[m_command_count];
+    ESP_RETURN_ON_ERROR(entry.command_data.set(command_data), TAG, "Failed to encode command data");
+    entry.endpoint_id = endpoint_id;
+    entry.cluster_id = cluster_id;
+    entry.command_id = command_id;
+    m_command_count++;
+    return ESP_OK;
+}
+
+void batch_cluster_command::on_device_connected_fcn(void *context, ExchangeManager &exchangeMgr,
+                                                    const SessionHandle &sessionHandle)
+{
+    batch_cluster_command *cmd = reinterpret_cast<batch_cluster_command *>(context);
+    chip::OperationalDeviceProxy device_proxy(&exchangeMgr, sessionHandle);
+    chip::Platform::ScopedMemoryBufferWithSize<chip::app::CommandPathParams> command_paths;
+    chip::Platform::ScopedMemoryBufferWithSize<const EncodableToTLV *> command_data;
+    command_paths.Alloc(cmd->m_command_count);
+    command_data.Alloc(cmd->m_command_count);
+    if (!command_paths.Get() || !command_data.Get()) {
+        ESP_LOGE(TAG, "Failed to alloc memory for batch command paths");
+        cmd->fail_all_commands(CHIP_ERROR_NO_MEMORY);
+    } else {
+        for (size_t i = 0; i < cmd->m_command_count; ++i) {
+            const command_entry &entry = cmd->m_commands[i];
+            command_paths[i] = chip::app::CommandPathParams(entry.endpoint_id, 0, entry.cluster_id, entry.command_id,
+                                                            chip::app::CommandPathFlags::kEndpointIdValid);
+            command_data[i] = &entry.command_data;
+        }
+        if (interaction::invoke::send_batch_request(cmd->m_ctx, &device_proxy, command_paths, command_data,
+                                                    cmd->on_success_cb, cmd->on_error_cb, cmd->on_done_cb,
+                                                    cmd->m_timed_invoke_timeout_ms) != ESP_OK) {
+            cmd->fail_all_commands(CHIP_ERROR_INTERNAL);
+        }
+    }
+    chip::Platform::Delete(cmd);
+}
+
+void batch_cluster_command::on_device_connection_failure_fcn(void *context, const ScopedNodeId &peerId,
+                                                             CHIP_ERROR error)
+{
+    batch_cluster_command *cmd = reinterpret_cast<batch_cluster_command *>(context);
+    cmd->fail_all_commands(error);
+    chip::Platform::Delete(cmd);
+}
+
+void batch_cluster_command::default_success_fcn(void *ctx, size_t command_index,
+                                                const ConcreteCommandPath &command_path, const StatusIB &status,
+                                                TLVReader *response_data)
+{
+    ESP_LOGI(TAG, "Batch command %u (endpoint 0x%x, cluster 0x%" PRIx32 ", command 0x%" PRIx32 ") status: 0x%x",
+             static_cast<unsigned>(command_index), command_path.mEndpointId, command_path.mClusterId,
+             command_path.mCommandId, chip::to_underlying(status.mStatus));
+    if (response_data) {
+        DataModelLogger::LogCommand(command_path, response_data);
+    }
+}
+
+void batch_cluster_command::default_error_fcn(void *ctx, size_t command_index, CHIP_ERROR error)
+{
+    ESP_LOGI(TAG, "Batch command %u failure: err :%" CHIP_ERROR_FORMAT, static_cast<unsigned>(command_index),
+             error.Format());
+}
+
+esp_err_t batch_cluster_command::send_command()
+{
+    if (m_command_count == 0 || chip::IsGroupId(m_node_id)) {
+        ESP_LOGE(TAG, "Batch command requires a NodeId and at least one command");
+        chip::Platform::Delete(this);
+        return ESP_ERR_INVALID_ARG;
+    }
+#ifdef CONFIG_ESP_MATTER_ENABLE_MATTER_SERVER
+    chip::Server &server = chip::Server::GetInstance();
+    server.GetCASESessionManager()->FindOrEstablishSession(ScopedNodeId(m_node_id, get_fabric_index()),
+                                                           &on_device_connected_cb, &on_device_connection_failure_cb);
+    return ESP_OK;
+#else
+    auto &controller_instance = esp_matter::controller::matter_controller_client::get_instance();
+#ifdef CONFIG_ESP_MATTER_COMMISSIONER_ENABLE
+    if (CHIP_NO_ERROR ==
+        controller_instance.get_commissioner()->GetConnectedDevice(m_node_id, &on_device_connected_cb,
+                                                                   &on_device_connection_failure_cb)) {
+        return ESP_OK;
+    }
+#else
+    if (CHIP_NO_ERROR ==
+        controller_instance.get_controller()->GetConnectedDevice(m_node_id, &on_device_connected_cb,
+                                                                 &on_device_connection_failure_cb)) {
+        return ESP_OK;
+    }
+#endif // CONFIG_ESP_MATTER_COMMISSIONER_ENABLE
+#endif // CONFIG_ESP_MATTER_ENABLE_MATTER_SERVER
+    chip::Platform::Delete(this);
+    return ESP_FAIL;
+}
+
 } // namespace controller
 } // namespace esp_matter
@@ -32,6 +32,8 @@ using chip::TLV::TLVReader;
 using esp_matter::client::peer_device_t;
 using esp_matter::client::interaction::invoke::custom_command_callback;
 using esp_matter::client::interaction::custom_encodable_type;
+using esp_matter::client::interaction::tlv_encodable_type;
+using chip::app::DataModel::EncodableToTLV;
 
 /** Cluster command class to send an invoke interaction command to a server **/
 class cluster_command {
@@ -54,6 +56,26 @@ public:
     {
     }
 
+    /** Constructor for command with pre-encoded command data **/
+    cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t command_id,
+                    tlv_encodable_type &&command_data,
+                    const chip::Optional<uint16_t> timed_invoke_timeout_ms = chip::NullOptional,
+                    custom_command_callback::on_success_callback_t on_success = default_success_fcn,
+                    custom_command_callback::on_error_callback_t on_error = default_error_fcn)
+        : m_destination_id(destination_id)
+        , m_endpoint_id(endpoint_id)
+        , m_cluster_id(cluster_id)
+        , m_command_id(command_id)
+        , m_command_data_field(nullptr, custom_encodable_type::interaction_type::k_invoke_cmd)
+        , m_command_data_tlv(std::move(command_data))
+        , m_timed_invoke_timeout_ms(timed_invoke_timeout_ms)
+        , on_device_connected_cb(on_device_connected_fcn, this)
+        , on_device_connection_failure_cb(on_device_connection_failure_fcn, this)
+        , on_success_cb(on_success)
+        , on_error_cb(on_error)
+    {
+    }
+
     ~cluster_command() {}
 
     esp_err_t send_command();
@@ -66,8 +88,17 @@ private:
     uint32_t m_cluster_id;
     uint32_t m_command_id;
     custom_encodable_type m_command_data_field;
+    tlv_encodable_type m_command_data_tlv;
     chip::Optional<uint16_t> m_timed_invoke_timeout_ms;
 
+    const EncodableToTLV &get_command_data()
+    {
+        if (!m_command_data_tlv.empty()) {
+            return m_command_data_tlv;
+        }
+        return m_command_data_field;
+    }
+
     static void on_device_connected_fcn(void *context, ExchangeManager &exchangeMgr,
                                         const SessionHandle &sessionHandle);
     static void on_device_connection_failure_fcn(void *context, const ScopedNodeId &peerId, CHIP_ERROR error);
@@ -106,5 +137,121 @@ esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint
                                       uint32_t command_id, const char *command_data_field,
                                       chip::Optional<uint16_t> timed_invoke_timeout_ms = chip::NullOptional);
 
+/** Send cluster invoke command with typed command data
+ *
+ * @note When the destination_id is a Matter GroupId, the endpoint_id parameter will be ignored.
+ * @note The command data is encoded when this function is called, so the object could be released after that.
+ *
+ * @param[in] destination_id NodeId or GroupId
+ * @param[in] endpoint_id EndpointId
+ * @param[in] cluster_id ClusterId
+ * @param[in] command_id CommandId
+ * @param[in] command_data Command data object. The generated command types are not EncodableToTLV, wrap them in
+ *            chip::app::DataModel::EncodableType, e.g.
+ *            chip::app::DataModel::EncodableType<chip::app::Clusters::OnOff::Commands::On::Type>
+ * @param[in] timed_invoke_timeout_ms Timeout in millisecond for timed-invoke command
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                      uint32_t command_id, const EncodableToTLV &command_data,
+                                      chip::Optional<uint16_t> timed_invoke_timeout_ms = chip::NullOptional);
+
+/** Send cluster invoke command with pre-encoded command data
+ *
+ * @note When the destination_id is a Matter GroupId, the endpoint_id parameter will be ignored.
+ *
+ * @param[in] destination_id NodeId or GroupId
+ * @param[in] endpoint_id EndpointId
+ * @param[in] cluster_id ClusterId
+ * @param[in] command_id CommandId
+ * @param[in] command_data_tlv Buffer of the command data encoded as an anonymous TLV structure
+ * @param[in] command_data_tlv_len Length of the command data buffer
+ * @param[in] timed_invoke_timeout_ms Timeout in millisecond for timed-invoke command
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t send_invoke_cluster_command(uint64_t destination_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                      uint32_t command_id, const uint8_t *command_data_tlv,
+                                      size_t command_data_tlv_len,
+                                      chip::Optional<uint16_t> timed_invoke_timeout_ms = chip::NullOptional);
+
+using esp_matter::client::interaction::invoke::batch_command_callback;
+
+/** Batch cluster command class to send several invoke commands to a node
+ *
+ * The commands are packed into the minimum number of InvokeRequests allowed by the MaxPathsPerInvoke of the
+ * node, and the responses are reported with the index of the command in the batch.
+ *
+ * Usage: allocate the object with chip::Platform::New, add the commands and call send_command(). The object
+ * is released by send_command(), whether it succeeds or not.
+ */
+class batch_cluster_command {
+public:
+    batch_cluster_command(uint64_t node_id, const chip::Optional<uint16_t> timed_invoke_timeout_ms = chip::NullOptional,
+                          batch_command_callback::on_success_callback_t on_success = default_success_fcn,
+                          batch_command_callback::on_error_callback_t on_error = default_error_fcn,
+                          batch_command_callback::on_done_callback_t on_done = nullptr, void *ctx = nullptr)
+        : m_node_id(node_id)
+        , m_timed_invoke_timeout_ms(timed_invoke_timeout_ms)
+        , on_device_connected_cb(on_device_connected_fcn, this)
+        , on_device_connection_failure_cb(on_device_connection_failure_fcn, this)
+        , on_success_cb(on_success)
+        , on_error_cb(on_error)
+        , on_done_cb(on_done)
+        , m_ctx(ctx)
+    {
+    }
+
+    ~batch_cluster_command() {}
+
+    /** Add a command with the command data in JSON format, command_data_field can be NULL */
+    esp_err_t add_command(uint16_t endpoint_id, uint32_t cluster_id, uint32_t command_id,
+                          const char *command_data_field);
+
+    /** Add a command with typed command data, which is encoded when this function is called */
+    esp_err_t add_command(uint16_t endpoint_id, uint32_t cluster_id, uint32_t command_id,
+                          const EncodableToTLV &command_data);
+
+    size_t get_command_count() { return m_command_count; }
+
+    esp_err_t send_command();
+
+private:
+    struct command_entry {
+        uint16_t endpoint_id = 0;
+        uint32_t cluster_id = 0;
+        uint32_t command_id = 0;
+        tlv_encodable_type command_data;
+    };
+
+    uint64_t m_node_id;
+    chip::Optional<uint16_t> m_timed_invoke_timeout_ms;
+    command_entry m_commands[CONFIG_ESP_MATTER_CONTROLLER_MAX_BATCH_INVOKE_COMMANDS];
+    size_t m_command_count = 0;
+
+    /** Report the error for all the commands when the batch could not be sent */
+    void fail_all_commands(CHIP_ERROR error);
+
+    static void on_device_connected_fcn(void *context, ExchangeManager &exchangeMgr,
+                                        const SessionHandle &sessionHandle);
+    static void on_device_connection_failure_fcn(void *context, const ScopedNodeId &peerId, CHIP_ERROR error);
+
+    static void default_success_fcn(void *ctx, size_t command_index, const ConcreteCommandPath &command_path,
+                                    const StatusIB &status, TLVReader *response_data);
+
+    static void default_error_fcn(void *ctx, size_t command_index, CHIP_ERROR error);
+
+    chip::Callback::Callback<chip::OnDeviceConnected> on_device_connected_cb;
+    chip::Callback::Callback<chip::OnDeviceConnectionFailure> on_device_connection_failure_cb;
+
+    batch_command_callback::on_success_callback_t on_success_cb;
+    batch_command_callback::on_error_callback_t on_error_cb;
+    batch_command_callback::on_done_callback_t on_done_cb;
+    void *m_ctx;
+};
+
 } // namespace controller
 } // namespace esp_matter
@@ -0,0 +1,334 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <esp_matter_controller_client.h>
+#include <esp_matter_controller_commissioning_queue.h>
+#include <esp_timer.h>
+#include <string.h>
+
+#include <credentials/FabricTable.h>
+
+static const char *TAG = "commissioning_queue";
+
+using namespace chip;
+using namespace chip::Controller;
+
+namespace esp_matter {
+namespace controller {
+
+static const char *entry_state_str[] = {"free", "queued", "pase", "pase-done", "commissioning"};
+
+esp_err_t commissioning_queue::set_max_concurrency(uint8_t max_concurrency)
+{
+    ESP_RETURN_ON_FALSE(max_concurrency > 0, ESP_ERR_INVALID_ARG, TAG, "Concurrency should be at least 1");
+    m_max_concurrency = max_concurrency;
+    schedule();
+    return ESP_OK;
+}
+
+esp_err_t commissioning_queue::set_wifi_credentials(const char *ssid, const char *password)
+{
+    if (!ssid) {
+        m_ssid[0] = 0;
+        m_password[0] = 0;
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(password && strlen(ssid) < sizeof(m_ssid) && strlen(password) < sizeof(m_password),
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid Wi-Fi credentials");
+    strncpy(m_ssid, ssid, sizeof(m_ssid));
+    strncpy(m_password, password, sizeof(m_password));
+    return ESP_OK;
+}
+
+esp_err_t commissioning_queue::set_thread_dataset(const uint8_t *dataset_buf, uint8_t dataset_len)
+{
+    if (!dataset_buf) {
+        m_dataset_len = 0;
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(dataset_len <= sizeof(m_dataset_buf), ESP_ERR_INVALID_ARG, TAG, "Invalid Thread dataset");
+    memcpy(m_dataset_buf, dataset_buf, dataset_len);
+    m_dataset_len = dataset_len;
+    return ESP_OK;
+}
+
+esp_err_t commissioning_queue::add(NodeId node_id, const char *payload)
+{
+    ESP_RETURN_ON_FALSE(payload && strlen(payload) < sizeof(m_entries[0].payload), ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid pairing code");
+    ESP_RETURN_ON_FALSE(find_entry(node_id) == nullptr, ESP_ERR_INVALID_STATE, TAG,
+                        "Node 0x%" PRIx64 " is already in the queue", node_id);
+    auto &controller_instance = esp_matter::controller::matter_controller_client::get_instance();
+    DevicePairingDelegate *delegate = controller_instance.get_commissioner()->GetPairingDelegate();
+    ESP_RETURN_ON_FALSE(delegate == nullptr || delegate == this, ESP_ERR_INVALID_STATE, TAG,
+                        "There is already a pairing process");
+    queue_entry_t *entry = find_entry(ENTRY_FREE);
+    ESP_RETURN_ON_FALSE(entry, ESP_ERR_NO_MEM, TAG, "Commissioning queue is full");
+
+    entry->node_id = node_id;
+    strncpy(entry->payload, payload, sizeof(entry->payload));
+    entry->state = ENTRY_QUEUED;
+    entry->sequence = m_sequence++;
+    entry->add_time_us = esp_timer_get_time();
+    entry->stage_start_time_us = entry->add_time_us;
+    controller_instance.get_commissioner()->RegisterPairingDelegate(this);
+    schedule();
+    return ESP_OK;
+}
+
+commissioning_queue::queue_entry_t *commissioning_queue::find_entry(entry_state_t state)
+{
+    // Return the oldest entry in the state so that the devices are processed in order.
+    queue_entry_t *found = nullptr;
+    for (size_t i = 0; i < CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_SIZE; ++i) {
+        queue_entry_t *entry = &m_entries[i];
+        if (entry->state == state && (!found || state == ENTRY_FREE || entry->sequence < found->sequence)) {
+            found = entry;
+            if (state == ENTRY_FREE) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+commissioning_queue::queue_entry_t *commissioning_queue::find_entry(NodeId node_id)
+{
+    for (size_t i = 0; i < CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_SIZE; ++i) {
+        if (m_entries[i].state != ENTRY_FREE && m_entries[i].node_id == node_id) {
+            return &m_entries[i];
+        }
+    }
+    return nullptr;
+}
+
+size_t commissioning_queue::get_active_count()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_SIZE; ++i) {
+        if (m_entries[i].state >= ENTRY_PASE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void commissioning_queue::schedule()
+{
+    // The commissioner might call the delegate synchronously when it fails to start a stage.
+    if (m_scheduling) {
+        return;
+    }
+    m_scheduling = true;
+    auto *commissioner = esp_matter::controller::matter_controller_client::get_instance().get_commissioner();
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        queue_entry_t *entry = nullptr;
+        if (!find_entry(ENTRY_COMMISSIONING) && (entry = find_entry(ENTRY_PASE_DONE)) != nullptr) {
+            CommissioningParameters params;
+            if (m_ssid[0]) {
+                params.SetWiFiCredentials(
+                    WiFiCredentials(ByteSpan(reinterpret_cast<const uint8_t *>(m_ssid), strlen(m_ssid)),
+                                    ByteSpan(reinterpret_cast<const uint8_t *>(m_password), strlen(m_password))));
+            }
+            if (m_dataset_len > 0) {
+                params.SetThreadOperationalDataset(ByteSpan(m_dataset_buf, m_dataset_len));
+            }
+            entry->state = ENTRY_COMMISSIONING;
+            entry->stage_start_time_us = esp_timer_get_time();
+            CHIP_ERROR err = commissioner->Commission(entry->node_id, params);
+            if (err != CHIP_NO_ERROR && entry->state == ENTRY_COMMISSIONING) {
+                ESP_LOGE(TAG, "Failed to start commissioning node 0x%" PRIx64 ": %" CHIP_ERROR_FORMAT, entry->node_id,
+                         err.Format());
+                commissioner->StopPairing(entry->node_id);
+                fail_entry(entry, err, CommissioningStage::kSecurePairing);
+            }
+            progress = true;
+        }
+        if (!find_entry(ENTRY_PASE) && get_active_count() < m_max_concurrency &&
+            (entry = find_entry(ENTRY_QUEUED)) != nullptr) {
+            int64_t now = esp_timer_get_time();
+            record_time(m_queue_wait_stats, now - entry->add_time_us);
+            entry->state = ENTRY_PASE;
+            entry->stage_start_time_us = now;
+            CHIP_ERROR err = commissioner->EstablishPASEConnection(entry->node_id, entry->payload, DiscoveryType::kAll);
+            if (err != CHIP_NO_ERROR && entry->state == ENTRY_PASE) {
+                ESP_LOGE(TAG, "Failed to pair node 0x%" PRIx64 ": %" CHIP_ERROR_FORMAT, entry->node_id, err.Format());
+                fail_entry(entry, err, CommissioningStage::kSecurePairing);
+            }
+            progress = true;
+        }
+    }
+    m_scheduling = false;
+
+    if (!find_entry(ENTRY_QUEUED) && get_active_count() == 0) {
+        if (commissioner->GetPairingDelegate() == this) {
+            commissioner->RegisterPairingDelegate(nullptr);
+            if (m_callbacks.queue_done_callback) {
+                m_callbacks.queue_done_callback();
+            }
+        }
+    }
+}
+
+void commissioning_queue::release_entry(queue_entry_t *entry)
+{
+    entry->state = ENTRY_FREE;
+    entry->node_id = 0;
+    entry->payload[0] = 0;
+}
+
+void commissioning_queue::fail_entry(queue_entry_t *entry, CHIP_ERROR error, CommissioningStage stage)
+{
+    NodeId node_id = entry->node_id;
+    release_entry(entry);
+    if (m_callbacks.commissioning_failure_callback) {
+        m_callbacks.commissioning_failure_callback(node_id, error, stage);
+    }
+}
+
+void commissioning_queue::OnPairingComplete(CHIP_ERROR error)
+{
+    queue_entry_t *entry = find_entry(ENTRY_PASE);
+    VerifyOrReturn(entry, ESP_LOGW(TAG, "PASE session completion without pending device"));
+    if (error == CHIP_NO_ERROR) {
+        int64_t now = esp_timer_get_time();
+        record_stage(CommissioningStage::kSecurePairing, now - entry->stage_start_time_us);
+        ESP_LOGI(TAG, "PASE session established with node 0x%" PRIx64, entry->node_id);
+        entry->state = ENTRY_PASE_DONE;
+        entry->stage_start_time_us = now;
+    } else {
+        ESP_LOGE(TAG, "PASE session establishment with node 0x%" PRIx64 " failed: %" CHIP_ERROR_FORMAT,
+                 entry->node_id, error.Format());
+        fail_entry(entry, error, CommissioningStage::kSecurePairing);
+    }
+    schedule();
+}
+
+void commissioning_queue::OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted,
+                                                      CHIP_ERROR error)
+{
+    queue_entry_t *entry = find_entry(peerId.GetNodeId());
+    VerifyOrReturn(entry && entry->state == ENTRY_COMMISSIONING);
+    int64_t now = esp_timer_get_time();
+    // The PASE session is recorded when it is established, before the device waits for the commissioning slot.
+    if (error == CHIP_NO_ERROR && stageCompleted != CommissioningStage::kSecurePairing) {
+        record_stage(stageCompleted, now - entry->stage_start_time_us);
+    }
+    entry->stage_start_time_us = now;
+}
+
+void commissioning_queue::OnCommissioningSuccess(PeerId peerId)
+{
+    queue_entry_t *entry = find_entry(peerId.GetNodeId());
+    VerifyOrReturn(entry && entry->state == ENTRY_COMMISSIONING);
+    record_time(m_total_stats, esp_timer_get_time() - entry->add_time_us);
+    ESP_LOGI(TAG, "Commissioning success with node 0x%" PRIx64, peerId.GetNodeId());
+    release_entry(entry);
+    if (m_callbacks.commissioning_success_callback) {
+        auto &controller_instance = esp_matter::controller::matter_controller_client::get_instance();
+        auto fabric = controller_instance.get_commissioner()->GetFabricTable()->FindFabricWithCompressedId(
+            peerId.GetCompressedFabricId());
+        m_callbacks.commissioning_success_callback(ScopedNodeId(peerId.GetNodeId(), fabric->GetFabricIndex()));
+    }
+    schedule();
+}
+
+void commissioning_queue::OnCommissioningFailure(
+    PeerId peerId, CHIP_ERROR error, CommissioningStage stageFailed,
+    Optional<Credentials::AttestationVerificationResult> additionalErrorInfo)
+{
+    queue_entry_t *entry = find_entry(peerId.GetNodeId());
+    VerifyOrReturn(entry && entry->state == ENTRY_COMMISSIONING);
+    ESP_LOGE(TAG, "Commissioning failure with node 0x%" PRIx64 " at stage %s: %" CHIP_ERROR_FORMAT,
+             peerId.GetNodeId(), StageToString(stageFailed), error.Format());
+    fail_entry(entry, error, stageFailed);
+    schedule();
+}
+
+void commissioning_queue::record_time(commissioning_time_stats_t &stats, int64_t time_us)
+{
+    stats.count++;
+    stats.total_time_us += time_us;
+    if ((uint64_t)time_us > stats.max_time_us) {
+        stats.max_time_us = time_us;
+    }
+}
+
+void commissioning_queue::record_stage(CommissioningStage stage, int64_t time_us)
+{
+    for (size_t i = 0; i < m_stage_stats_count; ++i) {
+        if (m_stage_stats[i].stage == stage) {
+            record_time(m_stage_stats[i].stats, time_us);
+            return;
+        }
+    }
+    VerifyOrReturn(m_stage_stats_count < k_max_stage_stats);
+    m_stage_stats[m_stage_stats_count].stage = stage;
+    m_stage_stats[m_stage_stats_count].stats = {};
+    record_time(m_stage_stats[m_stage_stats_count].stats, time_us);
+    m_stage_stats_count++;
+}
+
+void commissioning_queue::get_stage_stats(CommissioningStage stage, commissioning_time_stats_t &stats)
+{
+    stats = {};
+    for (size_t i = 0; i < m_stage_stats_count; ++i) {
+        if (m_stage_stats[i].stage == stage) {
+            stats = m_stage_stats[i].stats;
+            return;
+        }
+    }
+}
+
+void commissioning_queue::print_status()
+{
+    ESP_LOGI(TAG, "Max concurrency: %u, active devices: %u", m_max_concurrency,
+             static_cast<unsigned>(get_active_count()));
+    for (size_t i = 0; i < CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_SIZE; ++i) {
+        const queue_entry_t &entry = m_entries[i];
+        if (entry.state != ENTRY_FREE) {
+            ESP_LOGI(TAG, "  node 0x%" PRIx64 ": %s for %" PRId64 " ms", entry.node_id, entry_state_str[entry.state],
+                     (esp_timer_get_time() - entry.stage_start_time_us) / 1000);
+        }
+    }
+}
+
+static void print_time_stats(const char *name, const commissioning_time_stats_t &stats)
+{
+    ESP_LOGI(TAG, "%-40s count: %" PRIu32 ", avg: %" PRIu64 " ms, max: %" PRIu64 " ms", name, stats.count,
+             stats.count ? stats.total_time_us / stats.count / 1000 : 0, stats.max_time_us / 1000);
+}
+
+void commissioning_queue::print_stats()
+{
+    print_time_stats("QueueWait", m_queue_wait_stats);
+    for (size_t i = 0; i < m_stage_stats_count; ++i) {
+        print_time_stats(StageToString(m_stage_stats[i].stage), m_stage_stats[i].stats);
+    }
+    print_time_stats("Total", m_total_stats);
+}
+
+void commissioning_queue::reset_stats()
+{
+    m_stage_stats_count = 0;
+    m_queue_wait_stats = {};
+    m_total_stats = {};
+}
+
+} // namespace controller
+} // namespace esp_matter
@@ -0,0 +1,205 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <controller/CHIPDeviceController.h>
+#include <controller/CommissioningDelegate.h>
+#include <esp_matter.h>
+
+namespace esp_matter {
+namespace controller {
+
+using chip::NodeId;
+using chip::ScopedNodeId;
+using chip::Controller::CommissioningStage;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_time_us;
+    uint64_t max_time_us;
+} commissioning_time_stats_t;
+
+typedef struct {
+    // Callback for the success of commissioning of a queued device
+    void (*commissioning_success_callback)(ScopedNodeId peer_id);
+    // Callback for the failure of commissioning of a queued device, stage is kSecurePairing if the device failed
+    // in the discovery or the PASE session establishment.
+    void (*commissioning_failure_callback)(NodeId node_id, CHIP_ERROR error, CommissioningStage stage);
+    // Callback when all the queued devices are done
+    void (*queue_done_callback)();
+} commissioning_queue_callbacks_t;
+
+/** Commissioning queue to provision a batch of devices with pairing codes
+ *
+ * The DeviceCommissioner runs the commissioning stages (attestation, network provisioning, CASE...) of one device
+ * at a time, but the discovery and PASE session establishment of the next devices could be done meanwhile. The queue
+ * pipelines the devices through the two phases: while a device is being commissioned, the following devices are
+ * discovered and paired over PASE, one at a time, until the concurrency limit of devices in progress is reached.
+ *
+ * The queue and the pairing_command could not be used at the same time.
+ */
+class commissioning_queue : public chip::Controller::DevicePairingDelegate {
+public:
+    static commissioning_queue &get_instance()
+    {
+        static commissioning_queue s_instance;
+        return s_instance;
+    }
+
+    void set_callbacks(commissioning_queue_callbacks_t callbacks) { m_callbacks = callbacks; }
+
+    /**
+     * Set the maximum number of devices which are paired over PASE or being commissioned at the same time
+     *
+     * @param[in] max_concurrency Maximum number of devices in progress, 1 makes the queue strictly serial.
+     *
+     * @return ESP_OK on success
+     * @return error in case of failure
+     */
+    esp_err_t set_max_concurrency(uint8_t max_concurrency);
+
+    /**
+     * Set the Wi-Fi credentials provisioned to the queued devices
+     *
+     * @param[in] ssid     SSID of the Wi-Fi AP, NULL to clear the credentials.
+     * @param[in] password Password of the Wi-Fi AP.
+     *
+     * @return ESP_OK on success
+     * @return error in case of failure
+     */
+    esp_err_t set_wifi_credentials(const char *ssid, const char *password);
+
+    /**
+     * Set the Thread dataset provisioned to the queued devices
+     *
+     * @param[in] dataset_buf Buffer containing the Thread network dataset, NULL to clear the dataset.
+     * @param[in] dataset_len Length of the dataset buffer
+     *
+     * @return ESP_OK on success
+     * @return error in case of failure
+     */
+    esp_err_t set_thread_dataset(const uint8_t *dataset_buf, uint8_t dataset_len);
+
+    /**
+     * Add a device to the commissioning queue, the queue starts as soon as a device is added
+     *
+     * @param[in] node_id NodeId assigned to the Matter end-device.
+     * @param[in] payload Pairing code
+     *
+     * @return ESP_OK on success
+     * @return error in case of failure
+     */
+    esp_err_t add(NodeId node_id, const char *payload);
+
+    /** Print the devices in the queue and their states */
+    void print_status();
+
+    /**
+     * Get the time statistics of a commissioning stage
+     *
+     * @note The statistics of kSecurePairing include the discovery of the device.
+     *
+     * @param[in]  stage Commissioning stage.
+     * @param[out] stats Time statistics of the stage, zeroed if the stage has not been completed.
+     */
+    void get_stage_stats(CommissioningStage stage, commissioning_time_stats_t &stats);
+
+    /** Get the time statistics of the queued devices waiting for a free slot */
+    void get_queue_wait_stats(commissioning_time_stats_t &stats) { stats = m_queue_wait_stats; }
+
+    /** Get the time statistics of the successful commissionings, from add() to the commissioning success */
+    void get_total_stats(commissioning_time_stats_t &stats) { stats = m_total_stats; }
+
+    void print_stats();
+
+    void reset_stats();
+
+private:
+    enum entry_state_t : uint8_t {
+        ENTRY_FREE = 0,
+        ENTRY_QUEUED,
+        ENTRY_PASE,
+        ENTRY_PASE_DONE,
+        ENTRY_COMMISSIONING,
+    };
+
+    struct queue_entry_t {
+        NodeId node_id;
+        char payload[128];
+        entry_state_t state;
+        uint32_t sequence;
+        int64_t add_time_us;
+        int64_t stage_start_time_us;
+    };
+
+    struct stage_stats_t {
+        CommissioningStage stage;
+        commissioning_time_stats_t stats;
+    };
+
+    static constexpr size_t k_max_stage_stats = 48;
+
+    /****************** DevicePairingDelegate Interface *****************/
+    void OnPairingComplete(CHIP_ERROR error) override;
+    void OnCommissioningSuccess(chip::PeerId peerId) override;
+    void OnCommissioningFailure(
+        chip::PeerId peerId, CHIP_ERROR error, CommissioningStage stageFailed,
+        chip::Optional<chip::Credentials::AttestationVerificationResult> additionalErrorInfo) override;
+    void OnCommissioningStatusUpdate(chip::PeerId peerId, CommissioningStage stageCompleted,
+                                     CHIP_ERROR error) override;
+
+    queue_entry_t *find_entry(entry_state_t state);
+    queue_entry_t *find_entry(NodeId node_id);
+    size_t get_active_count();
+    void schedule();
+    void release_entry(queue_entry_t *entry);
+    void fail_entry(queue_entry_t *entry, CHIP_ERROR error, CommissioningStage stage);
+    void record_stage(CommissioningStage stage, int64_t time_us);
+    static void record_time(commissioning_time_stats_t &stats, int64_t time_us);
+
+    queue_entry_t m_entries[CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_SIZE];
+    uint32_t m_sequence;
+    uint8_t m_max_concurrency;
+    bool m_scheduling;
+    commissioning_queue_callbacks_t m_callbacks;
+
+    char m_ssid[33];
+    char m_password[65];
+    uint8_t m_dataset_buf[254];
+    uint8_t m_dataset_len;
+
+    stage_stats_t m_stage_stats[k_max_stage_stats];
+    size_t m_stage_stats_count;
+    commissioning_time_stats_t m_queue_wait_stats;
+    commissioning_time_stats_t m_total_stats;
+
+    commissioning_queue()
+        : m_entries{}
+        , m_sequence(0)
+        , m_max_concurrency(CONFIG_ESP_MATTER_COMMISSIONING_QUEUE_MAX_CONCURRENCY)
+        , m_scheduling(false)
+        , m_callbacks{nullptr, nullptr, nullptr}
+        , m_ssid{}
+        , m_password{}
+        , m_dataset_len(0)
+        , m_stage_stats_count(0)
+        , m_queue_wait_stats{}
+        , m_total_stats{}
+    {
+    }
+};
+
+} // namespace controller
+} // namespace esp_matter
@@ -15,6 +15,7 @@
 #include <app/server/Server.h>
 #include <controller/CommissioneeDeviceProxy.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <esp_matter_client.h>
 #include <esp_matter_controller_client.h>
 #include <esp_matter_controller_subscribe_command.h>
@@ -35,6 +36,48 @@ static const uint8_t k_max_resubscribe_retries = 2;
 namespace esp_matter {
 namespace controller {
 
+#if CONFIG_ESP_MATTER_CONTROLLER_REPORT_LOG_LEVEL_NONE
+static report_log_level_t s_report_log_level = REPORT_LOG_LEVEL_NONE;
+#elif CONFIG_ESP_MATTER_CONTROLLER_REPORT_LOG_LEVEL_PATH
+static report_log_level_t s_report_log_level = REPORT_LOG_LEVEL_PATH;
+#else
+static report_log_level_t s_report_log_level = REPORT_LOG_LEVEL_FULL;
+#endif
+// The reports are handled in the Matter task, the statistics are read and reset with the CHIP stack lock held.
+static report_stats_t s_report_stats;
+
+esp_err_t set_report_log_level(report_log_level_t level)
+{
+    if (level >= REPORT_LOG_LEVEL_DEFAULT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_report_log_level = level;
+    return ESP_OK;
+}
+
+report_log_level_t get_report_log_level()
+{
+    return s_report_log_level;
+}
+
+void get_report_stats(report_stats_t &stats)
+{
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    stats = s_report_stats;
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+}
+
+void reset_report_stats()
+{
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    s_report_stats = {};
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+}
+
 void subscribe_command::on_device_connected_fcn(void *context, ExchangeManager &exchangeMgr,
                                                 const SessionHandle &sessionHandle)
 {
@@ -102,15 +145,27 @@ void subscribe_command::OnAttributeData(const chip::app::ConcreteDataAttributePa
         return;
     }
 
-    chip::TLV::TLVReader log_data;
-    log_data.Init(*data);
-    error = DataModelLogger::LogAttribute(path, &log_data);
-    if (CHIP_NO_ERROR != error) {
-        ESP_LOGE(TAG, "Response Failure: Can not decode Data");
+    s_report_stats.attribute_reports++;
+    report_log_level_t log_level =
+        m_report_log_level == REPORT_LOG_LEVEL_DEFAULT ? s_report_log_level : m_report_log_level;
+    if (log_level == REPORT_LOG_LEVEL_FULL) {
+        int64_t start = esp_timer_get_time();
+        chip::TLV::TLVReader log_data;
+        log_data.Init(*data);
+        error = DataModelLogger::LogAttribute(path, &log_data);
+        if (CHIP_NO_ERROR != error) {
+            ESP_LOGE(TAG, "Response Failure: Can not decode Data");
+        }
+        s_report_stats.decode_time_us += esp_timer_get_time() - start;
+    } else if (log_level == REPORT_LOG_LEVEL_PATH) {
+        ESP_LOGI(TAG, "Attribute report from 0x%" PRIx64 ": endpoint %u cluster 0x%" PRIx32 " attribute 0x%" PRIx32,
+                 m_node_id, path.mEndpointId, path.mClusterId, path.mAttributeId);
     }
 
     if (attribute_data_cb) {
+        int64_t start = esp_timer_get_time();
         attribute_data_cb(m_node_id, path, data);
+        s_report_stats.callback_time_us += esp_timer_get_time() - start;
     }
 }
 
@@ -130,15 +185,28 @@ void subscribe_command::OnEventData(const chip::app::EventHeader &event_header,
         return;
     }
 
-    chip::TLV::TLVReader log_data;
-    log_data.Init(*data);
-    error = DataModelLogger::LogEvent(event_header, &log_data);
-    if (CHIP_NO_ERROR != error) {
-        ESP_LOGE(TAG, "Response Failure: Can not decode Data");
+    s_report_stats.event_reports++;
+    report_log_level_t log_level =
+        m_report_log_level == REPORT_LOG_LEVEL_DEFAULT ? s_report_log_level : m_report_log_level;
+    if (log_level == REPORT_LOG_LEVEL_FULL) {
+        int64_t start = esp_timer_get_time();
+        chip::TLV::TLVReader log_data;
+        log_data.Init(*data);
+        error = DataModelLogger::LogEvent(event_header, &log_data);
+        if (CHIP_NO_ERROR != error) {
+            ESP_LOGE(TAG, "Response Failure: Can not decode Data");
+        }
+        s_report_stats.decode_time_us += esp_timer_get_time() - start;
+    } else if (log_level == REPORT_LOG_LEVEL_PATH) {
+        ESP_LOGI(TAG, "Event report from 0x%" PRIx64 ": endpoint %u cluster 0x%" PRIx32 " event 0x%" PRIx32,
+                 m_node_id, event_header.mPath.mEndpointId, event_header.mPath.mClusterId,
+                 event_header.mPath.mEventId);
     }
 
     if (event_data_cb) {
+        int64_t start = esp_timer_get_time();
         event_data_cb(m_node_id, event_header, data);
+        s_report_stats.callback_time_us += esp_timer_get_time() - start;
     }
 }
 
@@ -184,7 +252,8 @@ void subscribe_command::OnDone(ReadClient *apReadClient)
 esp_err_t send_subscribe_attr_command(uint64_t node_id, ScopedMemoryBufferWithSize<uint16_t> &endpoint_ids,
                                       ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
                                       ScopedMemoryBufferWithSize<uint32_t> &attribute_ids, uint16_t min_interval,
-                                      uint16_t max_interval, bool auto_resubscribe, bool keep_subscription)
+                                      uint16_t max_interval, bool auto_resubscribe, bool keep_subscription,
+                                      report_log_level_t log_level)
 {
     if (endpoint_ids.AllocatedSize() != cluster_ids.AllocatedSize() ||
         endpoint_ids.AllocatedSize() != attribute_ids.AllocatedSize()) {
@@ -211,13 +280,15 @@ esp_err_t send_subscribe_attr_command(uint64_t node_id, ScopedMemoryBufferWithSi
         ESP_LOGE(TAG, "Failed to alloc memory for subscribe_command");
         return ESP_ERR_NO_MEM;
     }
+    cmd->set_report_log_level(log_level);
     return cmd->send_command();
 }
 
 esp_err_t send_subscribe_event_command(uint64_t node_id, ScopedMemoryBufferWithSize<uint16_t> &endpoint_ids,
                                        ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
                                        ScopedMemoryBufferWithSize<uint32_t> &event_ids, uint16_t min_interval,
-                                       uint16_t max_interval, bool auto_resubscribe, bool keep_subscription)
+                                       uint16_t max_interval, bool auto_resubscribe, bool keep_subscription,
+                                       report_log_level_t log_level)
 {
     if (endpoint_ids.AllocatedSize() != cluster_ids.AllocatedSize() ||
         endpoint_ids.AllocatedSize() != event_ids.AllocatedSize()) {
@@ -244,12 +315,13 @@ esp_err_t send_subscribe_event_command(uint64_t node_id, ScopedMemoryBufferWithS
         ESP_LOGE(TAG, "Failed to alloc memory for subscribe_command");
         return ESP_ERR_NO_MEM;
     }
+    cmd->set_report_log_level(log_level);
     return cmd->send_command();
 }
 
 esp_err_t send_subscribe_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id,
                                       uint32_t attribute_id, uint16_t min_interval, uint16_t max_interval,
-                                      bool auto_resubscribe, bool keep_subscription)
+                                      bool auto_resubscribe, bool keep_subscription, report_log_level_t log_level)
 {
     ScopedMemoryBufferWithSize<uint16_t> endpoint_ids;
     ScopedMemoryBufferWithSize<uint32_t> cluster_ids;
@@ -261,12 +333,12 @@ esp_err_t send_subscribe_attr_command(uint64_t node_id, uint16_t endpoint_id, ui
         return ESP_ERR_NO_MEM;
     }
     return send_subscribe_attr_command(node_id, endpoint_ids, cluster_ids, attribute_ids, min_interval, max_interval,
-                                       auto_resubscribe, keep_subscription);
+                                       auto_resubscribe, keep_subscription, log_level);
 }
 
 esp_err_t send_subscribe_event_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t event_id,
                                        uint16_t min_interval, uint16_t max_interval, bool auto_resubscribe,
-                                       bool keep_subscription)
+                                       bool keep_subscription, report_log_level_t log_level)
 {
     ScopedMemoryBufferWithSize<uint16_t> endpoint_ids;
     ScopedMemoryBufferWithSize<uint32_t> cluster_ids;
@@ -278,7 +350,7 @@ esp_err_t send_subscribe_event_command(uint64_t node_id, uint16_t endpoint_id, u
         return ESP_ERR_NO_MEM;
     }
     return send_subscribe_event_command(node_id, endpoint_ids, cluster_ids, event_ids, min_interval, max_interval,
-                                        auto_resubscribe, keep_subscription);
+                                        auto_resubscribe, keep_subscription, log_level);
 }
 
 esp_err_t send_shutdown_subscription(uint64_t node_id, uint32_t subscription_id)
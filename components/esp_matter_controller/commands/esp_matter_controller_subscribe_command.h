@@ -38,6 +38,30 @@ typedef enum {
     SUBSCRIBE_EVENT,
 } subscribe_command_type_t;
 
+/** Log level of the reports received on subscriptions **/
+typedef enum {
+    /** Do not log the reports, only call the report callbacks **/
+    REPORT_LOG_LEVEL_NONE = 0,
+    /** Log the path of each report without decoding the data **/
+    REPORT_LOG_LEVEL_PATH,
+    /** Decode and log the data of each report with the DataModelLogger **/
+    REPORT_LOG_LEVEL_FULL,
+    /** Use the global log level set by set_report_log_level() **/
+    REPORT_LOG_LEVEL_DEFAULT,
+} report_log_level_t;
+
+/** Counters and timings of the reports received on all the subscriptions **/
+typedef struct {
+    /** Number of attribute reports received **/
+    uint32_t attribute_reports;
+    /** Number of event reports received **/
+    uint32_t event_reports;
+    /** Total time spent in logging (decoding and printing) the reports, in microseconds **/
+    uint64_t decode_time_us;
+    /** Total time spent in the attribute and event report callbacks, in microseconds **/
+    uint64_t callback_time_us;
+} report_stats_t;
+
 /** Subscribe command class to send a subscribe interaction command to a server **/
 class subscribe_command : public ReadClient::Callback {
 public:
@@ -122,6 +146,9 @@ public:
 
     uint32_t get_subscription_id() { return m_subscription_id; }
 
+    /** Set the log level of the reports for this subscription, REPORT_LOG_LEVEL_DEFAULT to follow the global one **/
+    void set_report_log_level(report_log_level_t level) { m_report_log_level = level; }
+
 private:
     uint64_t m_node_id;
     uint16_t m_min_interval;
@@ -131,6 +158,7 @@ private:
     BufferedReadCallback m_buffered_read_cb;
     uint32_t m_subscription_id = 0;
     uint8_t m_resubscribe_retries = 0;
+    report_log_level_t m_report_log_level = REPORT_LOG_LEVEL_DEFAULT;
     ScopedMemoryBufferWithSize<AttributePathParams> m_attr_paths;
     ScopedMemoryBufferWithSize<EventPathParams> m_event_paths;
 
@@ -159,6 +187,7 @@ private:
  * @param[in] max_interval Maximum interval of the subscription
  * @param[in] auto_resubscribe Auto re-subscribe flag
  * @param[in] keep_subscription Keep subscription flag, terminate existing subscriptions if false
+ * @param[in] log_level Log level of the reports of this subscription, REPORT_LOG_LEVEL_DEFAULT for the global one
  *
  * @return ESP_OK on success.
  * @return error in case of failure.
@@ -167,7 +196,8 @@ esp_err_t send_subscribe_attr_command(uint64_t node_id, ScopedMemoryBufferWithSi
                                       ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
                                       ScopedMemoryBufferWithSize<uint32_t> &attribute_ids, uint16_t min_interval,
                                       uint16_t max_interval, bool auto_resubscribe = true,
-                                      bool keep_subscription = true);
+                                      bool keep_subscription = true,
+                                      report_log_level_t log_level = REPORT_LOG_LEVEL_DEFAULT);
 
 /** Send subscribe command with multiple event paths
  *
@@ -182,6 +212,7 @@ esp_err_t send_subscribe_attr_command(uint64_t node_id, ScopedMemoryBufferWithSi
  * @param[in] max_interval Maximum interval of the subscription
  * @param[in] auto_resubscribe Auto re-subscribe flag
  * @param[in] keep_subscription Keep subscription flag, terminate existing subscriptions if false
+ * @param[in] log_level Log level of the reports of this subscription, REPORT_LOG_LEVEL_DEFAULT for the global one
  *
  * @return ESP_OK on success.
  * @return error in case of failure.
@@ -190,7 +221,8 @@ esp_err_t send_subscribe_event_command(uint64_t node_id, ScopedMemoryBufferWithS
                                        ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
                                        ScopedMemoryBufferWithSize<uint32_t> &event_ids, uint16_t min_interval,
                                        uint16_t max_interval, bool auto_resubscribe = true,
-                                       bool keep_subscription = true);
+                                       bool keep_subscription = true,
+                                       report_log_level_t log_level = REPORT_LOG_LEVEL_DEFAULT);
 
 /** Send subscribe command with single attribute path
  *
@@ -205,13 +237,15 @@ esp_err_t send_subscribe_event_command(uint64_t node_id, ScopedMemoryBufferWithS
  * @param[in] max_interval Maximum interval of the subscription
  * @param[in] auto_resubscribe Auto re-subscribe flag
  * @param[in] keep_subscription Keep subscription flag, terminate existing subscriptions if false
+ * @param[in] log_level Log level of the reports of this subscription, REPORT_LOG_LEVEL_DEFAULT for the global one
  *
  * @return ESP_OK on success.
  * @return error in case of failure.
  */
 esp_err_t send_subscribe_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id,
                                       uint32_t attribute_id, uint16_t min_interval, uint16_t max_interval,
-                                      bool auto_resubscribe = true, bool keep_subscription = true);
+                                      bool auto_resubscribe = true, bool keep_subscription = true,
+                                      report_log_level_t log_level = REPORT_LOG_LEVEL_DEFAULT);
 
 /** Send subscribe command with single event path
  *
@@ -226,13 +260,46 @@ esp_err_t send_subscribe_attr_command(uint64_t node_id, uint16_t endpoint_id, ui
  * @param[in] max_interval Maximum interval of the subscription
  * @param[in] auto_resubscribe Auto re-subscribe flag
  * @param[in] keep_subscription Keep subscription flag, terminate existing subscriptions if false
+ * @param[in] log_level Log level of the reports of this subscription, REPORT_LOG_LEVEL_DEFAULT for the global one
  *
  * @return ESP_OK on success.
  * @return error in case of failure.
  */
 esp_err_t send_subscribe_event_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t event_id,
                                        uint16_t min_interval, uint16_t max_interval, bool auto_resubscribe = true,
-                                       bool keep_subscription = true);
+                                       bool keep_subscription = true,
+                                       report_log_level_t log_level = REPORT_LOG_LEVEL_DEFAULT);
+
+/** Set the global log level of the reports received on subscriptions
+ *
+ * @note The subscriptions with their own log level, set by subscribe_command::set_report_log_level() or passed to
+ * send_subscribe_attr_command() and send_subscribe_event_command(), are not affected.
+ *
+ * @param[in] level Log level, REPORT_LOG_LEVEL_DEFAULT is not allowed
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_INVALID_ARG if the level is invalid.
+ */
+esp_err_t set_report_log_level(report_log_level_t level);
+
+/** Get the global log level of the reports received on subscriptions
+ *
+ * @return The global log level.
+ */
+report_log_level_t get_report_log_level();
+
+/** Get the counters and timings of the reports received on all the subscriptions
+ *
+ * The statistics are copied with the CHIP stack lock held, so this could be called from any task.
+ *
+ * @param[out] stats Report statistics
+ */
+void get_report_stats(report_stats_t &stats);
+
+/** Reset the counters and timings of the reports received on all the subscriptions, with the CHIP stack lock held
+ * like get_report_stats()
+ */
+void reset_report_stats();
 
 /** Shut down a subscription for given node id and subscription id
  *
@@ -46,8 +46,14 @@ void write_command::on_device_connected_fcn(void *context, ExchangeManager &exch
 {
     write_command *cmd = (write_command *)context;
     chip::OperationalDeviceProxy device_proxy(&exchangeMgr, sessionHandle);
-    esp_err_t err = interaction::write::send_request(&device_proxy, cmd->m_attr_paths, cmd->m_attr_vals,
-                                                     cmd->m_chunked_callback, cmd->m_timed_write_timeout_ms);
+    esp_err_t err = ESP_OK;
+    if (!cmd->m_attr_vals_tlv.empty()) {
+        err = interaction::write::send_request(&device_proxy, cmd->m_attr_paths, cmd->m_attr_vals_tlv,
+                                               cmd->m_chunked_callback, cmd->m_timed_write_timeout_ms);
+    } else {
+        err = interaction::write::send_request(&device_proxy, cmd->m_attr_paths, cmd->m_attr_vals,
+                                               cmd->m_chunked_callback, cmd->m_timed_write_timeout_ms);
+    }
     if (err != ESP_OK) {
         chip::Platform::Delete(cmd);
     }
@@ -137,5 +143,78 @@ esp_err_t send_write_attr_command(uint64_t node_id, ScopedMemoryBufferWithSize<u
     return cmd->send_command();
 }
 
+static esp_err_t send_write_tlv_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id,
+                                             uint32_t attribute_id, tlv_encodable_type &&attr_val,
+                                             chip::Optional<uint16_t> timed_write_timeout_ms)
+{
+    ScopedMemoryBufferWithSize<AttributePathParams> attr_paths;
+    attr_paths.Alloc(1);
+    if (!attr_paths.Get()) {
+        ESP_LOGE(TAG, "Failed to alloc memory for attribute paths");
+        return ESP_ERR_NO_MEM;
+    }
+    attr_paths[0] = AttributePathParams(endpoint_id, cluster_id, attribute_id);
+
+    write_command *cmd = chip::Platform::New<write_command>(node_id, std::move(attr_paths), std::move(attr_val),
+                                                            timed_write_timeout_ms);
+    if (!cmd) {
+        ESP_LOGE(TAG, "Failed to alloc memory for write_command");
+        return ESP_ERR_NO_MEM;
+    }
+    return cmd->send_command();
+}
+
+esp_err_t send_write_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id,
+                                  const esp_matter_attr_val_t &attr_val,
+                                  chip::Optional<uint16_t> timed_write_timeout_ms)
+{
+    tlv_encodable_type attr_val_tlv;
+    ESP_RETURN_ON_ERROR(attr_val_tlv.set(attr_val), TAG, "Failed to encode attribute value");
+    return send_write_tlv_attr_command(node_id, endpoint_id, cluster_id, attribute_id, std::move(attr_val_tlv),
+                                       timed_write_timeout_ms);
+}
+
+esp_err_t send_write_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id,
+                                  const EncodableToTLV &attr_val, chip::Optional<uint16_t> timed_write_timeout_ms)
+{
+    tlv_encodable_type attr_val_tlv;
+    ESP_RETURN_ON_ERROR(attr_val_tlv.set(attr_val), TAG, "Failed to encode attribute value");
+    return send_write_tlv_attr_command(node_id, endpoint_id, cluster_id, attribute_id, std::move(attr_val_tlv),
+                                       timed_write_timeout_ms);
+}
+
+esp_err_t send_write_attr_command(uint64_t node_id, ScopedMemoryBufferWithSize<uint16_t> &endpoint_ids,
+                                  ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
+                                  ScopedMemoryBufferWithSize<uint32_t> &attribute_ids, const uint8_t *attr_vals_tlv,
+                                  size_t attr_vals_tlv_len, chip::Optional<uint16_t> timed_write_timeout_ms)
+{
+    if (endpoint_ids.AllocatedSize() != cluster_ids.AllocatedSize() ||
+        endpoint_ids.AllocatedSize() != attribute_ids.AllocatedSize()) {
+        ESP_LOGE(TAG,
+                 "The endpoint_id array length should be the same as the cluster_ids array length"
+                 "and the attribute_ids array length");
+        return ESP_ERR_INVALID_ARG;
+    }
+    tlv_encodable_type attr_vals;
+    ESP_RETURN_ON_ERROR(attr_vals.set(attr_vals_tlv, attr_vals_tlv_len), TAG, "Failed to copy attribute values");
+    ScopedMemoryBufferWithSize<AttributePathParams> attr_paths;
+    attr_paths.Alloc(endpoint_ids.AllocatedSize());
+    if (!attr_paths.Get()) {
+        ESP_LOGE(TAG, "Failed to alloc memory for attribute paths");
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < attr_paths.AllocatedSize(); ++i) {
+        attr_paths[i] = AttributePathParams(endpoint_ids[i], cluster_ids[i], attribute_ids[i]);
+    }
+
+    write_command *cmd = chip::Platform::New<write_command>(node_id, std::move(attr_paths), std::move(attr_vals),
+                                                            timed_write_timeout_ms);
+    if (!cmd) {
+        ESP_LOGE(TAG, "Failed to alloc memory for write_command");
+        return ESP_ERR_NO_MEM;
+    }
+    return cmd->send_command();
+}
+
 } // namespace controller
 } // namespace esp_matter
@@ -36,6 +36,8 @@ using chip::TLV::TLVElementType;
 using esp_matter::client::peer_device_t;
 using esp_matter::client::interaction::custom_encodable_type;
 using esp_matter::client::interaction::multiple_write_encodable_type;
+using esp_matter::client::interaction::tlv_encodable_type;
+using chip::app::DataModel::EncodableToTLV;
 
 /** Write command class to send a write interaction command to a server **/
 class write_command : public WriteClient::Callback {
@@ -74,6 +76,21 @@ public:
         }
     }
 
+    /** Constructor for command with multiple paths and pre-encoded attribute values **/
+    write_command(uint64_t node_id, ScopedMemoryBufferWithSize<AttributePathParams> &&attr_paths,
+                  tlv_encodable_type &&attr_vals,
+                  const chip::Optional<uint16_t> timed_write_timeout_ms = chip::NullOptional)
+        : m_node_id(node_id)
+        , m_attr_paths(std::move(attr_paths))
+        , m_chunked_callback(this)
+        , m_attr_vals(nullptr)
+        , m_attr_vals_tlv(std::move(attr_vals))
+        , m_timed_write_timeout_ms(timed_write_timeout_ms)
+        , on_device_connected_cb(on_device_connected_fcn, this)
+        , on_device_connection_failure_cb(on_device_connection_failure_fcn, this)
+    {
+    }
+
     ~write_command() {}
 
     esp_err_t send_command();
@@ -103,6 +120,7 @@ private:
     ScopedMemoryBufferWithSize<AttributePathParams> m_attr_paths;
     ChunkedWriteCallback m_chunked_callback;
     multiple_write_encodable_type m_attr_vals;
+    tlv_encodable_type m_attr_vals_tlv;
     chip::Optional<uint16_t> m_timed_write_timeout_ms;
 
     static void on_device_connected_fcn(void *context, ExchangeManager &exchangeMgr,
@@ -148,5 +166,59 @@ esp_err_t send_write_attr_command(uint64_t node_id, ScopedMemoryBufferWithSize<u
                                   ScopedMemoryBufferWithSize<uint32_t> &attribute_ids, const char *attr_val_json_str,
                                   chip::Optional<uint16_t> timed_write_timeout_ms = chip::NullOptional);
 
+/** Send write attribute command with an attribute value
+ *
+ * @param[in] node_id Remote NodeId
+ * @param[in] endpoint_id EndpointId
+ * @param[in] cluster_id ClusterId
+ * @param[in] attribute_id AttributeId
+ * @param[in] attr_val Attribute value, ESP_MATTER_VAL_TYPE_ARRAY is not supported
+ * @param[in] timed_write_timeout_ms Timeout in millisecond for timed-write attribute
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t send_write_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id,
+                                  const esp_matter_attr_val_t &attr_val,
+                                  chip::Optional<uint16_t> timed_write_timeout_ms = chip::NullOptional);
+
+/** Send write attribute command with a typed attribute value
+ *
+ * @note The attribute value is encoded when this function is called, so the object could be released after that.
+ *
+ * @param[in] node_id Remote NodeId
+ * @param[in] endpoint_id EndpointId
+ * @param[in] cluster_id ClusterId
+ * @param[in] attribute_id AttributeId
+ * @param[in] attr_val Attribute value object, e.g. chip::app::DataModel::EncodableType<uint8_t>
+ * @param[in] timed_write_timeout_ms Timeout in millisecond for timed-write attribute
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t send_write_attr_command(uint64_t node_id, uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id,
+                                  const EncodableToTLV &attr_val,
+                                  chip::Optional<uint16_t> timed_write_timeout_ms = chip::NullOptional);
+
+/** Send write attribute command to multiple attribute paths with pre-encoded attribute values
+ *
+ * @param[in] node_id Remote NodeId
+ * @param[in] endpoint_ids EndpointIds
+ * @param[in] cluster_ids ClusterIds
+ * @param[in] attribute_ids AttributeIds
+ * @param[in] attr_vals_tlv Buffer of the attribute values encoded as consecutive anonymous TLV elements, in the same
+ *            order as the attribute paths
+ * @param[in] attr_vals_tlv_len Length of the attribute values buffer
+ * @param[in] timed_write_timeout_ms Timeout in millisecond for timed-write attributes
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t send_write_attr_command(uint64_t node_id, ScopedMemoryBufferWithSize<uint16_t> &endpoint_ids,
+                                  ScopedMemoryBufferWithSize<uint32_t> &cluster_ids,
+                                  ScopedMemoryBufferWithSize<uint32_t> &attribute_ids, const uint8_t *attr_vals_tlv,
+                                  size_t attr_vals_tlv_len,
+                                  chip::Optional<uint16_t> timed_write_timeout_ms = chip::NullOptional);
+
 } // namespace controller
 } // namespace esp_matter
@@ -22,6 +22,7 @@
 #include <esp_matter_controller_console.h>
 #include <esp_matter_controller_group_settings.h>
 #include <esp_matter_controller_icd_client.h>
+#include <esp_matter_controller_commissioning_queue.h>
 #include <esp_matter_controller_pairing_command.h>
 #include <esp_matter_controller_read_command.h>
 #include <esp_matter_controller_subscribe_command.h>
@@ -137,7 +138,7 @@ static esp_err_t controller_help_handler(int argc, char **argv)
     return ESP_OK;
 }
 
-#if defined(CONFIG_ENABLE_ESP32_BLE_CONTROLLER) && defined(CONFIG_ESP_MATTER_COMMISSIONER_ENABLE)
+#if CONFIG_ESP_MATTER_COMMISSIONER_ENABLE
 static int char_to_int(char ch)
 {
     if ('A' <= ch && ch <= 'F') {
@@ -170,7 +171,7 @@ static bool convert_hex_str_to_bytes(const char *hex_str, uint8_t *bytes, uint8_
     }
     return true;
 }
-#endif // defined(CONFIG_ENABLE_ESP32_BLE_CONTROLLER) && defined(CONFIG_ESP_MATTER_COMMISSIONER_ENABLE)
+#endif // CONFIG_ESP_MATTER_COMMISSIONER_ENABLE
 
 #if CONFIG_ESP_MATTER_COMMISSIONER_ENABLE
 static esp_err_t controller_pairing_handler(int argc, char **argv)
@@ -273,6 +274,47 @@ static esp_err_t controller_pairing_handler(int argc, char **argv)
     return result;
 }
 
+static esp_err_t controller_commissioning_queue_handler(int argc, char **argv)
+{
+    VerifyOrReturnError(argc >= 1, ESP_ERR_INVALID_ARG);
+    controller::commissioning_queue &queue = controller::commissioning_queue::get_instance();
+
+    if (strncmp(argv[0], "add", sizeof("add")) == 0) {
+        VerifyOrReturnError(argc == 3, ESP_ERR_INVALID_ARG);
+        return queue.add(string_to_uint64(argv[1]), argv[2]);
+    } else if (strncmp(argv[0], "wifi", sizeof("wifi")) == 0) {
+        VerifyOrReturnError(argc == 1 || argc == 3, ESP_ERR_INVALID_ARG);
+        return argc == 1 ? queue.set_wifi_credentials(nullptr, nullptr) : queue.set_wifi_credentials(argv[1], argv[2]);
+    } else if (strncmp(argv[0], "thread", sizeof("thread")) == 0) {
+        VerifyOrReturnError(argc == 1 || argc == 2, ESP_ERR_INVALID_ARG);
+        if (argc == 1) {
+            return queue.set_thread_dataset(nullptr, 0);
+        }
+        uint8_t dataset_tlvs_buf[254];
+        uint8_t dataset_tlvs_len = sizeof(dataset_tlvs_buf);
+        if (!convert_hex_str_to_bytes(argv[1], dataset_tlvs_buf, dataset_tlvs_len)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        return queue.set_thread_dataset(dataset_tlvs_buf, dataset_tlvs_len);
+    } else if (strncmp(argv[0], "concurrency", sizeof("concurrency")) == 0) {
+        VerifyOrReturnError(argc == 2, ESP_ERR_INVALID_ARG);
+        return queue.set_max_concurrency(string_to_uint8(argv[1]));
+    } else if (strncmp(argv[0], "status", sizeof("status")) == 0) {
+        queue.print_status();
+        return ESP_OK;
+    } else if (strncmp(argv[0], "stats", sizeof("stats")) == 0) {
+        VerifyOrReturnError(argc <= 2, ESP_ERR_INVALID_ARG);
+        if (argc == 2) {
+            VerifyOrReturnError(strncmp(argv[1], "reset", sizeof("reset")) == 0, ESP_ERR_INVALID_ARG);
+            queue.reset_stats();
+            return ESP_OK;
+        }
+        queue.print_stats();
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
 #if CHIP_DEVICE_CONFIG_ENABLE_COMMISSIONER_DISCOVERY
 static esp_err_t controller_udc_handler(int argc, char **argv)
 {
@@ -590,6 +632,42 @@ static esp_err_t controller_shutdown_all_subscriptions_handler(int argc, char **
     return ESP_OK;
 }
 
+static esp_err_t controller_report_log_handler(int argc, char **argv)
+{
+    if (argc != 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (strncmp(argv[0], "none", sizeof("none")) == 0) {
+        return controller::set_report_log_level(controller::REPORT_LOG_LEVEL_NONE);
+    } else if (strncmp(argv[0], "path", sizeof("path")) == 0) {
+        return controller::set_report_log_level(controller::REPORT_LOG_LEVEL_PATH);
+    } else if (strncmp(argv[0], "full", sizeof("full")) == 0) {
+        return controller::set_report_log_level(controller::REPORT_LOG_LEVEL_FULL);
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t controller_report_stats_handler(int argc, char **argv)
+{
+    if (argc > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (argc == 1) {
+        if (strncmp(argv[0], "reset", sizeof("reset")) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        controller::reset_report_stats();
+        return ESP_OK;
+    }
+    controller::report_stats_t stats;
+    controller::get_report_stats(stats);
+    ESP_LOGI(TAG, "Attribute reports: %" PRIu32 ", Event reports: %" PRIu32, stats.attribute_reports,
+             stats.event_reports);
+    ESP_LOGI(TAG, "Decode time: %" PRIu64 " us, Callback time: %" PRIu64 " us", stats.decode_time_us,
+             stats.callback_time_us);
+    return ESP_OK;
+}
+
 static esp_err_t controller_icd_list_handler(int argc, char **argv)
 {
     if (argc != 1 || strncmp(argv[0], "list", sizeof("list")) != 0) {
@@ -631,6 +709,17 @@ esp_err_t controller_register_commands()
                            "\tcontroller pairing unpair <nodeid>",
             .handler = controller_pairing_handler,
         },
+        {
+            .name = "commissioning-queue",
+            .description = "Commission a batch of nodes with pairing codes.\n"
+                           "\tUsage: controller commissioning-queue add <nodeid> <payload> OR\n"
+                           "\tcontroller commissioning-queue wifi [<ssid> <password>] OR\n"
+                           "\tcontroller commissioning-queue thread [<dataset>] OR\n"
+                           "\tcontroller commissioning-queue concurrency <max-concurrency> OR\n"
+                           "\tcontroller commissioning-queue status OR\n"
+                           "\tcontroller commissioning-queue stats [reset]",
+            .handler = controller_commissioning_queue_handler,
+        },
         {
             .name = "group-settings",
             .description = "Managing the groups and keysets of the controller.\n"
@@ -741,6 +830,20 @@ esp_err_t controller_register_commands()
                            "\tUsage: controller shutdown-all-subss",
             .handler = controller_shutdown_all_subscriptions_handler,
         },
+        {
+            .name = "report-log",
+            .description = "Set the log level of the reports received on subscriptions.\n"
+                           "\tUsage: controller report-log <none|path|full>\n"
+                           "\tNotes: 'none' only calls the report callbacks, 'path' logs the report paths without "
+                           "decoding the data, 'full' decodes and logs the report data",
+            .handler = controller_report_log_handler,
+        },
+        {
+            .name = "report-stats",
+            .description = "Print or reset the counters and the time spent in decoding and callbacks of the reports.\n"
+                           "\tUsage: controller report-stats [reset]",
+            .handler = controller_report_stats_handler,
+        },
     };
 
     const static command_t controller_command = {
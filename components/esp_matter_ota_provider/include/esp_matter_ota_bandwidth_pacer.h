@@ -0,0 +1,44 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace ota_provider {
+
+// Token bucket limiting the bytes per second of the BDX blocks, it could be shared by several transfers.
+class OtaBandwidthPacer {
+public:
+    // 0 for no limit
+    void SetRate(uint32_t bytesPerSecond);
+
+    uint32_t GetRate() const { return mBytesPerSecond; }
+
+    // Whether a block of the size could be sent now
+    bool IsReady(size_t bytes);
+
+    void Consume(size_t bytes);
+
+private:
+    uint32_t mBytesPerSecond = 0;
+    int64_t mCapacity = 0;
+    int64_t mTokens = 0;
+    int64_t mLastRefillTimeUs = 0;
+};
+
+} // namespace ota_provider
+} // namespace esp_matter
@@ -0,0 +1,79 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <lib/core/ScopedNodeId.h>
+#include <sdkconfig.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace ota_provider {
+
+// Admission of the BDX transfers to the sessions of the OTA provider. A requestor rejected while no session is free
+// is put in a waiting list, and the requestors which have been waiting longer get the next free sessions first. The
+// sessions are the senders of OtaBdxSenderPool, this part does not depend on the CHIP exchanges.
+class OtaBdxSessionAdmission {
+public:
+    static constexpr size_t kMaxSessions = CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS;
+    static constexpr size_t kMaxWaitingRequestors = 16;
+    static constexpr int kNoSession = -1;
+
+    OtaBdxSessionAdmission();
+
+    // Returns the session of the requestor: the session it already holds, a free session, or kNoSession if all the
+    // sessions are in use or the free sessions are reserved for requestors which were rejected earlier.
+    int AcquireSession(const chip::ScopedNodeId &nodeId, uint8_t networkId);
+
+    void ReleaseSession(int session);
+
+    bool IsSessionInUse(int session) const { return mSessions[session].mInUse; }
+
+    esp_err_t SetMaxSessions(uint8_t maxSessions);
+
+    uint8_t GetMaxSessions() const { return mMaxSessions; }
+
+    size_t GetActiveSessionCount() const;
+
+    // Sessions held by the requestors of the network, the network of a requestor is the one of its last query
+    size_t GetNetworkSessionCount(uint8_t networkId) const;
+
+    size_t GetWaitingRequestorCount() const { return mWaitingRequestorCount; }
+
+private:
+    struct Session {
+        chip::ScopedNodeId mNodeId;
+        uint8_t mNetworkId;
+        bool mInUse;
+    };
+
+    struct WaitingRequestor {
+        chip::ScopedNodeId mNodeId;
+        int64_t mExpireTimeUs;
+    };
+
+    bool IsReservedForOthers(const chip::ScopedNodeId &nodeId, size_t freeSessions);
+    void AddWaitingRequestor(const chip::ScopedNodeId &nodeId);
+    void RemoveWaitingRequestor(const chip::ScopedNodeId &nodeId);
+
+    Session mSessions[kMaxSessions];
+    uint8_t mMaxSessions;
+    WaitingRequestor mWaitingRequestors[kMaxWaitingRequestors];
+    size_t mWaitingRequestorCount;
+};
+
+} // namespace ota_provider
+} // namespace esp_matter
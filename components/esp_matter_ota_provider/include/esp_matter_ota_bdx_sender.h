@@ -16,10 +16,16 @@
 
 #include <esp_err.h>
 #include <esp_http_client.h>
+#include <esp_matter_ota_bandwidth_pacer.h>
+#include <esp_matter_ota_bdx_admission.h>
+#include <lib/core/ScopedNodeId.h>
+#include <messaging/ExchangeDelegate.h>
 #include <protocols/bdx/BdxTransferSession.h>
 #include <protocols/bdx/TransferFacilitator.h>
+#include <sdkconfig.h>
 
 #define OTA_URL_MAX_LEN 256
+#define OTA_IMAGE_DIGEST_LEN 32
 
 namespace esp_matter {
 namespace ota_provider {
@@ -33,6 +39,35 @@ public:
         kErrBdxSenderTimeout,
     };
 
+    enum TransferEvent {
+        kTransferStarted = 0,
+        kTransferCompleted,
+        kTransferFailed,
+    };
+    // Called when a transfer is accepted and when an accepted transfer is finished.
+    using TransferEventCallback = void (*)(OtaBdxSender *sender, TransferEvent event, void *ctx);
+
+    // Statistics of a transfer, to tune the block size and the pacing of the transfers
+    struct TransferStats {
+        uint64_t mBytesSent;
+        uint32_t mBlocksSent;
+        uint32_t mDurationMs;
+        // Bytes per second over the transfer
+        uint32_t mThroughput;
+        // Negotiated block size, smallest adapted block size and block size at the end of the transfer
+        uint16_t mMaxBlockSize;
+        uint16_t mMinBlockSize;
+        uint16_t mBlockSize;
+        uint32_t mBlockSizeDecreases;
+        // Time between a block and the next block query of the Requestor
+        uint32_t mRttMinMs;
+        uint32_t mRttAvgMs;
+        uint32_t mRttMaxMs;
+        // Block polls waited for the download and for the bandwidth budget
+        uint32_t mBlockDeferrals;
+        uint32_t mPacedBlocks;
+    };
+
     OtaBdxSender()
     {
         memset(mOtaImageUrl, 0, sizeof(mOtaImageUrl));
@@ -42,6 +77,39 @@ public:
     // Initializes BDX transfer-related metadata. Should always be called first.
     esp_err_t InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId);
 
+    bool IsInitialized() const { return mInitialized; }
+
+    bool IsInitializedFor(chip::FabricIndex fabricIndex, chip::NodeId nodeId) const
+    {
+        return mInitialized && mFabricIndex.HasValue() && mFabricIndex.Value() == fabricIndex && mNodeId.HasValue() &&
+            mNodeId.Value() == nodeId;
+    }
+
+    // Whether the requestor has sent the BDX init message and the transfer is in progress
+    bool IsTransferring() const { return mTransferStartTimeUs != 0; }
+
+    uint64_t GetNumBytesSent() const { return mNumBytesSent; }
+
+    // Statistics of the last finished transfer of the sender
+    const TransferStats &GetLastTransferStats() const { return mLastTransferStats; }
+
+    int64_t GetTransferStartTimeUs() const { return mTransferStartTimeUs; }
+
+    void SetTransferEventCallback(TransferEventCallback callback, void *ctx)
+    {
+        mTransferEventCallback = callback;
+        mTransferEventCallbackCtx = ctx;
+    }
+
+    chip::ScopedNodeId GetPeerNodeId() const
+    {
+        return chip::ScopedNodeId(mNodeId.ValueOr(chip::kUndefinedNodeId),
+                                  mFabricIndex.ValueOr(chip::kUndefinedFabricIndex));
+    }
+
+    // Pace the blocks of the transfer, the pacer is cleared when the transfer is finished.
+    void SetBlockPacer(OtaBandwidthPacer *pacer) { mBlockPacer = pacer; }
+
     uint16_t GetTransferBlockSize(void);
 
     uint64_t GetTransferLength(void);
@@ -53,14 +121,76 @@ public:
 
     const char *GetOtaImageUrl() const { return mOtaImageUrl; }
 
+    // Size of the OTA image file, 0 if unknown. Otherwise it is read from the header of the image.
+    void SetOtaImageSize(uint64_t otaImageSize) { mOtaImageSize = otaImageSize; }
+
+    // SHA-256 digest of the OTA image file in the DCL record, NULL if unknown. A cached image is only served if its
+    // digest matches.
+    void SetOtaImageDigest(const uint8_t *otaImageDigest)
+    {
+        mHasOtaImageDigest = otaImageDigest != nullptr;
+        if (otaImageDigest) {
+            memcpy(mOtaImageDigest, otaImageDigest, sizeof(mOtaImageDigest));
+        }
+    }
+
+    // Offset of the next block in the image, the requestors which resume a download start at a non-zero offset
+    uint64_t GetImageOffset() const { return mImageOffset; }
+
+    // Finish the transfer and release the sender back to the pool
+    void Reset();
+
 private:
     void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent &event) override;
 
     esp_err_t ParseOtaImageHeader(const uint8_t *header_buf, size_t header_buf_size);
 
-    void Reset();
+    // Open the flash cache of the image if it is cached, otherwise start downloading the image.
+    esp_err_t StartImageSource();
+
+    // Start downloading the image from mImageOffset, with a range request if the offset is not zero.
+    esp_err_t StartDownload();
+
+    // Check whether a block of the given size could be read without waiting for the network.
+    esp_err_t IsImageDataReady(size_t size);
+
+    esp_err_t ReadImageData(uint8_t *buf, size_t size, size_t *readLen);
+
+    // Send the queried block if the prefetcher has the data, otherwise keep the query pending until the next poll.
+    void SendBlockIfReady();
+
+    // Called with the round-trip time of each block, adapt the block size and the poll interval
+    void OnBlockRoundTrip(int64_t rttUs);
+
+    // Negotiated block size, limited to half of the prefetch buffer when the image is downloaded
+    uint16_t GetMaxBlockSize() const;
+
+    void UpdateLastTransferStats();
 
     uint64_t mNumBytesSent = 0;
+    uint64_t mImageOffset = 0;
+    int64_t mTransferStartTimeUs = 0;
+    bool mTransferSucceeded = false;
+    bool mBlockQueryPending = false;
+    uint32_t mNumBlockDeferrals = 0;
+    uint32_t mNumPacedBlocks = 0;
+    OtaBandwidthPacer *mBlockPacer = nullptr;
+    // Size of the next blocks, up to the negotiated block size
+    uint16_t mBlockSize = 0;
+    uint16_t mMinBlockSize = 0;
+    uint32_t mNumBlocksSent = 0;
+    uint32_t mNumBlockSizeDecreases = 0;
+    // Time at which the last block was sent, 0 if the Requestor has queried the next block
+    int64_t mBlockSentTimeUs = 0;
+    int64_t mRttMinUs = 0;
+    int64_t mRttMaxUs = 0;
+    int64_t mRttSumUs = 0;
+    int64_t mRttSmoothedUs = 0;
+    uint32_t mNumRttSamples = 0;
+    chip::System::Clock::Timeout mBasePollFreq;
+    TransferStats mLastTransferStats = {};
+    TransferEventCallback mTransferEventCallback = nullptr;
+    void *mTransferEventCallbackCtx = nullptr;
 
     bool mInitialized = false;
 
@@ -69,7 +199,98 @@ private:
 
     char mOtaImageUrl[OTA_URL_MAX_LEN];
     uint64_t mOtaImageSize;
-    esp_http_client_handle_t mHttpDownloader = nullptr;
+    uint8_t mOtaImageDigest[OTA_IMAGE_DIGEST_LEN];
+    bool mHasOtaImageDigest = false;
+    struct http_prefetcher *mPrefetcher = nullptr;
+    // Handle of the cached image, -1 if the image is downloaded
+    int mImageCacheHandle = -1;
+};
+
+// Pool of BDX senders so that the OTA provider can transfer images to several requestors at the same time. The pool is
+// registered as the unsolicited message handler of the BDX protocol and hands each incoming transfer to the sender
+// prepared for the requestor. The senders are the sessions of the OtaBdxSessionAdmission.
+class OtaBdxSenderPool : public chip::Messaging::UnsolicitedMessageHandler, public chip::Messaging::ExchangeDelegate {
+public:
+    static constexpr size_t kMaxSessions = OtaBdxSessionAdmission::kMaxSessions;
+
+    struct Stats {
+        uint32_t mTransfersCompleted;
+        uint32_t mTransfersFailed;
+        uint32_t mBusyRejections;
+        uint64_t mBytesSent;
+        // Wall-clock time during which at least one transfer was in progress
+        uint64_t mActiveTimeUs;
+        // Bytes per second of all the transfers over the active time
+        uint32_t mAggregateThroughput;
+    };
+
+    static constexpr size_t kTransferHistorySize = 8;
+
+    struct TransferRecord {
+        chip::ScopedNodeId mNodeId;
+        bool mSucceeded;
+        OtaBdxSender::TransferStats mStats;
+    };
+
+    OtaBdxSenderPool();
+
+    // Returns the sender for the requestor, nullptr if all the senders are in use or if the free sender is reserved
+    // for a requestor which was rejected earlier. A rejected requestor is put in a waiting list so that it gets the
+    // next free sender when it queries again.
+    OtaBdxSender *AllocateSender(chip::FabricIndex fabricIndex, chip::NodeId nodeId, uint8_t networkId);
+
+    esp_err_t SetMaxSessions(uint8_t maxSessions) { return mAdmission.SetMaxSessions(maxSessions); }
+
+    uint8_t GetMaxSessions() const { return mAdmission.GetMaxSessions(); }
+
+    size_t GetActiveSessionCount() const;
+
+    // Senders in use for the requestors of the network
+    size_t GetNetworkSessionCount(uint8_t networkId);
+
+    void GetStats(Stats &stats);
+
+    void ResetStats();
+
+    // Copy the records of the last finished transfers, the most recent first. Returns the number of records.
+    size_t GetTransferHistory(TransferRecord *records, size_t maxRecords) const;
+
+    size_t GetSenderCount() const { return kMaxSessions; }
+
+    const OtaBdxSender &GetSender(size_t index) const { return mSenders[index]; }
+
+    // Observe the transfer events of all the senders
+    void SetTransferEventObserver(OtaBdxSender::TransferEventCallback callback, void *ctx)
+    {
+        mTransferEventObserver = callback;
+        mTransferEventObserverCtx = ctx;
+    }
+
+private:
+    // UnsolicitedMessageHandler Implementation
+    CHIP_ERROR OnUnsolicitedMessageReceived(const chip::PayloadHeader &payloadHeader,
+                                            chip::Messaging::ExchangeDelegate *&newDelegate) override;
+    // ExchangeDelegate Implementation, only used for the first message of a transfer
+    CHIP_ERROR OnMessageReceived(chip::Messaging::ExchangeContext *ec, const chip::PayloadHeader &payloadHeader,
+                                 chip::System::PacketBufferHandle &&payload) override;
+    void OnResponseTimeout(chip::Messaging::ExchangeContext *ec) override {}
+
+    static void TransferEventCallback(OtaBdxSender *sender, OtaBdxSender::TransferEvent event, void *ctx);
+
+    // Release the sessions of the senders which have been reset since the last call
+    void SyncSessions();
+
+    OtaBdxSender mSenders[kMaxSessions];
+    OtaBdxSessionAdmission mAdmission;
+    Stats mStats;
+    TransferRecord mTransferHistory[kTransferHistorySize];
+    // Index of the next record and number of records in the history
+    size_t mTransferHistoryNext;
+    size_t mTransferHistoryCount;
+    size_t mTransferringCount;
+    int64_t mActiveStartTimeUs;
+    OtaBdxSender::TransferEventCallback mTransferEventObserver = nullptr;
+    void *mTransferEventObserverCtx = nullptr;
 };
 
 } // namespace ota_provider
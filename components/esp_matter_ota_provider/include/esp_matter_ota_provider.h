@@ -21,6 +21,7 @@
 #include <app/clusters/ota-provider/ota-provider-delegate.h>
 #include <cstdint>
 #include <esp_matter_ota_bdx_sender.h>
+#include <esp_matter_ota_rollout.h>
 #include <freertos/FreeRTOS.h>
 #include <lib/core/OTAImageHeader.h>
 
@@ -46,11 +47,42 @@ public:
         char mImageUri[kUriMaxLen];
         char mOtaImageUrl[OTA_URL_MAX_LEN];
         size_t mOtaImageSize;
+        uint8_t mOtaImageDigest[OTA_IMAGE_DIGEST_LEN];
+        bool mHasOtaImageDigest;
         uint32_t mSoftwareVersion;
         char mSoftwareVersionString[SOFTWARE_VERSION_STR_MAX_LEN];
+        // Network of the requestor for the rollout scheduler
+        uint8_t mNetworkId;
+        // The requestor is admitted by the rollout scheduler for the rolled out image
+        bool mInRollout;
         EspOtaRequestorEntry *mNext;
     };
 
+    struct OtaCandidatesCacheStats {
+        // QueryImage commands answered from the cache with an available update
+        uint32_t mHits;
+        // QueryImage commands answered from the cache with no available update
+        uint32_t mNegativeHits;
+        // QueryImage commands which needed DCL requests
+        uint32_t mMisses;
+        uint32_t mDclRequests;
+        uint32_t mEvictions;
+        uint32_t mRefreshes;
+    };
+
+    struct QueryImageStats {
+        uint32_t mQueries;
+        // QueryImage commands rejected with a Busy response while CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS
+        // QueryImage commands were processed
+        uint32_t mConcurrentQueryRejections;
+        // Time between a QueryImage command and its response
+        uint32_t mLatencyMinMs;
+        uint32_t mLatencyAvgMs;
+        uint32_t mLatencyMaxMs;
+        // Lowest free heap size seen at the QueryImage commands and at the transfer events
+        uint32_t mMinFreeHeap;
+    };
+
     // OTAProviderDelegate Implementation
     void HandleQueryImage(chip::app::CommandHandler *commandObj, const chip::app::ConcreteCommandPath &commandPath,
                           const chip::app::Clusters::OtaSoftwareUpdateProvider::Commands::QueryImage::DecodableType
@@ -79,7 +111,8 @@ public:
     void SetPollInterval(uint32_t interval) { mPollInterval = (interval != 0) ? interval : mPollInterval; }
 
     static void FetchImageDoneCallback(OTAQueryStatus status, const char *imageUrl, size_t imageSize,
-                                       uint32_t softwareVersion, const char *softwareVersionStr, void *arg);
+                                       const uint8_t *imageDigest, uint32_t softwareVersion,
+                                       const char *softwareVersionStr, void *arg);
 
     // When the OTA Provider receives a QueryImage command from an OTA Requestor and there is no existing entry for the
     // Requestor node, the Provider will create an OTA Requestor Entry for the requestor, and set the entry's
@@ -93,15 +126,84 @@ public:
     esp_err_t RemoveOtaRequestorEntry(const chip::ScopedNodeId &nodeId);
     EspOtaRequestorEntry *FindOtaRequestorEntry(const chip::ScopedNodeId &nodeId);
 
+    // Set the maximum number of BDX transfers in progress at the same time, up to
+    // CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS. The requestors beyond the limit get a Busy response.
+    esp_err_t SetMaxBdxSessions(uint8_t maxSessions) { return mOtaBdxSenderPool.SetMaxSessions(maxSessions); }
+    void GetBdxTransferStats(OtaBdxSenderPool::Stats &stats) { mOtaBdxSenderPool.GetStats(stats); }
+    void ResetBdxTransferStats() { mOtaBdxSenderPool.ResetStats(); }
+    // Copy the block size, round-trip time and throughput statistics of the last finished transfers, the most
+    // recent first. Returns the number of records.
+    size_t GetBdxTransferHistory(OtaBdxSenderPool::TransferRecord *records, size_t maxRecords)
+    {
+        return mOtaBdxSenderPool.GetTransferHistory(records, maxRecords);
+    }
+
+    // Assign the requestor to a network of the rollout scheduler, the requestor entry is created if it does not exist.
+    esp_err_t SetRequestorNetwork(const chip::ScopedNodeId &nodeId, uint8_t networkId);
+    OtaRolloutScheduler &GetRolloutScheduler() { return mRolloutScheduler; }
+
+    void GetQueryImageStats(QueryImageStats &stats);
+    void ResetQueryImageStats();
+
+    void GetOtaCandidatesCacheStats(OtaCandidatesCacheStats &stats);
+    void ResetOtaCandidatesCacheStats();
+
+    // Serve the delta image instead of the full image of softwareVersion to the requestors running
+    // baseSoftwareVersion. The requestors of the VendorID and ProductID should use the delta image processor
+    // (CONFIG_ESP_MATTER_OTA_DELTA_IMAGE). imageDigest is the SHA-256 of the delta image, nullptr if unknown.
+    esp_err_t AddDeltaImage(uint16_t vendorId, uint16_t productId, uint32_t baseSoftwareVersion,
+                            uint32_t softwareVersion, const char *imageUrl, size_t imageSize,
+                            const uint8_t *imageDigest);
+    esp_err_t RemoveDeltaImage(uint16_t vendorId, uint16_t productId, uint32_t baseSoftwareVersion,
+                               uint32_t softwareVersion);
+
 private:
+    struct DeltaImage {
+        bool mInUse;
+        uint16_t mVendorId;
+        uint16_t mProductId;
+        uint32_t mBaseSoftwareVersion;
+        uint32_t mSoftwareVersion;
+        char mImageUrl[OTA_URL_MAX_LEN];
+        size_t mImageSize;
+        uint8_t mImageDigest[OTA_IMAGE_DIGEST_LEN];
+        bool mHasImageDigest;
+    };
+
+    // QueryImage command of a requestor waiting for its OTA candidate
+    struct PendingQuery {
+        EspOtaProvider *mProvider = nullptr;
+        bool mInUse = false;
+        chip::app::CommandHandler::Handle mCommandHandle;
+        chip::app::ConcreteCommandPath mPath = chip::app::ConcreteCommandPath(0, 0, 0);
+        chip::Access::SubjectDescriptor mSubjectDescriptor;
+        chip::ScopedNodeId mPeerNodeId;
+        uint16_t mVendorId;
+        uint16_t mProductId;
+        uint32_t mSoftwareVersion;
+        int64_t mStartTimeUs;
+    };
+
     EspOtaProvider() {}
     ~EspOtaProvider() {}
 
-    void SendQueryImageResponse(OTAQueryStatus status);
+    void SendQueryImageResponse(PendingQuery &query, OTAQueryStatus status);
+
+    // Block size proposed to the requestor, according to the transport of its session
+    static uint32_t GetMaxBdxBlockSize(const chip::SessionHandle &session);
 
     esp_err_t CreateOtaRequestorEntry(const chip::ScopedNodeId &nodeId);
 
-    OtaBdxSender mOtaBdxSender;
+    static void TransferEventObserver(OtaBdxSender *sender, OtaBdxSender::TransferEvent event, void *ctx);
+
+    void UpdateMinFreeHeap();
+
+    DeltaImage *FindDeltaImage(uint16_t vendorId, uint16_t productId, uint32_t baseSoftwareVersion,
+                               uint32_t softwareVersion);
+
+    OtaBdxSenderPool mOtaBdxSenderPool;
+    OtaRolloutScheduler mRolloutScheduler;
+    DeltaImage mDeltaImages[CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_DELTA_IMAGES];
     uint32_t mDelayedQueryActionTimeSec;
     OTAApplyUpdateAction mUpdateAction;
     uint32_t mDelayedApplyActionTimeSec;
@@ -109,11 +211,11 @@ private:
     bool mOtaAllowedDefault;
     EspOtaRequestorEntry *mOtaRequestorList;
 
-    // Use async command handler for QueryImage command
-    chip::app::CommandHandler::Handle mAsyncCommandHandle;
-    chip::app::ConcreteCommandPath mPath = chip::app::ConcreteCommandPath(0, 0, 0);
-    chip::Access::SubjectDescriptor mSubjectDescriptor;
-    chip::ScopedNodeId mPeerNodeId;
+    // Use async command handlers for the QueryImage commands, one for each BDX transfer that could be started
+    PendingQuery mPendingQueries[CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS];
+    QueryImageStats mQueryImageStats;
+    uint64_t mQueryLatencySumMs;
+    uint32_t mQueryResponses;
 };
 } // namespace ota_provider
 } // namespace esp_matter
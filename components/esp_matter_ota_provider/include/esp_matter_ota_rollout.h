@@ -0,0 +1,120 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <esp_matter_ota_bdx_sender.h>
+#include <lib/core/ScopedNodeId.h>
+#include <sdkconfig.h>
+
+namespace esp_matter {
+namespace ota_provider {
+
+// Rollout scheduler of the OTA provider, which admits the requestors in waves and limits the transfers of each
+// network. The nodes are assigned to networks by the application, the nodes which are not assigned are in network 0.
+class OtaRolloutScheduler {
+public:
+    static constexpr uint8_t kMaxStages = 8;
+    static constexpr uint8_t kMaxNetworks = CONFIG_ESP_MATTER_OTA_PROVIDER_ROLLOUT_MAX_NETWORKS;
+
+    enum Admission {
+        kAdmitted = 0,
+        // The node is not in the current stage of the rollout, or the rollout is paused
+        kNotInStage,
+        // The network of the node has reached its concurrent transfer limit
+        kNetworkBusy,
+        // The transfers are only allowed in the transfer window
+        kOutsideWindow,
+    };
+
+    struct RolloutConfig {
+        uint16_t mVendorId;
+        uint16_t mProductId;
+        // Software version rolled out, 0 for any version of the VendorID and ProductID
+        uint32_t mSoftwareVersion;
+        // Cumulative percentages of the nodes admitted in each stage, e.g. {5, 25, 100}
+        uint8_t mStagePercents[kMaxStages];
+        uint8_t mStageCount;
+    };
+
+    struct RolloutProgress {
+        bool mActive;
+        bool mPaused;
+        uint8_t mStage;
+        uint8_t mStagePercent;
+        uint32_t mQueriesAdmitted;
+        uint32_t mQueriesNotInStage;
+        uint32_t mQueriesThrottled;
+        uint32_t mTransfersStarted;
+        uint32_t mTransfersCompleted;
+        uint32_t mTransfersFailed;
+        uint32_t mUpdatesApplied;
+    };
+
+    OtaRolloutScheduler();
+
+    esp_err_t StartRollout(const RolloutConfig &config);
+
+    // Admit the nodes of the next stage
+    esp_err_t AdvanceStage();
+
+    void PauseRollout(bool pause) { mProgress.mPaused = pause; }
+
+    void StopRollout();
+
+    void GetProgress(RolloutProgress &progress) const { progress = mProgress; }
+
+    // Limit the concurrent transfers of a network, 0 for no limit
+    esp_err_t SetNetworkTransferLimit(uint8_t networkId, uint8_t maxTransfers);
+
+    // Limit the bytes per second of all the transfers of a network by pacing the BDX blocks, 0 for no limit
+    esp_err_t SetNetworkBandwidth(uint8_t networkId, uint32_t bytesPerSecond);
+
+    // Only start the transfers between the minutes of the day in local time, the window could wrap around midnight.
+    // The window is ignored until the system time is set. Set the same start and end to allow any time.
+    esp_err_t SetTransferWindow(uint16_t startMinuteOfDay, uint16_t endMinuteOfDay);
+
+    // Called by the OTA provider when an update is available for a requestor
+    Admission CheckAdmission(const chip::ScopedNodeId &nodeId, uint8_t networkId, uint16_t vendorId,
+                             uint16_t productId, uint32_t softwareVersion, size_t networkTransfers);
+
+    // Pacer of the network, nullptr if the bandwidth of the network is not limited
+    OtaBandwidthPacer *GetNetworkPacer(uint8_t networkId);
+
+    // Whether the image is the one rolled out
+    bool IsInRollout(uint16_t vendorId, uint16_t productId, uint32_t softwareVersion) const;
+
+    // Called by the OTA provider for the transfers and the applied updates of the admitted requestors
+    void OnTransferEvent(OtaBdxSender::TransferEvent event);
+
+    void OnUpdateApplied() { mProgress.mUpdatesApplied++; }
+
+private:
+    struct NetworkLimit {
+        uint8_t mMaxTransfers;
+        OtaBandwidthPacer mPacer;
+    };
+
+    bool IsInTransferWindow() const;
+
+    RolloutConfig mConfig;
+    RolloutProgress mProgress;
+    NetworkLimit mNetworks[kMaxNetworks];
+    uint16_t mWindowStartMinute;
+    uint16_t mWindowEndMinute;
+};
+
+} // namespace ota_provider
+} // namespace esp_matter
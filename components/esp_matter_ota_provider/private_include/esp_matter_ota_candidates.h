@@ -30,17 +30,24 @@ typedef struct {
     uint32_t max_applicable_software_version;
     char ota_url[OTA_URL_MAX_LEN];
     uint32_t ota_file_size;
-    uint32_t lifetime;
+    // SHA-256 digest of the OTA file, only valid when has_ota_checksum is true
+    uint8_t ota_checksum[OTA_IMAGE_DIGEST_LEN];
+    bool has_ota_checksum;
 } model_version_t;
 
+// imageSize is 0 and imageDigest is NULL when the DCL record does not provide the size or the SHA-256 digest.
 typedef void (*fetch_ota_image_done_callback_t)(EspOtaProvider::OTAQueryStatus status, const char *imageUrl,
-                                                size_t imageSize, uint32_t softwareVersion,
-                                                const char *softwareVersionStr, void *ctx);
+                                                size_t imageSize, const uint8_t *imageDigest,
+                                                uint32_t softwareVersion, const char *softwareVersionStr, void *ctx);
 
 esp_err_t fetch_ota_candidate(const uint16_t vendor_id, const uint16_t product_id, const uint32_t software_version,
                               fetch_ota_image_done_callback_t callback, void *callback_args);
 
 esp_err_t init_ota_candidates();
 
+void get_ota_candidates_cache_stats(EspOtaProvider::OtaCandidatesCacheStats &stats);
+
+void reset_ota_candidates_cache_stats();
+
 } // namespace ota_provider
 } // namespace esp_matter
@@ -34,7 +34,72 @@ int http_downloader_read(esp_http_client_handle_t http_client, char *buf, size_t
 
 void http_downloader_abort(esp_http_client_handle_t http_client);
 
-esp_err_t http_downloader_start(esp_http_client_config_t *config, esp_http_client_handle_t *http_client);
+/**
+ * Connect to the HTTP server and fetch the headers of the response
+ *
+ * @param[in] config Config of the HTTP client.
+ * @param[in] range_start Offset of the first byte to download. If the server does not support the range requests,
+ *                        the first bytes of the response are discarded.
+ * @param[out] http_client HTTP client to read the data with http_downloader_read().
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t http_downloader_start(esp_http_client_config_t *config, size_t range_start,
+                                esp_http_client_handle_t *http_client);
+
+typedef struct http_prefetcher *http_prefetcher_handle_t;
+
+/**
+ * Start downloading in a background task which fills a ring buffer ahead of the reader
+ *
+ * The HTTP connection is established by the task, so this function does not block on the network.
+ *
+ * @param[in] config Config of the HTTP client, the URL is copied.
+ * @param[in] range_start Offset of the first byte to download.
+ * @param[in] buffer_size Size of the ring buffer.
+ * @param[out] handle Handle of the prefetcher.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t http_prefetcher_start(const esp_http_client_config_t *config, size_t range_start, size_t buffer_size,
+                                http_prefetcher_handle_t *handle);
+
+/**
+ * Check whether http_prefetcher_read() would copy the data without blocking
+ *
+ * @param[in] handle Handle of the prefetcher.
+ * @param[in] size Size of the data to read.
+ *
+ * @return ESP_OK if the data is ready or the download is finished.
+ * @return ESP_ERR_NOT_FINISHED if the data is not ready yet.
+ * @return ESP_ERR_INVALID_SIZE if size is larger than the ring buffer.
+ * @return ESP_FAIL if the download failed.
+ */
+esp_err_t http_prefetcher_is_ready(http_prefetcher_handle_t handle, size_t size);
+
+/**
+ * Copy the downloaded data without blocking
+ *
+ * The data is only copied when size bytes are ready or when the download is finished, so that a block is never split.
+ *
+ * @param[in] handle Handle of the prefetcher.
+ * @param[out] buf Buffer to copy the data to.
+ * @param[in] size Size of the data to read.
+ * @param[out] read_len Length of the data copied, 0 at the end of the download.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_FINISHED if the data is not ready yet.
+ * @return ESP_ERR_INVALID_SIZE if size is larger than the ring buffer.
+ * @return ESP_FAIL if the download failed.
+ */
+esp_err_t http_prefetcher_read(http_prefetcher_handle_t handle, uint8_t *buf, size_t size, size_t *read_len);
+
+/**
+ * Stop the download, the resources are released by the background task and the handle could not be used anymore.
+ */
+void http_prefetcher_stop(http_prefetcher_handle_t handle);
 
 } // namespace ota_provider
 } // namespace esp_matter
@@ -0,0 +1,86 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp_matter {
+namespace ota_provider {
+
+typedef int ota_image_cache_handle_t;
+
+static constexpr ota_image_cache_handle_t k_invalid_ota_image_cache_handle = -1;
+
+/**
+ * Initialize the OTA image cache on the data partition CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_PARTITION_LABEL
+ *
+ * The partition is split in CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_MAX_IMAGES slots, the images cached before the
+ * reboot are kept.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t ota_image_cache_init();
+
+/**
+ * Request an image to be cached, the image is downloaded by a background task
+ *
+ * This function does nothing if the image is already cached or being cached. A cached image at the same URL whose
+ * digest does not match is invalidated and the image is cached again.
+ *
+ * @param[in] url URL of the image.
+ * @param[in] size Size of the image in the DCL record, 0 if unknown.
+ * @param[in] digest SHA-256 digest of the image in the DCL record, NULL if unknown.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t ota_image_cache_add(const char *url, size_t size, const uint8_t *digest);
+
+/**
+ * Acquire a verified cached image, the image will not be evicted until it is released
+ *
+ * @param[in] url URL of the image.
+ * @param[in] digest SHA-256 digest of the image in the DCL record, NULL if unknown.
+ * @param[out] handle Handle of the cached image.
+ * @param[out] size Size of the cached image.
+ *
+ * @return ESP_OK on success.
+ * @return ESP_ERR_NOT_FOUND if the image is not cached or its digest does not match.
+ */
+esp_err_t ota_image_cache_acquire(const char *url, const uint8_t *digest, ota_image_cache_handle_t *handle,
+                                  size_t *size);
+
+/**
+ * Read an acquired cached image
+ *
+ * @param[in] handle Handle of the cached image.
+ * @param[in] offset Offset in the image.
+ * @param[out] buf Buffer to read the data to.
+ * @param[in] size Size of the data to read.
+ * @param[out] read_len Length of the data read, less than size at the end of the image.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t ota_image_cache_read(ota_image_cache_handle_t handle, size_t offset, uint8_t *buf, size_t size,
+                               size_t *read_len);
+
+void ota_image_cache_release(ota_image_cache_handle_t handle);
+
+} // namespace ota_provider
+} // namespace esp_matter
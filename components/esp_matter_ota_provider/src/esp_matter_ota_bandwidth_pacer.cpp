@@ -0,0 +1,51 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <esp_matter_ota_bandwidth_pacer.h>
+#include <esp_timer.h>
+
+namespace esp_matter {
+namespace ota_provider {
+
+void OtaBandwidthPacer::SetRate(uint32_t bytesPerSecond)
+{
+    mBytesPerSecond = bytesPerSecond;
+    // Allow a burst of a quarter of a second so that the blocks of several transfers are interleaved
+    mCapacity = bytesPerSecond / 4;
+    mTokens = mCapacity;
+    mLastRefillTimeUs = esp_timer_get_time();
+}
+
+bool OtaBandwidthPacer::IsReady(size_t bytes)
+{
+    if (mBytesPerSecond == 0) {
+        return true;
+    }
+    int64_t now = esp_timer_get_time();
+    mTokens = std::min(mCapacity, mTokens + (now - mLastRefillTimeUs) * mBytesPerSecond / 1000000);
+    mLastRefillTimeUs = now;
+    // A block larger than the burst is sent when the bucket is full, and the next blocks wait for the debt.
+    return mTokens >= std::min(static_cast<int64_t>(bytes), mCapacity);
+}
+
+void OtaBandwidthPacer::Consume(size_t bytes)
+{
+    if (mBytesPerSecond != 0) {
+        mTokens -= static_cast<int64_t>(bytes);
+    }
+}
+
+} // namespace ota_provider
+} // namespace esp_matter
@@ -0,0 +1,148 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <esp_matter_ota_bdx_admission.h>
+#include <esp_timer.h>
+
+static constexpr char TAG[] = "ota_provider";
+
+namespace esp_matter {
+namespace ota_provider {
+
+// A requestor which got a busy response keeps its turn for a while, longer than the delayed action time of the
+// busy response, and loses it if it does not query again.
+constexpr int64_t kWaitingRequestorLifetimeUs = 10 * 60 * 1000 * 1000LL;
+
+OtaBdxSessionAdmission::OtaBdxSessionAdmission() : mSessions{}, mMaxSessions(kMaxSessions), mWaitingRequestorCount(0)
+{
+}
+
+int OtaBdxSessionAdmission::AcquireSession(const chip::ScopedNodeId &nodeId, uint8_t networkId)
+{
+    // The requestor queries again while it already holds a session, its transfer restarts in the same session.
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSessions[i].mInUse && mSessions[i].mNodeId == nodeId) {
+            mSessions[i].mNetworkId = networkId;
+            return static_cast<int>(i);
+        }
+    }
+
+    size_t activeSessions = GetActiveSessionCount();
+    size_t freeSessions = activeSessions < mMaxSessions ? mMaxSessions - activeSessions : 0;
+    if (freeSessions == 0 || IsReservedForOthers(nodeId, freeSessions)) {
+        AddWaitingRequestor(nodeId);
+        return kNoSession;
+    }
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (!mSessions[i].mInUse) {
+            mSessions[i].mNodeId = nodeId;
+            mSessions[i].mNetworkId = networkId;
+            mSessions[i].mInUse = true;
+            RemoveWaitingRequestor(nodeId);
+            return static_cast<int>(i);
+        }
+    }
+    return kNoSession;
+}
+
+void OtaBdxSessionAdmission::ReleaseSession(int session)
+{
+    if (session >= 0 && static_cast<size_t>(session) < kMaxSessions) {
+        mSessions[session] = {};
+    }
+}
+
+esp_err_t OtaBdxSessionAdmission::SetMaxSessions(uint8_t maxSessions)
+{
+    ESP_RETURN_ON_FALSE(maxSessions > 0 && maxSessions <= kMaxSessions, ESP_ERR_INVALID_ARG, TAG,
+                        "Max sessions should be in range [1, %u]", static_cast<unsigned>(kMaxSessions));
+    // The sessions in use above the new limit finish their transfers, new transfers are limited.
+    mMaxSessions = maxSessions;
+    return ESP_OK;
+}
+
+size_t OtaBdxSessionAdmission::GetActiveSessionCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSessions[i].mInUse) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t OtaBdxSessionAdmission::GetNetworkSessionCount(uint8_t networkId) const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSessions[i].mInUse && mSessions[i].mNetworkId == networkId) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool OtaBdxSessionAdmission::IsReservedForOthers(const chip::ScopedNodeId &nodeId, size_t freeSessions)
+{
+    int64_t now = esp_timer_get_time();
+    size_t i = 0;
+    while (i < mWaitingRequestorCount) {
+        if (mWaitingRequestors[i].mExpireTimeUs < now) {
+            RemoveWaitingRequestor(mWaitingRequestors[i].mNodeId);
+        } else {
+            ++i;
+        }
+    }
+    // The requestors which have been waiting longer are served first.
+    size_t ahead = 0;
+    for (i = 0; i < mWaitingRequestorCount && mWaitingRequestors[i].mNodeId != nodeId; ++i) {
+        ahead++;
+    }
+    return ahead >= freeSessions;
+}
+
+void OtaBdxSessionAdmission::AddWaitingRequestor(const chip::ScopedNodeId &nodeId)
+{
+    int64_t expireTimeUs = esp_timer_get_time() + kWaitingRequestorLifetimeUs;
+    for (size_t i = 0; i < mWaitingRequestorCount; ++i) {
+        if (mWaitingRequestors[i].mNodeId == nodeId) {
+            mWaitingRequestors[i].mExpireTimeUs = expireTimeUs;
+            return;
+        }
+    }
+    if (mWaitingRequestorCount < kMaxWaitingRequestors) {
+        mWaitingRequestors[mWaitingRequestorCount].mNodeId = nodeId;
+        mWaitingRequestors[mWaitingRequestorCount].mExpireTimeUs = expireTimeUs;
+        mWaitingRequestorCount++;
+    }
+}
+
+void OtaBdxSessionAdmission::RemoveWaitingRequestor(const chip::ScopedNodeId &nodeId)
+{
+    for (size_t i = 0; i < mWaitingRequestorCount; ++i) {
+        if (mWaitingRequestors[i].mNodeId == nodeId) {
+            for (size_t j = i + 1; j < mWaitingRequestorCount; ++j) {
+                mWaitingRequestors[j - 1] = mWaitingRequestors[j];
+            }
+            mWaitingRequestorCount--;
+            return;
+        }
+    }
+}
+
+} // namespace ota_provider
+} // namespace esp_matter
@@ -12,10 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <esp_check.h>
 #include <esp_crt_bundle.h>
 #include <esp_log.h>
 #include <esp_matter_ota_bdx_sender.h>
 #include <esp_matter_ota_http_downloader.h>
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+#include <esp_matter_ota_image_cache.h>
+#endif
+#include <esp_timer.h>
 
 #include <lib/core/CHIPError.h>
 #include <lib/support/BitFlags.h>
@@ -33,6 +39,16 @@ using chip::bdx::TransferSession;
 namespace esp_matter {
 namespace ota_provider {
 
+// The block size is not adapted below this size, or below the negotiated block size if it is smaller
+constexpr uint16_t kMinAdaptiveBlockSize = 256;
+constexpr uint16_t kBlockSizeIncrement = 128;
+// A round trip this much longer than the minimum round trip is a retransmission or a congested link
+constexpr int64_t kRttCongestionFactor = 3;
+constexpr int64_t kRttCongestionMinExtraUs = 200 * 1000;
+constexpr uint32_t kMinPollIntervalMs = 10;
+// A block is only sent once all its data is in the prefetch buffer, which keeps room for the download of the next block
+constexpr uint16_t kMaxPrefetchBlockSize = CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE / 2;
+
 esp_err_t OtaBdxSender::InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
 {
     if (mInitialized) {
@@ -78,8 +94,18 @@ void OtaBdxSender::HandleTransferSessionOutput(TransferSession::OutputEvent &eve
     if (event.EventType != TransferSession::OutputEventType::kNone) {
         ESP_LOGD(TAG, "OutputEvent type: %s", event.ToString(event.EventType));
     }
+    if ((event.EventType == TransferSession::OutputEventType::kQueryReceived ||
+         event.EventType == TransferSession::OutputEventType::kQueryWithSkipReceived) &&
+        mBlockSentTimeUs != 0) {
+        OnBlockRoundTrip(esp_timer_get_time() - mBlockSentTimeUs);
+        mBlockSentTimeUs = 0;
+    }
     switch (event.EventType) {
     case TransferSession::OutputEventType::kNone:
+        // The block query is deferred until the prefetcher has the data, retry at each poll of the transfer session.
+        if (mBlockQueryPending) {
+            SendBlockIfReady();
+        }
         break;
     case TransferSession::OutputEventType::kMsgToSend: {
         chip::Messaging::SendFlags sendFlags;
@@ -116,64 +142,58 @@ void OtaBdxSender::HandleTransferSessionOutput(TransferSession::OutputEvent &eve
             ESP_LOGE(TAG, "AcceptTransfter failed error:%" CHIP_ERROR_FORMAT, err.Format());
             return;
         }
-        // Establish http connection
-        esp_http_client_config_t config = {
-            .url = mOtaImageUrl,
-            .event_handler = NULL,
-            .transport_type = HTTP_TRANSPORT_OVER_SSL,
-            .skip_cert_common_name_check = false,
-            .crt_bundle_attach = esp_crt_bundle_attach,
-            .keep_alive_enable = true,
-        };
-        if (mHttpDownloader) {
-            http_downloader_abort(mHttpDownloader);
-        }
-        if (http_downloader_start(&config, &mHttpDownloader) != ESP_OK) {
+        mBasePollFreq = mPollFreq;
+        // The requestor resumes an interrupted download
+        mImageOffset = acceptData.StartOffset;
+        if (mImageOffset > 0) {
+            ESP_LOGI(TAG, "Resume the transfer at offset %" PRIu64, mImageOffset);
+        }
+        if (StartImageSource() != ESP_OK) {
             mTransfer.AbortTransfer(StatusCode::kUnknown);
+            break;
+        }
+        mBlockSize = GetMaxBlockSize();
+        mMinBlockSize = mBlockSize;
+        mTransferStartTimeUs = esp_timer_get_time();
+        if (mTransferEventCallback) {
+            mTransferEventCallback(this, kTransferStarted, mTransferEventCallbackCtx);
         }
         break;
     }
     case TransferSession::OutputEventType::kQueryReceived: {
-        TransferSession::BlockData blockData;
-        uint16_t bytesToRead = mTransfer.GetTransferBlockSize();
-
-        chip::System::PacketBufferHandle blockBuf = chip::System::PacketBufferHandle::New(bytesToRead);
-        if (blockBuf.IsNull()) {
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
-            return;
-        }
-        // Read http response
-        int bytes_read =
-            http_downloader_read(mHttpDownloader, reinterpret_cast<char *>(blockBuf->Start()), bytesToRead);
-        if (bytes_read < 0) {
-            ESP_LOGE(TAG, "http_downloader_read failed");
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
+        mBlockQueryPending = true;
+        SendBlockIfReady();
+        break;
+    }
+    case TransferSession::OutputEventType::kQueryWithSkipReceived: {
+        // The requestor already has the data, which is the case when it resumes an interrupted download
+        mImageOffset += event.bytesToSkip.BytesToSkip;
+        ESP_LOGI(TAG, "Skip %" PRIu64 " bytes, continue the transfer at offset %" PRIu64,
+                 event.bytesToSkip.BytesToSkip, mImageOffset);
+        if (mOtaImageSize != 0 && mImageOffset > mOtaImageSize) {
+            ESP_LOGE(TAG, "Skip beyond the end of the image");
+            mTransfer.AbortTransfer(StatusCode::kBadMessageContents);
             break;
         }
-        if (mOtaImageSize == 0 && mNumBytesSent == 0) {
-            if (ParseOtaImageHeader(blockBuf->Start(), static_cast<size_t>(bytes_read)) != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to Parse OTA image header");
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+        // The cache is read at the offset of each block
+        if (mImageCacheHandle == k_invalid_ota_image_cache_handle)
+#endif
+        {
+            if (StartDownload() != ESP_OK) {
                 mTransfer.AbortTransfer(StatusCode::kUnknown);
                 break;
             }
         }
-        blockData.Data = blockBuf->Start();
-        blockData.Length =
-            static_cast<size_t>(std::min(static_cast<uint64_t>(bytes_read), (mOtaImageSize - mNumBytesSent)));
-        blockData.IsEof = (blockData.Length < bytesToRead) ||
-            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mOtaImageSize);
-        mNumBytesSent = static_cast<uint64_t>(mNumBytesSent + blockData.Length);
-
-        if (CHIP_NO_ERROR != mTransfer.PrepareBlock(blockData)) {
-            ESP_LOGE(TAG, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, err.Format());
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
-        }
+        mBlockQueryPending = true;
+        SendBlockIfReady();
         break;
     }
     case TransferSession::OutputEventType::kAckReceived:
         break;
     case TransferSession::OutputEventType::kAckEOFReceived: {
         ESP_LOGI(TAG, "Transfer completed, got AckEOF");
+        mTransferSucceeded = true;
         Reset();
         break;
     }
@@ -201,8 +221,207 @@ void OtaBdxSender::HandleTransferSessionOutput(TransferSession::OutputEvent &eve
     return;
 }
 
+esp_err_t OtaBdxSender::StartImageSource()
+{
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+    size_t cachedImageSize = 0;
+    if (ota_image_cache_acquire(mOtaImageUrl, mHasOtaImageDigest ? mOtaImageDigest : nullptr,
+                                &mImageCacheHandle, &cachedImageSize) == ESP_OK) {
+        ESP_LOGI(TAG, "Serve the OTA image from the flash cache, %u bytes", static_cast<unsigned>(cachedImageSize));
+        mOtaImageSize = cachedImageSize;
+        ESP_RETURN_ON_FALSE(mImageOffset <= mOtaImageSize, ESP_ERR_INVALID_ARG, TAG, "Invalid start offset");
+        return ESP_OK;
+    }
+#endif
+    ESP_RETURN_ON_FALSE(mOtaImageSize == 0 || mImageOffset <= mOtaImageSize, ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid start offset");
+    return StartDownload();
+}
+
+esp_err_t OtaBdxSender::StartDownload()
+{
+    // Download the image in the background, the http connection is established by the prefetch task
+    esp_http_client_config_t config = {
+        .url = mOtaImageUrl,
+        .event_handler = NULL,
+        .transport_type = HTTP_TRANSPORT_OVER_SSL,
+        .skip_cert_common_name_check = false,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .keep_alive_enable = true,
+    };
+    if (mPrefetcher) {
+        http_prefetcher_stop(mPrefetcher);
+        mPrefetcher = nullptr;
+    }
+    return http_prefetcher_start(&config, static_cast<size_t>(mImageOffset),
+                                 CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE, &mPrefetcher);
+}
+
+esp_err_t OtaBdxSender::IsImageDataReady(size_t size)
+{
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+    if (mImageCacheHandle != k_invalid_ota_image_cache_handle) {
+        return ESP_OK;
+    }
+#endif
+    return http_prefetcher_is_ready(mPrefetcher, size);
+}
+
+esp_err_t OtaBdxSender::ReadImageData(uint8_t *buf, size_t size, size_t *readLen)
+{
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+    if (mImageCacheHandle != k_invalid_ota_image_cache_handle) {
+        return ota_image_cache_read(mImageCacheHandle, mImageOffset, buf, size, readLen);
+    }
+#endif
+    // Copy the prefetched data, never wait for the network on the Matter thread
+    return http_prefetcher_read(mPrefetcher, buf, size, readLen);
+}
+
+void OtaBdxSender::SendBlockIfReady()
+{
+    TransferSession::BlockData blockData;
+    uint16_t bytesToRead = mBlockSize;
+    size_t bytesRead = 0;
+
+    // Hold the block until the bandwidth budget of the transfer allows it
+    if (mBlockPacer && !mBlockPacer->IsReady(bytesToRead)) {
+        mNumPacedBlocks++;
+        return;
+    }
+    esp_err_t err = IsImageDataReady(bytesToRead);
+    if (err == ESP_ERR_NOT_FINISHED) {
+        mNumBlockDeferrals++;
+        return;
+    }
+    mBlockQueryPending = false;
+    // The packet buffer is only allocated once the block is sent, not on each poll of a deferred block.
+    chip::System::PacketBufferHandle blockBuf;
+    if (err == ESP_OK) {
+        blockBuf = chip::System::PacketBufferHandle::New(bytesToRead);
+        if (blockBuf.IsNull()) {
+            mTransfer.AbortTransfer(StatusCode::kUnknown);
+            return;
+        }
+        err = ReadImageData(blockBuf->Start(), bytesToRead, &bytesRead);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read the image data");
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+        return;
+    }
+    if (mImageOffset == 0) {
+        if (ParseOtaImageHeader(blockBuf->Start(), bytesRead) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to Parse OTA image header");
+            mTransfer.AbortTransfer(StatusCode::kUnknown);
+            return;
+        }
+    }
+    blockData.Data = blockBuf->Start();
+    blockData.Length = bytesRead;
+    // Without the image size, a transfer resumed at an offset ends with the short read of the end of the image
+    if (mOtaImageSize != 0) {
+        blockData.Length =
+            static_cast<size_t>(std::min(static_cast<uint64_t>(bytesRead), (mOtaImageSize - mImageOffset)));
+    }
+    blockData.IsEof = (blockData.Length < bytesToRead) ||
+        (mImageOffset + static_cast<uint64_t>(blockData.Length) == mOtaImageSize);
+    mImageOffset = static_cast<uint64_t>(mImageOffset + blockData.Length);
+    mNumBytesSent = static_cast<uint64_t>(mNumBytesSent + blockData.Length);
+    if (mBlockPacer) {
+        mBlockPacer->Consume(blockData.Length);
+    }
+
+    CHIP_ERROR chipErr = mTransfer.PrepareBlock(blockData);
+    if (chipErr != CHIP_NO_ERROR) {
+        ESP_LOGE(TAG, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, chipErr.Format());
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+        return;
+    }
+    mNumBlocksSent++;
+    mBlockSentTimeUs = esp_timer_get_time();
+}
+
+void OtaBdxSender::OnBlockRoundTrip(int64_t rttUs)
+{
+    mRttMinUs = mNumRttSamples == 0 ? rttUs : std::min(mRttMinUs, rttUs);
+    mRttMaxUs = std::max(mRttMaxUs, rttUs);
+    mRttSumUs += rttUs;
+    mRttSmoothedUs = mNumRttSamples == 0 ? rttUs : (7 * mRttSmoothedUs + rttUs) / 8;
+    mNumRttSamples++;
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_BDX_ADAPTIVE_BLOCK_SIZE
+    uint16_t maxBlockSize = GetMaxBlockSize();
+    if (rttUs > kRttCongestionFactor * mRttMinUs && rttUs > mRttMinUs + kRttCongestionMinExtraUs) {
+        // The smaller blocks are cheaper to retransmit, and have fewer fragments to lose on Thread
+        uint16_t blockSize =
+            std::max(std::min(kMinAdaptiveBlockSize, maxBlockSize), static_cast<uint16_t>(mBlockSize / 2));
+        if (blockSize < mBlockSize) {
+            ESP_LOGD(TAG, "Round trip of %" PRId64 " ms, block size %u -> %u", rttUs / 1000, mBlockSize, blockSize);
+            mBlockSize = blockSize;
+            mMinBlockSize = std::min(mMinBlockSize, mBlockSize);
+            mNumBlockSizeDecreases++;
+        }
+    } else if (rttUs <= mRttMinUs * 3 / 2 && mBlockSize < maxBlockSize) {
+        mBlockSize = static_cast<uint16_t>(std::min<uint32_t>(maxBlockSize, mBlockSize + kBlockSizeIncrement));
+    }
+    // Retry the deferred blocks within half a round trip, never less often than the configured poll interval
+    uint32_t pollIntervalMs = std::max(kMinPollIntervalMs, static_cast<uint32_t>(mRttSmoothedUs / 2000));
+    mPollFreq = std::min(mBasePollFreq, chip::System::Clock::Timeout(pollIntervalMs));
+#endif
+}
+
+void OtaBdxSender::UpdateLastTransferStats()
+{
+    TransferStats &stats = mLastTransferStats;
+    stats.mBytesSent = mNumBytesSent;
+    stats.mBlocksSent = mNumBlocksSent;
+    stats.mDurationMs = static_cast<uint32_t>((esp_timer_get_time() - mTransferStartTimeUs) / 1000);
+    stats.mThroughput = stats.mDurationMs > 0 ? static_cast<uint32_t>(mNumBytesSent * 1000 / stats.mDurationMs) : 0;
+    stats.mMaxBlockSize = mTransfer.GetTransferBlockSize();
+    stats.mMinBlockSize = mMinBlockSize;
+    stats.mBlockSize = mBlockSize;
+    stats.mBlockSizeDecreases = mNumBlockSizeDecreases;
+    stats.mRttMinMs = static_cast<uint32_t>(mRttMinUs / 1000);
+    stats.mRttAvgMs = mNumRttSamples > 0 ? static_cast<uint32_t>(mRttSumUs / mNumRttSamples / 1000) : 0;
+    stats.mRttMaxMs = static_cast<uint32_t>(mRttMaxUs / 1000);
+    stats.mBlockDeferrals = mNumBlockDeferrals;
+    stats.mPacedBlocks = mNumPacedBlocks;
+}
+
 void OtaBdxSender::Reset()
 {
+    if (mTransferStartTimeUs != 0) {
+        UpdateLastTransferStats();
+        const TransferStats &stats = mLastTransferStats;
+        ESP_LOGI(TAG, "Transfer to node 0x%" PRIx64 " %s: %" PRIu64 " bytes in %" PRIu32 " ms (%" PRIu32
+                 " B/s), %" PRIu32 " block polls waited for the download, %" PRIu32 " for the bandwidth budget",
+                 mNodeId.ValueOr(chip::kUndefinedNodeId), mTransferSucceeded ? "completed" : "failed", stats.mBytesSent,
+                 stats.mDurationMs, stats.mThroughput, stats.mBlockDeferrals, stats.mPacedBlocks);
+        ESP_LOGI(TAG, "%" PRIu32 " blocks of %u bytes at most, %u at least, %" PRIu32 " decreases, round trip %" PRIu32
+                 "/%" PRIu32 "/%" PRIu32 " ms min/avg/max",
+                 stats.mBlocksSent, stats.mMaxBlockSize, stats.mMinBlockSize, stats.mBlockSizeDecreases,
+                 stats.mRttMinMs, stats.mRttAvgMs, stats.mRttMaxMs);
+        if (mTransferEventCallback) {
+            mTransferEventCallback(this, mTransferSucceeded ? kTransferCompleted : kTransferFailed,
+                                   mTransferEventCallbackCtx);
+        }
+    }
+    mTransferStartTimeUs = 0;
+    mTransferSucceeded = false;
+    mBlockQueryPending = false;
+    mNumBlockDeferrals = 0;
+    mNumPacedBlocks = 0;
+    mBlockPacer = nullptr;
+    mBlockSize = 0;
+    mMinBlockSize = 0;
+    mNumBlocksSent = 0;
+    mNumBlockSizeDecreases = 0;
+    mBlockSentTimeUs = 0;
+    mRttMinUs = 0;
+    mRttMaxUs = 0;
+    mRttSumUs = 0;
+    mRttSmoothedUs = 0;
+    mNumRttSamples = 0;
     mFabricIndex.ClearValue();
     mNodeId.ClearValue();
     ResetTransfer();
@@ -213,13 +432,25 @@ void OtaBdxSender::Reset()
 
     mInitialized = false;
     mNumBytesSent = 0;
+    mImageOffset = 0;
     mOtaImageSize = 0;
-    if (mHttpDownloader) {
-        // Release current http client
-        http_downloader_abort(mHttpDownloader);
+    if (mPrefetcher) {
+        // The prefetch task releases the http client
+        http_prefetcher_stop(mPrefetcher);
     }
-    mHttpDownloader = nullptr;
+    mPrefetcher = nullptr;
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+    ota_image_cache_release(mImageCacheHandle);
+    mImageCacheHandle = k_invalid_ota_image_cache_handle;
+#endif
     memset(mOtaImageUrl, 0, sizeof(mOtaImageUrl));
+    mHasOtaImageDigest = false;
+}
+
+uint16_t OtaBdxSender::GetMaxBlockSize() const
+{
+    uint16_t maxBlockSize = mTransfer.GetTransferBlockSize();
+    return mPrefetcher ? std::min(maxBlockSize, kMaxPrefetchBlockSize) : maxBlockSize;
 }
 
 uint16_t OtaBdxSender::GetTransferBlockSize(void)
@@ -232,5 +463,151 @@ uint64_t OtaBdxSender::GetTransferLength()
     return mTransfer.GetTransferLength();
 }
 
+OtaBdxSenderPool::OtaBdxSenderPool()
+    : mStats{}
+    , mTransferHistoryNext(0)
+    , mTransferHistoryCount(0)
+    , mTransferringCount(0)
+    , mActiveStartTimeUs(0)
+{
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        mSenders[i].SetTransferEventCallback(TransferEventCallback, this);
+    }
+}
+
+OtaBdxSender *OtaBdxSenderPool::AllocateSender(chip::FabricIndex fabricIndex, chip::NodeId nodeId, uint8_t networkId)
+{
+    SyncSessions();
+    // The requestor which queries again while it already owns a sender restarts its transfer with the same sender.
+    int session = mAdmission.AcquireSession(chip::ScopedNodeId(nodeId, fabricIndex), networkId);
+    if (session == OtaBdxSessionAdmission::kNoSession) {
+        mStats.mBusyRejections++;
+        return nullptr;
+    }
+    if (mSenders[session].InitializeTransfer(fabricIndex, nodeId) != ESP_OK) {
+        mAdmission.ReleaseSession(session);
+        return nullptr;
+    }
+    return &mSenders[session];
+}
+
+size_t OtaBdxSenderPool::GetNetworkSessionCount(uint8_t networkId)
+{
+    SyncSessions();
+    return mAdmission.GetNetworkSessionCount(networkId);
+}
+
+void OtaBdxSenderPool::SyncSessions()
+{
+    // The senders reset themselves when their transfer finishes or times out
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mAdmission.IsSessionInUse(static_cast<int>(i)) && !mSenders[i].IsInitialized()) {
+            mAdmission.ReleaseSession(static_cast<int>(i));
+        }
+    }
+}
+
+size_t OtaBdxSenderPool::GetActiveSessionCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSenders[i].IsInitialized()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void OtaBdxSenderPool::GetStats(Stats &stats)
+{
+    stats = mStats;
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSenders[i].IsTransferring()) {
+            stats.mBytesSent += mSenders[i].GetNumBytesSent();
+        }
+    }
+    if (mTransferringCount > 0) {
+        stats.mActiveTimeUs += esp_timer_get_time() - mActiveStartTimeUs;
+    }
+    stats.mAggregateThroughput =
+        stats.mActiveTimeUs > 0 ? static_cast<uint32_t>(stats.mBytesSent * 1000000 / stats.mActiveTimeUs) : 0;
+}
+
+void OtaBdxSenderPool::ResetStats()
+{
+    mStats = {};
+    mTransferHistoryNext = 0;
+    mTransferHistoryCount = 0;
+    mActiveStartTimeUs = esp_timer_get_time();
+}
+
+size_t OtaBdxSenderPool::GetTransferHistory(TransferRecord *records, size_t maxRecords) const
+{
+    size_t count = std::min(maxRecords, mTransferHistoryCount);
+    for (size_t i = 0; i < count; ++i) {
+        records[i] = mTransferHistory[(mTransferHistoryNext + kTransferHistorySize - 1 - i) % kTransferHistorySize];
+    }
+    return count;
+}
+
+CHIP_ERROR OtaBdxSenderPool::OnUnsolicitedMessageReceived(const chip::PayloadHeader &payloadHeader,
+                                                          chip::Messaging::ExchangeDelegate *&newDelegate)
+{
+    // The requestor is only known from the exchange of the first message, so receive it here and hand the
+    // exchange to the sender prepared for the requestor.
+    newDelegate = this;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OtaBdxSenderPool::OnMessageReceived(chip::Messaging::ExchangeContext *ec,
+                                               const chip::PayloadHeader &payloadHeader,
+                                               chip::System::PacketBufferHandle &&payload)
+{
+    VerifyOrReturnError(ec && ec->HasSessionHandle(), CHIP_ERROR_INCORRECT_STATE);
+    chip::ScopedNodeId peer = ec->GetSessionHandle()->GetPeer();
+    for (size_t i = 0; i < kMaxSessions; ++i) {
+        if (mSenders[i].IsInitializedFor(peer.GetFabricIndex(), peer.GetNodeId())) {
+            ec->SetDelegate(&mSenders[i]);
+            chip::Messaging::ExchangeDelegate &delegate = mSenders[i];
+            return delegate.OnMessageReceived(ec, payloadHeader, std::move(payload));
+        }
+    }
+    ESP_LOGE(TAG, "No BDX sender prepared for node 0x%" PRIx64, peer.GetNodeId());
+    return CHIP_ERROR_INCORRECT_STATE;
+}
+
+void OtaBdxSenderPool::TransferEventCallback(OtaBdxSender *sender, OtaBdxSender::TransferEvent event, void *ctx)
+{
+    OtaBdxSenderPool *pool = static_cast<OtaBdxSenderPool *>(ctx);
+    int64_t now = esp_timer_get_time();
+    if (event == OtaBdxSender::kTransferStarted) {
+        if (pool->mTransferringCount++ == 0) {
+            pool->mActiveStartTimeUs = now;
+        }
+        if (pool->mTransferEventObserver) {
+            pool->mTransferEventObserver(sender, event, pool->mTransferEventObserverCtx);
+        }
+        return;
+    }
+    pool->mStats.mBytesSent += sender->GetNumBytesSent();
+    TransferRecord &record = pool->mTransferHistory[pool->mTransferHistoryNext];
+    record.mNodeId = sender->GetPeerNodeId();
+    record.mSucceeded = event == OtaBdxSender::kTransferCompleted;
+    record.mStats = sender->GetLastTransferStats();
+    pool->mTransferHistoryNext = (pool->mTransferHistoryNext + 1) % kTransferHistorySize;
+    pool->mTransferHistoryCount = std::min(pool->mTransferHistoryCount + 1, kTransferHistorySize);
+    if (event == OtaBdxSender::kTransferCompleted) {
+        pool->mStats.mTransfersCompleted++;
+    } else {
+        pool->mStats.mTransfersFailed++;
+    }
+    if (pool->mTransferringCount > 0 && --pool->mTransferringCount == 0) {
+        pool->mStats.mActiveTimeUs += now - pool->mActiveStartTimeUs;
+    }
+    if (pool->mTransferEventObserver) {
+        pool->mTransferEventObserver(sender, event, pool->mTransferEventObserverCtx);
+    }
+}
+
 } // namespace ota_provider
 } // namespace esp_matter
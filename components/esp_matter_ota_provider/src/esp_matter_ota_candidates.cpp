@@ -28,6 +28,7 @@
 #include <freertos/task.h>
 #include <functional>
 #include <json_parser.h>
+#include <mbedtls/base64.h>
 
 #include <lib/support/ScopedBuffer.h>
 
@@ -46,11 +47,50 @@ static constexpr char dcl_rest_url[] = "https://on.dcl.csa-iot.org/dcl/model/ver
 static constexpr char dcl_rest_url[] = "https://on.test-net.dcl.csa-iot.org/dcl/model/versions";
 #endif
 static constexpr size_t max_ota_candidate_count = CONFIG_ESP_MATTER_MAX_OTA_CANDIDATES_COUNT;
+static constexpr int64_t k_candidate_ttl_us = (int64_t)CONFIG_ESP_MATTER_OTA_CANDIDATES_TTL * 3600 * 1000 * 1000;
+static constexpr int64_t k_no_update_ttl_us = (int64_t)CONFIG_ESP_MATTER_OTA_CANDIDATES_NO_UPDATE_TTL * 60 * 1000 * 1000;
 
-static model_version_t *_ota_candidates_cache[max_ota_candidate_count];
+static constexpr size_t _bucket_count(size_t count)
+{
+    return count <= 1 ? 1 : 2 * _bucket_count((count + 1) / 2);
+}
+// Power of two not smaller than the cache size, so that a bucket has one entry on average
+static constexpr size_t k_bucket_count = _bucket_count(max_ota_candidate_count);
+static constexpr int16_t k_invalid_index = -1;
+// Software versions without update remembered by an entry, the requestors of a model usually run a few versions
+static constexpr size_t k_max_no_update_versions = 4;
+
+typedef struct {
+    uint32_t software_version;
+    int64_t expire_time_us;
+} no_update_version_t;
+
+// A cache entry is keyed by VendorID and ProductID. It holds the candidate of the model, if any, and the software
+// versions for which the DCL had no update, e.g. the version of the requestors already running the candidate. The DCL
+// record of an update has a range of applicable software versions, so a negative answer is only reused for the same
+// software version.
+typedef struct {
+    model_version_t model;
+    bool in_use;
+    bool has_candidate;
+    no_update_version_t no_update_versions[k_max_no_update_versions];
+    uint8_t no_update_count;
+    uint32_t last_used;
+    int64_t fetch_time_us;
+    int64_t expire_time_us;
+    int16_t next;
+} ota_candidate_entry_t;
+
+static ota_candidate_entry_t *_ota_candidates_cache = nullptr;
+static int16_t _ota_candidates_buckets[k_bucket_count];
+static uint32_t _ota_candidates_use_counter = 0;
+static EspOtaProvider::OtaCandidatesCacheStats _ota_candidates_stats;
+static portMUX_TYPE _ota_candidates_stats_lock = portMUX_INITIALIZER_UNLOCKED;
 static QueueHandle_t _ota_candidate_task_queue = NULL;
 #ifdef CONFIG_ESP_MATTER_OTA_CANDIDATES_UPDATE_PERIODICALLY
 static esp_timer_handle_t _ota_candidates_update_timer = NULL;
+static esp_timer_handle_t _ota_candidates_refresh_batch_timer = NULL;
+static int64_t _ota_candidates_refresh_round_start_us = 0;
 #endif
 
 typedef struct {
@@ -61,6 +101,13 @@ typedef struct {
     void *callback_args;
 } ota_candidate_fetch_action_t;
 
+#define OTA_CANDIDATES_STATS_INC(field)                                                                                \
+    do {                                                                                                               \
+        portENTER_CRITICAL(&_ota_candidates_stats_lock);                                                               \
+        _ota_candidates_stats.field++;                                                                                 \
+        portEXIT_CRITICAL(&_ota_candidates_stats_lock);                                                                \
+    } while (0)
+
 static bool _is_ota_candidate_valid(model_version_t *model, uint32_t current_software_version)
 {
     return model->software_version > current_software_version &&
@@ -68,53 +115,126 @@ static bool _is_ota_candidate_valid(model_version_t *model, uint32_t current_sof
         model->min_applicable_software_version <= current_software_version;
 }
 
-static int _search_ota_candidate(uint16_t vendor_id, uint16_t product_id, uint32_t software_ver)
+static size_t _ota_candidate_hash(uint16_t vendor_id, uint16_t product_id)
 {
-    for (size_t index = 0; index < max_ota_candidate_count; ++index) {
-        model_version_t *cur_model = _ota_candidates_cache[index];
-        if (cur_model) {
-            if (cur_model->vendor_id == vendor_id && cur_model->product_id == product_id) {
-                if (_is_ota_candidate_valid(cur_model, software_ver)) {
-                    return index;
-                } else {
-                    // This candidate is not valid, expire it.
-                    esp_matter_mem_free(cur_model);
-                    _ota_candidates_cache[index] = nullptr;
-                    return -1;
-                }
-            }
+    return ((static_cast<uint32_t>(vendor_id) << 16 | product_id) * 2654435761u >> 16) & (k_bucket_count - 1);
+}
+
+static ota_candidate_entry_t *_search_ota_candidate(uint16_t vendor_id, uint16_t product_id)
+{
+    int16_t index = _ota_candidates_buckets[_ota_candidate_hash(vendor_id, product_id)];
+    while (index != k_invalid_index) {
+        ota_candidate_entry_t *entry = &_ota_candidates_cache[index];
+        if (entry->model.vendor_id == vendor_id && entry->model.product_id == product_id) {
+            return entry;
         }
+        index = entry->next;
     }
-    return -1;
+    return nullptr;
 }
 
-static size_t _find_empty_ota_candidates()
+static void _remove_ota_candidate(ota_candidate_entry_t *entry)
 {
-    uint8_t oldest_candidate_lifetime = 0;
-    size_t oldest_candidate_index = 0;
-    for (size_t index = 0; index < max_ota_candidate_count; ++index) {
-        if (!_ota_candidates_cache[index]) {
-            return index;
-        } else {
-            if (oldest_candidate_lifetime < _ota_candidates_cache[index]->lifetime) {
-                oldest_candidate_lifetime = _ota_candidates_cache[index]->lifetime;
-                oldest_candidate_index = index;
-            }
+    int16_t entry_index = entry - _ota_candidates_cache;
+    int16_t *link = &_ota_candidates_buckets[_ota_candidate_hash(entry->model.vendor_id, entry->model.product_id)];
+    while (*link != k_invalid_index) {
+        if (*link == entry_index) {
+            *link = entry->next;
+            break;
         }
+        link = &_ota_candidates_cache[*link].next;
     }
-    // expire the oldest candidate
-    esp_matter_mem_free(_ota_candidates_cache[oldest_candidate_index]);
-    _ota_candidates_cache[oldest_candidate_index] = nullptr;
-    return oldest_candidate_index;
+    memset(entry, 0, sizeof(ota_candidate_entry_t));
+    entry->next = k_invalid_index;
 }
 
-static void _increase_ota_candidates_lifetime()
+// Return the entry of the VendorID and ProductID, a new entry is taken from the free entries or by evicting the least
+// recently used entry.
+static ota_candidate_entry_t *_get_or_add_ota_candidate(uint16_t vendor_id, uint16_t product_id)
 {
+    ota_candidate_entry_t *entry = _search_ota_candidate(vendor_id, product_id);
+    if (entry) {
+        return entry;
+    }
     for (size_t index = 0; index < max_ota_candidate_count; ++index) {
-        if (_ota_candidates_cache[index]) {
-            _ota_candidates_cache[index]->lifetime++;
+        ota_candidate_entry_t *cur = &_ota_candidates_cache[index];
+        if (!cur->in_use) {
+            entry = cur;
+            break;
+        }
+        if (!entry || cur->last_used < entry->last_used) {
+            entry = cur;
+        }
+    }
+    if (entry->in_use) {
+        ESP_LOGI(TAG, "Evict OTA candidate of VID 0x%x PID 0x%x", entry->model.vendor_id, entry->model.product_id);
+        OTA_CANDIDATES_STATS_INC(mEvictions);
+        _remove_ota_candidate(entry);
+    }
+    size_t bucket = _ota_candidate_hash(vendor_id, product_id);
+    entry->in_use = true;
+    entry->model.vendor_id = vendor_id;
+    entry->model.product_id = product_id;
+    entry->next = _ota_candidates_buckets[bucket];
+    _ota_candidates_buckets[bucket] = entry - _ota_candidates_cache;
+    return entry;
+}
+
+static no_update_version_t *_search_no_update_version(ota_candidate_entry_t *entry, uint32_t software_version)
+{
+    for (size_t index = 0; index < entry->no_update_count; ++index) {
+        if (entry->no_update_versions[index].software_version == software_version) {
+            return &entry->no_update_versions[index];
         }
     }
+    return nullptr;
+}
+
+// Keep the versions without update for which keep() returns true
+template <typename Predicate>
+static void _filter_no_update_versions(ota_candidate_entry_t *entry, Predicate keep)
+{
+    uint8_t count = 0;
+    for (size_t index = 0; index < entry->no_update_count; ++index) {
+        if (keep(entry->no_update_versions[index].software_version)) {
+            entry->no_update_versions[count++] = entry->no_update_versions[index];
+        }
+    }
+    entry->no_update_count = count;
+}
+
+// Record the fetch result of a software version. A negative result is added to the versions without update of the
+// entry, the version which expires first is replaced if the entry is full. A negative result does not replace the
+// candidate of an entry, which is still valid for the other versions.
+static void _set_ota_candidate_fetched(ota_candidate_entry_t *entry, bool has_candidate, uint32_t software_version)
+{
+    int64_t now = esp_timer_get_time();
+    if (has_candidate) {
+        entry->has_candidate = true;
+        entry->fetch_time_us = now;
+        entry->expire_time_us = now + k_candidate_ttl_us;
+        _filter_no_update_versions(entry, [entry](uint32_t version) {
+            return !_is_ota_candidate_valid(&entry->model, version);
+        });
+        return;
+    }
+    int64_t expire_time_us = now + k_no_update_ttl_us;
+    if (!entry->has_candidate) {
+        entry->fetch_time_us = now;
+        entry->expire_time_us = expire_time_us;
+    }
+    no_update_version_t *version = _search_no_update_version(entry, software_version);
+    if (!version && entry->no_update_count < k_max_no_update_versions) {
+        version = &entry->no_update_versions[entry->no_update_count++];
+    }
+    if (!version) {
+        version = std::min_element(entry->no_update_versions, entry->no_update_versions + entry->no_update_count,
+                                   [](const no_update_version_t &a, const no_update_version_t &b) {
+                                       return a.expire_time_us < b.expire_time_us;
+                                   });
+    }
+    version->software_version = software_version;
+    version->expire_time_us = expire_time_us;
 }
 
 static esp_err_t _query_software_version_array(const uint16_t vendor_id, const uint16_t product_id,
@@ -140,6 +260,7 @@ static esp_err_t _query_software_version_array(const uint16_t vendor_id, const u
     int http_len, http_status_code;
     jparse_ctx_t jctx;
 
+    OTA_CANDIDATES_STATS_INC(mDclRequests);
     client = esp_http_client_init(&config);
     if (!client) {
         ESP_LOGE(TAG, "Failed to initialise HTTP Client.");
@@ -175,7 +296,9 @@ static esp_err_t _query_software_version_array(const uint16_t vendor_id, const u
                       "Failed to parse the http response json on json_parse_start");
     if (json_obj_get_object(&jctx, "modelVersions") == 0) {
         if (json_obj_get_array(&jctx, "softwareVersions", &sw_ver_count) == 0 && sw_ver_count > 0) {
-            *software_version_array = (uint32_t *)esp_matter_mem_calloc(sw_ver_count, sizeof(uint32_t));
+            *software_version_array =
+                (uint32_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER,
+                                                         sw_ver_count, sizeof(uint32_t));
             if (*software_version_array) {
                 software_version_count = sw_ver_count;
                 for (sw_ver_index = 0; sw_ver_index < sw_ver_count; ++sw_ver_index) {
@@ -205,7 +328,7 @@ cleanup:
 
     if (ret != ESP_OK) {
         if (*software_version_array) {
-            esp_matter_mem_free(*software_version_array);
+            esp_matter_mem_free_tagged(*software_version_array);
             *software_version_array = nullptr;
             software_version_count = 0;
         }
@@ -213,6 +336,31 @@ cleanup:
     return ret;
 }
 
+// DCL Checksum type of SHA-256, see the IANA Named Information Hash Algorithm Registry
+static constexpr int k_ota_checksum_type_sha256 = 1;
+
+static void _parse_ota_file_info(jparse_ctx_t *jctx, model_version_t *model)
+{
+    char str_buf[64];
+    int64_t file_size = 0;
+    int checksum_type = 0;
+    size_t checksum_len = 0;
+    // The uint64 fields are encoded as strings by the DCL REST API
+    if (json_obj_get_string(jctx, "otaFileSize", str_buf, sizeof(str_buf)) == 0) {
+        model->ota_file_size = strtoul(str_buf, nullptr, 10);
+    } else if (json_obj_get_int64(jctx, "otaFileSize", &file_size) == 0) {
+        model->ota_file_size = file_size;
+    }
+    model->has_ota_checksum = false;
+    if (json_obj_get_int(jctx, "otaChecksumType", &checksum_type) == 0 && checksum_type == k_ota_checksum_type_sha256 &&
+        json_obj_get_string(jctx, "otaChecksum", str_buf, sizeof(str_buf)) == 0 &&
+        mbedtls_base64_decode(model->ota_checksum, sizeof(model->ota_checksum), &checksum_len,
+                              (const unsigned char *)str_buf, strlen(str_buf)) == 0 &&
+        checksum_len == sizeof(model->ota_checksum)) {
+        model->has_ota_checksum = true;
+    }
+}
+
 static esp_err_t _query_ota_candidate(model_version_t *model, uint32_t new_software_version,
                                       uint32_t current_software_version)
 {
@@ -236,6 +384,7 @@ static esp_err_t _query_ota_candidate(model_version_t *model, uint32_t new_softw
     bool software_version_valid;
     jparse_ctx_t jctx;
 
+    OTA_CANDIDATES_STATS_INC(mDclRequests);
     client = esp_http_client_init(&config);
     ESP_RETURN_ON_FALSE(client, ESP_FAIL, TAG, "Failed to initialise HTTP Client.");
     ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "accept", "application/json"), cleanup, TAG,
@@ -290,6 +439,7 @@ static esp_err_t _query_ota_candidate(model_version_t *model, uint32_t new_softw
                 json_obj_get_string(&jctx, "otaUrl", model->ota_url, sizeof(model->ota_url)) == 0) {
                 model->ota_url[string_len] = 0;
             }
+            _parse_ota_file_info(&jctx, model);
         } else {
             ESP_LOGI(TAG, "This result is not valid for software version %ld, skip it", current_software_version);
             ret = ESP_ERR_NOT_FINISHED;
@@ -307,88 +457,186 @@ cleanup:
     return ret;
 }
 
+// Find the newest software version on the DCL which is applicable to the current software version.
+// Return ESP_ERR_NOT_FOUND if the DCL has no update for the current software version.
+static esp_err_t _fetch_ota_candidate_from_dcl(model_version_t *model, uint32_t current_software_version,
+                                               uint32_t *latest_software_version)
+{
+    uint32_t *software_version_array = nullptr;
+    size_t software_version_count = 0;
+    esp_err_t err = _query_software_version_array(model->vendor_id, model->product_id, &software_version_array,
+                                                  software_version_count);
+    if (err != ESP_OK || !software_version_array || software_version_count == 0) {
+        return err == ESP_OK ? ESP_ERR_NOT_FOUND : err;
+    }
+    std::sort(software_version_array, software_version_array + software_version_count, std::greater<uint32_t>());
+    if (latest_software_version) {
+        *latest_software_version = software_version_array[0];
+    }
+    err = ESP_ERR_NOT_FOUND;
+    for (size_t index = 0;
+         index < software_version_count && software_version_array[index] > current_software_version; ++index) {
+        esp_err_t query_err = _query_ota_candidate(model, software_version_array[index], current_software_version);
+        if (query_err == ESP_OK) {
+            err = ESP_OK;
+            break;
+        } else if (query_err != ESP_ERR_NOT_FINISHED) {
+            // Do not report that there is no update if one of the versions could not be queried
+            err = query_err;
+        }
+    }
+    esp_matter_mem_free_tagged(software_version_array);
+    return err;
+}
+
 #ifdef CONFIG_ESP_MATTER_OTA_CANDIDATES_UPDATE_PERIODICALLY
-static void _update_all_ota_candidates_cache()
+static void _refresh_ota_candidate(ota_candidate_entry_t *entry)
 {
-    for (size_t index = 0; index < max_ota_candidate_count; ++index) {
-        model_version_t *candidate = _ota_candidates_cache[index];
-        if (candidate) {
-            uint32_t *software_version_array = nullptr;
-            size_t software_version_count;
-            esp_err_t err = _query_software_version_array(candidate->vendor_id, candidate->product_id,
-                                                          &software_version_array, software_version_count);
-            if (err == ESP_OK && software_version_array && software_version_count > 0) {
-                std::sort(&software_version_array[0], &software_version_array[software_version_count - 1],
-                          std::greater<uint32_t>());
-                for (size_t index = 0;
-                     index < software_version_count && software_version_array[index] > candidate->software_version;
-                     ++index) {
-                    err = _query_ota_candidate(candidate, software_version_array[index], candidate->software_version);
-                    if (err == ESP_OK) {
-                        break;
-                    }
+    uint32_t latest_software_version = 0;
+    OTA_CANDIDATES_STATS_INC(mRefreshes);
+    if (entry->has_candidate) {
+        // Look for a newer version applicable to the cached one, the cached candidate is kept if there is none.
+        model_version_t model = entry->model;
+        esp_err_t err = _fetch_ota_candidate_from_dcl(&model, entry->model.software_version, &latest_software_version);
+        if (err == ESP_OK) {
+            entry->model = model;
+        }
+        if (err == ESP_OK || err == ESP_ERR_NOT_FOUND) {
+            _set_ota_candidate_fetched(entry, true, 0);
+            // Drop the versions older than a newly published version, the next queries of these versions will fetch it
+            _filter_no_update_versions(entry, [latest_software_version](uint32_t version) {
+                return latest_software_version <= version;
+            });
+        }
+    } else {
+        uint32_t *software_version_array = nullptr;
+        size_t software_version_count = 0;
+        esp_err_t err = _query_software_version_array(entry->model.vendor_id, entry->model.product_id,
+                                                      &software_version_array, software_version_count);
+        if (err == ESP_OK) {
+            latest_software_version =
+                *std::max_element(software_version_array, software_version_array + software_version_count);
+            esp_matter_mem_free_tagged(software_version_array);
+            // Drop the versions older than a newly published version, the next queries of these versions will fetch it
+            _filter_no_update_versions(entry, [latest_software_version](uint32_t version) {
+                return latest_software_version <= version;
+            });
+            if (entry->no_update_count == 0) {
+                _remove_ota_candidate(entry);
+            } else {
+                for (size_t index = 0; index < entry->no_update_count; ++index) {
+                    _set_ota_candidate_fetched(entry, false, entry->no_update_versions[index].software_version);
                 }
-                esp_matter_mem_free(software_version_array);
             }
         }
     }
 }
 
-static void _ota_candidates_periodic_update_handler(void *arg)
+// Refresh a batch of the entries which are not refreshed in the current round, the next batch is refreshed after
+// CONFIG_ESP_MATTER_OTA_CANDIDATES_REFRESH_BATCH_INTERVAL seconds so that the fetch actions are not delayed by a
+// burst of DCL requests.
+static void _refresh_ota_candidates_batch()
+{
+    size_t refreshed = 0;
+    while (refreshed < CONFIG_ESP_MATTER_OTA_CANDIDATES_REFRESH_BATCH_SIZE) {
+        ota_candidate_entry_t *oldest = nullptr;
+        for (size_t index = 0; index < max_ota_candidate_count; ++index) {
+            ota_candidate_entry_t *entry = &_ota_candidates_cache[index];
+            if (entry->in_use && entry->fetch_time_us < _ota_candidates_refresh_round_start_us &&
+                (!oldest || entry->fetch_time_us < oldest->fetch_time_us)) {
+                oldest = entry;
+            }
+        }
+        if (!oldest) {
+            return;
+        }
+        int64_t fetch_time_us = oldest->fetch_time_us;
+        _refresh_ota_candidate(oldest);
+        if (oldest->in_use && oldest->fetch_time_us == fetch_time_us) {
+            // The refresh failed, retry it in the next round
+            oldest->fetch_time_us = _ota_candidates_refresh_round_start_us;
+        }
+        refreshed++;
+    }
+    esp_timer_start_once(_ota_candidates_refresh_batch_timer,
+                         (uint64_t)CONFIG_ESP_MATTER_OTA_CANDIDATES_REFRESH_BATCH_INTERVAL * 1000 * 1000);
+}
+
+static void _post_refresh_action(bool new_round)
 {
     ota_candidate_fetch_action_t action;
     action.vendor_id = chip::kMaxVendorId;
-    if (xQueueSend(_ota_candidate_task_queue, &action, portMAX_DELAY) != pdTRUE) {
-        ESP_LOGE(TAG, "Failed send search ota candidate action");
+    action.product_id = new_round ? 1 : 0;
+    if (xQueueSend(_ota_candidate_task_queue, &action, 0) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed send refresh ota candidates action");
     }
 }
+
+static void _ota_candidates_periodic_update_handler(void *arg)
+{
+    _post_refresh_action(true);
+}
+
+static void _ota_candidates_refresh_batch_handler(void *arg)
+{
+    _post_refresh_action(false);
+}
 #endif
 
 static void _ota_candidate_fetch_handler(ota_candidate_fetch_action_t &action)
 {
-    model_version_t *candidate = nullptr;
     assert(action.callback);
-    int candate_index = _search_ota_candidate(action.vendor_id, action.product_id, action.software_version);
-    if (candate_index >= 0 && candate_index < max_ota_candidate_count && _ota_candidates_cache[candate_index]) {
-        candidate = _ota_candidates_cache[candate_index];
+    ota_candidate_entry_t *entry = _search_ota_candidate(action.vendor_id, action.product_id);
+    int64_t now = esp_timer_get_time();
+    if (entry && now < entry->expire_time_us && entry->has_candidate &&
+        _is_ota_candidate_valid(&entry->model, action.software_version)) {
+        OTA_CANDIDATES_STATS_INC(mHits);
+        entry->last_used = ++_ota_candidates_use_counter;
+        model_version_t *candidate = &entry->model;
         action.callback(EspOtaProvider::OTAQueryStatus::kUpdateAvailable, candidate->ota_url, candidate->ota_file_size,
-                        candidate->software_version, candidate->software_version_str, action.callback_args);
+                        candidate->has_ota_checksum ? candidate->ota_checksum : nullptr, candidate->software_version,
+                        candidate->software_version_str, action.callback_args);
         return;
-    } else {
-        // Cannot find the candidate from cache, we need to query DCL for a new candidate;
-        uint32_t *software_version_array = nullptr;
-        size_t software_version_count;
-        esp_err_t err = _query_software_version_array(action.vendor_id, action.product_id, &software_version_array,
-                                                      software_version_count);
-        if (err == ESP_OK && software_version_array && software_version_count > 0) {
-            // Sort the software version array
-            std::sort(&software_version_array[0], &software_version_array[software_version_count - 1],
-                      std::greater<uint32_t>());
-            candidate = (model_version_t *)esp_matter_mem_calloc(1, sizeof(model_version_t));
-            candidate->vendor_id = action.vendor_id;
-            candidate->product_id = action.product_id;
-            for (size_t index = 0;
-                 index < software_version_count && software_version_array[index] > action.software_version; ++index) {
-                err = _query_ota_candidate(candidate, software_version_array[index], action.software_version);
-                if (err == ESP_OK) {
-                    size_t empty_index = _find_empty_ota_candidates();
-                    _increase_ota_candidates_lifetime();
-                    candidate->lifetime = 0;
-                    // Add this candidate to cache
-                    _ota_candidates_cache[empty_index] = candidate;
-                    action.callback(EspOtaProvider::OTAQueryStatus::kUpdateAvailable, candidate->ota_url,
-                                    candidate->ota_file_size, candidate->software_version,
-                                    candidate->software_version_str, action.callback_args);
-                    esp_matter_mem_free(software_version_array);
-                    return;
-                }
+    }
+    // The versions without update are recorded by the entries with a candidate as well
+    no_update_version_t *no_update_version =
+        entry ? _search_no_update_version(entry, action.software_version) : nullptr;
+    if (no_update_version && now < no_update_version->expire_time_us) {
+        OTA_CANDIDATES_STATS_INC(mNegativeHits);
+        entry->last_used = ++_ota_candidates_use_counter;
+        action.callback(EspOtaProvider::OTAQueryStatus::kNotAvailable, nullptr, 0, nullptr, 0, nullptr,
+                        action.callback_args);
+        return;
+    }
+    // Cannot find the candidate from cache, we need to query DCL for a new candidate
+    OTA_CANDIDATES_STATS_INC(mMisses);
+    model_version_t *model =
+        (model_version_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, sizeof(model_version_t));
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (model) {
+        model->vendor_id = action.vendor_id;
+        model->product_id = action.product_id;
+        err = _fetch_ota_candidate_from_dcl(model, action.software_version, nullptr);
+        if (err == ESP_OK || err == ESP_ERR_NOT_FOUND) {
+            entry = _get_or_add_ota_candidate(action.vendor_id, action.product_id);
+            if (err == ESP_OK) {
+                entry->model = *model;
             }
-            esp_matter_mem_free(candidate);
-            esp_matter_mem_free(software_version_array);
+            _set_ota_candidate_fetched(entry, err == ESP_OK, action.software_version);
+            entry->last_used = ++_ota_candidates_use_counter;
         }
+        esp_matter_mem_free_tagged(model);
+    }
+    if (err == ESP_OK) {
+        model_version_t *candidate = &entry->model;
+        action.callback(EspOtaProvider::OTAQueryStatus::kUpdateAvailable, candidate->ota_url, candidate->ota_file_size,
+                        candidate->has_ota_checksum ? candidate->ota_checksum : nullptr, candidate->software_version,
+                        candidate->software_version_str, action.callback_args);
+        return;
     }
     // Cannot fetch the candidate
-    action.callback(EspOtaProvider::OTAQueryStatus::kNotAvailable, nullptr, 0, 0, nullptr, action.callback_args);
+    action.callback(EspOtaProvider::OTAQueryStatus::kNotAvailable, nullptr, 0, nullptr, 0, nullptr,
+                    action.callback_args);
 }
 
 static void ota_candidate_task(void *ctx)
@@ -401,8 +649,13 @@ static void ota_candidate_task(void *ctx)
             }
 #ifdef CONFIG_ESP_MATTER_OTA_CANDIDATES_UPDATE_PERIODICALLY
             else {
-                // If receiving an action with Max VendorId, try to update all the candidates cache.
-                _update_all_ota_candidates_cache();
+                // If receiving an action with Max VendorId, refresh a batch of the candidates cache. The ProductID
+                // indicates whether a new refresh round starts.
+                if (action.product_id) {
+                    esp_timer_stop(_ota_candidates_refresh_batch_timer);
+                    _ota_candidates_refresh_round_start_us = esp_timer_get_time();
+                }
+                _refresh_ota_candidates_batch();
             }
 #endif
         }
@@ -434,13 +687,41 @@ esp_err_t fetch_ota_candidate(const uint16_t vendor_id, const uint16_t product_i
     return ESP_OK;
 }
 
+void get_ota_candidates_cache_stats(EspOtaProvider::OtaCandidatesCacheStats &stats)
+{
+    portENTER_CRITICAL(&_ota_candidates_stats_lock);
+    stats = _ota_candidates_stats;
+    portEXIT_CRITICAL(&_ota_candidates_stats_lock);
+}
+
+void reset_ota_candidates_cache_stats()
+{
+    portENTER_CRITICAL(&_ota_candidates_stats_lock);
+    memset(&_ota_candidates_stats, 0, sizeof(_ota_candidates_stats));
+    portEXIT_CRITICAL(&_ota_candidates_stats_lock);
+}
+
 esp_err_t init_ota_candidates()
 {
-    memset(_ota_candidates_cache, 0, sizeof(_ota_candidates_cache));
     if (_ota_candidate_task_queue) {
         return ESP_ERR_INVALID_STATE;
     }
-    _ota_candidate_task_queue = xQueueCreate(8, sizeof(ota_candidate_fetch_action_t));
+    _ota_candidates_cache =
+        (ota_candidate_entry_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER,
+                                                              max_ota_candidate_count, sizeof(ota_candidate_entry_t));
+    if (!_ota_candidates_cache) {
+        ESP_LOGE(TAG, "Failed to allocate ota_candidate cache");
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t index = 0; index < max_ota_candidate_count; ++index) {
+        _ota_candidates_cache[index].next = k_invalid_index;
+    }
+    for (size_t index = 0; index < k_bucket_count; ++index) {
+        _ota_candidates_buckets[index] = k_invalid_index;
+    }
+    // Room for a fetch action of each pending QueryImage command and for the refresh actions
+    _ota_candidate_task_queue =
+        xQueueCreate(CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS + 4, sizeof(ota_candidate_fetch_action_t));
     if (!_ota_candidate_task_queue) {
         ESP_LOGE(TAG, "Failed to create ota_candidate task queue");
         return ESP_ERR_NO_MEM;
@@ -463,6 +744,10 @@ esp_err_t init_ota_candidates()
         esp_timer_create(&timer_args, &_ota_candidates_update_timer);
         esp_timer_start_periodic(_ota_candidates_update_timer,
                                  (uint64_t)CONFIG_ESP_MATTER_OTA_CANDIDATES_UPDATE_PERIOD * 3600 * 1000 * 1000);
+        const esp_timer_create_args_t batch_timer_args = {.callback = _ota_candidates_refresh_batch_handler,
+                                                          .arg = nullptr,
+                                                          .name = "ota_candidates_refresh_batch_timer"};
+        esp_timer_create(&batch_timer_args, &_ota_candidates_refresh_batch_timer);
     }
 #endif
     return ESP_OK;
@@ -18,7 +18,13 @@
 #include <esp_log.h>
 #include <esp_matter_mem.h>
 #include <esp_matter_ota_http_downloader.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/task.h>
 #include <sdkconfig.h>
+#include <string.h>
+
+#include <atomic>
 
 static constexpr char TAG[] = "ota_provider";
 
@@ -132,7 +138,7 @@ static int _http_client_read(esp_http_client_handle_t http_client, char *data, s
 {
     int read_len = 0;
     while (read_len < size) {
-        int len = _http_client_read_check_connection(http_client, data, size - read_len);
+        int len = _http_client_read_check_connection(http_client, data + read_len, size - read_len);
         if (esp_http_client_is_complete_data_received(http_client)) {
             ESP_LOGI(TAG, "Finish downloading");
             return read_len + len;
@@ -166,13 +172,39 @@ void http_downloader_abort(esp_http_client_handle_t http_client)
     }
 }
 
-esp_err_t http_downloader_start(esp_http_client_config_t *config, esp_http_client_handle_t *http_client)
+// Discard the beginning of the response of a server which does not support the range requests
+static esp_err_t _http_client_discard(esp_http_client_handle_t http_client, size_t size)
+{
+    char buf[256];
+    while (size > 0) {
+        int len = _http_client_read_check_connection(http_client, buf, size < sizeof(buf) ? size : sizeof(buf));
+        if (len <= 0) {
+            ESP_LOGE(TAG, "Failed to skip the image data");
+            return ESP_FAIL;
+        }
+        size -= len;
+    }
+    return ESP_OK;
+}
+
+esp_err_t http_downloader_start(esp_http_client_config_t *config, size_t range_start,
+                                esp_http_client_handle_t *http_client)
 {
     esp_err_t ret = ESP_OK;
     ESP_RETURN_ON_FALSE(http_client, ESP_ERR_INVALID_ARG, TAG, "http_client cannot be NULL");
     *http_client = esp_http_client_init(config);
     ESP_RETURN_ON_FALSE(*http_client, ESP_ERR_NO_MEM, TAG, "Failed to initialize http client");
+    if (range_start > 0) {
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%u-", range_start);
+        ESP_GOTO_ON_ERROR(esp_http_client_set_header(*http_client, "Range", range), exit, TAG,
+                          "Failed to set the Range header");
+    }
     ESP_GOTO_ON_ERROR(_http_connect(*http_client), exit, TAG, "Failed to connect to HTTP server");
+    if (range_start > 0 && esp_http_client_get_status_code(*http_client) != HttpStatus_PartialContent) {
+        ESP_LOGW(TAG, "The server ignored the range request, skip %u bytes", range_start);
+        ESP_GOTO_ON_ERROR(_http_client_discard(*http_client, range_start), exit, TAG, "Failed to skip the image data");
+    }
     return ESP_OK;
 exit:
     _http_client_cleanup(*http_client);
@@ -180,5 +212,160 @@ exit:
     return ret;
 }
 
+enum prefetcher_state_t : uint8_t {
+    PREFETCHER_RUNNING = 0,
+    PREFETCHER_COMPLETE,
+    PREFETCHER_FAILED,
+};
+
+struct http_prefetcher {
+    esp_http_client_config_t config;
+    char *url;
+    size_t range_start;
+    size_t buffer_size;
+    StreamBufferHandle_t stream;
+    std::atomic<uint8_t> state;
+    std::atomic<bool> stopped;
+};
+
+static constexpr size_t k_prefetch_chunk_size = 1024;
+static constexpr TickType_t k_prefetch_poll_period = pdMS_TO_TICKS(100);
+
+static void _http_prefetcher_free(http_prefetcher *prefetcher)
+{
+    if (prefetcher->stream) {
+        vStreamBufferDelete(prefetcher->stream);
+    }
+    esp_matter_mem_free_tagged(prefetcher->url);
+    esp_matter_mem_free_tagged(prefetcher);
+}
+
+// Push the data to the stream buffer, waiting for the reader to make room. Return false if the prefetcher is stopped.
+static bool _http_prefetcher_push(http_prefetcher *prefetcher, const char *data, size_t len)
+{
+    while (len > 0) {
+        if (prefetcher->stopped.load()) {
+            return false;
+        }
+        size_t sent = xStreamBufferSend(prefetcher->stream, data, len, k_prefetch_poll_period);
+        data += sent;
+        len -= sent;
+    }
+    return true;
+}
+
+static void _http_prefetcher_task(void *arg)
+{
+    http_prefetcher *prefetcher = (http_prefetcher *)arg;
+    esp_http_client_handle_t http_client = nullptr;
+    uint8_t state = PREFETCHER_FAILED;
+    char *chunk = (char *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, k_prefetch_chunk_size);
+    if (!chunk) {
+        ESP_LOGE(TAG, "Failed to allocate memory for prefetch chunk");
+    } else if (http_downloader_start(&prefetcher->config, prefetcher->range_start, &http_client) == ESP_OK) {
+        while (!prefetcher->stopped.load()) {
+            int len = _http_client_read_check_connection(http_client, chunk, k_prefetch_chunk_size);
+            if (len < 0) {
+                ESP_LOGE(TAG, "Failed to read image");
+                break;
+            }
+            if (!_http_prefetcher_push(prefetcher, chunk, len)) {
+                break;
+            }
+            if (esp_http_client_is_complete_data_received(http_client)) {
+                ESP_LOGI(TAG, "Finish downloading");
+                state = PREFETCHER_COMPLETE;
+                break;
+            }
+        }
+        _http_client_cleanup(http_client);
+    }
+    esp_matter_mem_free_tagged(chunk);
+    prefetcher->state.store(state);
+
+    // The reader may still be reading the remaining data, wait for it to stop the prefetcher. The stop flag is polled
+    // so that the reader never accesses the task or the prefetcher after stopping it.
+    while (!prefetcher->stopped.load()) {
+        vTaskDelay(k_prefetch_poll_period);
+    }
+    _http_prefetcher_free(prefetcher);
+    vTaskDelete(NULL);
+}
+
+esp_err_t http_prefetcher_start(const esp_http_client_config_t *config, size_t range_start, size_t buffer_size,
+                                http_prefetcher_handle_t *handle)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config && config->url && handle, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    http_prefetcher *prefetcher =
+        (http_prefetcher *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, sizeof(http_prefetcher));
+    ESP_RETURN_ON_FALSE(prefetcher, ESP_ERR_NO_MEM, TAG, "Failed to allocate memory for prefetcher");
+    prefetcher->config = *config;
+    prefetcher->url = (char *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, strlen(config->url) + 1);
+    ESP_GOTO_ON_FALSE(prefetcher->url, ESP_ERR_NO_MEM, exit, TAG, "Failed to allocate memory for URL");
+    strcpy(prefetcher->url, config->url);
+    prefetcher->config.url = prefetcher->url;
+    prefetcher->range_start = range_start;
+    prefetcher->buffer_size = buffer_size;
+    prefetcher->stream = xStreamBufferCreate(buffer_size, 1);
+    ESP_GOTO_ON_FALSE(prefetcher->stream, ESP_ERR_NO_MEM, exit, TAG, "Failed to create prefetch buffer");
+    prefetcher->state.store(PREFETCHER_RUNNING);
+    prefetcher->stopped.store(false);
+    ESP_GOTO_ON_FALSE(xTaskCreate(_http_prefetcher_task, "ota_prefetch",
+                                  CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_STACK_SIZE, prefetcher,
+                                  CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_PRIORITY, NULL) == pdPASS,
+                      ESP_ERR_NO_MEM, exit, TAG, "Failed to create prefetch task");
+    *handle = prefetcher;
+    return ESP_OK;
+exit:
+    _http_prefetcher_free(prefetcher);
+    return ret;
+}
+
+static esp_err_t _http_prefetcher_check_ready(http_prefetcher *prefetcher, size_t size, size_t *available)
+{
+    // Load the state before checking the available bytes, all the data is in the buffer once the download completes.
+    uint8_t state = prefetcher->state.load();
+    *available = xStreamBufferBytesAvailable(prefetcher->stream);
+    if (state == PREFETCHER_FAILED) {
+        return ESP_FAIL;
+    }
+    // The buffer could never hold the data, do not wait for it forever
+    ESP_RETURN_ON_FALSE(size <= prefetcher->buffer_size, ESP_ERR_INVALID_SIZE, TAG,
+                        "Read of %u bytes from a prefetch buffer of %u bytes", static_cast<unsigned>(size),
+                        static_cast<unsigned>(prefetcher->buffer_size));
+    if (state == PREFETCHER_RUNNING && *available < size) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    return ESP_OK;
+}
+
+esp_err_t http_prefetcher_is_ready(http_prefetcher_handle_t handle, size_t size)
+{
+    ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    size_t available = 0;
+    return _http_prefetcher_check_ready(handle, size, &available);
+}
+
+esp_err_t http_prefetcher_read(http_prefetcher_handle_t handle, uint8_t *buf, size_t size, size_t *read_len)
+{
+    ESP_RETURN_ON_FALSE(handle && buf && read_len, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    *read_len = 0;
+    size_t available = 0;
+    esp_err_t err = _http_prefetcher_check_ready(handle, size, &available);
+    if (err != ESP_OK) {
+        return err;
+    }
+    *read_len = xStreamBufferReceive(handle->stream, buf, size < available ? size : available, 0);
+    return ESP_OK;
+}
+
+void http_prefetcher_stop(http_prefetcher_handle_t handle)
+{
+    if (handle) {
+        handle->stopped.store(true);
+    }
+}
+
 } // namespace ota_provider
 } // namespace esp_matter
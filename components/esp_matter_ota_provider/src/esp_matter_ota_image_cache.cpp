@@ -0,0 +1,392 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <esp_check.h>
+#include <esp_crt_bundle.h>
+#include <esp_http_client.h>
+#include <esp_log.h>
+#include <esp_matter_mem.h>
+#include <esp_matter_ota_bdx_sender.h>
+#include <esp_matter_ota_http_downloader.h>
+#include <esp_matter_ota_image_cache.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <mbedtls/sha256.h>
+#include <string.h>
+
+static constexpr char TAG[] = "ota_image_cache";
+
+namespace esp_matter {
+namespace ota_provider {
+
+static constexpr uint32_t k_slot_header_magic = 0x4f544143; // "OTAC"
+static constexpr size_t k_slot_header_size = SPI_FLASH_SEC_SIZE;
+static constexpr size_t k_max_slots = CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_MAX_IMAGES;
+static constexpr size_t k_download_chunk_size = 4096;
+static constexpr size_t k_request_queue_size = 4;
+
+// The header is written in the first sector of the slot once the image is downloaded and verified.
+typedef struct {
+    uint32_t magic;
+    uint32_t image_size;
+    uint8_t digest[OTA_IMAGE_DIGEST_LEN];
+    char url[OTA_URL_MAX_LEN];
+} slot_header_t;
+
+typedef enum : uint8_t {
+    SLOT_EMPTY = 0,
+    SLOT_WRITING,
+    SLOT_VALID,
+} slot_state_t;
+
+typedef struct {
+    slot_state_t state;
+    uint8_t ref_count;
+    uint32_t image_size;
+    uint32_t last_used;
+    char url[OTA_URL_MAX_LEN];
+    // Digest of the cached image, or of the DCL record while the image is written
+    uint8_t digest[OTA_IMAGE_DIGEST_LEN];
+    bool has_digest;
+} slot_t;
+
+typedef struct {
+    char url[OTA_URL_MAX_LEN];
+    size_t size;
+    uint8_t digest[OTA_IMAGE_DIGEST_LEN];
+    bool has_digest;
+} cache_request_t;
+
+static const esp_partition_t *s_partition = nullptr;
+static size_t s_slot_size = 0;
+static slot_t s_slots[k_max_slots];
+static uint32_t s_use_counter = 0;
+static SemaphoreHandle_t s_mutex = nullptr;
+static QueueHandle_t s_request_queue = nullptr;
+
+class cache_lock {
+public:
+    cache_lock() { xSemaphoreTake(s_mutex, portMAX_DELAY); }
+    ~cache_lock() { xSemaphoreGive(s_mutex); }
+};
+
+static void _clear_slot(slot_t &slot)
+{
+    slot.state = SLOT_EMPTY;
+    slot.image_size = 0;
+    slot.has_digest = false;
+    memset(slot.url, 0, sizeof(slot.url));
+}
+
+// Find the slot of the image with the given URL and digest, the digest is not compared if it is NULL. The image at the
+// same URL may be replaced after it is cached, so a cached image whose digest does not match the DCL record is
+// invalidated if it is not being read and the image is cached again.
+static int _find_slot(const char *url, const uint8_t *digest)
+{
+    for (size_t index = 0; index < k_max_slots; ++index) {
+        slot_t &slot = s_slots[index];
+        if (slot.state == SLOT_EMPTY || strncmp(slot.url, url, OTA_URL_MAX_LEN) != 0) {
+            continue;
+        }
+        if (!digest || !slot.has_digest || memcmp(slot.digest, digest, OTA_IMAGE_DIGEST_LEN) == 0) {
+            return index;
+        }
+        if (slot.state == SLOT_VALID && slot.ref_count == 0) {
+            ESP_LOGI(TAG, "Invalidate cached image %s, its digest does not match the DCL record", slot.url);
+            _clear_slot(slot);
+        }
+    }
+    return -1;
+}
+
+// Take an empty slot or evict the least recently used image which is not being read
+static int _take_slot_for_writing(const cache_request_t &request)
+{
+    int victim = -1;
+    for (size_t index = 0; index < k_max_slots; ++index) {
+        slot_t &slot = s_slots[index];
+        if (slot.state == SLOT_EMPTY) {
+            victim = index;
+            break;
+        }
+        if (slot.state == SLOT_VALID && slot.ref_count == 0 &&
+            (victim < 0 || slot.last_used < s_slots[victim].last_used)) {
+            victim = index;
+        }
+    }
+    if (victim >= 0) {
+        slot_t &slot = s_slots[victim];
+        if (slot.state == SLOT_VALID) {
+            ESP_LOGI(TAG, "Evict cached image %s", slot.url);
+        }
+        slot.state = SLOT_WRITING;
+        slot.image_size = 0;
+        strlcpy(slot.url, request.url, sizeof(slot.url));
+        slot.has_digest = request.has_digest;
+        memcpy(slot.digest, request.digest, sizeof(slot.digest));
+    }
+    return victim;
+}
+
+static size_t _slot_offset(int index)
+{
+    return index * s_slot_size;
+}
+
+static esp_err_t _download_to_slot(int index, const cache_request_t &request, uint32_t *image_size, uint8_t *digest)
+{
+    esp_err_t ret = ESP_OK;
+    esp_http_client_handle_t http_client = nullptr;
+    mbedtls_sha256_context sha_ctx;
+    size_t data_offset = _slot_offset(index) + k_slot_header_size;
+    size_t max_image_size = s_slot_size - k_slot_header_size;
+    size_t written = 0;
+    esp_http_client_config_t config = {
+        .url = request.url,
+        .event_handler = NULL,
+        .transport_type = HTTP_TRANSPORT_OVER_SSL,
+        .skip_cert_common_name_check = false,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .keep_alive_enable = true,
+    };
+
+    ESP_RETURN_ON_FALSE(request.size <= max_image_size, ESP_ERR_INVALID_SIZE, TAG,
+                        "Image of %u bytes does not fit in a cache slot", static_cast<unsigned>(request.size));
+    char *chunk = (char *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, k_download_chunk_size);
+    ESP_RETURN_ON_FALSE(chunk, ESP_ERR_NO_MEM, TAG, "Failed to allocate memory for download chunk");
+    mbedtls_sha256_init(&sha_ctx);
+    mbedtls_sha256_starts(&sha_ctx, 0);
+
+    ESP_GOTO_ON_ERROR(esp_partition_erase_range(s_partition, _slot_offset(index), s_slot_size), exit, TAG,
+                      "Failed to erase cache slot");
+    ESP_GOTO_ON_ERROR(http_downloader_start(&config, 0, &http_client), exit, TAG, "Failed to download %s", request.url);
+    while (true) {
+        int len = http_downloader_read(http_client, chunk, k_download_chunk_size);
+        ESP_GOTO_ON_FALSE(len >= 0, ESP_FAIL, exit, TAG, "Failed to read image");
+        ESP_GOTO_ON_FALSE(written + len <= max_image_size, ESP_ERR_INVALID_SIZE, exit, TAG,
+                          "Image does not fit in a cache slot");
+        if (len > 0) {
+            ESP_GOTO_ON_ERROR(esp_partition_write(s_partition, data_offset + written, chunk, len), exit, TAG,
+                              "Failed to write cache slot");
+            mbedtls_sha256_update(&sha_ctx, (const unsigned char *)chunk, len);
+            written += len;
+        }
+        if (len < k_download_chunk_size) {
+            ESP_GOTO_ON_FALSE(esp_http_client_is_complete_data_received(http_client), ESP_FAIL, exit, TAG,
+                              "Image download is incomplete");
+            break;
+        }
+    }
+    mbedtls_sha256_finish(&sha_ctx, digest);
+
+    // Verify the image against the DCL record
+    ESP_GOTO_ON_FALSE(written > 0 && (request.size == 0 || written == request.size), ESP_ERR_INVALID_SIZE, exit, TAG,
+                      "Image size %u does not match %u", static_cast<unsigned>(written),
+                      static_cast<unsigned>(request.size));
+    ESP_GOTO_ON_FALSE(!request.has_digest || memcmp(digest, request.digest, OTA_IMAGE_DIGEST_LEN) == 0,
+                      ESP_ERR_INVALID_CRC, exit, TAG, "Image digest does not match the DCL record");
+    {
+        slot_header_t header = {};
+        header.magic = k_slot_header_magic;
+        header.image_size = written;
+        memcpy(header.digest, digest, sizeof(header.digest));
+        strlcpy(header.url, request.url, sizeof(header.url));
+        ESP_GOTO_ON_ERROR(esp_partition_write(s_partition, _slot_offset(index), &header, sizeof(header)), exit, TAG,
+                          "Failed to write cache slot header");
+    }
+    *image_size = written;
+
+exit:
+    if (http_client) {
+        http_downloader_abort(http_client);
+    }
+    mbedtls_sha256_free(&sha_ctx);
+    esp_matter_mem_free_tagged(chunk);
+    return ret;
+}
+
+static void _handle_cache_request(const cache_request_t &request)
+{
+    int index = -1;
+    {
+        cache_lock lock;
+        if (_find_slot(request.url, request.has_digest ? request.digest : nullptr) >= 0) {
+            return;
+        }
+        index = _take_slot_for_writing(request);
+    }
+    if (index < 0) {
+        ESP_LOGW(TAG, "All the cache slots are in use, skip caching %s", request.url);
+        return;
+    }
+    ESP_LOGI(TAG, "Caching image %s in slot %d", request.url, index);
+    uint32_t image_size = 0;
+    uint8_t digest[OTA_IMAGE_DIGEST_LEN];
+    esp_err_t err = _download_to_slot(index, request, &image_size, digest);
+
+    cache_lock lock;
+    slot_t &slot = s_slots[index];
+    if (err == ESP_OK) {
+        slot.state = SLOT_VALID;
+        slot.image_size = image_size;
+        slot.last_used = ++s_use_counter;
+        memcpy(slot.digest, digest, sizeof(slot.digest));
+        slot.has_digest = true;
+        ESP_LOGI(TAG, "Cached image %s, %" PRIu32 " bytes", slot.url, image_size);
+    } else {
+        _clear_slot(slot);
+    }
+}
+
+static void _ota_image_cache_task(void *arg)
+{
+    cache_request_t *request =
+        (cache_request_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, sizeof(cache_request_t));
+    if (!request) {
+        ESP_LOGE(TAG, "Failed to allocate memory for cache request");
+        vTaskDelete(NULL);
+        return;
+    }
+    while (true) {
+        if (xQueueReceive(s_request_queue, request, portMAX_DELAY) == pdTRUE) {
+            _handle_cache_request(*request);
+        }
+    }
+}
+
+esp_err_t ota_image_cache_init()
+{
+    ESP_RETURN_ON_FALSE(!s_partition, ESP_ERR_INVALID_STATE, TAG, "OTA image cache is already initialized");
+    s_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_PARTITION_LABEL);
+    ESP_RETURN_ON_FALSE(s_partition, ESP_ERR_NOT_FOUND, TAG, "Cannot find the partition %s",
+                        CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_PARTITION_LABEL);
+    s_slot_size = (s_partition->size / k_max_slots) & ~(SPI_FLASH_SEC_SIZE - 1);
+    if (s_slot_size <= k_slot_header_size) {
+        ESP_LOGE(TAG, "The partition is too small for %u images", static_cast<unsigned>(k_max_slots));
+        s_partition = nullptr;
+        return ESP_ERR_INVALID_SIZE;
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    s_request_queue = xQueueCreate(k_request_queue_size, sizeof(cache_request_t));
+    if (!s_mutex || !s_request_queue ||
+        xTaskCreate(_ota_image_cache_task, "ota_image_cache", CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_TASK_STACK_SIZE,
+                    NULL, CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the OTA image cache task");
+        s_partition = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Restore the images cached before the reboot, their digests were verified before writing the headers
+    memset(s_slots, 0, sizeof(s_slots));
+    for (size_t index = 0; index < k_max_slots; ++index) {
+        slot_header_t header;
+        if (esp_partition_read(s_partition, _slot_offset(index), &header, sizeof(header)) == ESP_OK &&
+            header.magic == k_slot_header_magic && header.image_size <= s_slot_size - k_slot_header_size) {
+            s_slots[index].state = SLOT_VALID;
+            s_slots[index].image_size = header.image_size;
+            s_slots[index].last_used = ++s_use_counter;
+            // The header comes from the flash, do not trust the URL to be terminated
+            header.url[sizeof(header.url) - 1] = '\0';
+            strlcpy(s_slots[index].url, header.url, std::min(sizeof(s_slots[index].url), sizeof(header.url)));
+            memcpy(s_slots[index].digest, header.digest, sizeof(s_slots[index].digest));
+            s_slots[index].has_digest = true;
+            ESP_LOGI(TAG, "Found cached image %s", s_slots[index].url);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_image_cache_add(const char *url, size_t size, const uint8_t *digest)
+{
+    ESP_RETURN_ON_FALSE(s_partition, ESP_ERR_INVALID_STATE, TAG, "OTA image cache is not initialized");
+    ESP_RETURN_ON_FALSE(url && strlen(url) < OTA_URL_MAX_LEN, ESP_ERR_INVALID_ARG, TAG, "Invalid url");
+    {
+        cache_lock lock;
+        if (_find_slot(url, digest) >= 0) {
+            return ESP_OK;
+        }
+    }
+    cache_request_t *request =
+        (cache_request_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_OTA_PROVIDER, 1, sizeof(cache_request_t));
+    ESP_RETURN_ON_FALSE(request, ESP_ERR_NO_MEM, TAG, "Failed to allocate memory for cache request");
+    strlcpy(request->url, url, sizeof(request->url));
+    request->size = size;
+    if (digest) {
+        memcpy(request->digest, digest, sizeof(request->digest));
+        request->has_digest = true;
+    }
+    // Do not block the caller if the task is busy, the image will be requested again by the next transfer.
+    esp_err_t ret = xQueueSend(s_request_queue, request, 0) == pdTRUE ? ESP_OK : ESP_ERR_NO_MEM;
+    esp_matter_mem_free_tagged(request);
+    return ret;
+}
+
+esp_err_t ota_image_cache_acquire(const char *url, const uint8_t *digest, ota_image_cache_handle_t *handle,
+                                  size_t *size)
+{
+    ESP_RETURN_ON_FALSE(url && handle && size, ESP_ERR_INVALID_ARG, TAG, "Invalid arguments");
+    *handle = k_invalid_ota_image_cache_handle;
+    if (!s_partition) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    cache_lock lock;
+    int index = _find_slot(url, digest);
+    if (index < 0 || s_slots[index].state != SLOT_VALID) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_slots[index].ref_count++;
+    s_slots[index].last_used = ++s_use_counter;
+    *handle = index;
+    *size = s_slots[index].image_size;
+    return ESP_OK;
+}
+
+esp_err_t ota_image_cache_read(ota_image_cache_handle_t handle, size_t offset, uint8_t *buf, size_t size,
+                               size_t *read_len)
+{
+    ESP_RETURN_ON_FALSE(handle >= 0 && handle < k_max_slots && buf && read_len, ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid arguments");
+    // The slot could not be rewritten while it is acquired, so it is read without the lock.
+    const slot_t &slot = s_slots[handle];
+    ESP_RETURN_ON_FALSE(slot.state == SLOT_VALID && slot.ref_count > 0, ESP_ERR_INVALID_STATE, TAG,
+                        "Cache slot is not acquired");
+    *read_len = 0;
+    if (offset >= slot.image_size) {
+        return ESP_OK;
+    }
+    size_t len = std::min(size, static_cast<size_t>(slot.image_size - offset));
+    ESP_RETURN_ON_ERROR(esp_partition_read(s_partition, _slot_offset(handle) + k_slot_header_size + offset, buf, len),
+                        TAG, "Failed to read cache slot");
+    *read_len = len;
+    return ESP_OK;
+}
+
+void ota_image_cache_release(ota_image_cache_handle_t handle)
+{
+    if (handle < 0 || handle >= k_max_slots) {
+        return;
+    }
+    cache_lock lock;
+    if (s_slots[handle].ref_count > 0) {
+        s_slots[handle].ref_count--;
+    }
+}
+
+} // namespace ota_provider
+} // namespace esp_matter
@@ -15,11 +15,16 @@
 #include <algorithm>
 #include <cstring>
 #include <esp_check.h>
+#include <esp_heap_caps.h>
 #include <esp_http_client.h>
 #include <esp_log.h>
 #include <esp_matter_mem.h>
 #include <esp_matter_ota_candidates.h>
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+#include <esp_matter_ota_image_cache.h>
+#endif
 #include <esp_matter_ota_provider.h>
+#include <esp_timer.h>
 #include <json_parser.h>
 
 #include <app/server/Server.h>
@@ -43,6 +48,12 @@ namespace ota_provider {
 
 // Arbitrary BDX Transfer Params
 constexpr uint32_t kMaxBdxBlockSize = 1024;
+// TCP carries the large blocks without the fragmentation of the UDP messages. The prefetch buffer holds at least two
+// blocks, so that the next block is downloaded while a block is sent.
+constexpr uint32_t kMaxBdxTcpBlockSize = std::min(CONFIG_ESP_MATTER_OTA_PROVIDER_BDX_TCP_BLOCK_SIZE,
+                                                  CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE / 2);
+static_assert(kMaxBdxBlockSize <= CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE / 2,
+              "The prefetch buffer should hold two BDX blocks");
 constexpr chip::System::Clock::Timeout kBdxTimeout =
     chip::System::Clock::Seconds16(5 * 60); // OTA Spec mandates >= 5 minutes
 constexpr uint32_t kBdxServerPollIntervalMillis = 50;
@@ -71,20 +82,46 @@ void EspOtaProvider::Init(bool otaAllowedDefault)
     mPollInterval = kBdxServerPollIntervalMillis;
     mOtaRequestorList = nullptr;
     mOtaAllowedDefault = otaAllowedDefault;
+    memset(mDeltaImages, 0, sizeof(mDeltaImages));
+    ResetQueryImageStats();
     init_ota_candidates();
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+    if (ota_image_cache_init() != ESP_OK) {
+        ESP_LOGW(TAG, "OTA image cache is not available, the images will be downloaded for each transfer");
+    }
+#endif
     chip::Server::GetInstance().GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(
-        chip::Protocols::BDX::Id, &mOtaBdxSender);
+        chip::Protocols::BDX::Id, &mOtaBdxSenderPool);
+    mOtaBdxSenderPool.SetTransferEventObserver(TransferEventObserver, this);
+}
+
+uint32_t EspOtaProvider::GetMaxBdxBlockSize(const chip::SessionHandle &session)
+{
+    if (session->IsSecureSession() &&
+        session->AsSecureSession()->GetPeerAddress().GetTransportType() == chip::Transport::Type::kTcp) {
+        return kMaxBdxTcpBlockSize;
+    }
+    // The block and the headers of the message should fit the IPv6 MTU
+    return kMaxBdxBlockSize;
 }
 
-void EspOtaProvider::SendQueryImageResponse(OTAQueryStatus status)
+void EspOtaProvider::SendQueryImageResponse(PendingQuery &query, OTAQueryStatus status)
 {
-    auto commandHandleRef = std::move(mAsyncCommandHandle);
+    auto commandHandleRef = std::move(query.mCommandHandle);
+    query.mInUse = false;
     auto commandHandle = commandHandleRef.Get();
-    if (commandHandle == nullptr || commandHandle->GetExchangeContext()->GetSessionHandle()->GetPeer() != mPeerNodeId) {
+    if (commandHandle == nullptr ||
+        commandHandle->GetExchangeContext()->GetSessionHandle()->GetPeer() != query.mPeerNodeId) {
         ESP_LOGE(TAG, "Invalid commandHandle, cannot send QueryImageResponse");
         return;
     }
-    EspOtaRequestorEntry *requestor = FindOtaRequestorEntry(mPeerNodeId);
+    uint32_t latencyMs = static_cast<uint32_t>((esp_timer_get_time() - query.mStartTimeUs) / 1000);
+    mQueryImageStats.mLatencyMinMs =
+        mQueryResponses == 0 ? latencyMs : std::min(mQueryImageStats.mLatencyMinMs, latencyMs);
+    mQueryImageStats.mLatencyMaxMs = std::max(mQueryImageStats.mLatencyMaxMs, latencyMs);
+    mQueryLatencySumMs += latencyMs;
+    mQueryResponses++;
+    EspOtaRequestorEntry *requestor = FindOtaRequestorEntry(query.mPeerNodeId);
     if (requestor) {
         if ((!requestor->mOtaAllowed) && (!requestor->mOtaAllowedOnce)) {
             if (status == OTAQueryStatus::kUpdateAvailable) {
@@ -96,12 +133,27 @@ void EspOtaProvider::SendQueryImageResponse(OTAQueryStatus status)
         status = OTAQueryStatus::kNotAvailable;
     }
 
+    if (status == OTAQueryStatus::kUpdateAvailable) {
+        OtaRolloutScheduler::Admission admission =
+            mRolloutScheduler.CheckAdmission(query.mPeerNodeId, requestor->mNetworkId, query.mVendorId,
+                                             query.mProductId, requestor->mSoftwareVersion,
+                                             mOtaBdxSenderPool.GetNetworkSessionCount(requestor->mNetworkId));
+        if (admission == OtaRolloutScheduler::kNotInStage) {
+            ESP_LOGI(TAG, "Node 0x%" PRIx64 " is not in the current rollout stage", query.mPeerNodeId.GetNodeId());
+            status = OTAQueryStatus::kNotAvailable;
+        } else if (admission != OtaRolloutScheduler::kAdmitted) {
+            ESP_LOGI(TAG, "Transfer to node 0x%" PRIx64 " is deferred: %s", query.mPeerNodeId.GetNodeId(),
+                     admission == OtaRolloutScheduler::kNetworkBusy ? "network busy" : "outside transfer window");
+            status = OTAQueryStatus::kBusy;
+        }
+    }
+
     QueryImageResponse::Type response;
     char strBuf[kUpdateTokenStrLen] = {0};
 
     // Set fields specific for an available status response
     if (status == OTAQueryStatus::kUpdateAvailable) {
-        FabricIndex fabricIndex = mSubjectDescriptor.fabricIndex;
+        FabricIndex fabricIndex = query.mSubjectDescriptor.fabricIndex;
         const FabricInfo *fabricInfo = Server::GetInstance().GetFabricTable().FindFabricWithIndex(fabricIndex);
         NodeId providerNodeId = fabricInfo->GetPeerId().GetNodeId();
 
@@ -121,17 +173,34 @@ void EspOtaProvider::SendQueryImageResponse(OTAQueryStatus status)
         // Initialize the transfer session in prepartion for a BDX transfer
         BitFlags<TransferControlFlags> bdxFlags;
         bdxFlags.Set(TransferControlFlags::kReceiverDrive);
-        if (mOtaBdxSender.InitializeTransfer(mSubjectDescriptor.fabricIndex, mSubjectDescriptor.subject) == ESP_OK) {
-            mOtaBdxSender.SetOtaImageUrl(requestor->mOtaImageUrl);
+        OtaBdxSender *bdxSender = mOtaBdxSenderPool.AllocateSender(
+            query.mSubjectDescriptor.fabricIndex, query.mSubjectDescriptor.subject, requestor->mNetworkId);
+        if (bdxSender) {
+            bdxSender->SetOtaImageUrl(requestor->mOtaImageUrl);
+            // Known size of the image, so that the transfers resumed at an offset find the end of the image
+            bdxSender->SetOtaImageSize(requestor->mOtaImageSize);
+            bdxSender->SetOtaImageDigest(requestor->mHasOtaImageDigest ? requestor->mOtaImageDigest : nullptr);
+            bdxSender->SetBlockPacer(mRolloutScheduler.GetNetworkPacer(requestor->mNetworkId));
+            requestor->mInRollout =
+                mRolloutScheduler.IsInRollout(query.mVendorId, query.mProductId, requestor->mSoftwareVersion);
             ESP_LOGI(TAG, "Bdx Sender will query the OTA image from %s", requestor->mOtaImageUrl);
-            CHIP_ERROR error = mOtaBdxSender.PrepareForTransfer(
-                &chip::DeviceLayer::SystemLayer(), chip::bdx::TransferRole::kSender, bdxFlags, kMaxBdxBlockSize,
+            uint32_t maxBlockSize = GetMaxBdxBlockSize(commandHandle->GetExchangeContext()->GetSessionHandle());
+            CHIP_ERROR error = bdxSender->PrepareForTransfer(
+                &chip::DeviceLayer::SystemLayer(), chip::bdx::TransferRole::kSender, bdxFlags, maxBlockSize,
                 kBdxTimeout, chip::System::Clock::Milliseconds32(mPollInterval));
             if (error != CHIP_NO_ERROR) {
                 ESP_LOGE(TAG, "Cannot prepare for transfer: %" CHIP_ERROR_FORMAT, error.Format());
-                commandHandle->AddStatus(mPath, Status::Failure);
+                // Release the sender back to the pool
+                bdxSender->Reset();
+                commandHandle->AddStatus(query.mPath, Status::Failure);
                 return;
             }
+#if CONFIG_ESP_MATTER_OTA_PROVIDER_IMAGE_CACHE
+            // Cache the image in the background for the next transfers, this transfer is served from the network if
+            // the image is not cached yet.
+            ota_image_cache_add(requestor->mOtaImageUrl, requestor->mOtaImageSize,
+                                requestor->mHasOtaImageDigest ? requestor->mOtaImageDigest : nullptr);
+#endif
             GenerateUpdateToken(requestor->mUpdateToken, kUpdateTokenLen);
             GetUpdateTokenString(ByteSpan(requestor->mUpdateToken), strBuf, kUpdateTokenStrLen);
             ESP_LOGD(TAG, "Generated updateToken: %s", strBuf);
@@ -141,7 +210,9 @@ void EspOtaProvider::SendQueryImageResponse(OTAQueryStatus status)
             response.softwareVersionString.Emplace(chip::CharSpan::fromCharString(requestor->mSoftwareVersionString));
             response.updateToken.Emplace(chip::ByteSpan(requestor->mUpdateToken));
         } else {
-            // Another BDX transfer in progress
+            // All the BDX senders are in use or reserved for the requestors which have been waiting longer
+            ESP_LOGI(TAG, "No free BDX sender, %u transfers in progress",
+                     static_cast<unsigned>(mOtaBdxSenderPool.GetActiveSessionCount()));
             status = OTAQueryStatus::kBusy;
         }
     }
@@ -157,23 +228,40 @@ void EspOtaProvider::SendQueryImageResponse(OTAQueryStatus status)
     // Set remaining fields common to all status types
     response.status = status;
     // Either sends the response or an error status
-    commandHandle->AddResponse(mPath, response);
+    commandHandle->AddResponse(query.mPath, response);
 }
 
 void EspOtaProvider::FetchImageDoneCallback(OTAQueryStatus status, const char *imageUrl, size_t imageSize,
-                                            uint32_t softwareVersion, const char *softwareVersionStr, void *arg)
+                                            const uint8_t *imageDigest, uint32_t softwareVersion,
+                                            const char *softwareVersionStr, void *arg)
 {
-    EspOtaProvider *provider = (EspOtaProvider *)arg;
-    assert(provider);
-    EspOtaRequestorEntry *requestor = provider->FindOtaRequestorEntry(provider->mPeerNodeId);
+    PendingQuery *query = (PendingQuery *)arg;
+    assert(query && query->mProvider);
+    EspOtaProvider *provider = query->mProvider;
+    // The requestor entries are accessed in the Matter task, look up and update the entry with the stack locked.
+    DeviceLayer::PlatformMgr().LockChipStack();
+    EspOtaRequestorEntry *requestor = provider->FindOtaRequestorEntry(query->mPeerNodeId);
     if (requestor && status == OTAQueryStatus::kUpdateAvailable) {
         strncpy(requestor->mOtaImageUrl, imageUrl, sizeof(requestor->mOtaImageUrl) - 1);
         requestor->mOtaImageSize = imageSize;
+        requestor->mHasOtaImageDigest = imageDigest != nullptr;
+        if (imageDigest) {
+            memcpy(requestor->mOtaImageDigest, imageDigest, sizeof(requestor->mOtaImageDigest));
+        }
         requestor->mSoftwareVersion = softwareVersion;
         strncpy(requestor->mSoftwareVersionString, softwareVersionStr, sizeof(requestor->mSoftwareVersionString) - 1);
+        DeltaImage *delta = provider->FindDeltaImage(query->mVendorId, query->mProductId, query->mSoftwareVersion,
+                                                     softwareVersion);
+        if (delta) {
+            ESP_LOGI(TAG, "Serve the delta image from version %" PRIu32 " to version %" PRIu32,
+                     delta->mBaseSoftwareVersion, softwareVersion);
+            strncpy(requestor->mOtaImageUrl, delta->mImageUrl, sizeof(requestor->mOtaImageUrl) - 1);
+            requestor->mOtaImageSize = delta->mImageSize;
+            requestor->mHasOtaImageDigest = delta->mHasImageDigest;
+            memcpy(requestor->mOtaImageDigest, delta->mImageDigest, sizeof(requestor->mOtaImageDigest));
+        }
     }
-    DeviceLayer::PlatformMgr().LockChipStack();
-    provider->SendQueryImageResponse(status);
+    provider->SendQueryImageResponse(*query, status);
     DeviceLayer::PlatformMgr().UnlockChipStack();
 }
 
@@ -183,14 +271,24 @@ void EspOtaProvider::HandleQueryImage(CommandHandler *commandObj, const Concrete
     uint16_t vendor_id = commandData.vendorID;
     uint16_t product_id = commandData.productID;
     uint32_t software_version = commandData.softwareVersion;
+    mQueryImageStats.mQueries++;
+    UpdateMinFreeHeap();
     if (CreateOtaRequestorEntry(commandObj->GetExchangeContext()->GetSessionHandle()->GetPeer()) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create Ota Pending Entry");
         commandObj->AddStatus(commandPath, Status::ResourceExhausted);
         return;
     }
 
-    if (mAsyncCommandHandle.Get() != nullptr) {
-        // We have a command processing in the backend, reject query image command.
+    PendingQuery *query = nullptr;
+    for (PendingQuery &pendingQuery : mPendingQueries) {
+        if (!pendingQuery.mInUse) {
+            query = &pendingQuery;
+            break;
+        }
+    }
+    if (!query) {
+        // As many commands as BDX transfers are processing in the backend, reject query image command.
+        mQueryImageStats.mConcurrentQueryRejections++;
         QueryImageResponse::Type response;
         response.status = OTAQueryStatus::kBusy;
         if (mDelayedApplyActionTimeSec == 0) {
@@ -203,12 +301,18 @@ void EspOtaProvider::HandleQueryImage(CommandHandler *commandObj, const Concrete
     // The OTA provider might need some time to query the image information from DCL.
     commandObj->FlushAcksRightAwayOnSlowCommand();
     // Use a command handle to hold the CommandHandler so that it will not be released.
-    mSubjectDescriptor = commandObj->GetSubjectDescriptor();
-    mPeerNodeId = commandObj->GetExchangeContext()->GetSessionHandle()->GetPeer();
-    mAsyncCommandHandle = chip::app::CommandHandler::Handle(commandObj);
-    mPath = commandPath;
-    if (fetch_ota_candidate(vendor_id, product_id, software_version, FetchImageDoneCallback, this) != ESP_OK) {
-        SendQueryImageResponse(OTAQueryStatus::kNotAvailable);
+    query->mProvider = this;
+    query->mInUse = true;
+    query->mSubjectDescriptor = commandObj->GetSubjectDescriptor();
+    query->mPeerNodeId = commandObj->GetExchangeContext()->GetSessionHandle()->GetPeer();
+    query->mCommandHandle = chip::app::CommandHandler::Handle(commandObj);
+    query->mStartTimeUs = esp_timer_get_time();
+    query->mPath = commandPath;
+    query->mVendorId = vendor_id;
+    query->mProductId = product_id;
+    query->mSoftwareVersion = software_version;
+    if (fetch_ota_candidate(vendor_id, product_id, software_version, FetchImageDoneCallback, query) != ESP_OK) {
+        SendQueryImageResponse(*query, OTAQueryStatus::kNotAvailable);
     }
 }
 
@@ -261,6 +365,10 @@ void EspOtaProvider::HandleNotifyUpdateApplied(app::CommandHandler *commandObj,
         commandObj->AddStatus(commandPath, Status::Success);
         // Finish OTA, set the set OtaAllowedOnce to false.
         requestor->mOtaAllowedOnce = false;
+        if (requestor->mInRollout) {
+            mRolloutScheduler.OnUpdateApplied();
+            requestor->mInRollout = false;
+        }
     } else {
         commandObj->AddStatus(commandPath, Status::InvalidCommand);
     }
@@ -304,6 +412,109 @@ esp_err_t EspOtaProvider::DisableOtaForNode(const chip::ScopedNodeId &nodeId)
     return found ? ESP_OK : ESP_ERR_NOT_FOUND;
 }
 
+esp_err_t EspOtaProvider::SetRequestorNetwork(const chip::ScopedNodeId &nodeId, uint8_t networkId)
+{
+    ESP_RETURN_ON_FALSE(networkId < OtaRolloutScheduler::kMaxNetworks, ESP_ERR_INVALID_ARG, TAG,
+                        "Invalid network id");
+    ESP_RETURN_ON_ERROR(CreateOtaRequestorEntry(nodeId), TAG, "Failed to create Ota Requestor Entry");
+    FindOtaRequestorEntry(nodeId)->mNetworkId = networkId;
+    return ESP_OK;
+}
+
+void EspOtaProvider::TransferEventObserver(OtaBdxSender *sender, OtaBdxSender::TransferEvent event, void *ctx)
+{
+    EspOtaProvider *provider = static_cast<EspOtaProvider *>(ctx);
+    provider->UpdateMinFreeHeap();
+    EspOtaRequestorEntry *requestor = provider->FindOtaRequestorEntry(sender->GetPeerNodeId());
+    if (requestor && requestor->mInRollout) {
+        provider->mRolloutScheduler.OnTransferEvent(event);
+    }
+}
+
+void EspOtaProvider::GetQueryImageStats(QueryImageStats &stats)
+{
+    stats = mQueryImageStats;
+    stats.mLatencyAvgMs = mQueryResponses > 0 ? static_cast<uint32_t>(mQueryLatencySumMs / mQueryResponses) : 0;
+}
+
+void EspOtaProvider::ResetQueryImageStats()
+{
+    mQueryImageStats = {};
+    mQueryImageStats.mMinFreeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    mQueryLatencySumMs = 0;
+    mQueryResponses = 0;
+}
+
+void EspOtaProvider::UpdateMinFreeHeap()
+{
+    mQueryImageStats.mMinFreeHeap =
+        std::min(mQueryImageStats.mMinFreeHeap, static_cast<uint32_t>(heap_caps_get_free_size(MALLOC_CAP_8BIT)));
+}
+
+void EspOtaProvider::GetOtaCandidatesCacheStats(OtaCandidatesCacheStats &stats)
+{
+    get_ota_candidates_cache_stats(stats);
+}
+
+void EspOtaProvider::ResetOtaCandidatesCacheStats()
+{
+    reset_ota_candidates_cache_stats();
+}
+
+esp_err_t EspOtaProvider::AddDeltaImage(uint16_t vendorId, uint16_t productId, uint32_t baseSoftwareVersion,
+                                        uint32_t softwareVersion, const char *imageUrl, size_t imageSize,
+                                        const uint8_t *imageDigest)
+{
+    ESP_RETURN_ON_FALSE(imageUrl && strlen(imageUrl) < OTA_URL_MAX_LEN && strrchr(imageUrl, '/'),
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid delta image URL");
+    ESP_RETURN_ON_FALSE(baseSoftwareVersion < softwareVersion, ESP_ERR_INVALID_ARG, TAG,
+                        "The base version should be older than the new version");
+    DeltaImage *delta = FindDeltaImage(vendorId, productId, baseSoftwareVersion, softwareVersion);
+    for (size_t i = 0; !delta && i < CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_DELTA_IMAGES; ++i) {
+        if (!mDeltaImages[i].mInUse) {
+            delta = &mDeltaImages[i];
+        }
+    }
+    ESP_RETURN_ON_FALSE(delta, ESP_ERR_NO_MEM, TAG, "No room for the delta image");
+    memset(delta, 0, sizeof(DeltaImage));
+    delta->mInUse = true;
+    delta->mVendorId = vendorId;
+    delta->mProductId = productId;
+    delta->mBaseSoftwareVersion = baseSoftwareVersion;
+    delta->mSoftwareVersion = softwareVersion;
+    strncpy(delta->mImageUrl, imageUrl, sizeof(delta->mImageUrl) - 1);
+    delta->mImageSize = imageSize;
+    delta->mHasImageDigest = imageDigest != nullptr;
+    if (imageDigest) {
+        memcpy(delta->mImageDigest, imageDigest, sizeof(delta->mImageDigest));
+    }
+    return ESP_OK;
+}
+
+esp_err_t EspOtaProvider::RemoveDeltaImage(uint16_t vendorId, uint16_t productId, uint32_t baseSoftwareVersion,
+                                           uint32_t softwareVersion)
+{
+    DeltaImage *delta = FindDeltaImage(vendorId, productId, baseSoftwareVersion, softwareVersion);
+    if (!delta) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    delta->mInUse = false;
+    return ESP_OK;
+}
+
+EspOtaProvider::DeltaImage *EspOtaProvider::FindDeltaImage(uint16_t vendorId, uint16_t productId,
+                                                           uint32_t baseSoftwareVersion, uint32_t softwareVersion)
+{
+    for (size_t i = 0; i < CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_DELTA_IMAGES; ++i) {
+        DeltaImage &delta = mDeltaImages[i];
+        if (delta.mInUse && delta.mVendorId == vendorId && delta.mProductId == productId &&
+            delta.mBaseSoftwareVersion == baseSoftwareVersion && delta.mSoftwareVersion == softwareVersion) {
+            return &delta;
+        }
+    }
+    return nullptr;
+}
+
 EspOtaProvider::EspOtaRequestorEntry *EspOtaProvider::FindOtaRequestorEntry(const chip::ScopedNodeId &nodeId)
 {
     EspOtaRequestorEntry *iter = mOtaRequestorList;
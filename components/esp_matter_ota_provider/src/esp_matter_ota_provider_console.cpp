@@ -0,0 +1,140 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_matter_ota_provider.h>
+#include <esp_matter_ota_provider_console.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <esp_matter_core.h>
+
+static constexpr char TAG[] = "ota_provider";
+
+using esp_matter::ota_provider::EspOtaProvider;
+using esp_matter::ota_provider::OtaBdxSenderPool;
+
+namespace esp_matter {
+namespace console {
+
+static engine ota_provider_console;
+
+static esp_err_t ota_provider_stats_handler(int argc, char **argv)
+{
+    if (argc > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (argc == 1 && strncmp(argv[0], "reset", sizeof("reset")) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    EspOtaProvider &provider = EspOtaProvider::GetInstance();
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturnError(lock_status != lock::FAILED, ESP_FAIL, ESP_LOGE(TAG, "Could not get task context"));
+    if (argc == 1) {
+        provider.ResetQueryImageStats();
+        provider.ResetBdxTransferStats();
+        provider.ResetOtaCandidatesCacheStats();
+        if (lock_status == lock::SUCCESS) {
+            lock::chip_stack_unlock();
+        }
+        return ESP_OK;
+    }
+    EspOtaProvider::QueryImageStats queryStats;
+    OtaBdxSenderPool::Stats bdxStats;
+    EspOtaProvider::OtaCandidatesCacheStats cacheStats;
+    provider.GetQueryImageStats(queryStats);
+    provider.GetBdxTransferStats(bdxStats);
+    provider.GetOtaCandidatesCacheStats(cacheStats);
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+    ESP_LOGI(TAG, "QueryImage: %" PRIu32 " commands, %" PRIu32 " rejected while busy, latency %" PRIu32 "/%" PRIu32
+             "/%" PRIu32 " ms min/avg/max", queryStats.mQueries, queryStats.mConcurrentQueryRejections,
+             queryStats.mLatencyMinMs, queryStats.mLatencyAvgMs, queryStats.mLatencyMaxMs);
+
+    ESP_LOGI(TAG, "BDX: %" PRIu32 " completed, %" PRIu32 " failed, %" PRIu32 " busy responses, %" PRIu64
+             " bytes, %" PRIu32 " B/s aggregate", bdxStats.mTransfersCompleted, bdxStats.mTransfersFailed,
+             bdxStats.mBusyRejections, bdxStats.mBytesSent, bdxStats.mAggregateThroughput);
+
+    ESP_LOGI(TAG, "Candidates cache: %" PRIu32 " hits, %" PRIu32 " negative hits, %" PRIu32 " misses, %" PRIu32
+             " DCL requests", cacheStats.mHits, cacheStats.mNegativeHits, cacheStats.mMisses, cacheStats.mDclRequests);
+
+    ESP_LOGI(TAG, "Heap: %u bytes free, %" PRIu32 " at least during the OTA, %u at least since boot",
+             heap_caps_get_free_size(MALLOC_CAP_8BIT), queryStats.mMinFreeHeap,
+             heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+    return ESP_OK;
+}
+
+static esp_err_t ota_provider_transfers_handler(int argc, char **argv)
+{
+    if (argc != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    OtaBdxSenderPool::TransferRecord records[OtaBdxSenderPool::kTransferHistorySize];
+    lock::status_t lock_status = lock::chip_stack_lock(portMAX_DELAY);
+    VerifyOrReturnError(lock_status != lock::FAILED, ESP_FAIL, ESP_LOGE(TAG, "Could not get task context"));
+    size_t count =
+        EspOtaProvider::GetInstance().GetBdxTransferHistory(records, OtaBdxSenderPool::kTransferHistorySize);
+    if (lock_status == lock::SUCCESS) {
+        lock::chip_stack_unlock();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const auto &stats = records[i].mStats;
+        ESP_LOGI(TAG, "Node 0x%" PRIx64 " %s: %" PRIu64 " bytes in %" PRIu32 " ms (%" PRIu32 " B/s), block size %u"
+                 "/%u/%u max/min/last, round trip %" PRIu32 "/%" PRIu32 "/%" PRIu32 " ms min/avg/max",
+                 records[i].mNodeId.GetNodeId(), records[i].mSucceeded ? "completed" : "failed", stats.mBytesSent,
+                 stats.mDurationMs, stats.mThroughput, stats.mMaxBlockSize, stats.mMinBlockSize, stats.mBlockSize,
+                 stats.mRttMinMs, stats.mRttAvgMs, stats.mRttMaxMs);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ota_provider_dispatch(int argc, char **argv)
+{
+    if (argc <= 0) {
+        ota_provider_console.for_each_command(print_description, NULL);
+        return ESP_OK;
+    }
+    return ota_provider_console.exec_command(argc, argv);
+}
+
+esp_err_t ota_provider_register_commands()
+{
+    static const command_t command = {
+        .name = "ota-provider",
+        .description = "OTA provider commands. Usage: matter esp ota-provider <ota_provider_command>.",
+        .handler = ota_provider_dispatch,
+    };
+
+    static const command_t ota_provider_commands[] = {
+        {
+            .name = "stats",
+            .description = "Print the QueryImage, BDX, candidates cache and heap statistics.\n"
+                           "\tUsage: ota-provider stats [reset]",
+            .handler = ota_provider_stats_handler,
+        },
+        {
+            .name = "transfers",
+            .description = "Print the statistics of the last BDX transfers. Usage: ota-provider transfers",
+            .handler = ota_provider_transfers_handler,
+        },
+    };
+    ota_provider_console.register_commands(ota_provider_commands,
+                                           sizeof(ota_provider_commands) / sizeof(command_t));
+    return add_commands(&command, 1);
+}
+
+} // namespace console
+} // namespace esp_matter
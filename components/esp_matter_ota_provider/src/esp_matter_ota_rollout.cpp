@@ -0,0 +1,184 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <esp_matter_ota_rollout.h>
+#include <string.h>
+#include <time.h>
+
+static constexpr char TAG[] = "ota_provider";
+
+namespace esp_matter {
+namespace ota_provider {
+
+static constexpr uint16_t kMinutesPerDay = 24 * 60;
+
+// Stable bucket in [0, 100) of a node, so that the nodes admitted in a stage stay admitted in the next stages
+static uint8_t GetNodeBucket(const chip::ScopedNodeId &nodeId)
+{
+    // FNV-1a over the NodeId and the FabricIndex
+    uint32_t hash = 2166136261u;
+    uint64_t value = nodeId.GetNodeId();
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        hash = (hash ^ static_cast<uint8_t>(value >> (i * 8))) * 16777619u;
+    }
+    hash = (hash ^ nodeId.GetFabricIndex()) * 16777619u;
+    return hash % 100;
+}
+
+OtaRolloutScheduler::OtaRolloutScheduler()
+    : mConfig{}
+    , mProgress{}
+    , mNetworks{}
+    , mWindowStartMinute(0)
+    , mWindowEndMinute(0)
+{
+}
+
+esp_err_t OtaRolloutScheduler::StartRollout(const RolloutConfig &config)
+{
+    ESP_RETURN_ON_FALSE(config.mStageCount > 0 && config.mStageCount <= kMaxStages, ESP_ERR_INVALID_ARG, TAG,
+                        "Stage count should be in range [1, %u]", kMaxStages);
+    for (uint8_t i = 0; i < config.mStageCount; ++i) {
+        ESP_RETURN_ON_FALSE(config.mStagePercents[i] <= 100 &&
+                                (i == 0 || config.mStagePercents[i] >= config.mStagePercents[i - 1]),
+                            ESP_ERR_INVALID_ARG, TAG, "Stage percentages should be increasing and not above 100");
+    }
+    mConfig = config;
+    mProgress = {};
+    mProgress.mActive = true;
+    mProgress.mStagePercent = mConfig.mStagePercents[0];
+    ESP_LOGI(TAG, "Start rollout of VID 0x%x PID 0x%x version %" PRIu32 ", stage 0: %u%%", mConfig.mVendorId,
+             mConfig.mProductId, mConfig.mSoftwareVersion, mProgress.mStagePercent);
+    return ESP_OK;
+}
+
+esp_err_t OtaRolloutScheduler::AdvanceStage()
+{
+    ESP_RETURN_ON_FALSE(mProgress.mActive, ESP_ERR_INVALID_STATE, TAG, "No rollout in progress");
+    ESP_RETURN_ON_FALSE(mProgress.mStage + 1 < mConfig.mStageCount, ESP_ERR_INVALID_STATE, TAG,
+                        "The rollout is at its last stage");
+    mProgress.mStage++;
+    mProgress.mStagePercent = mConfig.mStagePercents[mProgress.mStage];
+    ESP_LOGI(TAG, "Rollout stage %u: %u%%", mProgress.mStage, mProgress.mStagePercent);
+    return ESP_OK;
+}
+
+void OtaRolloutScheduler::StopRollout()
+{
+    mProgress.mActive = false;
+    mProgress.mPaused = false;
+}
+
+esp_err_t OtaRolloutScheduler::SetNetworkTransferLimit(uint8_t networkId, uint8_t maxTransfers)
+{
+    ESP_RETURN_ON_FALSE(networkId < kMaxNetworks, ESP_ERR_INVALID_ARG, TAG, "Invalid network id");
+    mNetworks[networkId].mMaxTransfers = maxTransfers;
+    return ESP_OK;
+}
+
+esp_err_t OtaRolloutScheduler::SetNetworkBandwidth(uint8_t networkId, uint32_t bytesPerSecond)
+{
+    ESP_RETURN_ON_FALSE(networkId < kMaxNetworks, ESP_ERR_INVALID_ARG, TAG, "Invalid network id");
+    mNetworks[networkId].mPacer.SetRate(bytesPerSecond);
+    return ESP_OK;
+}
+
+esp_err_t OtaRolloutScheduler::SetTransferWindow(uint16_t startMinuteOfDay, uint16_t endMinuteOfDay)
+{
+    ESP_RETURN_ON_FALSE(startMinuteOfDay < kMinutesPerDay && endMinuteOfDay < kMinutesPerDay, ESP_ERR_INVALID_ARG,
+                        TAG, "Invalid transfer window");
+    mWindowStartMinute = startMinuteOfDay;
+    mWindowEndMinute = endMinuteOfDay;
+    return ESP_OK;
+}
+
+bool OtaRolloutScheduler::IsInTransferWindow() const
+{
+    if (mWindowStartMinute == mWindowEndMinute) {
+        return true;
+    }
+    time_t now = time(nullptr);
+    struct tm localTime;
+    localtime_r(&now, &localTime);
+    // The system time is not set
+    if (localTime.tm_year < (2020 - 1900)) {
+        return true;
+    }
+    uint16_t minute = localTime.tm_hour * 60 + localTime.tm_min;
+    if (mWindowStartMinute < mWindowEndMinute) {
+        return minute >= mWindowStartMinute && minute < mWindowEndMinute;
+    }
+    return minute >= mWindowStartMinute || minute < mWindowEndMinute;
+}
+
+bool OtaRolloutScheduler::IsInRollout(uint16_t vendorId, uint16_t productId, uint32_t softwareVersion) const
+{
+    return mProgress.mActive && vendorId == mConfig.mVendorId && productId == mConfig.mProductId &&
+        (mConfig.mSoftwareVersion == 0 || mConfig.mSoftwareVersion == softwareVersion);
+}
+
+OtaRolloutScheduler::Admission OtaRolloutScheduler::CheckAdmission(const chip::ScopedNodeId &nodeId,
+                                                                   uint8_t networkId, uint16_t vendorId,
+                                                                   uint16_t productId, uint32_t softwareVersion,
+                                                                   size_t networkTransfers)
+{
+    bool inRollout = IsInRollout(vendorId, productId, softwareVersion);
+    if (inRollout && (mProgress.mPaused || GetNodeBucket(nodeId) >= mProgress.mStagePercent)) {
+        mProgress.mQueriesNotInStage++;
+        return kNotInStage;
+    }
+    Admission admission = kAdmitted;
+    if (!IsInTransferWindow()) {
+        admission = kOutsideWindow;
+    } else if (networkId < kMaxNetworks && mNetworks[networkId].mMaxTransfers != 0 &&
+               networkTransfers >= mNetworks[networkId].mMaxTransfers) {
+        admission = kNetworkBusy;
+    }
+    if (inRollout) {
+        if (admission == kAdmitted) {
+            mProgress.mQueriesAdmitted++;
+        } else {
+            mProgress.mQueriesThrottled++;
+        }
+    }
+    return admission;
+}
+
+OtaBandwidthPacer *OtaRolloutScheduler::GetNetworkPacer(uint8_t networkId)
+{
+    if (networkId >= kMaxNetworks || mNetworks[networkId].mPacer.GetRate() == 0) {
+        return nullptr;
+    }
+    return &mNetworks[networkId].mPacer;
+}
+
+void OtaRolloutScheduler::OnTransferEvent(OtaBdxSender::TransferEvent event)
+{
+    switch (event) {
+    case OtaBdxSender::kTransferStarted:
+        mProgress.mTransfersStarted++;
+        break;
+    case OtaBdxSender::kTransferCompleted:
+        mProgress.mTransfersCompleted++;
+        break;
+    case OtaBdxSender::kTransferFailed:
+        mProgress.mTransfersFailed++;
+        break;
+    }
+}
+
+} // namespace ota_provider
+} // namespace esp_matter
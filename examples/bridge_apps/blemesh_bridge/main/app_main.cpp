@@ -146,6 +146,12 @@ extern "C" void app_main()
 #if CONFIG_ENABLE_CHIP_SHELL
     esp_matter::console::diagnostics_register_commands();
     esp_matter::console::factoryreset_register_commands();
+#if CONFIG_ESP_MATTER_LOCK_STATS
+    esp_matter::console::lock_register_commands();
+#endif
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+    esp_matter::console::callback_register_commands();
+#endif
     esp_matter::console::init();
 #endif
 }
@@ -176,12 +176,13 @@ app_bridged_device_t *app_bridge_create_bridged_device(node_t *node, uint16_t pa
         ESP_LOGE(TAG, "The device list is full, could not add bridged device");
         return NULL;
     }
-    app_bridged_device_t *new_dev = (app_bridged_device_t *)esp_matter_mem_calloc(1, sizeof(app_bridged_device_t));
+    app_bridged_device_t *new_dev =
+        (app_bridged_device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE, 1, sizeof(app_bridged_device_t));
     new_dev->priv_data = priv_data;
     new_dev->dev = esp_matter_bridge::create_device(node, parent_endpoint_id, matter_device_type_id, new_dev);
     if (!(new_dev->dev)) {
         ESP_LOGE(TAG, "Failed to create the bridged device");
-        esp_matter_mem_free(new_dev);
+        esp_matter_mem_free_tagged(new_dev);
         return NULL;
     }
 
@@ -223,7 +224,8 @@ esp_err_t app_bridge_initialize(node_t *node, esp_matter_bridge::bridge_device_t
                 continue;
             }
             app_bridged_device_t *new_dev =
-                (app_bridged_device_t *)esp_matter_mem_calloc(1, sizeof(app_bridged_device_t));
+                (app_bridged_device_t *)esp_matter_mem_calloc_tagged(ESP_MATTER_MEM_TAG_BRIDGE, 1,
+                                                                     sizeof(app_bridged_device_t));
             if (!new_dev) {
                 ESP_LOGE(TAG, "Failed to alloc memory for the resumed bridged device");
                 continue;
@@ -231,7 +233,7 @@ esp_err_t app_bridge_initialize(node_t *node, esp_matter_bridge::bridge_device_t
             new_dev->dev = esp_matter_bridge::resume_device(node, matter_endpoint_id_array[idx], new_dev);
             if (!(new_dev->dev)) {
                 ESP_LOGE(TAG, "Failed to resume the bridged device");
-                esp_matter_mem_free(new_dev);
+                esp_matter_mem_free_tagged(new_dev);
                 continue;
             }
             new_dev->dev_type = device_type;
@@ -280,7 +282,7 @@ esp_err_t app_bridge_remove_device(app_bridged_device_t *bridged_device)
     if (error != ESP_OK) {
         ESP_LOGE(TAG, "Failed to delete bridged device");
     }
-    esp_matter_mem_free(bridged_device);
+    esp_matter_mem_free_tagged(bridged_device);
 
     return error;
 }
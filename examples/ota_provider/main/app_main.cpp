@@ -13,6 +13,9 @@
 #include <esp_matter.h>
 #include <esp_matter_console.h>
 #include <esp_matter_ota_provider.h>
+#if CONFIG_ENABLE_CHIP_SHELL
+#include <esp_matter_ota_provider_console.h>
+#endif
 
 #include <app_reset.h>
 
@@ -69,6 +72,13 @@ extern "C" void app_main()
     esp_matter::console::diagnostics_register_commands();
     esp_matter::console::wifi_register_commands();
     esp_matter::console::factoryreset_register_commands();
+#if CONFIG_ESP_MATTER_LOCK_STATS
+    esp_matter::console::lock_register_commands();
+#endif
+#if CONFIG_ESP_MATTER_CALLBACK_STATS
+    esp_matter::console::callback_register_commands();
+#endif
+    esp_matter::console::ota_provider_register_commands();
     esp_matter::console::init();
 #endif // CONFIG_ENABLE_CHIP_SHELL
 }
@@ -0,0 +1,151 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark of json_to_tlv() with the payloads of the controller commands. Each payload is converted with the
+// streaming JSON string path and, as the baseline, with cJSON_Parse() and the cJSON tree overload. It prints the
+// conversion time and the heap allocations per conversion of both paths, and the time to convert the items of a JSON
+// array one after the other with and without a cursor.
+
+#include <json_to_tlv.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using namespace chip;
+using namespace esp_matter;
+
+namespace {
+
+struct payload {
+    const char *name;
+    std::string json;
+};
+
+double elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Converts the payload with the JSON string, or with the cJSON tree parsed from the JSON string as the previous
+// implementation did.
+esp_err_t convert(const payload &p, bool use_cjson, TLV::TLVWriter &writer)
+{
+    if (!use_cjson) {
+        return json_to_tlv(p.json.c_str(), writer, TLV::AnonymousTag());
+    }
+    cJSON *json = cJSON_Parse(p.json.c_str());
+    if (!json) {
+        return ESP_FAIL;
+    }
+    esp_err_t err = json_to_tlv(json, writer, TLV::AnonymousTag());
+    cJSON_Delete(json);
+    return err;
+}
+
+bool run_payload(const payload &p, size_t iterations, bool use_cjson, uint8_t *buf, size_t buf_size, size_t &len)
+{
+    size_t allocations = Platform::gAllocationCount;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        TLV::TLVWriter writer;
+        writer.Init(buf, buf_size);
+        if (convert(p, use_cjson, writer) != ESP_OK) {
+            printf("%s: conversion failed\n", p.name);
+            return false;
+        }
+        len = writer.GetLengthWritten();
+    }
+    double total_us = elapsed_us(start);
+    printf("%-24s %-9s %6zu bytes %10.3f us/conversion %6.2f allocations/conversion\n", p.name,
+           use_cjson ? "cJSON" : "streaming", p.json.size(), total_us / iterations,
+           (double)(Platform::gAllocationCount - allocations) / iterations);
+    return true;
+}
+
+bool run_payload(const payload &p, size_t iterations)
+{
+    uint8_t cjson_buf[2048], streaming_buf[2048];
+    size_t cjson_len = 0, streaming_len = 0;
+    if (!run_payload(p, iterations, true, cjson_buf, sizeof(cjson_buf), cjson_len) ||
+        !run_payload(p, iterations, false, streaming_buf, sizeof(streaming_buf), streaming_len)) {
+        return false;
+    }
+    // Both paths are timed on the same input and must produce the same TLV
+    if (cjson_len != streaming_len || memcmp(cjson_buf, streaming_buf, cjson_len) != 0) {
+        printf("%s: the cJSON and the streaming outputs differ\n", p.name);
+        return false;
+    }
+    return true;
+}
+
+bool run_array_items(size_t item_count, size_t iterations, bool use_cursor)
+{
+    std::string json = "[";
+    for (size_t i = 0; i < item_count; ++i) {
+        json += (i ? ",{\"0:U16\":" : "{\"0:U16\":") + std::to_string(i) + ",\"1:STR\":\"item\"}";
+    }
+    json += "]";
+    static uint8_t buf[64 * 1024];
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < iterations; ++n) {
+        TLV::TLVWriter writer;
+        writer.Init(buf, sizeof(buf));
+        json_array_cursor_t cursor = {};
+        for (size_t i = 0; i < item_count; ++i) {
+            if (json_array_item_to_tlv(json.c_str(), i, writer, TLV::AnonymousTag(), use_cursor ? &cursor : nullptr) !=
+                ESP_OK) {
+                printf("array item %zu: conversion failed\n", i);
+                return false;
+            }
+        }
+    }
+    printf("%4zu array items %-10s %10.3f us/array\n", item_count, use_cursor ? "cursor" : "no cursor",
+           elapsed_us(start) / iterations);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    const payload payloads[] = {
+        {"on-off toggle", "{}"},
+        {"move-to-level", "{\"0:U8\": 128, \"1:U16\": 10, \"2:U8\": 0, \"3:U8\": 0}"},
+        {"move-to-level unsorted", "{\"3:U8\": 0, \"2:U8\": 0, \"1:U16\": 10, \"0:U8\": 128}"},
+        {"acl write",
+         "{\"0:ARR-OBJ\": [{\"1:U8\": 5, \"2:U8\": 2, \"3:ARR-U64\": [112233, \"18446744073709551615\"], "
+         "\"4:NULL\": null}, {\"1:U8\": 3, \"2:U8\": 2, \"3:ARR-U64\": [1, 2, 3], \"4:ARR-OBJ\": [{\"0:U32\": 6, "
+         "\"1:U16\": 1}]}]}"},
+        {"strings and bytes",
+         "{\"0:STR\": \"kitchen light\", \"1:STR\": \"caf\\u00e9 \\\"escaped\\\"\", \"2:BYT\": "
+         "\"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=\", \"3:FP\": 21.5, \"4:DFP\": \"-INF\"}"},
+    };
+    for (const payload &p : payloads) {
+        if (!run_payload(p, iterations)) {
+            return 1;
+        }
+    }
+    size_t array_iterations = iterations / 100 ? iterations / 100 : 1;
+    for (size_t item_count : {16, 256}) {
+        if (!run_array_items(item_count, array_iterations, false) || !run_array_items(item_count, array_iterations,
+                                                                                        true)) {
+            return 1;
+        }
+    }
+    return 0;
+}
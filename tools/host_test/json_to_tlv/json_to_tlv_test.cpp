@@ -0,0 +1,185 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <host_test.h>
+#include <json_to_tlv.h>
+
+#include <string>
+
+using namespace chip;
+using namespace esp_matter;
+
+static bool encode(const char *json, uint8_t *buf, size_t buf_size, size_t &len)
+{
+    TLV::TLVWriter writer;
+    writer.Init(buf, buf_size);
+    if (json_to_tlv(json, writer, TLV::AnonymousTag()) != ESP_OK) {
+        return false;
+    }
+    len = writer.GetLengthWritten();
+    return true;
+}
+
+static int test_struct()
+{
+    const uint8_t expected[] = {0x15, 0x24, 0x00, 0x01, 0x2C, 0x01, 0x02, 'a', 'b', 0x18};
+    uint8_t buf[64];
+    size_t len = 0;
+    TEST_ASSERT(encode("{\"0:U8\": 1, \"1:STR\": \"ab\"}", buf, sizeof(buf), len));
+    TEST_ASSERT(len == sizeof(expected) && memcmp(buf, expected, len) == 0);
+    return 0;
+}
+
+static int test_unsorted_struct()
+{
+    uint8_t sorted[128], unsorted[128];
+    size_t sorted_len = 0, unsorted_len = 0;
+    TEST_ASSERT(encode("{\"0:U8\":1,\"1:OBJ\":{\"0:BOOL\":true,\"2:I16\":-300},\"2:ARR-U16\":[1,2,3]}", sorted,
+                       sizeof(sorted), sorted_len));
+    TEST_ASSERT(encode("{\"2:ARR-U16\":[1,2,3],\"1:OBJ\":{\"2:I16\":-300,\"0:BOOL\":true},\"0:U8\":1}", unsorted,
+                       sizeof(unsorted), unsorted_len));
+    TEST_ASSERT(sorted_len == unsorted_len && memcmp(sorted, unsorted, sorted_len) == 0);
+    return 0;
+}
+
+static int test_nested_unsorted_struct()
+{
+    // Every level is out of tag order, so that each one of them is sorted.
+    std::string json;
+    for (int i = 0; i < 14; ++i) {
+        json += "{\"1:U8\":1,\"0:OBJ\":";
+    }
+    json += "{}";
+    for (int i = 0; i < 14; ++i) {
+        json += "}";
+    }
+    uint8_t buf[256];
+    size_t len = 0;
+    TEST_ASSERT(encode(json.c_str(), buf, sizeof(buf), len));
+    TEST_ASSERT(buf[0] == 0x15 && buf[1] == 0x35 && buf[2] == 0x00);
+    return 0;
+}
+
+static int test_rollback_on_error()
+{
+    uint8_t buf[64];
+    TLV::TLVWriter writer;
+    writer.Init(buf, sizeof(buf));
+    TLV::TLVType outer;
+    TEST_ASSERT(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, outer) == CHIP_NO_ERROR);
+    uint32_t written = writer.GetLengthWritten();
+
+    // Invalid value in a nested container
+    TEST_ASSERT(json_to_tlv("{\"0:U8\":1,\"1:OBJ\":{\"0:ARR-U8\":[1,\"x\"]}}", writer, TLV::AnonymousTag()) != ESP_OK);
+    TEST_ASSERT(writer.GetLengthWritten() == written && writer.GetContainerType() == TLV::kTLVType_Array);
+    // Invalid value in an unsorted object
+    TEST_ASSERT(json_to_tlv("{\"1:U8\":1,\"0:U8\":256}", writer, TLV::AnonymousTag()) != ESP_OK);
+    TEST_ASSERT(writer.GetLengthWritten() == written && writer.GetContainerType() == TLV::kTLVType_Array);
+    // Characters after the object
+    TEST_ASSERT(json_to_tlv("{\"0:U8\":1} x", writer, TLV::AnonymousTag()) != ESP_OK);
+    TEST_ASSERT(writer.GetLengthWritten() == written && writer.GetContainerType() == TLV::kTLVType_Array);
+
+    // The writer is still usable
+    TEST_ASSERT(json_to_tlv("{\"0:U8\":1}", writer, TLV::AnonymousTag()) == ESP_OK);
+    TEST_ASSERT(writer.EndContainer(outer) == CHIP_NO_ERROR);
+    const uint8_t expected[] = {0x16, 0x15, 0x24, 0x00, 0x01, 0x18, 0x18};
+    TEST_ASSERT(writer.GetLengthWritten() == sizeof(expected) && memcmp(buf, expected, sizeof(expected)) == 0);
+    return 0;
+}
+
+static int test_cjson_matches_string()
+{
+    const char *payloads[] = {
+        "{\"0:U8\": 1, \"1:STR\": \"a\\\"b\\u00e9\"}",
+        "{\"2:ARR-U16\":[1,2,3],\"1:OBJ\":{\"2:I16\":-300,\"0:BOOL\":true},\"0:U8\":1}",
+        "{\"0:ARR-OBJ\":[{\"1:NULL\":null,\"0:DFP\":1.5},{\"0:FP\":-2}],\"1:BYT\":\"AQID\"}",
+    };
+    for (const char *payload : payloads) {
+        uint8_t expected[128], buf[128];
+        size_t expected_len = 0;
+        TEST_ASSERT(encode(payload, expected, sizeof(expected), expected_len));
+        cJSON *json = cJSON_Parse(payload);
+        TEST_ASSERT(json);
+        TLV::TLVWriter writer;
+        writer.Init(buf, sizeof(buf));
+        esp_err_t err = json_to_tlv(json, writer, TLV::AnonymousTag());
+        cJSON_Delete(json);
+        TEST_ASSERT(err == ESP_OK);
+        TEST_ASSERT(writer.GetLengthWritten() == expected_len && memcmp(buf, expected, expected_len) == 0);
+    }
+
+    // Invalid value in a nested container, the writer is rolled back
+    cJSON *json = cJSON_Parse("{\"0:U8\":1,\"1:OBJ\":{\"0:ARR-U8\":[1,\"x\"]}}");
+    TEST_ASSERT(json);
+    uint8_t buf[64];
+    TLV::TLVWriter writer;
+    writer.Init(buf, sizeof(buf));
+    esp_err_t err = json_to_tlv(json, writer, TLV::AnonymousTag());
+    cJSON_Delete(json);
+    TEST_ASSERT(err != ESP_OK && writer.GetLengthWritten() == 0);
+    return 0;
+}
+
+static int test_array_get_size()
+{
+    size_t size = 1;
+    TEST_ASSERT(json_array_get_size("{\"0:U8\":1}", size) == ESP_OK && size == 0);
+    TEST_ASSERT(json_array_get_size("[]", size) == ESP_OK && size == 0);
+    TEST_ASSERT(json_array_get_size("[{\"0:U8\":1}, {}, {\"1:ARR-U8\":[1,2]}]", size) == ESP_OK && size == 3);
+    TEST_ASSERT(json_array_get_size("[{}, {}", size) != ESP_OK);
+    return 0;
+}
+
+static int test_array_item_cursor()
+{
+    const char *json = "[{\"0:U8\":0}, {\"0:U8\":1}, {\"1:U8\":2, \"0:U8\":2}, {\"0:U8\":3}]";
+    uint8_t with_cursor[128], without_cursor[128];
+    TLV::TLVWriter writer_with_cursor, writer_without_cursor;
+    writer_with_cursor.Init(with_cursor, sizeof(with_cursor));
+    writer_without_cursor.Init(without_cursor, sizeof(without_cursor));
+    json_array_cursor_t cursor = {};
+    for (size_t i = 0; i < 4; ++i) {
+        TEST_ASSERT(json_array_item_to_tlv(json, i, writer_with_cursor, TLV::AnonymousTag(), &cursor) == ESP_OK);
+        TEST_ASSERT(json_array_item_to_tlv(json, i, writer_without_cursor, TLV::AnonymousTag()) == ESP_OK);
+    }
+    TEST_ASSERT(cursor.index == 0 && cursor.offset == 0);
+    TEST_ASSERT(writer_with_cursor.GetLengthWritten() == writer_without_cursor.GetLengthWritten());
+    TEST_ASSERT(memcmp(with_cursor, without_cursor, writer_with_cursor.GetLengthWritten()) == 0);
+
+    // Skipping items forward and going back to an earlier item
+    uint8_t buf[32];
+    TLV::TLVWriter writer;
+    writer.Init(buf, sizeof(buf));
+    TEST_ASSERT(json_array_item_to_tlv(json, 1, writer, TLV::AnonymousTag(), &cursor) == ESP_OK);
+    TEST_ASSERT(cursor.index == 2);
+    TEST_ASSERT(json_array_item_to_tlv(json, 3, writer, TLV::AnonymousTag(), &cursor) == ESP_OK);
+    TEST_ASSERT(json_array_item_to_tlv(json, 0, writer, TLV::AnonymousTag(), &cursor) == ESP_OK);
+    const uint8_t expected[] = {0x15, 0x24, 0x00, 0x01, 0x18, 0x15, 0x24, 0x00, 0x03, 0x18, 0x15, 0x24, 0x00, 0x00, 0x18};
+    TEST_ASSERT(writer.GetLengthWritten() == sizeof(expected) && memcmp(buf, expected, sizeof(expected)) == 0);
+    TEST_ASSERT(json_array_item_to_tlv(json, 4, writer, TLV::AnonymousTag(), &cursor) != ESP_OK);
+    return 0;
+}
+
+int main()
+{
+    int failures = 0;
+    RUN_TEST(test_struct);
+    RUN_TEST(test_unsorted_struct);
+    RUN_TEST(test_nested_unsorted_struct);
+    RUN_TEST(test_rollback_on_error);
+    RUN_TEST(test_cjson_matches_string);
+    RUN_TEST(test_array_get_size);
+    RUN_TEST(test_array_item_cursor);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Compress images with tools/ota_compress/ota_compress.py and decode them with the lzss_decoder of the requestor.
+
+    ota_compressed_fixture.py <ota_compress.py> <ota_compressed_test executable> <output directory>
+"""
+
+import os
+import random
+import struct
+import subprocess
+import sys
+
+
+def _write(path, data):
+    with open(path, 'wb') as f:
+        f.write(data)
+
+
+def _scan(payload):
+    # Longest match and whether a match reads the window across its end, from the bit stream of the compressed image
+    _, _, window_bits, lookahead_bits, _, size = struct.unpack('<4sBBBBI', payload[:12])
+    bits = ''.join(f'{byte:08b}' for byte in payload[12:])
+    window = 1 << window_bits
+    pos = produced = longest = 0
+    wrapped = False
+    while produced < size:
+        if bits[pos] == '1':
+            pos += 9
+            produced += 1
+            continue
+        dist = int(bits[pos + 1:pos + 1 + window_bits], 2) + 1
+        length = int(bits[pos + 1 + window_bits:pos + 1 + window_bits + lookahead_bits], 2) + 1
+        pos += 1 + window_bits + lookahead_bits
+        wrapped |= (produced - dist) // window != produced // window
+        longest = max(longest, length)
+        produced += length
+    return longest, wrapped
+
+
+def _images(rng):
+    # Name, window bits, lookahead bits, image. The images are larger than the output buffer of the decoder and are not
+    # a multiple of its size.
+    block = rng.randbytes(200)
+    repeated = bytearray()
+    while len(repeated) < 24 * 1024:
+        mutated = bytearray(block)
+        mutated[rng.randrange(len(mutated))] = rng.randrange(256)
+        repeated += mutated
+    # Back-references of 200 bytes in a window of 256 bytes, across the end of the window
+    yield 'window_wrap', 8, 4, bytes(repeated[:24 * 1024 + 17])
+    runs = bytearray()
+    while len(runs) < 20 * 1024:
+        runs += rng.randbytes(rng.randrange(1, 64)) + bytes([rng.randrange(256)]) * rng.randrange(200, 600)
+    # Runs longer than the maximum match length, with the shortest and the longest lookahead
+    yield 'max_match_short', 10, 3, bytes(runs)
+    yield 'max_match_long', 12, 7, bytes(runs)
+    words = [b'esp_matter', b'cluster', b'attribute', b'endpoint', b' ', b'\n']
+    text = b''.join(rng.choice(words) for _ in range(5000))
+    yield 'mixed', 10, 4, rng.randbytes(5000) + text + rng.randbytes(3000)
+    yield 'large_window', 15, 7, text + text[::-1]
+    yield 'random', 10, 4, rng.randbytes(9000)
+
+
+def main():
+    ota_compress, decoder, out_dir = sys.argv[1:4]
+    os.makedirs(out_dir, exist_ok=True)
+    rng = random.Random(0)
+    for name, window_bits, lookahead_bits, image in _images(rng):
+        image_path = os.path.join(out_dir, f'{name}.bin')
+        compressed_path = os.path.join(out_dir, f'{name}.bin.lz')
+        _write(image_path, image)
+        subprocess.run([sys.executable, ota_compress, '-w', str(window_bits), '-l', str(lookahead_bits), image_path,
+                        compressed_path], check=True)
+        with open(compressed_path, 'rb') as f:
+            longest, wrapped = _scan(f.read())
+        if name.startswith('max_match') and longest != 1 << lookahead_bits:
+            raise SystemExit(f'{name}: no match of the maximum length')
+        if name == 'window_wrap' and not wrapped:
+            raise SystemExit(f'{name}: no match across the end of the window')
+        subprocess.run([decoder, compressed_path, image_path], check=True)
+
+
+if __name__ == '__main__':
+    main()
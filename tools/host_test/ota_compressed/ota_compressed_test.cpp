@@ -0,0 +1,207 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_matter_ota_lzss_decoder.h>
+#include <host_test.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+using namespace esp_matter::ota;
+
+typedef std::vector<uint8_t> bytes;
+
+// LZSS bit stream writer, most significant bit first like ota_compress.py
+struct bit_writer {
+    bytes data;
+    uint8_t bits = 0;
+    int count = 0;
+
+    void write(uint32_t value, int width)
+    {
+        for (int shift = width - 1; shift >= 0; --shift) {
+            bits = (bits << 1) | ((value >> shift) & 1);
+            if (++count == 8) {
+                data.push_back(bits);
+                bits = 0;
+                count = 0;
+            }
+        }
+    }
+
+    void literal(uint8_t byte)
+    {
+        write(1, 1);
+        write(byte, 8);
+    }
+
+    void match(uint32_t dist, uint32_t length, int window_bits, int lookahead_bits)
+    {
+        write(0, 1);
+        write(dist - 1, window_bits);
+        write(length - 1, lookahead_bits);
+    }
+
+    bytes flush()
+    {
+        if (count) {
+            data.push_back(bits << (8 - count));
+            bits = 0;
+            count = 0;
+        }
+        return data;
+    }
+};
+
+static esp_err_t write_output(const uint8_t *data, size_t size, void *ctx)
+{
+    bytes *output = static_cast<bytes *>(ctx);
+    output->insert(output->end(), data, data + size);
+    return ESP_OK;
+}
+
+// Decode the stream in chunks of chunk_size bytes, like the blocks of the BDX transfer
+static esp_err_t decode(const bytes &stream, uint8_t window_bits, uint8_t lookahead_bits, size_t output_size,
+                        size_t chunk_size, bytes &output)
+{
+    lzss_decoder decoder;
+    output.clear();
+    esp_err_t err = decoder.init(window_bits, lookahead_bits, output_size, write_output, &output);
+    for (size_t offset = 0; err == ESP_OK && offset < stream.size(); offset += chunk_size) {
+        size_t len = stream.size() - offset < chunk_size ? stream.size() - offset : chunk_size;
+        err = decoder.decode(stream.data() + offset, len);
+    }
+    if (err == ESP_OK) {
+        err = decoder.finish();
+    }
+    decoder.deinit();
+    return err;
+}
+
+static int test_overlapping_match()
+{
+    // A match which copies the bytes it produces, and a match before the start of the output which reads zeros
+    bit_writer writer;
+    writer.match(4, 3, 8, 4);
+    writer.literal('a');
+    writer.literal('b');
+    writer.match(2, 16, 8, 4);
+    bytes stream = writer.flush();
+    bytes expected = {0, 0, 0, 'a', 'b'};
+    for (int i = 0; i < 8; ++i) {
+        expected.push_back('a');
+        expected.push_back('b');
+    }
+    const size_t chunk_sizes[] = {1, 2, stream.size()};
+    for (size_t chunk_size : chunk_sizes) {
+        bytes output;
+        TEST_ASSERT(decode(stream, 8, 4, expected.size(), chunk_size, output) == ESP_OK);
+        TEST_ASSERT(output == expected);
+    }
+    return 0;
+}
+
+static int test_padding_ignored()
+{
+    // The match is longer than the remaining output and the padding bits look like a literal
+    bit_writer writer;
+    writer.literal(0x55);
+    writer.match(1, 16, 8, 4);
+    writer.write(1, 1);
+    bytes stream = writer.flush();
+    bytes output;
+    TEST_ASSERT(decode(stream, 8, 4, 10, 1, output) == ESP_OK);
+    TEST_ASSERT(output == bytes(10, 0x55));
+    return 0;
+}
+
+static int test_truncated_stream()
+{
+    bit_writer writer;
+    writer.literal(1);
+    writer.literal(2);
+    bytes stream = writer.flush();
+    bytes output;
+    TEST_ASSERT(decode(stream, 8, 4, 3, 1, output) == ESP_ERR_INVALID_SIZE);
+    return 0;
+}
+
+static int test_invalid_parameters()
+{
+    lzss_decoder decoder;
+    bytes output;
+    const uint8_t data[] = {0x80};
+    TEST_ASSERT(decoder.decode(data, sizeof(data)) == ESP_ERR_INVALID_STATE);
+    TEST_ASSERT(decoder.init(16, 4, 1, write_output, &output) == ESP_ERR_NOT_SUPPORTED);
+    TEST_ASSERT(decoder.init(8, 8, 1, write_output, &output) == ESP_ERR_NOT_SUPPORTED);
+    TEST_ASSERT(decoder.init(8, 2, 1, write_output, &output) == ESP_ERR_NOT_SUPPORTED);
+    TEST_ASSERT(decoder.init(8, 4, 1, nullptr, nullptr) == ESP_ERR_INVALID_ARG);
+    return 0;
+}
+
+static bool read_file(const char *path, bytes &data)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buf[4096];
+    size_t len;
+    data.clear();
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0) {
+        data.insert(data.end(), buf, buf + len);
+    }
+    fclose(file);
+    return true;
+}
+
+// Decode an image compressed by ota_compress.py, the header is checked like the compressed image processor does
+static int decode_file(const char *compressed_path, const char *image_path)
+{
+    bytes compressed, expected;
+    TEST_ASSERT(read_file(compressed_path, compressed) && read_file(image_path, expected));
+    compressed_image_header_t header;
+    TEST_ASSERT(compressed.size() >= sizeof(header));
+    memcpy(&header, compressed.data(), sizeof(header));
+    TEST_ASSERT(memcmp(header.magic, k_compressed_image_magic, sizeof(header.magic)) == 0);
+    TEST_ASSERT(header.version == k_compressed_image_version);
+    TEST_ASSERT(header.image_size == expected.size());
+    bytes stream(compressed.begin() + sizeof(header), compressed.end());
+    // The literals, the matches and their fields are split across the chunks, and the chunks across the output buffer
+    const size_t chunk_sizes[] = {1, 3, 7, 1024, 4099, stream.size()};
+    for (size_t chunk_size : chunk_sizes) {
+        bytes output;
+        TEST_ASSERT(decode(stream, header.window_bits, header.lookahead_bits, header.image_size, chunk_size, output) ==
+                    ESP_OK);
+        TEST_ASSERT(output == expected);
+    }
+    printf("PASS %s: %zu bytes decoded from %zu bytes\n", compressed_path, expected.size(), compressed.size());
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3) {
+        return decode_file(argv[1], argv[2]);
+    }
+    int failures = 0;
+    static_assert(sizeof(compressed_image_header_t) == 12, "The header of ota_compress.py is 12 bytes");
+    RUN_TEST(test_overlapping_match);
+    RUN_TEST(test_padding_ignored);
+    RUN_TEST(test_truncated_stream);
+    RUN_TEST(test_invalid_parameters);
+    return failures == 0 ? 0 : 1;
+}
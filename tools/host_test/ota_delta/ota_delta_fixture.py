@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Generate delta images with tools/ota_delta/ota_delta.py and apply them with the delta_patch_applier of the requestor.
+
+    ota_delta_fixture.py <ota_delta.py> <ota_delta_test executable> <output directory>
+"""
+
+import os
+import random
+import subprocess
+import sys
+
+
+def _write(path, data):
+    with open(path, 'wb') as f:
+        f.write(data)
+
+
+def _new_images(base, rng):
+    # A few changed bytes, an inserted section, a removed section and moved code
+    patched = bytearray(base)
+    for _ in range(32):
+        patched[rng.randrange(len(patched))] = rng.randrange(256)
+    yield 'changed', bytes(patched)
+    yield 'inserted', base[:20000] + rng.randbytes(3000) + base[20000:]
+    yield 'removed', base[:30000] + base[42000:]
+    yield 'moved', base[40000:] + base[:40000]
+    yield 'unrelated', rng.randbytes(len(base) // 2)
+
+
+def main():
+    ota_delta, applier, out_dir = sys.argv[1:4]
+    os.makedirs(out_dir, exist_ok=True)
+    rng = random.Random(0)
+    base = rng.randbytes(64 * 1024)
+    base_path = os.path.join(out_dir, 'base.bin')
+    _write(base_path, base)
+    for name, new in _new_images(base, rng):
+        new_path = os.path.join(out_dir, f'{name}.bin')
+        patch_path = os.path.join(out_dir, f'{name}.patch')
+        _write(new_path, new)
+        subprocess.run([sys.executable, ota_delta, 'create', '--verify', base_path, new_path, patch_path], check=True)
+        subprocess.run([applier, base_path, patch_path, new_path], check=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,248 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_matter_ota_delta_patch.h>
+#include <host_test.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+using namespace esp_matter::ota;
+
+typedef std::vector<uint8_t> bytes;
+
+static void put_le32(bytes &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(value >> (8 * i));
+    }
+}
+
+static void add_copy(bytes &patch, uint32_t offset, uint32_t length)
+{
+    patch.push_back(0x01);
+    put_le32(patch, offset);
+    put_le32(patch, length);
+}
+
+static void add_insert(bytes &patch, const bytes &data)
+{
+    patch.push_back(0x02);
+    put_le32(patch, data.size());
+    patch.insert(patch.end(), data.begin(), data.end());
+}
+
+static bytes make_data(size_t size, uint32_t seed)
+{
+    bytes data(size);
+    for (size_t i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+    return data;
+}
+
+struct patch_ctx {
+    const bytes *base;
+    bytes output;
+    size_t base_reads;
+};
+
+static esp_err_t read_base(size_t offset, uint8_t *buf, size_t size, void *ctx)
+{
+    patch_ctx *patch = static_cast<patch_ctx *>(ctx);
+    if (offset + size > patch->base->size()) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(buf, patch->base->data() + offset, size);
+    patch->base_reads++;
+    return ESP_OK;
+}
+
+static esp_err_t write_output(const uint8_t *data, size_t size, void *ctx)
+{
+    patch_ctx *patch = static_cast<patch_ctx *>(ctx);
+    patch->output.insert(patch->output.end(), data, data + size);
+    return ESP_OK;
+}
+
+// Apply the patch in chunks of chunk_size bytes, like the blocks of the BDX transfer
+static esp_err_t apply_patch(const bytes &base, const bytes &patch, size_t output_size, size_t chunk_size,
+                             patch_ctx &ctx)
+{
+    delta_patch_applier applier;
+    ctx.base = &base;
+    ctx.output.clear();
+    ctx.base_reads = 0;
+    esp_err_t err = applier.init(base.size(), output_size, read_base, write_output, &ctx);
+    for (size_t offset = 0; err == ESP_OK && offset < patch.size(); offset += chunk_size) {
+        size_t len = patch.size() - offset < chunk_size ? patch.size() - offset : chunk_size;
+        err = applier.apply(patch.data() + offset, len);
+    }
+    if (err == ESP_OK) {
+        err = applier.finish();
+    }
+    applier.deinit();
+    return err;
+}
+
+static int test_copy_and_insert()
+{
+    bytes base = make_data(8192, 1);
+    bytes inserted = make_data(300, 2);
+    bytes patch, expected;
+    // A copy longer than the copy buffer of the applier, an insert and a copy from the beginning of the base
+    add_copy(patch, 100, 3000);
+    expected.insert(expected.end(), base.begin() + 100, base.begin() + 3100);
+    add_insert(patch, inserted);
+    expected.insert(expected.end(), inserted.begin(), inserted.end());
+    add_copy(patch, 0, 17);
+    expected.insert(expected.end(), base.begin(), base.begin() + 17);
+
+    // The operations and their arguments are split at every possible position
+    const size_t chunk_sizes[] = {1, 3, 7, 64, patch.size()};
+    for (size_t chunk_size : chunk_sizes) {
+        patch_ctx ctx;
+        TEST_ASSERT(apply_patch(base, patch, expected.size(), chunk_size, ctx) == ESP_OK);
+        TEST_ASSERT(ctx.output == expected);
+    }
+    return 0;
+}
+
+static int test_empty_insert()
+{
+    bytes base = make_data(64, 3);
+    bytes patch;
+    add_insert(patch, bytes());
+    add_copy(patch, 0, 64);
+    patch_ctx ctx;
+    TEST_ASSERT(apply_patch(base, patch, 64, patch.size(), ctx) == ESP_OK);
+    TEST_ASSERT(ctx.output == base);
+    return 0;
+}
+
+static int test_copy_out_of_base()
+{
+    bytes base = make_data(1024, 4);
+    bytes patch;
+    add_copy(patch, 1000, 25);
+    patch_ctx ctx;
+    TEST_ASSERT(apply_patch(base, patch, 25, patch.size(), ctx) == ESP_ERR_INVALID_SIZE);
+    // Nothing is read from the base image
+    TEST_ASSERT(ctx.base_reads == 0);
+    return 0;
+}
+
+static int test_output_overflow()
+{
+    bytes base = make_data(1024, 5);
+    bytes patch;
+    add_copy(patch, 0, 512);
+    add_insert(patch, make_data(16, 6));
+    patch_ctx ctx;
+    TEST_ASSERT(apply_patch(base, patch, 520, patch.size(), ctx) == ESP_ERR_INVALID_SIZE);
+    TEST_ASSERT(ctx.output.size() == 512);
+    return 0;
+}
+
+static int test_truncated_patch()
+{
+    bytes base = make_data(1024, 7);
+    bytes patch;
+    add_copy(patch, 0, 512);
+    add_insert(patch, make_data(16, 8));
+    patch_ctx ctx;
+    // The patch stops in the inserted data
+    patch.resize(patch.size() - 4);
+    TEST_ASSERT(apply_patch(base, patch, 528, patch.size(), ctx) == ESP_ERR_INVALID_SIZE);
+    // The patch is complete but produces less than the image size
+    add_copy(patch, 0, 1);
+    patch.resize(patch.size() - 9);
+    TEST_ASSERT(apply_patch(base, patch, 600, patch.size(), ctx) == ESP_ERR_INVALID_SIZE);
+    return 0;
+}
+
+static int test_invalid_opcode()
+{
+    bytes base = make_data(64, 9);
+    bytes patch;
+    add_copy(patch, 0, 8);
+    patch.push_back(0x03);
+    patch_ctx ctx;
+    TEST_ASSERT(apply_patch(base, patch, 16, patch.size(), ctx) == ESP_ERR_INVALID_RESPONSE);
+    return 0;
+}
+
+static int test_not_initialized()
+{
+    delta_patch_applier applier;
+    const uint8_t data[] = {0x02, 0, 0, 0, 0};
+    TEST_ASSERT(applier.apply(data, sizeof(data)) == ESP_ERR_INVALID_STATE);
+    TEST_ASSERT(applier.init(0, 0, nullptr, write_output, nullptr) == ESP_ERR_INVALID_ARG);
+    return 0;
+}
+
+static bool read_file(const char *path, bytes &data)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buf[4096];
+    size_t len;
+    data.clear();
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0) {
+        data.insert(data.end(), buf, buf + len);
+    }
+    fclose(file);
+    return true;
+}
+
+// Apply a patch generated by ota_delta.py, the header is checked like the delta image processor does
+static int apply_patch_file(const char *base_path, const char *patch_path, const char *new_path)
+{
+    bytes base, patch, expected;
+    TEST_ASSERT(read_file(base_path, base) && read_file(patch_path, patch) && read_file(new_path, expected));
+    delta_image_header_t header;
+    TEST_ASSERT(patch.size() >= sizeof(header));
+    memcpy(&header, patch.data(), sizeof(header));
+    TEST_ASSERT(memcmp(header.magic, k_delta_image_magic, sizeof(header.magic)) == 0);
+    TEST_ASSERT(header.version == k_delta_image_version);
+    TEST_ASSERT(header.base_size == base.size() && header.image_size == expected.size());
+    bytes ops(patch.begin() + sizeof(header), patch.end());
+    patch_ctx ctx;
+    TEST_ASSERT(apply_patch(base, ops, header.image_size, 1024, ctx) == ESP_OK);
+    TEST_ASSERT(ctx.output == expected);
+    printf("PASS %s: %zu bytes patched from a patch of %zu bytes\n", patch_path, ctx.output.size(), patch.size());
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 4) {
+        return apply_patch_file(argv[1], argv[2], argv[3]);
+    }
+    int failures = 0;
+    static_assert(sizeof(delta_image_header_t) == 48, "The header of ota_delta.py is 48 bytes");
+    RUN_TEST(test_copy_and_insert);
+    RUN_TEST(test_empty_insert);
+    RUN_TEST(test_copy_out_of_base);
+    RUN_TEST(test_output_overflow);
+    RUN_TEST(test_truncated_patch);
+    RUN_TEST(test_invalid_opcode);
+    RUN_TEST(test_not_initialized);
+    return failures == 0 ? 0 : 1;
+}
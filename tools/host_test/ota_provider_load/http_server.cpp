@@ -0,0 +1,206 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+
+static constexpr char k_dcl_path[] = "/dcl/model/versions/";
+static constexpr char k_image_path[] = "/images/";
+static constexpr size_t k_send_chunk_size = 4096;
+
+static bool send_all(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+uint16_t http_server::start(const std::vector<dcl_model> &models, const std::vector<uint8_t> &image,
+                            uint32_t dcl_latency_ms)
+{
+    m_models = models;
+    m_image = &image;
+    m_dcl_latency_ms = dcl_latency_ms;
+    m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listen_fd < 0) {
+        return 0;
+    }
+    int one = 1;
+    setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (bind(m_listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(m_listen_fd, 64) != 0 ||
+        getsockname(m_listen_fd, reinterpret_cast<sockaddr *>(&addr), &addr_len) != 0) {
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return 0;
+    }
+    m_port = ntohs(addr.sin_port);
+    m_accept_thread = std::thread(&http_server::accept_loop, this);
+    return m_port;
+}
+
+void http_server::stop()
+{
+    if (m_listen_fd < 0) {
+        return;
+    }
+    m_stopped.store(true);
+    shutdown(m_listen_fd, SHUT_RDWR);
+    m_accept_thread.join();
+    close(m_listen_fd);
+    m_listen_fd = -1;
+    // The connections are closed by the clients, the prefetchers stop them in the background
+    while (m_connections.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+std::string http_server::image_url(const dcl_model &model) const
+{
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u%s%04X-%04X.bin", m_port, k_image_path, model.vendor_id,
+             model.product_id);
+    return url;
+}
+
+void http_server::accept_loop()
+{
+    while (!m_stopped.load()) {
+        int fd = accept(m_listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        m_connections++;
+        std::thread([this, fd] {
+            serve(fd);
+            close(fd);
+            m_connections--;
+        }).detach();
+    }
+}
+
+const dcl_model *http_server::find_model(uint16_t vendor_id, uint16_t product_id) const
+{
+    for (const dcl_model &model : m_models) {
+        if (model.vendor_id == vendor_id && model.product_id == product_id) {
+            return &model;
+        }
+    }
+    return nullptr;
+}
+
+bool http_server::route(const std::string &path, size_t range_start, int &status, std::string &body)
+{
+    unsigned vendor_id = 0, product_id = 0, software_version = 0;
+    if (path.compare(0, strlen(k_dcl_path), k_dcl_path) == 0) {
+        m_dcl_requests++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_dcl_latency_ms));
+        int count = sscanf(path.c_str() + strlen(k_dcl_path), "%u/%u/%u", &vendor_id, &product_id, &software_version);
+        const dcl_model *model = count >= 2 ? find_model(vendor_id, product_id) : nullptr;
+        char json[512];
+        status = 200;
+        if (model && count == 2) {
+            snprintf(json, sizeof(json),
+                     "{\"modelVersions\":{\"vid\":%u,\"pid\":%u,\"softwareVersions\":[%u,%u]}}", vendor_id,
+                     product_id, model->min_applicable_software_version, model->software_version);
+        } else if (model && count == 3 && software_version == model->software_version) {
+            snprintf(json, sizeof(json),
+                     "{\"modelVersion\":{\"vid\":%u,\"pid\":%u,\"softwareVersion\":%u,"
+                     "\"softwareVersionString\":\"%u.0\",\"cdVersionNumber\":1,\"softwareVersionValid\":true,"
+                     "\"otaUrl\":\"%s\",\"otaFileSize\":\"%u\",\"otaChecksum\":\"%s\",\"otaChecksumType\":1,"
+                     "\"minApplicableSoftwareVersion\":%u,\"maxApplicableSoftwareVersion\":%u}}",
+                     vendor_id, product_id, software_version, software_version, image_url(*model).c_str(),
+                     static_cast<unsigned>(m_image->size()), model->ota_checksum.c_str(),
+                     model->min_applicable_software_version, model->max_applicable_software_version);
+        } else {
+            status = 404;
+            snprintf(json, sizeof(json), "{\"code\":5,\"message\":\"not found\"}");
+        }
+        body = json;
+        return false;
+    }
+    if (path.compare(0, strlen(k_image_path), k_image_path) == 0 &&
+        sscanf(path.c_str() + strlen(k_image_path), "%4X-%4X.bin", &vendor_id, &product_id) == 2 &&
+        find_model(vendor_id, product_id) && range_start <= m_image->size()) {
+        m_image_requests++;
+        status = range_start > 0 ? 206 : 200;
+        return true;
+    }
+    status = 404;
+    return false;
+}
+
+void http_server::serve(int fd)
+{
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len <= 0) {
+            return;
+        }
+        request.append(buf, static_cast<size_t>(len));
+    }
+    char path[256] = {0};
+    if (sscanf(request.c_str(), "GET %255s HTTP/1.1", path) != 1) {
+        return;
+    }
+    size_t range_start = 0;
+    const char *range = strstr(request.c_str(), "\r\nRange: bytes=");
+    if (range) {
+        range_start = strtoul(range + strlen("\r\nRange: bytes="), nullptr, 10);
+    }
+    int status = 0;
+    std::string body;
+    bool is_image = route(path, range_start, status, body);
+    size_t length = is_image ? m_image->size() - range_start : body.size();
+    char header[256];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 %d %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n", status,
+                              status == 404 ? "Not Found" : "OK", static_cast<unsigned>(length));
+    if (!send_all(fd, header, header_len)) {
+        return;
+    }
+    if (!is_image) {
+        send_all(fd, body.data(), body.size());
+        return;
+    }
+    // The sends block while the prefetch buffer of the provider is full
+    for (size_t offset = range_start; offset < m_image->size() && !m_stopped.load(); offset += k_send_chunk_size) {
+        size_t chunk = std::min(k_send_chunk_size, m_image->size() - offset);
+        if (!send_all(fd, reinterpret_cast<const char *>(m_image->data()) + offset, chunk)) {
+            return;
+        }
+        m_image_bytes += chunk;
+    }
+}
@@ -0,0 +1,77 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Loopback HTTP server standing in for the DCL REST API and for the host of the OTA images
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct dcl_model {
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint32_t software_version;
+    uint32_t min_applicable_software_version;
+    uint32_t max_applicable_software_version;
+    // Base64 of the SHA-256 digest advertised by the DCL
+    std::string ota_checksum;
+};
+
+class http_server {
+public:
+    /**
+     * Serve the models under /dcl/model/versions and the same image for all the models under /images
+     *
+     * @param[in] models Models of the DCL.
+     * @param[in] image Content of the OTA images.
+     * @param[in] dcl_latency_ms Delay of the DCL responses.
+     *
+     * @return port of the server, 0 on failure.
+     */
+    uint16_t start(const std::vector<dcl_model> &models, const std::vector<uint8_t> &image, uint32_t dcl_latency_ms);
+
+    void stop();
+
+    /** URL of the OTA image of a model */
+    std::string image_url(const dcl_model &model) const;
+
+    uint32_t dcl_requests() const { return m_dcl_requests.load(); }
+    uint32_t image_requests() const { return m_image_requests.load(); }
+    uint64_t image_bytes() const { return m_image_bytes.load(); }
+
+private:
+    void accept_loop();
+    void serve(int fd);
+    bool route(const std::string &path, size_t range_start, int &status, std::string &body);
+
+    const dcl_model *find_model(uint16_t vendor_id, uint16_t product_id) const;
+
+    std::vector<dcl_model> m_models;
+    const std::vector<uint8_t> *m_image = nullptr;
+    uint32_t m_dcl_latency_ms = 0;
+    uint16_t m_port = 0;
+    int m_listen_fd = -1;
+    std::thread m_accept_thread;
+    std::atomic<int> m_connections{0};
+    std::atomic<bool> m_stopped{false};
+    std::atomic<uint32_t> m_dcl_requests{0};
+    std::atomic<uint32_t> m_image_requests{0};
+    std::atomic<uint64_t> m_image_bytes{0};
+};
@@ -0,0 +1,512 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Load test of the OTA provider with simulated requestors. The DCL queries and the candidates cache, the rollout
+// scheduler, the admission of the BDX sessions of the sender pool, the bandwidth pacers and the HTTP prefetchers are
+// the ones of the component, the DCL and the image host are a loopback HTTP server. The CHIP exchanges are modeled:
+// the QueryImage commands take a pending query slot and a BDX session as EspOtaProvider does, and the requestors query
+// the blocks as BDX receivers polled by the provider.
+//
+//   ota_provider_load [--requestors N] [--models N] [--up-to-date N] [--image-size BYTES] [--block-size BYTES]
+//                     [--sessions N] [--networks N] [--network-transfers N] [--network-bandwidth BYTES_PER_S]
+//                     [--stage-percent P] [--rtt-ms MS] [--poll-ms MS] [--dcl-latency-ms MS] [--busy-delay-ms MS]
+//                     [--timeout-s S]
+
+#include "http_server.h"
+
+#include <esp_http_client.h>
+#include <esp_matter_mem.h>
+#include <esp_matter_ota_bdx_admission.h>
+#include <esp_matter_ota_candidates.h>
+#include <esp_matter_ota_http_downloader.h>
+#include <esp_matter_ota_rollout.h>
+#include <esp_timer.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace esp_matter::ota_provider;
+using OTAQueryStatus = EspOtaProvider::OTAQueryStatus;
+
+namespace {
+
+struct load_config {
+    uint32_t requestors = 64;
+    uint32_t models = 4;
+    // Requestors which already run the latest version, they get the negative answers of the cache
+    uint32_t up_to_date = 8;
+    uint32_t image_size = 512 * 1024;
+    uint32_t block_size = 1024;
+    uint32_t sessions = CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS;
+    uint32_t networks = 2;
+    uint32_t network_transfers = 0;
+    uint32_t network_bandwidth = 0;
+    uint32_t stage_percent = 100;
+    uint32_t rtt_ms = 4;
+    uint32_t poll_ms = 50;
+    uint32_t dcl_latency_ms = 20;
+    uint32_t busy_delay_ms = 200;
+    uint32_t timeout_s = 300;
+};
+
+struct requestor {
+    uint32_t index;
+    chip::ScopedNodeId node_id;
+    uint8_t network_id;
+    const dcl_model *model;
+    uint32_t software_version;
+
+    // QueryImage response, set under the provider lock
+    bool responded;
+    OTAQueryStatus status;
+    char image_url[OTA_URL_MAX_LEN];
+    size_t image_size;
+    int64_t query_start_us;
+
+    // BDX session, the sender of the pool
+    int session;
+    bool in_rollout;
+    uint32_t queries;
+    uint32_t session_rejections;
+    bool done;
+    bool updated;
+    bool failed;
+};
+
+// State of EspOtaProvider which gates the QueryImage commands and the BDX sessions, protected by the lock standing
+// for the CHIP stack lock
+struct provider_model {
+    std::mutex lock;
+    std::condition_variable responded;
+    size_t pending_queries = 0;
+    size_t peak_sessions = 0;
+    size_t peak_waiting_requestors = 0;
+    OtaBdxSessionAdmission sessions;
+    OtaRolloutScheduler rollout;
+
+    uint32_t queries = 0;
+    uint32_t concurrent_query_rejections = 0;
+    uint32_t session_rejections = 0;
+    uint32_t throttled = 0;
+    uint32_t not_in_stage = 0;
+    std::vector<uint32_t> latencies_us;
+
+    uint64_t bytes_sent = 0;
+    uint32_t blocks_sent = 0;
+    uint32_t paced_blocks = 0;
+    uint32_t block_deferrals = 0;
+    uint32_t transfers_completed = 0;
+    uint32_t transfers_failed = 0;
+    uint32_t data_mismatches = 0;
+    int64_t first_transfer_start_us = INT64_MAX;
+    int64_t last_transfer_end_us = 0;
+    std::vector<uint32_t> transfer_throughputs;
+};
+
+load_config s_config;
+provider_model s_provider;
+std::vector<uint8_t> s_image;
+
+void sleep_ms(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// EspOtaProvider::SendQueryImageResponse(), called with the provider lock
+void send_query_image_response(requestor &req, OTAQueryStatus status)
+{
+    s_provider.pending_queries--;
+    s_provider.latencies_us.push_back(static_cast<uint32_t>(esp_timer_get_time() - req.query_start_us));
+    if (status == OTAQueryStatus::kUpdateAvailable) {
+        OtaRolloutScheduler::Admission admission = s_provider.rollout.CheckAdmission(
+            req.node_id, req.network_id, req.model->vendor_id, req.model->product_id, req.model->software_version,
+            s_provider.sessions.GetNetworkSessionCount(req.network_id));
+        if (admission == OtaRolloutScheduler::kNotInStage) {
+            s_provider.not_in_stage++;
+            status = OTAQueryStatus::kNotAvailable;
+        } else if (admission != OtaRolloutScheduler::kAdmitted) {
+            s_provider.throttled++;
+            status = OTAQueryStatus::kBusy;
+        } else if ((req.session = s_provider.sessions.AcquireSession(req.node_id, req.network_id)) ==
+                   OtaBdxSessionAdmission::kNoSession) {
+            // OtaBdxSenderPool::AllocateSender() found no sender for the requestor
+            s_provider.session_rejections++;
+            req.session_rejections++;
+            s_provider.peak_waiting_requestors =
+                std::max(s_provider.peak_waiting_requestors, s_provider.sessions.GetWaitingRequestorCount());
+            status = OTAQueryStatus::kBusy;
+        } else {
+            s_provider.peak_sessions = std::max(s_provider.peak_sessions, s_provider.sessions.GetActiveSessionCount());
+            req.in_rollout = s_provider.rollout.IsInRollout(req.model->vendor_id, req.model->product_id,
+                                                            req.model->software_version);
+            if (req.in_rollout) {
+                s_provider.rollout.OnTransferEvent(OtaBdxSender::kTransferStarted);
+            }
+        }
+    }
+    req.status = status;
+    req.responded = true;
+    s_provider.responded.notify_all();
+}
+
+// EspOtaProvider::FetchImageDoneCallback(), called by the task of the candidates cache
+void fetch_image_done(OTAQueryStatus status, const char *image_url, size_t image_size, const uint8_t *image_digest,
+                      uint32_t software_version, const char *software_version_str, void *arg)
+{
+    requestor &req = *static_cast<requestor *>(arg);
+    std::lock_guard<std::mutex> lock(s_provider.lock);
+    if (status == OTAQueryStatus::kUpdateAvailable) {
+        strncpy(req.image_url, image_url, sizeof(req.image_url) - 1);
+        req.image_size = image_size;
+        if (software_version != req.model->software_version || image_size != s_image.size() || !image_digest) {
+            printf("requestor %" PRIu32 ": unexpected candidate %" PRIu32 " of %u bytes\n", req.index,
+                   software_version, static_cast<unsigned>(image_size));
+            req.failed = true;
+        }
+    }
+    send_query_image_response(req, status);
+}
+
+// EspOtaProvider::HandleQueryImage()
+OTAQueryStatus query_image(requestor &req)
+{
+    std::unique_lock<std::mutex> lock(s_provider.lock);
+    req.queries++;
+    s_provider.queries++;
+    if (s_provider.pending_queries >= CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS) {
+        s_provider.concurrent_query_rejections++;
+        return OTAQueryStatus::kBusy;
+    }
+    s_provider.pending_queries++;
+    req.responded = false;
+    req.query_start_us = esp_timer_get_time();
+    if (fetch_ota_candidate(req.model->vendor_id, req.model->product_id, req.software_version, fetch_image_done,
+                            &req) != ESP_OK) {
+        send_query_image_response(req, OTAQueryStatus::kNotAvailable);
+    }
+    s_provider.responded.wait(lock, [&req] { return req.responded; });
+    return req.status;
+}
+
+// OtaBdxSender::SendBlockIfReady() for the BlockQuery of a requestor, polled as the BDX server does
+esp_err_t send_block(requestor &req, http_prefetcher_handle_t prefetcher, uint8_t *block, size_t offset,
+                     size_t *block_len, bool *eof)
+{
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(s_provider.lock);
+            OtaBandwidthPacer *pacer = s_provider.rollout.GetNetworkPacer(req.network_id);
+            esp_err_t err = ESP_OK;
+            if (pacer && !pacer->IsReady(s_config.block_size)) {
+                s_provider.paced_blocks++;
+                err = ESP_ERR_NOT_FINISHED;
+            } else if ((err = http_prefetcher_is_ready(prefetcher, s_config.block_size)) == ESP_ERR_NOT_FINISHED) {
+                s_provider.block_deferrals++;
+            }
+            if (err != ESP_ERR_NOT_FINISHED) {
+                size_t read_len = 0;
+                if (err == ESP_OK) {
+                    err = http_prefetcher_read(prefetcher, block, s_config.block_size, &read_len);
+                }
+                if (err != ESP_OK) {
+                    return err;
+                }
+                *block_len = std::min(read_len, req.image_size - offset);
+                *eof = *block_len < s_config.block_size || offset + *block_len == req.image_size;
+                if (pacer) {
+                    pacer->Consume(*block_len);
+                }
+                s_provider.blocks_sent++;
+                s_provider.bytes_sent += *block_len;
+                return ESP_OK;
+            }
+        }
+        sleep_ms(s_config.poll_ms);
+    }
+}
+
+// BDX transfer of the image to a requestor which drives the transfer
+bool receive_image(requestor &req)
+{
+    esp_http_client_config_t config = {
+        .url = req.image_url,
+        .event_handler = NULL,
+        .transport_type = HTTP_TRANSPORT_OVER_SSL,
+        .skip_cert_common_name_check = false,
+        .keep_alive_enable = true,
+    };
+    http_prefetcher_handle_t prefetcher = nullptr;
+    std::vector<uint8_t> block(s_config.block_size);
+    int64_t start_us = esp_timer_get_time();
+    size_t offset = 0;
+    bool eof = false;
+    bool ok = http_prefetcher_start(&config, 0, CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE, &prefetcher) ==
+        ESP_OK;
+    while (ok && !eof) {
+        // The BlockQuery and the Block messages each take half of the round trip
+        sleep_ms(s_config.rtt_ms / 2);
+        size_t block_len = 0;
+        ok = send_block(req, prefetcher, block.data(), offset, &block_len, &eof) == ESP_OK;
+        sleep_ms(s_config.rtt_ms - s_config.rtt_ms / 2);
+        if (ok && memcmp(block.data(), s_image.data() + offset, block_len) != 0) {
+            std::lock_guard<std::mutex> lock(s_provider.lock);
+            s_provider.data_mismatches++;
+            ok = false;
+        }
+        offset += block_len;
+    }
+    ok = ok && offset == s_image.size();
+    http_prefetcher_stop(prefetcher);
+
+    int64_t end_us = esp_timer_get_time();
+    std::lock_guard<std::mutex> lock(s_provider.lock);
+    // The sender resets itself at the end of the transfer, which releases its session
+    s_provider.sessions.ReleaseSession(req.session);
+    if (req.in_rollout) {
+        s_provider.rollout.OnTransferEvent(ok ? OtaBdxSender::kTransferCompleted : OtaBdxSender::kTransferFailed);
+    }
+    if (ok) {
+        s_provider.transfers_completed++;
+        s_provider.first_transfer_start_us = std::min(s_provider.first_transfer_start_us, start_us);
+        s_provider.last_transfer_end_us = std::max(s_provider.last_transfer_end_us, end_us);
+        s_provider.transfer_throughputs.push_back(
+            static_cast<uint32_t>(offset * 1000000 / std::max<int64_t>(end_us - start_us, 1)));
+    } else {
+        s_provider.transfers_failed++;
+    }
+    return ok;
+}
+
+void run_requestor(requestor &req)
+{
+    int64_t deadline_us = esp_timer_get_time() + static_cast<int64_t>(s_config.timeout_s) * 1000000;
+    while (!req.done && esp_timer_get_time() < deadline_us) {
+        switch (query_image(req)) {
+        case OTAQueryStatus::kUpdateAvailable:
+            req.updated = receive_image(req);
+            req.failed = req.failed || !req.updated;
+            req.done = true;
+            break;
+        case OTAQueryStatus::kBusy:
+            sleep_ms(s_config.busy_delay_ms);
+            break;
+        default:
+            req.done = true;
+            break;
+        }
+    }
+}
+
+uint32_t percentile(std::vector<uint32_t> values, uint32_t percent)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, values.size() * percent / 100)];
+}
+
+void print_distribution(const char *name, const std::vector<uint32_t> &values, double scale, const char *unit)
+{
+    uint64_t sum = 0;
+    for (uint32_t value : values) {
+        sum += value;
+    }
+    printf("%-22s min %.1f, avg %.1f, p50 %.1f, p95 %.1f, max %.1f %s\n", name, percentile(values, 0) * scale,
+           values.empty() ? 0 : sum * scale / values.size(), percentile(values, 50) * scale,
+           percentile(values, 95) * scale, percentile(values, 100) * scale, unit);
+}
+
+bool parse_args(int argc, char **argv)
+{
+    struct option {
+        const char *name;
+        uint32_t *value;
+    } options[] = {
+        {"--requestors", &s_config.requestors},
+        {"--models", &s_config.models},
+        {"--up-to-date", &s_config.up_to_date},
+        {"--image-size", &s_config.image_size},
+        {"--block-size", &s_config.block_size},
+        {"--sessions", &s_config.sessions},
+        {"--networks", &s_config.networks},
+        {"--network-transfers", &s_config.network_transfers},
+        {"--network-bandwidth", &s_config.network_bandwidth},
+        {"--stage-percent", &s_config.stage_percent},
+        {"--rtt-ms", &s_config.rtt_ms},
+        {"--poll-ms", &s_config.poll_ms},
+        {"--dcl-latency-ms", &s_config.dcl_latency_ms},
+        {"--busy-delay-ms", &s_config.busy_delay_ms},
+        {"--timeout-s", &s_config.timeout_s},
+    };
+    for (int i = 1; i < argc; i += 2) {
+        option *found = nullptr;
+        for (option &opt : options) {
+            if (strcmp(argv[i], opt.name) == 0) {
+                found = &opt;
+            }
+        }
+        if (!found || i + 1 >= argc) {
+            printf("Unknown or incomplete option %s\n", argv[i]);
+            return false;
+        }
+        *found->value = strtoul(argv[i + 1], NULL, 10);
+    }
+    // The BDX sender never reads more than half of the prefetch buffer
+    s_config.block_size =
+        std::min<uint32_t>(s_config.block_size, CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE / 2);
+    s_config.models = std::max<uint32_t>(s_config.models, 1);
+    if (s_provider.sessions.SetMaxSessions(static_cast<uint8_t>(s_config.sessions)) != ESP_OK) {
+        return false;
+    }
+    s_config.networks = std::min<uint32_t>(std::max<uint32_t>(s_config.networks, 1), OtaRolloutScheduler::kMaxNetworks);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv)) {
+        return 2;
+    }
+    s_image.resize(s_config.image_size);
+    uint32_t seed = 0x12345678;
+    for (uint8_t &byte : s_image) {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(seed >> 16);
+    }
+    std::vector<dcl_model> models;
+    for (uint32_t i = 0; i < s_config.models; ++i) {
+        // The digest is only checked by the image cache, which is not part of this test
+        models.push_back({0xFFF1, static_cast<uint16_t>(0x8000 + i), 2, 1, 1,
+                          "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8="});
+    }
+
+    http_server server;
+    uint16_t port = server.start(models, s_image, s_config.dcl_latency_ms);
+    if (port == 0) {
+        printf("Failed to start the HTTP server\n");
+        return 1;
+    }
+    // The DCL URL of the candidates has no port, it is served by the loopback server as well
+    esp_http_client_host_set_default_port(port);
+    if (init_ota_candidates() != ESP_OK) {
+        printf("Failed to initialize the OTA candidates\n");
+        return 1;
+    }
+
+    OtaRolloutScheduler::RolloutConfig rollout = {};
+    rollout.mVendorId = models[0].vendor_id;
+    rollout.mProductId = models[0].product_id;
+    rollout.mStagePercents[0] = static_cast<uint8_t>(std::min<uint32_t>(s_config.stage_percent, 100));
+    rollout.mStageCount = 1;
+    s_provider.rollout.StartRollout(rollout);
+    for (uint32_t network = 0; network < s_config.networks; ++network) {
+        s_provider.rollout.SetNetworkTransferLimit(network, static_cast<uint8_t>(s_config.network_transfers));
+        s_provider.rollout.SetNetworkBandwidth(network, s_config.network_bandwidth);
+    }
+
+    std::vector<requestor> requestors(s_config.requestors);
+    for (uint32_t i = 0; i < s_config.requestors; ++i) {
+        requestor &req = requestors[i];
+        req.index = i;
+        req.node_id = chip::ScopedNodeId(0x1000 + i, 1);
+        req.network_id = static_cast<uint8_t>(i % s_config.networks);
+        req.model = &models[i % s_config.models];
+        req.software_version = i < s_config.up_to_date ? req.model->software_version : 1;
+    }
+
+    printf("%" PRIu32 " requestors (%" PRIu32 " up to date) of %" PRIu32 " models, %" PRIu32
+           " bytes image, %" PRIu32 " BDX sessions, %" PRIu32 " bytes blocks, %" PRIu32 " networks\n",
+           s_config.requestors, s_config.up_to_date, s_config.models, s_config.image_size, s_config.sessions,
+           s_config.block_size, s_config.networks);
+    int64_t start_us = esp_timer_get_time();
+    std::vector<std::thread> threads;
+    for (requestor &req : requestors) {
+        threads.emplace_back(run_requestor, std::ref(req));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    int64_t duration_us = esp_timer_get_time() - start_us;
+    server.stop();
+    // The stopped prefetchers release their memory once their tasks notice it
+    sleep_ms(300);
+
+    uint32_t updated = 0, not_updated = 0, failed = 0, unfinished = 0, max_session_rejections = 0;
+    for (const requestor &req : requestors) {
+        max_session_rejections = std::max(max_session_rejections, req.session_rejections);
+        updated += req.updated;
+        failed += req.failed;
+        unfinished += !req.done;
+        not_updated += req.done && !req.updated && !req.failed;
+    }
+    EspOtaProvider::OtaCandidatesCacheStats cache_stats;
+    get_ota_candidates_cache_stats(cache_stats);
+    OtaRolloutScheduler::RolloutProgress progress;
+    s_provider.rollout.GetProgress(progress);
+
+    printf("Duration               %.2f s\n", duration_us / 1e6);
+    printf("Requestors             %" PRIu32 " updated, %" PRIu32 " without update, %" PRIu32 " failed, %" PRIu32
+           " unfinished\n", updated, not_updated, failed, unfinished);
+    printf("QueryImage             %" PRIu32 " commands, %" PRIu32 " busy rejections (%" PRIu32
+           " pending queries, %" PRIu32 " BDX sessions, %" PRIu32 " network limits), %" PRIu32 " not in stage\n",
+           s_provider.queries, s_provider.concurrent_query_rejections + s_provider.session_rejections +
+           s_provider.throttled, s_provider.concurrent_query_rejections, s_provider.session_rejections,
+           s_provider.throttled, s_provider.not_in_stage);
+    print_distribution("QueryImage latency", s_provider.latencies_us, 1e-3, "ms");
+    printf("BDX sessions           %u peak, %u peak waiting requestors, %" PRIu32
+           " busy responses at most for a requestor, %u sessions in use at the end\n",
+           static_cast<unsigned>(s_provider.peak_sessions), static_cast<unsigned>(s_provider.peak_waiting_requestors),
+           max_session_rejections, static_cast<unsigned>(s_provider.sessions.GetActiveSessionCount()));
+    printf("Candidates cache       %" PRIu32 " hits, %" PRIu32 " negative hits, %" PRIu32 " misses, %" PRIu32
+           " DCL requests (%" PRIu32 " served)\n", cache_stats.mHits, cache_stats.mNegativeHits, cache_stats.mMisses,
+           cache_stats.mDclRequests, server.dcl_requests());
+    printf("BDX                    %" PRIu32 " transfers completed, %" PRIu32 " failed, %" PRIu32
+           " data mismatches, %" PRIu32 " blocks, %" PRIu32 " paced, %" PRIu32 " deferred\n",
+           s_provider.transfers_completed, s_provider.transfers_failed, s_provider.data_mismatches,
+           s_provider.blocks_sent, s_provider.paced_blocks, s_provider.block_deferrals);
+    int64_t transfer_time_us = s_provider.last_transfer_end_us - s_provider.first_transfer_start_us;
+    printf("BDX throughput         %.1f KB/s aggregate, %" PRIu64 " bytes sent, %" PRIu64 " bytes downloaded in %"
+           PRIu32 " requests\n", transfer_time_us > 0 ? s_provider.bytes_sent * 1e6 / 1024 / transfer_time_us : 0.0,
+           s_provider.bytes_sent, server.image_bytes(), server.image_requests());
+    print_distribution("Transfer throughput", s_provider.transfer_throughputs, 1.0 / 1024, "KB/s");
+    printf("Rollout of the model 0 %" PRIu32 " admitted, %" PRIu32 " throttled, %" PRIu32 " started, %" PRIu32
+           " completed, %" PRIu32 " failed\n", progress.mQueriesAdmitted, progress.mQueriesThrottled,
+           progress.mTransfersStarted, progress.mTransfersCompleted, progress.mTransfersFailed);
+    esp_matter_mem_stats_t mem_stats;
+    esp_matter_mem_get_stats(ESP_MATTER_MEM_TAG_OTA_PROVIDER, &mem_stats);
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // The stream buffers of the prefetchers are allocated by FreeRTOS, out of the accounting of esp_matter_mem
+    printf("Memory                 ota-provider peak %u bytes + %u bytes of prefetch buffers, %u bytes in %" PRIu32
+           " allocations at the end, process max RSS %ld KB\n", static_cast<unsigned>(mem_stats.peak),
+           static_cast<unsigned>(s_provider.peak_sessions * CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE),
+           static_cast<unsigned>(mem_stats.current), mem_stats.count, usage.ru_maxrss);
+
+    // Every session is released at the end of its transfer
+    bool sessions_released = s_provider.sessions.GetActiveSessionCount() == 0;
+    return failed == 0 && unfinished == 0 && s_provider.data_mismatches == 0 && sessions_released ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Subset of the BDX sender header for the host load test, the BDX transfers need the CHIP exchange layer
+
+#pragma once
+
+#include <esp_matter_ota_bandwidth_pacer.h>
+
+#define OTA_URL_MAX_LEN 256
+#define OTA_IMAGE_DIGEST_LEN 32
+
+namespace esp_matter {
+namespace ota_provider {
+
+class OtaBdxSender {
+public:
+    enum TransferEvent {
+        kTransferStarted = 0,
+        kTransferCompleted,
+        kTransferFailed,
+    };
+};
+
+} // namespace ota_provider
+} // namespace esp_matter
@@ -0,0 +1,50 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Subset of the OTA provider header for the host load test, the provider cluster server needs the CHIP stack
+
+#pragma once
+
+#include <esp_matter_ota_bdx_sender.h>
+#include <stdint.h>
+
+#define SOFTWARE_VERSION_STR_MAX_LEN 64
+
+namespace esp_matter {
+namespace ota_provider {
+
+class EspOtaProvider {
+public:
+    enum class OTAQueryStatus : uint8_t {
+        kUpdateAvailable = 0x00,
+        kBusy = 0x01,
+        kNotAvailable = 0x02,
+        kDownloadProtocolNotSupported = 0x03,
+    };
+
+    struct OtaCandidatesCacheStats {
+        // QueryImage commands answered from the cache with an available update
+        uint32_t mHits;
+        // QueryImage commands answered from the cache with no available update
+        uint32_t mNegativeHits;
+        // QueryImage commands which needed DCL requests
+        uint32_t mMisses;
+        uint32_t mDclRequests;
+        uint32_t mEvictions;
+        uint32_t mRefreshes;
+    };
+};
+
+} // namespace ota_provider
+} // namespace esp_matter
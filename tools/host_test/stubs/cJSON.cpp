@@ -0,0 +1,306 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cJSON.h>
+#include <lib/support/CHIPMem.h>
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+using chip::Platform::MemoryCalloc;
+using chip::Platform::MemoryFree;
+
+namespace {
+
+// Same nesting limit as CJSON_NESTING_LIMIT
+constexpr int k_nesting_limit = 1000;
+
+struct parser {
+    const char *pos;
+    int depth;
+};
+
+void skip_whitespace(parser &p)
+{
+    while (*p.pos && (unsigned char)*p.pos <= 32) {
+        p.pos++;
+    }
+}
+
+cJSON *new_item(int type)
+{
+    cJSON *item = static_cast<cJSON *>(MemoryCalloc(1, sizeof(cJSON)));
+    if (item) {
+        item->type = type;
+    }
+    return item;
+}
+
+bool parse_hex4(const char *str, uint32_t &out)
+{
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        char ch = str[i];
+        out <<= 4;
+        if (ch >= '0' && ch <= '9') {
+            out |= ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            out |= ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            out |= ch - 'A' + 10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t encode_utf8(uint32_t code_point, char *out)
+{
+    if (code_point < 0x80) {
+        out[0] = static_cast<char>(code_point);
+        return 1;
+    } else if (code_point < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+        out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 2;
+    } else if (code_point < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+        out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+    out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+char *parse_string(parser &p)
+{
+    if (*p.pos != '"') {
+        return nullptr;
+    }
+    const char *end = p.pos + 1;
+    while (*end && *end != '"') {
+        if (*end == '\\' && end[1]) {
+            end++;
+        }
+        end++;
+    }
+    if (*end != '"') {
+        return nullptr;
+    }
+    // The unescaped string is never longer than the escaped one
+    char *out = static_cast<char *>(MemoryCalloc(1, end - p.pos));
+    if (!out) {
+        return nullptr;
+    }
+    char *dst = out;
+    for (const char *src = p.pos + 1; src < end; ++src) {
+        if (*src != '\\') {
+            *dst++ = *src;
+            continue;
+        }
+        src++;
+        switch (*src) {
+        case 'b': *dst++ = '\b'; break;
+        case 'f': *dst++ = '\f'; break;
+        case 'n': *dst++ = '\n'; break;
+        case 'r': *dst++ = '\r'; break;
+        case 't': *dst++ = '\t'; break;
+        case '"':
+        case '\\':
+        case '/': *dst++ = *src; break;
+        case 'u': {
+            uint32_t code_point;
+            if (end - src < 5 || !parse_hex4(src + 1, code_point)) {
+                MemoryFree(out);
+                return nullptr;
+            }
+            src += 4;
+            if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                uint32_t low;
+                if (end - src < 7 || src[1] != '\\' || src[2] != 'u' || !parse_hex4(src + 3, low) || low < 0xDC00 ||
+                    low > 0xDFFF) {
+                    MemoryFree(out);
+                    return nullptr;
+                }
+                src += 6;
+                code_point = 0x10000 + (((code_point & 0x3FF) << 10) | (low & 0x3FF));
+            }
+            dst += encode_utf8(code_point, dst);
+            break;
+        }
+        default:
+            MemoryFree(out);
+            return nullptr;
+        }
+    }
+    p.pos = end + 1;
+    return out;
+}
+
+cJSON *parse_value(parser &p);
+
+cJSON *parse_container(parser &p, int type, char close)
+{
+    cJSON *item = new_item(type);
+    if (!item || ++p.depth > k_nesting_limit) {
+        cJSON_Delete(item);
+        return nullptr;
+    }
+    p.pos++;
+    skip_whitespace(p);
+    if (*p.pos == close) {
+        p.pos++;
+        p.depth--;
+        return item;
+    }
+    cJSON *tail = nullptr;
+    while (true) {
+        char *name = nullptr;
+        if (type == cJSON_Object) {
+            skip_whitespace(p);
+            name = parse_string(p);
+            skip_whitespace(p);
+            if (!name || *p.pos != ':') {
+                MemoryFree(name);
+                cJSON_Delete(item);
+                return nullptr;
+            }
+            p.pos++;
+        }
+        cJSON *child = parse_value(p);
+        if (!child) {
+            MemoryFree(name);
+            cJSON_Delete(item);
+            return nullptr;
+        }
+        child->string = name;
+        if (tail) {
+            tail->next = child;
+            child->prev = tail;
+        } else {
+            item->child = child;
+        }
+        tail = child;
+        skip_whitespace(p);
+        if (*p.pos == ',') {
+            p.pos++;
+        } else if (*p.pos == close) {
+            p.pos++;
+            break;
+        } else {
+            cJSON_Delete(item);
+            return nullptr;
+        }
+    }
+    // As in cJSON, the prev of the first child points to the last child
+    item->child->prev = tail;
+    p.depth--;
+    return item;
+}
+
+cJSON *parse_value(parser &p)
+{
+    skip_whitespace(p);
+    if (strncmp(p.pos, "null", 4) == 0) {
+        p.pos += 4;
+        return new_item(cJSON_NULL);
+    } else if (strncmp(p.pos, "false", 5) == 0) {
+        p.pos += 5;
+        return new_item(cJSON_False);
+    } else if (strncmp(p.pos, "true", 4) == 0) {
+        p.pos += 4;
+        cJSON *item = new_item(cJSON_True);
+        if (item) {
+            item->valueint = 1;
+        }
+        return item;
+    } else if (*p.pos == '"') {
+        char *str = parse_string(p);
+        cJSON *item = str ? new_item(cJSON_String) : nullptr;
+        if (!item) {
+            MemoryFree(str);
+            return nullptr;
+        }
+        item->valuestring = str;
+        return item;
+    } else if (*p.pos == '-' || (*p.pos >= '0' && *p.pos <= '9')) {
+        char *end = nullptr;
+        double number = strtod(p.pos, &end);
+        if (end == p.pos) {
+            return nullptr;
+        }
+        p.pos = end;
+        cJSON *item = new_item(cJSON_Number);
+        if (item) {
+            item->valuedouble = number;
+            // valueint is saturated as in cJSON
+            if (number >= INT_MAX) {
+                item->valueint = INT_MAX;
+            } else if (number <= (double)INT_MIN) {
+                item->valueint = INT_MIN;
+            } else {
+                item->valueint = static_cast<int>(number);
+            }
+        }
+        return item;
+    } else if (*p.pos == '[') {
+        return parse_container(p, cJSON_Array, ']');
+    } else if (*p.pos == '{') {
+        return parse_container(p, cJSON_Object, '}');
+    }
+    return nullptr;
+}
+
+} // namespace
+
+cJSON *cJSON_Parse(const char *value)
+{
+    if (!value) {
+        return nullptr;
+    }
+    parser p = {value, 0};
+    cJSON *item = parse_value(p);
+    if (item) {
+        skip_whitespace(p);
+        if (*p.pos != '\0') {
+            cJSON_Delete(item);
+            return nullptr;
+        }
+    }
+    return item;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    while (item) {
+        cJSON *next = item->next;
+        cJSON_Delete(item->child);
+        MemoryFree(item->valuestring);
+        MemoryFree(item->string);
+        MemoryFree(item);
+        item = next;
+    }
+}
+
+void cJSON_free(void *object)
+{
+    MemoryFree(object);
+}
@@ -0,0 +1,64 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lib/support/Base64.h>
+#include <lib/support/CHIPMem.h>
+
+namespace chip {
+namespace Platform {
+
+size_t gAllocationCount = 0;
+
+} // namespace Platform
+
+static int Base64CharToVal(char c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    } else if (c == '+') {
+        return 62;
+    } else if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+uint16_t Base64Decode(const char *in, uint16_t inLen, uint8_t *out)
+{
+    uint16_t outLen = 0;
+    while (inLen > 0 && in[inLen - 1] == '=') {
+        inLen--;
+    }
+    uint32_t acc = 0;
+    int bits = 0;
+    for (uint16_t i = 0; i < inLen; ++i) {
+        int val = Base64CharToVal(in[i]);
+        if (val < 0) {
+            return UINT16_MAX;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(val);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[outLen++] = static_cast<uint8_t>(acc >> bits);
+        }
+    }
+    return outLen;
+}
+
+} // namespace chip
@@ -0,0 +1,24 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stub of the ESP x509 certificate bundle, the host HTTP client does not use TLS
+
+#pragma once
+
+#include <esp_err.h>
+
+static inline esp_err_t esp_crt_bundle_attach(void *conf)
+{
+    return ESP_OK;
+}
@@ -0,0 +1,255 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host implementation of the ESP HTTP client stub over the loopback interface
+
+#include <esp_http_client.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+static std::atomic<uint16_t> s_default_port{80};
+
+struct esp_http_client {
+    uint16_t port;
+    std::string path;
+    esp_http_client_method_t method;
+    std::vector<std::pair<std::string, std::string>> headers;
+    int socket_fd;
+    int status_code;
+    int64_t content_length;
+    int64_t received;
+    // Body bytes received with the headers
+    std::string pending;
+};
+
+void esp_http_client_host_set_default_port(uint16_t port)
+{
+    s_default_port.store(port);
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    if (!config || !config->url) {
+        return nullptr;
+    }
+    const char *host = strstr(config->url, "://");
+    host = host ? host + 3 : config->url;
+    const char *path = strchr(host, '/');
+    const char *port = strchr(host, ':');
+    esp_http_client *client = new esp_http_client;
+    client->port = port && (!path || port < path) ? static_cast<uint16_t>(atoi(port + 1)) : s_default_port.load();
+    client->path = path ? path : "/";
+    client->method = HTTP_METHOD_GET;
+    client->socket_fd = -1;
+    client->status_code = -1;
+    client->content_length = 0;
+    client->received = 0;
+    return client;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_http_client_close(client);
+    delete client;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    for (auto &header : client->headers) {
+        if (strcasecmp(header.first.c_str(), key) == 0) {
+            header.second = value;
+            return ESP_OK;
+        }
+    }
+    client->headers.emplace_back(key, value);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    client->method = method;
+    return ESP_OK;
+}
+
+static bool send_all(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len)
+{
+    static const char *k_methods[] = {"GET", "POST", "PUT", "PATCH", "DELETE", "HEAD"};
+    esp_http_client_close(client);
+    client->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (client->socket_fd < 0) {
+        return ESP_FAIL;
+    }
+    int one = 1;
+    setsockopt(client->socket_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(client->port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(client->socket_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        esp_http_client_close(client);
+        return ESP_FAIL;
+    }
+    std::string request = std::string(k_methods[client->method]) + " " + client->path + " HTTP/1.1\r\n";
+    request += "Host: 127.0.0.1\r\nConnection: close\r\n";
+    for (const auto &header : client->headers) {
+        request += header.first + ": " + header.second + "\r\n";
+    }
+    if (write_len > 0) {
+        request += "Content-Length: " + std::to_string(write_len) + "\r\n";
+    }
+    request += "\r\n";
+    if (!send_all(client->socket_fd, request.data(), request.size())) {
+        esp_http_client_close(client);
+        return ESP_FAIL;
+    }
+    client->status_code = -1;
+    client->content_length = 0;
+    client->received = 0;
+    client->pending.clear();
+    return ESP_OK;
+}
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len)
+{
+    return client->socket_fd >= 0 && send_all(client->socket_fd, buffer, len) ? len : -1;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client)
+{
+    if (client->socket_fd < 0) {
+        return -1;
+    }
+    std::string response;
+    size_t end;
+    char buf[512];
+    while ((end = response.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t len = recv(client->socket_fd, buf, sizeof(buf), 0);
+        if (len <= 0) {
+            return -1;
+        }
+        response.append(buf, static_cast<size_t>(len));
+    }
+    client->pending = response.substr(end + 4);
+    response.resize(end + 2);
+    if (sscanf(response.c_str(), "HTTP/1.%*d %d", &client->status_code) != 1) {
+        return -1;
+    }
+    for (size_t line = response.find("\r\n") + 2; line < response.size(); line = response.find("\r\n", line) + 2) {
+        if (strncasecmp(response.c_str() + line, "Content-Length:", 15) == 0) {
+            client->content_length = strtoll(response.c_str() + line + 15, nullptr, 10);
+        }
+    }
+    return client->content_length;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client->status_code;
+}
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client)
+{
+    return client->content_length;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
+{
+    // As the ESP-IDF client, fill the buffer unless the body ends
+    int read_len = 0;
+    while (read_len < len && client->received < client->content_length) {
+        size_t wanted =
+            static_cast<size_t>(std::min<int64_t>(len - read_len, client->content_length - client->received));
+        ssize_t chunk;
+        if (!client->pending.empty()) {
+            chunk = static_cast<ssize_t>(std::min(wanted, client->pending.size()));
+            memcpy(buffer + read_len, client->pending.data(), static_cast<size_t>(chunk));
+            client->pending.erase(0, static_cast<size_t>(chunk));
+        } else {
+            chunk = client->socket_fd >= 0 ? recv(client->socket_fd, buffer + read_len, wanted, 0) : -1;
+            if (chunk <= 0) {
+                if (chunk == 0) {
+                    errno = ECONNRESET;
+                }
+                return read_len > 0 ? read_len : (chunk == 0 ? 0 : -1);
+            }
+        }
+        read_len += static_cast<int>(chunk);
+        client->received += chunk;
+    }
+    return read_len;
+}
+
+int esp_http_client_read_response(esp_http_client_handle_t client, char *buffer, int len)
+{
+    return esp_http_client_read(client, buffer, len);
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client)
+{
+    return client->status_code >= 0 && client->received >= client->content_length;
+}
+
+int esp_http_client_get_post_field(esp_http_client_handle_t client, char **data)
+{
+    *data = nullptr;
+    return 0;
+}
+
+esp_err_t esp_http_client_set_redirection(esp_http_client_handle_t client)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void esp_http_client_add_auth(esp_http_client_handle_t client)
+{
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    if (client->socket_fd >= 0) {
+        close(client->socket_fd);
+        client->socket_fd = -1;
+    }
+    return ESP_OK;
+}
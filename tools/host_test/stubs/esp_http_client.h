@@ -0,0 +1,118 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stub of the ESP HTTP client. The requests are plain HTTP/1.1 requests to the loopback interface: the host of
+// the URL is ignored, the port of the URL is used when it is given and the port set with
+// esp_http_client_host_set_default_port() otherwise. The redirections and the authentication are not supported.
+
+#pragma once
+
+// The ESP-IDF header includes the lwIP sockets, which define errno
+#include <errno.h>
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+typedef struct esp_http_client_event esp_http_client_event_t;
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t *evt);
+
+typedef enum {
+    HTTP_TRANSPORT_UNKNOWN = 0x0,
+    HTTP_TRANSPORT_OVER_TCP,
+    HTTP_TRANSPORT_OVER_SSL,
+} esp_http_client_transport_t;
+
+typedef enum {
+    HTTP_METHOD_GET = 0,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_PUT,
+    HTTP_METHOD_PATCH,
+    HTTP_METHOD_DELETE,
+    HTTP_METHOD_HEAD,
+} esp_http_client_method_t;
+
+typedef enum {
+    HttpStatus_Ok = 200,
+    HttpStatus_PartialContent = 206,
+    HttpStatus_MultipleChoices = 300,
+    HttpStatus_MovedPermanently = 301,
+    HttpStatus_Found = 302,
+    HttpStatus_SeeOther = 303,
+    HttpStatus_TemporaryRedirect = 307,
+    HttpStatus_PermanentRedirect = 308,
+    HttpStatus_BadRequest = 400,
+    HttpStatus_Unauthorized = 401,
+    HttpStatus_Forbidden = 403,
+    HttpStatus_NotFound = 404,
+    HttpStatus_InternalError = 500,
+} HttpStatus_Code;
+
+/** Subset of the fields of the ESP-IDF config, in the same order for the designated initializers */
+typedef struct {
+    const char *url;
+    int timeout_ms;
+    http_event_handle_cb event_handler;
+    esp_http_client_transport_t transport_type;
+    int buffer_size;
+    void *user_data;
+    bool skip_cert_common_name_check;
+    esp_err_t (*crt_bundle_attach)(void *conf);
+    bool keep_alive_enable;
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method);
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len);
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len);
+
+/** Read the response headers, return the content length or -1 on failure */
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client);
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client);
+
+/** Read up to len bytes of the body, return 0 at the end of the body and -1 on failure */
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len);
+
+int esp_http_client_read_response(esp_http_client_handle_t client, char *buffer, int len);
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client);
+
+int esp_http_client_get_post_field(esp_http_client_handle_t client, char **data);
+
+esp_err_t esp_http_client_set_redirection(esp_http_client_handle_t client);
+
+void esp_http_client_add_auth(esp_http_client_handle_t client);
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+
+/** Host only: port of the URLs without a port */
+void esp_http_client_host_set_default_port(uint16_t port);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,38 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stub of the ESP-IDF logging, the logs are printed to stderr only when HOST_TEST_VERBOSE is defined
+
+#pragma once
+
+#include <esp_err.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#ifdef HOST_TEST_VERBOSE
+#define HOST_TEST_LOG(level, tag, format, ...) fprintf(stderr, level " (%s) " format "\n", tag, ##__VA_ARGS__)
+#else
+#define HOST_TEST_LOG(level, tag, format, ...)                                                                         \
+    do {                                                                                                               \
+        if (0) {                                                                                                       \
+            fprintf(stderr, level " (%s) " format "\n", tag, ##__VA_ARGS__);                                           \
+        }                                                                                                              \
+    } while (0)
+#endif
+
+#define ESP_LOGE(tag, format, ...) HOST_TEST_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_TEST_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_TEST_LOG("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_TEST_LOG("D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_TEST_LOG("V", tag, format, ##__VA_ARGS__)
@@ -0,0 +1,244 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host implementation of the FreeRTOS and ESP timer stubs
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using std::chrono::steady_clock;
+
+static const steady_clock::time_point s_start_time = steady_clock::now();
+
+int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - s_start_time).count();
+}
+
+struct host_task_start {
+    TaskFunction_t task;
+    void *arg;
+};
+
+static void *host_task_entry(void *arg)
+{
+    host_task_start start = *static_cast<host_task_start *>(arg);
+    delete static_cast<host_task_start *>(arg);
+    start.task(start.arg);
+    return nullptr;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_size, void *arg, UBaseType_t priority,
+                       TaskHandle_t *handle)
+{
+    pthread_t thread;
+    host_task_start *start = new host_task_start{task, arg};
+    if (pthread_create(&thread, nullptr, host_task_entry, start) != 0) {
+        delete start;
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (handle) {
+        *handle = reinterpret_cast<TaskHandle_t>(thread);
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (!task) {
+        pthread_exit(nullptr);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return static_cast<TickType_t>(esp_timer_get_time() / 1000);
+}
+
+// Wait for the predicate until the FreeRTOS timeout
+template <typename Predicate>
+static bool host_wait(std::condition_variable &cond, std::unique_lock<std::mutex> &lock, TickType_t ticks,
+                      Predicate predicate)
+{
+    if (ticks == portMAX_DELAY) {
+        cond.wait(lock, predicate);
+        return true;
+    }
+    return cond.wait_for(lock, std::chrono::milliseconds(ticks), predicate);
+}
+
+struct host_queue {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<uint8_t> items;
+    size_t item_size;
+    size_t length;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    host_queue *queue = new host_queue;
+    queue->items.resize(length * item_size);
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!host_wait(queue->cond, lock, ticks_to_wait, [queue] { return queue->count < queue->length; })) {
+        return pdFALSE;
+    }
+    memcpy(&queue->items[(queue->head + queue->count) % queue->length * queue->item_size], item, queue->item_size);
+    queue->count++;
+    queue->cond.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!host_wait(queue->cond, lock, ticks_to_wait, [queue] { return queue->count > 0; })) {
+        return pdFALSE;
+    }
+    memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->cond.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->count;
+}
+
+struct host_semaphore {
+    std::timed_mutex mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new host_semaphore;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    if (ticks_to_wait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticks_to_wait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+struct host_stream_buffer {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<uint8_t> data;
+    size_t trigger_level;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level)
+{
+    host_stream_buffer *stream = new host_stream_buffer;
+    stream->data.resize(size);
+    stream->trigger_level = trigger_level > 0 ? trigger_level : 1;
+    return stream;
+}
+
+void vStreamBufferDelete(StreamBufferHandle_t stream)
+{
+    delete stream;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    size_t size = stream->data.size();
+    host_wait(stream->cond, lock, ticks_to_wait, [stream, size] { return stream->count < size; });
+    size_t sent = std::min(len, size - stream->count);
+    for (size_t i = 0; i < sent; ++i) {
+        stream->data[(stream->head + stream->count + i) % size] = static_cast<const uint8_t *>(data)[i];
+    }
+    stream->count += sent;
+    stream->cond.notify_all();
+    return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    size_t size = stream->data.size();
+    host_wait(stream->cond, lock, ticks_to_wait, [stream] { return stream->count >= stream->trigger_level; });
+    size_t received = std::min(len, stream->count);
+    for (size_t i = 0; i < received; ++i) {
+        static_cast<uint8_t *>(data)[i] = stream->data[(stream->head + i) % size];
+    }
+    stream->head = (stream->head + received) % size;
+    stream->count -= received;
+    stream->cond.notify_all();
+    return received;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream)
+{
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    return stream->count;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t stream)
+{
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    return stream->data.size() - stream->count;
+}
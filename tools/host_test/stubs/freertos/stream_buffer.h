@@ -0,0 +1,43 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stub of the FreeRTOS stream buffers
+
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_stream_buffer *StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level);
+
+void vStreamBufferDelete(StreamBufferHandle_t stream);
+
+/** Copy as many bytes as fit, waiting up to ticks_to_wait for some room, and return the number of bytes copied */
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks_to_wait);
+
+/** Copy up to len bytes, waiting up to ticks_to_wait for the trigger level, and return the number of bytes copied */
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks_to_wait);
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream);
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t stream);
+
+#ifdef __cplusplus
+}
+#endif
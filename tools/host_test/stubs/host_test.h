@@ -0,0 +1,36 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Minimal assertions of the host tests
+
+#pragma once
+
+#include <stdio.h>
+
+#define TEST_ASSERT(cond)                                                                                              \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            printf("%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #cond);                                        \
+            return 1;                                                                                                  \
+        }                                                                                                              \
+    } while (0)
+
+#define RUN_TEST(test)                                                                                                 \
+    do {                                                                                                               \
+        if (test() != 0) {                                                                                             \
+            printf("FAIL %s\n", #test);                                                                                \
+            failures++;                                                                                                \
+        } else {                                                                                                       \
+            printf("PASS %s\n", #test);                                                                                \
+        }                                                                                                              \
+    } while (0)
@@ -0,0 +1,266 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host implementation of the ESP JSON parser stub
+
+#include <json_parser.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum json_type { JSON_OBJECT, JSON_ARRAY, JSON_STRING, JSON_PRIMITIVE };
+
+struct json_node {
+    json_type type;
+    // Raw text of the strings and of the primitives
+    std::string text;
+    std::vector<std::pair<std::string, json_node>> members;
+};
+
+struct json_reader {
+    const char *cur;
+    const char *end;
+
+    void skip_spaces()
+    {
+        while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r' || *cur == '\n')) {
+            cur++;
+        }
+    }
+
+    bool read_string(std::string &out)
+    {
+        const char *start = ++cur;
+        while (cur < end && *cur != '"') {
+            cur += *cur == '\\' ? 2 : 1;
+        }
+        if (cur >= end) {
+            return false;
+        }
+        out.assign(start, cur++);
+        return true;
+    }
+
+    bool read_value(json_node &node, int depth)
+    {
+        skip_spaces();
+        if (cur >= end || depth > JSON_PARSER_MAX_DEPTH) {
+            return false;
+        }
+        if (*cur == '"') {
+            node.type = JSON_STRING;
+            return read_string(node.text);
+        }
+        if (*cur != '{' && *cur != '[') {
+            node.type = JSON_PRIMITIVE;
+            const char *start = cur;
+            while (cur < end && !strchr(",]} \t\r\n", *cur)) {
+                cur++;
+            }
+            node.text.assign(start, cur);
+            return !node.text.empty();
+        }
+        bool is_object = *cur++ == '{';
+        node.type = is_object ? JSON_OBJECT : JSON_ARRAY;
+        skip_spaces();
+        if (cur < end && *cur == (is_object ? '}' : ']')) {
+            cur++;
+            return true;
+        }
+        while (true) {
+            std::pair<std::string, json_node> member;
+            if (is_object) {
+                skip_spaces();
+                if (cur >= end || *cur != '"' || !read_string(member.first)) {
+                    return false;
+                }
+                skip_spaces();
+                if (cur >= end || *cur++ != ':') {
+                    return false;
+                }
+            }
+            if (!read_value(member.second, depth + 1)) {
+                return false;
+            }
+            node.members.push_back(std::move(member));
+            skip_spaces();
+            if (cur < end && *cur == ',') {
+                cur++;
+            } else if (cur < end && *cur == (is_object ? '}' : ']')) {
+                cur++;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+};
+
+json_node *current(jparse_ctx_t *jctx)
+{
+    return static_cast<json_node *>(jctx->stack[jctx->depth]);
+}
+
+json_node *get_member(jparse_ctx_t *jctx, const char *name, json_type type)
+{
+    json_node *node = current(jctx);
+    if (node->type != JSON_OBJECT) {
+        return nullptr;
+    }
+    for (auto &member : node->members) {
+        if (member.first == name) {
+            return member.second.type == type ? &member.second : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+int enter(jparse_ctx_t *jctx, json_node *node)
+{
+    if (!node || jctx->depth + 1 >= JSON_PARSER_MAX_DEPTH) {
+        return -1;
+    }
+    jctx->stack[++jctx->depth] = node;
+    return 0;
+}
+
+int leave(jparse_ctx_t *jctx, json_type type)
+{
+    if (jctx->depth == 0 || current(jctx)->type != type) {
+        return -1;
+    }
+    jctx->depth--;
+    return 0;
+}
+
+int to_int64(const json_node *node, int64_t *val)
+{
+    if (!node) {
+        return -1;
+    }
+    char *end = nullptr;
+    *val = strtoll(node->text.c_str(), &end, 10);
+    return *end == '\0' ? 0 : -1;
+}
+
+} // namespace
+
+int json_parse_start(jparse_ctx_t *jctx, const char *js, int len)
+{
+    memset(jctx, 0, sizeof(*jctx));
+    json_node *root = new json_node;
+    json_reader reader = {js, js + len};
+    if (!reader.read_value(*root, 0) || root->type != JSON_OBJECT) {
+        delete root;
+        return -1;
+    }
+    jctx->root = root;
+    jctx->stack[0] = root;
+    return 0;
+}
+
+int json_parse_end(jparse_ctx_t *jctx)
+{
+    delete static_cast<json_node *>(jctx->root);
+    memset(jctx, 0, sizeof(*jctx));
+    return 0;
+}
+
+int json_obj_get_object(jparse_ctx_t *jctx, const char *name)
+{
+    return enter(jctx, get_member(jctx, name, JSON_OBJECT));
+}
+
+int json_obj_leave_object(jparse_ctx_t *jctx)
+{
+    return leave(jctx, JSON_OBJECT);
+}
+
+int json_obj_get_array(jparse_ctx_t *jctx, const char *name, int *num_elem)
+{
+    json_node *node = get_member(jctx, name, JSON_ARRAY);
+    if (enter(jctx, node) != 0) {
+        return -1;
+    }
+    *num_elem = static_cast<int>(node->members.size());
+    return 0;
+}
+
+int json_obj_leave_array(jparse_ctx_t *jctx)
+{
+    return leave(jctx, JSON_ARRAY);
+}
+
+int json_obj_get_bool(jparse_ctx_t *jctx, const char *name, bool *val)
+{
+    json_node *node = get_member(jctx, name, JSON_PRIMITIVE);
+    if (!node || (node->text != "true" && node->text != "false")) {
+        return -1;
+    }
+    *val = node->text == "true";
+    return 0;
+}
+
+int json_obj_get_int(jparse_ctx_t *jctx, const char *name, int *val)
+{
+    int64_t val64;
+    if (to_int64(get_member(jctx, name, JSON_PRIMITIVE), &val64) != 0) {
+        return -1;
+    }
+    *val = static_cast<int>(val64);
+    return 0;
+}
+
+int json_obj_get_int64(jparse_ctx_t *jctx, const char *name, int64_t *val)
+{
+    return to_int64(get_member(jctx, name, JSON_PRIMITIVE), val);
+}
+
+int json_obj_get_string(jparse_ctx_t *jctx, const char *name, char *val, int size)
+{
+    json_node *node = get_member(jctx, name, JSON_STRING);
+    if (!node || static_cast<int>(node->text.size()) > size - 1) {
+        return -1;
+    }
+    memcpy(val, node->text.c_str(), node->text.size() + 1);
+    return 0;
+}
+
+int json_obj_get_strlen(jparse_ctx_t *jctx, const char *name, int *strlen)
+{
+    json_node *node = get_member(jctx, name, JSON_STRING);
+    if (!node) {
+        return -1;
+    }
+    *strlen = static_cast<int>(node->text.size());
+    return 0;
+}
+
+int json_arr_get_int(jparse_ctx_t *jctx, uint32_t index, int *val)
+{
+    json_node *node = current(jctx);
+    int64_t val64;
+    if (node->type != JSON_ARRAY || index >= node->members.size() ||
+        node->members[index].second.type != JSON_PRIMITIVE || to_int64(&node->members[index].second, &val64) != 0) {
+        return -1;
+    }
+    *val = static_cast<int>(val64);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP error type
+
+#pragma once
+
+#include <inttypes.h>
+#include <stdint.h>
+
+namespace chip {
+
+class ChipError {
+public:
+    constexpr ChipError() : mCode(0) {}
+    explicit constexpr ChipError(uint32_t code) : mCode(code) {}
+
+    constexpr bool operator==(const ChipError &other) const { return mCode == other.mCode; }
+    constexpr bool operator!=(const ChipError &other) const { return mCode != other.mCode; }
+    constexpr uint32_t AsInteger() const { return mCode; }
+    constexpr bool IsSuccess() const { return mCode == 0; }
+    uint32_t Format() const { return mCode; }
+
+private:
+    uint32_t mCode;
+};
+
+} // namespace chip
+
+using CHIP_ERROR = chip::ChipError;
+
+#define CHIP_ERROR_FORMAT PRIu32
+
+#define CHIP_NO_ERROR chip::ChipError(0)
+#define CHIP_ERROR_INCORRECT_STATE chip::ChipError(0x03)
+#define CHIP_ERROR_NO_MEMORY chip::ChipError(0x0B)
+#define CHIP_ERROR_BUFFER_TOO_SMALL chip::ChipError(0x19)
+#define CHIP_ERROR_INVALID_ARGUMENT chip::ChipError(0x2F)
+#define CHIP_ERROR_INVALID_TLV_TAG chip::ChipError(0x25)
+#define CHIP_ERROR_INTERNAL chip::ChipError(0xAC)
+#define CHIP_ERROR_BUSY chip::ChipError(0xDB)
+#define CHIP_END_OF_TLV chip::ChipError(0x21)
@@ -0,0 +1,30 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP data model types
+
+#pragma once
+
+#include <stdint.h>
+
+namespace chip {
+
+typedef uint8_t FabricIndex;
+typedef uint64_t NodeId;
+typedef uint16_t VendorId;
+
+constexpr FabricIndex kUndefinedFabricIndex = 0;
+constexpr NodeId kUndefinedNodeId = 0;
+constexpr VendorId kMaxVendorId = 0xFFF4;
+
+} // namespace chip
@@ -0,0 +1,284 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP TLV tags and TLVWriter, it writes the Matter TLV encoding into a flat buffer
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/SafeInt.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace chip {
+namespace TLV {
+
+enum class TLVElementType : int8_t {
+    NotSpecified = -1,
+    Int8 = 0x00,
+    Int16 = 0x01,
+    Int32 = 0x02,
+    Int64 = 0x03,
+    UInt8 = 0x04,
+    UInt16 = 0x05,
+    UInt32 = 0x06,
+    UInt64 = 0x07,
+    BooleanFalse = 0x08,
+    BooleanTrue = 0x09,
+    FloatingPointNumber32 = 0x0A,
+    FloatingPointNumber64 = 0x0B,
+    UTF8String_1ByteLength = 0x0C,
+    UTF8String_2ByteLength = 0x0D,
+    UTF8String_4ByteLength = 0x0E,
+    ByteString_1ByteLength = 0x10,
+    ByteString_2ByteLength = 0x11,
+    ByteString_4ByteLength = 0x12,
+    Null = 0x14,
+    Structure = 0x15,
+    Array = 0x16,
+    List = 0x17,
+    EndOfContainer = 0x18,
+};
+
+enum TLVType {
+    kTLVType_NotSpecified = -1,
+    kTLVType_Structure = 0x15,
+    kTLVType_Array = 0x16,
+    kTLVType_List = 0x17,
+};
+
+class Tag {
+public:
+    constexpr Tag() : mProfileId(kAnonymousProfileId), mTagNum(UINT32_MAX) {}
+    constexpr Tag(uint32_t profileId, uint32_t tagNum) : mProfileId(profileId), mTagNum(tagNum) {}
+
+    constexpr bool operator==(const Tag &other) const
+    {
+        return mProfileId == other.mProfileId && mTagNum == other.mTagNum;
+    }
+    constexpr bool operator!=(const Tag &other) const { return !(*this == other); }
+
+    static constexpr uint32_t kContextProfileId = 0xFFFFFFFE;
+    static constexpr uint32_t kAnonymousProfileId = 0xFFFFFFFF;
+
+    uint32_t mProfileId;
+    uint32_t mTagNum;
+};
+
+constexpr Tag AnonymousTag()
+{
+    return Tag();
+}
+
+constexpr Tag ContextTag(uint8_t tagNum)
+{
+    return Tag(Tag::kContextProfileId, tagNum);
+}
+
+constexpr Tag ProfileTag(uint32_t profileId, uint32_t tagNum)
+{
+    return Tag(profileId, tagNum);
+}
+
+constexpr bool IsContextTag(Tag tag)
+{
+    return tag.mProfileId == Tag::kContextProfileId;
+}
+
+constexpr bool IsProfileTag(Tag tag)
+{
+    return tag.mProfileId != Tag::kContextProfileId && tag.mProfileId != Tag::kAnonymousProfileId;
+}
+
+constexpr uint32_t TagNumFromTag(Tag tag)
+{
+    return tag.mTagNum;
+}
+
+constexpr uint32_t ProfileIdFromTag(Tag tag)
+{
+    return tag.mProfileId;
+}
+
+class TLVWriter {
+public:
+    void Init(uint8_t *buf, size_t maxLen)
+    {
+        mBufStart = buf;
+        mWritePoint = buf;
+        mRemainingLen = maxLen;
+        mContainerType = kTLVType_NotSpecified;
+    }
+
+    uint32_t GetLengthWritten() const { return static_cast<uint32_t>(mWritePoint - mBufStart); }
+    TLVType GetContainerType() const { return mContainerType; }
+
+    CHIP_ERROR Put(Tag tag, int8_t v) { return Put(tag, static_cast<int64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, int16_t v) { return Put(tag, static_cast<int64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, int32_t v) { return Put(tag, static_cast<int64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, int64_t v)
+    {
+        if (v >= INT8_MIN && v <= INT8_MAX) {
+            return WriteElement(tag, TLVElementType::Int8, static_cast<uint64_t>(v), 1);
+        } else if (v >= INT16_MIN && v <= INT16_MAX) {
+            return WriteElement(tag, TLVElementType::Int16, static_cast<uint64_t>(v), 2);
+        } else if (v >= INT32_MIN && v <= INT32_MAX) {
+            return WriteElement(tag, TLVElementType::Int32, static_cast<uint64_t>(v), 4);
+        }
+        return WriteElement(tag, TLVElementType::Int64, static_cast<uint64_t>(v), 8);
+    }
+    CHIP_ERROR Put(Tag tag, uint8_t v) { return Put(tag, static_cast<uint64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, uint16_t v) { return Put(tag, static_cast<uint64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, uint32_t v) { return Put(tag, static_cast<uint64_t>(v)); }
+    CHIP_ERROR Put(Tag tag, uint64_t v)
+    {
+        if (v <= UINT8_MAX) {
+            return WriteElement(tag, TLVElementType::UInt8, v, 1);
+        } else if (v <= UINT16_MAX) {
+            return WriteElement(tag, TLVElementType::UInt16, v, 2);
+        } else if (v <= UINT32_MAX) {
+            return WriteElement(tag, TLVElementType::UInt32, v, 4);
+        }
+        return WriteElement(tag, TLVElementType::UInt64, v, 8);
+    }
+    CHIP_ERROR Put(Tag tag, bool v)
+    {
+        return WriteElement(tag, v ? TLVElementType::BooleanTrue : TLVElementType::BooleanFalse, 0, 0);
+    }
+    CHIP_ERROR Put(Tag tag, float v)
+    {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return WriteElement(tag, TLVElementType::FloatingPointNumber32, bits, 4);
+    }
+    CHIP_ERROR Put(Tag tag, double v)
+    {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return WriteElement(tag, TLVElementType::FloatingPointNumber64, bits, 8);
+    }
+    CHIP_ERROR PutNull(Tag tag) { return WriteElement(tag, TLVElementType::Null, 0, 0); }
+    CHIP_ERROR PutString(Tag tag, const char *buf, uint32_t len)
+    {
+        return WriteString(tag, TLVElementType::UTF8String_1ByteLength, reinterpret_cast<const uint8_t *>(buf), len);
+    }
+    CHIP_ERROR PutString(Tag tag, const char *buf) { return PutString(tag, buf, static_cast<uint32_t>(strlen(buf))); }
+    CHIP_ERROR PutBytes(Tag tag, const uint8_t *buf, uint32_t len)
+    {
+        return WriteString(tag, TLVElementType::ByteString_1ByteLength, buf, len);
+    }
+
+    CHIP_ERROR StartContainer(Tag tag, TLVType containerType, TLVType &outerContainerType)
+    {
+        CHIP_ERROR err = WriteElement(tag, static_cast<TLVElementType>(containerType), 0, 0);
+        if (err != CHIP_NO_ERROR) {
+            return err;
+        }
+        outerContainerType = mContainerType;
+        mContainerType = containerType;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR EndContainer(TLVType outerContainerType)
+    {
+        if (mContainerType == kTLVType_NotSpecified) {
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+        mContainerType = outerContainerType;
+        return WriteBytes(static_cast<uint8_t>(TLVElementType::EndOfContainer), nullptr, 0);
+    }
+
+    uint32_t ImplicitProfileId = 0;
+
+private:
+    CHIP_ERROR WriteElement(Tag tag, TLVElementType type, uint64_t value, uint8_t valueLen)
+    {
+        // The members of a structure are tagged, the items of an array are anonymous.
+        if (mContainerType == kTLVType_Array && tag != AnonymousTag()) {
+            return CHIP_ERROR_INVALID_TLV_TAG;
+        }
+        if (mContainerType == kTLVType_Structure && tag == AnonymousTag()) {
+            return CHIP_ERROR_INVALID_TLV_TAG;
+        }
+        uint8_t head[1 + 8 + 8];
+        size_t headLen = 1;
+        uint8_t control = static_cast<uint8_t>(type);
+        if (IsContextTag(tag)) {
+            control |= 0x20;
+            head[headLen++] = static_cast<uint8_t>(tag.mTagNum);
+        } else if (IsProfileTag(tag)) {
+            bool implicit = tag.mProfileId == ImplicitProfileId;
+            bool shortTag = tag.mTagNum <= UINT16_MAX;
+            control |= implicit ? (shortTag ? 0x80 : 0xA0) : (shortTag ? 0xC0 : 0xE0);
+            if (!implicit) {
+                headLen += PutLE(&head[headLen], tag.mProfileId, 4);
+            }
+            headLen += PutLE(&head[headLen], tag.mTagNum, shortTag ? 2 : 4);
+        }
+        head[0] = control;
+        headLen += PutLE(&head[headLen], value, valueLen);
+        return WriteBytes(head[0], &head[1], headLen - 1);
+    }
+
+    CHIP_ERROR WriteString(Tag tag, TLVElementType type, const uint8_t *buf, uint32_t len)
+    {
+        uint8_t lenSize = len <= UINT8_MAX ? 1 : (len <= UINT16_MAX ? 2 : 4);
+        TLVElementType sizedType = static_cast<TLVElementType>(static_cast<uint8_t>(type) + (lenSize == 4 ? 2 : lenSize - 1));
+        TLVWriter checkpoint = *this;
+        CHIP_ERROR err = WriteElement(tag, sizedType, len, lenSize);
+        if (err == CHIP_NO_ERROR && len > mRemainingLen) {
+            err = CHIP_ERROR_BUFFER_TOO_SMALL;
+        }
+        if (err != CHIP_NO_ERROR) {
+            *this = checkpoint;
+            return err;
+        }
+        memcpy(mWritePoint, buf, len);
+        mWritePoint += len;
+        mRemainingLen -= len;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR WriteBytes(uint8_t first, const uint8_t *rest, size_t restLen)
+    {
+        if (1 + restLen > mRemainingLen) {
+            return CHIP_ERROR_BUFFER_TOO_SMALL;
+        }
+        *mWritePoint++ = first;
+        if (restLen) {
+            memcpy(mWritePoint, rest, restLen);
+            mWritePoint += restLen;
+        }
+        mRemainingLen -= 1 + restLen;
+        return CHIP_NO_ERROR;
+    }
+
+    static size_t PutLE(uint8_t *out, uint64_t value, uint8_t len)
+    {
+        for (uint8_t i = 0; i < len; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        return len;
+    }
+
+    uint8_t *mBufStart = nullptr;
+    uint8_t *mWritePoint = nullptr;
+    size_t mRemainingLen = 0;
+    TLVType mContainerType = kTLVType_NotSpecified;
+};
+
+} // namespace TLV
+} // namespace chip
@@ -0,0 +1,27 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP base64 decoder
+
+#pragma once
+
+#include <stdint.h>
+
+#define BASE64_MAX_DECODED_LEN(ENCODED_LEN) ((ENCODED_LEN * 3u) / 4u)
+
+namespace chip {
+
+/** Decode a base64 string, return UINT16_MAX if the string is not valid base64 */
+uint16_t Base64Decode(const char *in, uint16_t inLen, uint8_t *out);
+
+} // namespace chip
@@ -0,0 +1,51 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP platform memory, which counts the allocations for the host tests
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+
+namespace chip {
+namespace Platform {
+
+/** Number of the allocations since the start of the program */
+extern size_t gAllocationCount;
+
+inline void *MemoryAlloc(size_t size)
+{
+    gAllocationCount++;
+    return malloc(size);
+}
+
+inline void *MemoryCalloc(size_t num, size_t size)
+{
+    gAllocationCount++;
+    return calloc(num, size);
+}
+
+inline void *MemoryRealloc(void *p, size_t size)
+{
+    gAllocationCount++;
+    return realloc(p, size);
+}
+
+inline void MemoryFree(void *p)
+{
+    free(p);
+}
+
+} // namespace Platform
+} // namespace chip
@@ -0,0 +1,33 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP integer casting checks
+
+#pragma once
+
+#include <limits>
+#include <type_traits>
+
+namespace chip {
+
+template <typename T, typename U>
+bool CanCastTo(U arg)
+{
+    if (std::is_signed<U>::value && arg < 0) {
+        return std::is_signed<T>::value &&
+            static_cast<long long>(arg) >= static_cast<long long>(std::numeric_limits<T>::min());
+    }
+    return static_cast<unsigned long long>(arg) <= static_cast<unsigned long long>(std::numeric_limits<T>::max());
+}
+
+} // namespace chip
@@ -0,0 +1,101 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Host stub of the CHIP scoped memory buffers
+
+#pragma once
+
+#include <lib/support/CHIPMem.h>
+
+#include <new>
+#include <type_traits>
+
+namespace chip {
+namespace Platform {
+
+template <typename T>
+class ScopedMemoryBuffer {
+public:
+    static_assert(std::is_trivially_destructible<T>::value, "Destructors won't get run");
+
+    ScopedMemoryBuffer() = default;
+    ScopedMemoryBuffer(const ScopedMemoryBuffer &) = delete;
+    ScopedMemoryBuffer &operator=(const ScopedMemoryBuffer &) = delete;
+    ~ScopedMemoryBuffer() { Free(); }
+
+    T *Get() { return mBuffer; }
+    const T *Get() const { return mBuffer; }
+    T &operator[](size_t index) { return mBuffer[index]; }
+    const T &operator[](size_t index) const { return mBuffer[index]; }
+    explicit operator bool() const { return mBuffer != nullptr; }
+
+    ScopedMemoryBuffer &Calloc(size_t elementCount)
+    {
+        Free();
+        mBuffer = static_cast<T *>(MemoryCalloc(elementCount, sizeof(T)));
+        Construct(elementCount);
+        return *this;
+    }
+
+    ScopedMemoryBuffer &Alloc(size_t elementCount)
+    {
+        Free();
+        mBuffer = static_cast<T *>(MemoryAlloc(elementCount * sizeof(T)));
+        Construct(elementCount);
+        return *this;
+    }
+
+    void Free()
+    {
+        MemoryFree(mBuffer);
+        mBuffer = nullptr;
+    }
+
+private:
+    void Construct(size_t elementCount)
+    {
+        if (!std::is_trivially_default_constructible<T>::value && mBuffer) {
+            for (size_t i = 0; i < elementCount; ++i) {
+                new (&mBuffer[i]) T();
+            }
+        }
+    }
+
+    T *mBuffer = nullptr;
+};
+
+template <typename T>
+class ScopedMemoryBufferWithSize : public ScopedMemoryBuffer<T> {
+public:
+    ScopedMemoryBufferWithSize &Calloc(size_t elementCount)
+    {
+        ScopedMemoryBuffer<T>::Calloc(elementCount);
+        mCount = *this ? elementCount : 0;
+        return *this;
+    }
+
+    ScopedMemoryBufferWithSize &Alloc(size_t elementCount)
+    {
+        ScopedMemoryBuffer<T>::Alloc(elementCount);
+        mCount = *this ? elementCount : 0;
+        return *this;
+    }
+
+    size_t AllocatedSize() const { return mCount; }
+
+private:
+    size_t mCount = 0;
+};
+
+} // namespace Platform
+} // namespace chip
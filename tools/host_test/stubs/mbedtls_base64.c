@@ -0,0 +1,63 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host implementation of the mbed TLS base64 decoder stub
+
+#include <mbedtls/base64.h>
+
+static int base64_value(unsigned char c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    } else if (c == '+') {
+        return 62;
+    } else if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen)
+{
+    while (slen > 0 && src[slen - 1] == '=') {
+        slen--;
+    }
+    size_t needed = slen * 3 / 4;
+    *olen = needed;
+    if (!dst || dlen < needed) {
+        return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+    unsigned int acc = 0;
+    int bits = 0;
+    size_t len = 0;
+    for (size_t i = 0; i < slen; ++i) {
+        int value = base64_value(src[i]);
+        if (value < 0) {
+            *olen = 0;
+            return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        }
+        acc = (acc << 6) | (unsigned int)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            dst[len++] = (unsigned char)(acc >> bits);
+        }
+    }
+    *olen = len;
+    return 0;
+}
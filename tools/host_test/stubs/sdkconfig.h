@@ -0,0 +1,46 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host configuration of the host tests, the options are the Kconfig defaults unless a test overrides them
+
+#pragma once
+
+#ifndef CONFIG_ESP_MATTER_MEM_ACCOUNTING
+#define CONFIG_ESP_MATTER_MEM_ACCOUNTING 0
+#endif
+
+#ifndef CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS
+#define CONFIG_ESP_MATTER_OTA_PROVIDER_MAX_BDX_SESSIONS 4
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE
+#define CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_BUFFER_SIZE 8192
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_STACK_SIZE
+#define CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_STACK_SIZE 6144
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_PRIORITY
+#define CONFIG_ESP_MATTER_OTA_PROVIDER_PREFETCH_TASK_PRIORITY 5
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_PROVIDER_ROLLOUT_MAX_NETWORKS
+#define CONFIG_ESP_MATTER_OTA_PROVIDER_ROLLOUT_MAX_NETWORKS 4
+#endif
+#ifndef CONFIG_ESP_MATTER_MAX_OTA_CANDIDATES_COUNT
+#define CONFIG_ESP_MATTER_MAX_OTA_CANDIDATES_COUNT 8
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_CANDIDATES_TTL
+#define CONFIG_ESP_MATTER_OTA_CANDIDATES_TTL 72
+#endif
+#ifndef CONFIG_ESP_MATTER_OTA_CANDIDATES_NO_UPDATE_TTL
+#define CONFIG_ESP_MATTER_OTA_CANDIDATES_NO_UPDATE_TTL 60
+#endif
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Compress an application image for the compressed OTA image processor of the OTA requestor
+(CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE).
+
+The output is the payload of the Matter OTA image, generate the Matter OTA image with the ota_image_tool.py of
+connectedhomeip:
+
+    ./ota_compress.py build/light.bin build/light.bin.lz
+    ota_image_tool.py create -v 0xFFF1 -p 0x8000 -vn 2 -vs "2.0" -da sha256 build/light.bin.lz light-ota.bin
+
+Format: a 12-byte header {"ESPZ", version 1, window bits, lookahead bits, reserved, uint32 LE image size}, followed
+by a LZSS bit stream with the layout of heatshrink, most significant bit first: a 1 bit followed by a 8-bit
+literal, or a 0 bit followed by the distance minus 1 on window bits and the length minus 1 on lookahead bits.
+"""
+
+import argparse
+import logging
+import struct
+
+MAGIC = b'ESPZ'
+VERSION = 1
+MIN_MATCH = 3
+MAX_CHAIN = 64
+
+
+class BitWriter:
+    def __init__(self):
+        self.data = bytearray()
+        self.bits = 0
+        self.count = 0
+
+    def write(self, value, width):
+        for shift in range(width - 1, -1, -1):
+            self.bits = (self.bits << 1) | ((value >> shift) & 1)
+            self.count += 1
+            if self.count == 8:
+                self.data.append(self.bits)
+                self.bits = 0
+                self.count = 0
+
+    def flush(self):
+        if self.count:
+            self.data.append(self.bits << (8 - self.count))
+            self.bits = 0
+            self.count = 0
+        return bytes(self.data)
+
+
+def compress(data, window_bits, lookahead_bits):
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    writer = BitWriter()
+    # Positions of the 3-byte prefixes, the most recent last
+    chains = {}
+    size = len(data)
+    pos = 0
+
+    def insert(at):
+        if at + MIN_MATCH <= size:
+            chain = chains.setdefault(data[at:at + MIN_MATCH], [])
+            chain.append(at)
+            if len(chain) > MAX_CHAIN:
+                del chain[0]
+
+    while pos < size:
+        best_len = 0
+        best_dist = 0
+        limit = min(max_len, size - pos)
+        if limit >= MIN_MATCH:
+            for candidate in reversed(chains.get(data[pos:pos + MIN_MATCH], ())):
+                dist = pos - candidate
+                if dist > window:
+                    break
+                length = MIN_MATCH
+                while length < limit and data[candidate + length] == data[pos + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_dist = length, dist
+                    if length == limit:
+                        break
+        if best_len >= MIN_MATCH:
+            writer.write(0, 1)
+            writer.write(best_dist - 1, window_bits)
+            writer.write(best_len - 1, lookahead_bits)
+            for at in range(pos, pos + best_len):
+                insert(at)
+            pos += best_len
+        else:
+            writer.write(1, 1)
+            writer.write(data[pos], 8)
+            insert(pos)
+            pos += 1
+
+    header = MAGIC + struct.pack('<BBBBI', VERSION, window_bits, lookahead_bits, 0, size)
+    return header + writer.flush()
+
+
+def decompress(payload):
+    magic, version, window_bits, lookahead_bits, _, size = struct.unpack('<4sBBBBI', payload[:12])
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('Not a compressed image')
+    window_mask = (1 << window_bits) - 1
+    window = bytearray(1 << window_bits)
+    out = bytearray()
+    bits = ''.join(f'{byte:08b}' for byte in payload[12:])
+    pos = 0
+
+    def read(width):
+        nonlocal pos
+        value = int(bits[pos:pos + width], 2)
+        pos += width
+        return value
+
+    def emit(byte):
+        window[len(out) & window_mask] = byte
+        out.append(byte)
+
+    while len(out) < size:
+        if read(1):
+            emit(read(8))
+        else:
+            index = read(window_bits) + 1
+            count = read(lookahead_bits) + 1
+            for _ in range(min(count, size - len(out))):
+                emit(window[(len(out) - index) & window_mask])
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compress an application image for the Matter OTA requestor')
+    parser.add_argument('input', help='Application image, e.g. build/light.bin')
+    parser.add_argument('output', help='Compressed image, to use as the payload of the Matter OTA image')
+    parser.add_argument('-w', '--window-bits', type=int, default=10, choices=range(8, 16),
+                        help='Window size in bits, the requestor allocates 2^N bytes (default: 10). It should not '
+                             'exceed CONFIG_ESP_MATTER_OTA_COMPRESSED_IMAGE_MAX_WINDOW_BITS of the requestor')
+    parser.add_argument('-l', '--lookahead-bits', type=int, default=4, choices=range(3, 8),
+                        help='Maximum match length in bits (default: 4)')
+    parser.add_argument('--verify', action='store_true', help='Decompress the output and compare it to the input')
+    args = parser.parse_args()
+
+    logging.basicConfig(format='%(levelname)s: %(message)s', level=logging.INFO)
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    payload = compress(data, args.window_bits, args.lookahead_bits)
+    if args.verify and decompress(payload) != data:
+        raise SystemExit('Verification of the compressed image failed')
+    with open(args.output, 'wb') as f:
+        f.write(payload)
+    logging.info('%s: %d -> %d bytes (%.1f%%)', args.output, len(data), len(payload),
+                 100.0 * len(payload) / max(len(data), 1))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Generate and apply the delta images of the delta OTA image processor of the OTA requestor
+(CONFIG_ESP_MATTER_OTA_DELTA_IMAGE).
+
+The patch is the payload of the Matter OTA image, generate the Matter OTA image with the ota_image_tool.py of
+connectedhomeip. The software version of the Matter OTA image is the version of the new image:
+
+    ./ota_delta.py create --verify light-v1.bin light-v2.bin light-v1-v2.patch
+    ota_image_tool.py create -v 0xFFF1 -p 0x8000 -vn 2 -vs "2.0" -da sha256 light-v1-v2.patch light-v1-v2-ota.bin
+
+The patch only applies to the base image it was generated from, the requestor checks the SHA-256 digest of its
+running image before writing anything.
+
+Format: a 48-byte header {"ESPD", version 1, 3 reserved bytes, uint32 LE new image size, uint32 LE base image size,
+SHA-256 of the base image}, followed by operations: COPY (0x01) {uint32 LE base offset, uint32 LE length} and
+INSERT (0x02) {uint32 LE length} followed by the data.
+"""
+
+import argparse
+import hashlib
+import logging
+import struct
+
+MAGIC = b'ESPD'
+VERSION = 1
+OP_COPY = 0x01
+OP_INSERT = 0x02
+HEADER = struct.Struct('<4sB3xII32s')
+
+# Length of the blocks of the base image index, and step between the indexed blocks
+BLOCK_LEN = 16
+BLOCK_STEP = 4
+# Shorter matches are cheaper as inserted data than as a COPY operation
+MIN_COPY_LEN = 24
+MAX_CANDIDATES = 8
+
+
+def _match_len(base, base_pos, new, new_pos):
+    length = 0
+    limit = min(len(base) - base_pos, len(new) - new_pos)
+    # Compare by chunks first, then byte by byte
+    while length + 64 <= limit and base[base_pos + length:base_pos + length + 64] == \
+            new[new_pos + length:new_pos + length + 64]:
+        length += 64
+    while length < limit and base[base_pos + length] == new[new_pos + length]:
+        length += 1
+    return length
+
+
+def create(base, new):
+    index = {}
+    for pos in range(0, len(base) - BLOCK_LEN + 1, BLOCK_STEP):
+        candidates = index.setdefault(base[pos:pos + BLOCK_LEN], [])
+        if len(candidates) < MAX_CANDIDATES:
+            candidates.append(pos)
+
+    ops = bytearray()
+    insert_start = 0
+    pos = 0
+
+    def flush_insert(end):
+        if end > insert_start:
+            ops.extend(struct.pack('<BI', OP_INSERT, end - insert_start))
+            ops.extend(new[insert_start:end])
+
+    while pos + BLOCK_LEN <= len(new):
+        best_len = 0
+        best_base = 0
+        best_back = 0
+        for candidate in index.get(new[pos:pos + BLOCK_LEN], ()):
+            length = _match_len(base, candidate, new, pos)
+            # Extend the match backwards into the pending inserted data
+            back = 0
+            while back < pos - insert_start and back < candidate and \
+                    base[candidate - back - 1] == new[pos - back - 1]:
+                back += 1
+            if length + back > best_len + best_back:
+                best_len, best_base, best_back = length, candidate, back
+        if best_len + best_back >= MIN_COPY_LEN:
+            flush_insert(pos - best_back)
+            ops.extend(struct.pack('<BII', OP_COPY, best_base - best_back, best_len + best_back))
+            pos += best_len
+            insert_start = pos
+        else:
+            pos += 1
+    flush_insert(len(new))
+
+    header = HEADER.pack(MAGIC, VERSION, len(new), len(base), hashlib.sha256(base).digest())
+    return header + bytes(ops)
+
+
+def apply(base, patch):
+    magic, version, new_size, base_size, base_digest = HEADER.unpack(patch[:HEADER.size])
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('Not a delta image')
+    if base_size != len(base) or hashlib.sha256(base).digest() != base_digest:
+        raise ValueError('The patch does not apply to the base image')
+    new = bytearray()
+    pos = HEADER.size
+    while pos < len(patch):
+        opcode = patch[pos]
+        if opcode == OP_COPY:
+            offset, length = struct.unpack_from('<II', patch, pos + 1)
+            if offset + length > len(base):
+                raise ValueError('Copy out of the base image')
+            new.extend(base[offset:offset + length])
+            pos += 9
+        elif opcode == OP_INSERT:
+            length, = struct.unpack_from('<I', patch, pos + 1)
+            new.extend(patch[pos + 5:pos + 5 + length])
+            pos += 5 + length
+        else:
+            raise ValueError(f'Invalid opcode 0x{opcode:02x}')
+    if len(new) != new_size:
+        raise ValueError('Truncated patch')
+    return bytes(new)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate and apply the delta images of the Matter OTA requestor')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    create_parser = subparsers.add_parser('create', help='Generate a patch from the base image to the new image')
+    create_parser.add_argument('base', help='Application image running on the requestors')
+    create_parser.add_argument('new', help='New application image')
+    create_parser.add_argument('patch', help='Patch, to use as the payload of the Matter OTA image')
+    create_parser.add_argument('--verify', action='store_true', help='Apply the patch and compare it to the new image')
+
+    apply_parser = subparsers.add_parser('apply', help='Apply a patch to the base image, like the requestor does')
+    apply_parser.add_argument('base', help='Base application image')
+    apply_parser.add_argument('patch', help='Patch')
+    apply_parser.add_argument('new', help='Output application image')
+
+    args = parser.parse_args()
+    logging.basicConfig(format='%(levelname)s: %(message)s', level=logging.INFO)
+
+    with open(args.base, 'rb') as f:
+        base = f.read()
+    if args.command == 'create':
+        with open(args.new, 'rb') as f:
+            new = f.read()
+        patch = create(base, new)
+        if args.verify and apply(base, patch) != new:
+            raise SystemExit('Verification of the patch failed')
+        with open(args.patch, 'wb') as f:
+            f.write(patch)
+        logging.info('%s: %d bytes for a new image of %d bytes (%.1f%%)', args.patch, len(patch), len(new),
+                     100.0 * len(patch) / max(len(new), 1))
+    else:
+        with open(args.patch, 'rb') as f:
+            patch = f.read()
+        with open(args.new, 'wb') as f:
+            f.write(apply(base, patch))
+
+
+if __name__ == '__main__':
+    main()